@@ -33,7 +33,25 @@ uint32_t tf_crc32(uint32_t crc, const unsigned char *buf, size_t size)
 	size_t local_size = size;
 
 	/*
-	 * calculate CRC over byte data
+	 * calculate CRC over byte data up to a 32-bit aligned address
+	 */
+	while ((local_size != 0UL) && (((uintptr_t)local_buf & 3UL) != 0UL)) {
+		calc_crc = __crc32b(calc_crc, *local_buf);
+		local_buf++;
+		local_size--;
+	}
+
+	/*
+	 * calculate CRC over 32-bit data
+	 */
+	while (local_size >= sizeof(uint32_t)) {
+		calc_crc = __crc32w(calc_crc, *(const uint32_t *)local_buf);
+		local_buf += sizeof(uint32_t);
+		local_size -= sizeof(uint32_t);
+	}
+
+	/*
+	 * calculate CRC over the remaining byte data
 	 */
 	while (local_size != 0UL) {
 		calc_crc = __crc32b(calc_crc, *local_buf);
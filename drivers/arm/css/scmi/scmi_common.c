@@ -23,6 +23,88 @@
 #endif
 
 
+#if SCMI_LATENCY_STATS
+/*
+ * Account the completed command to the latency counters of its protocol.
+ * Called with the channel lock held.
+ */
+static void scmi_stats_update(scmi_channel_t *ch)
+{
+	uint64_t delta = read_cntpct_el0() - ch->cmd_start;
+	struct scmi_proto_stats *st;
+	unsigned int i;
+
+	for (i = 0U; i < SCMI_STATS_MAX_PROTO; i++) {
+		st = &ch->stats[i];
+		if ((st->count == 0U) || (st->proto_id == ch->cmd_proto))
+			break;
+	}
+
+	/* Out of slots, drop the sample */
+	if (i == SCMI_STATS_MAX_PROTO)
+		return;
+
+	st->proto_id = ch->cmd_proto;
+	st->count++;
+	st->total += delta;
+	if (delta > st->max)
+		st->max = delta;
+}
+
+/*
+ * API to print the per-protocol command latency counters of a channel.
+ */
+void scmi_latency_stats_dump(void *p)
+{
+	scmi_channel_t *ch = (scmi_channel_t *)p;
+	uint64_t ticks_per_us = read_cntfrq_el0() / 1000000U;
+	struct scmi_proto_stats *st;
+	unsigned int i;
+
+	validate_scmi_channel(ch);
+
+	if (ticks_per_us == 0U)
+		ticks_per_us = 1U;
+
+	for (i = 0U; i < SCMI_STATS_MAX_PROTO; i++) {
+		st = &ch->stats[i];
+		if (st->count == 0U)
+			break;
+
+		INFO("SCMI proto 0x%x: %u cmds, avg %llu us, max %llu us\n",
+		     st->proto_id, st->count,
+		     (unsigned long long)(st->total / st->count / ticks_per_us),
+		     (unsigned long long)(st->max / ticks_per_us));
+	}
+}
+#endif
+
+/*
+ * Private helper function to complete a posted command once SCP has handed
+ * the channel back, keeping its status for scmi_channel_wait(). Called with
+ * the channel lock held. Returns 1 when no command is in flight anymore.
+ */
+static int scmi_posted_done(scmi_channel_t *ch)
+{
+	mailbox_mem_t *mbx_mem = (mailbox_mem_t *)(ch->info->scmi_mbx_mem);
+	int status;
+
+	if (ch->posted == 0)
+		return 1;
+
+	if (scmi_command_done(ch) == 0)
+		return 0;
+
+#if SCMI_LATENCY_STATS
+	scmi_stats_update(ch);
+#endif
+	SCMI_PAYLOAD_RET_VAL1(mbx_mem->payload, status);
+	ch->posted_status = status;
+	ch->posted = 0;
+
+	return 1;
+}
+
 /*
  * Private helper function to get exclusive access to SCMI channel.
  */
@@ -31,20 +113,37 @@ void scmi_get_channel(scmi_channel_t *ch)
 	assert(ch->lock);
 	scmi_lock_get(ch->lock);
 
+	/* Let a command posted by the previous owner finish */
+	while (scmi_posted_done(ch) == 0)
+		;
+
+	/* Nobody waited for a failed posted command, report it here */
+	if (ch->posted_status != SCMI_E_SUCCESS) {
+		WARN("SCMI posted command failed (%d)\n", ch->posted_status);
+		ch->posted_status = SCMI_E_SUCCESS;
+	}
+
 	/* Make sure any previous command has finished */
 	assert(SCMI_IS_CHANNEL_FREE(
 			((mailbox_mem_t *)(ch->info->scmi_mbx_mem))->status));
 }
 
 /*
- * Private helper function to transfer ownership of channel from AP to SCP.
+ * Private helper function to transfer ownership of channel from AP to SCP
+ * without waiting for the command to complete.
  */
-void scmi_send_sync_command(scmi_channel_t *ch)
+void scmi_send_command(scmi_channel_t *ch)
 {
 	mailbox_mem_t *mbx_mem = (mailbox_mem_t *)(ch->info->scmi_mbx_mem);
 
 	SCMI_MARK_CHANNEL_BUSY(mbx_mem->status);
 
+#if SCMI_LATENCY_STATS
+	ch->cmd_proto = (mbx_mem->msg_header >> SCMI_MSG_PROTO_ID_SHIFT) &
+			SCMI_MSG_PROTO_ID_MASK;
+	ch->cmd_start = read_cntpct_el0();
+#endif
+
 	/*
 	 * Ensure that any write to the SCMI payload area is seen by SCP before
 	 * we write to the doorbell register. If these 2 writes were reordered
@@ -58,10 +157,18 @@ void scmi_send_sync_command(scmi_channel_t *ch)
 	 * checking whether the channel is free.
 	 */
 	dmbsy();
+}
 
-	/* Wait for channel to be free */
-	while (!SCMI_IS_CHANNEL_FREE(mbx_mem->status))
-		;
+/*
+ * Private helper function to check whether SCP has handed the channel back.
+ * Returns 1 once the command sent with scmi_send_command() has completed.
+ */
+int scmi_command_done(scmi_channel_t *ch)
+{
+	mailbox_mem_t *mbx_mem = (mailbox_mem_t *)(ch->info->scmi_mbx_mem);
+
+	if (!SCMI_IS_CHANNEL_FREE(mbx_mem->status))
+		return 0;
 
 	/*
 	 * Ensure that any read to the SCMI payload area is done after reading
@@ -69,6 +176,24 @@ void scmi_send_sync_command(scmi_channel_t *ch)
 	 * read invalid payload data
 	 */
 	dmbld();
+
+	return 1;
+}
+
+/*
+ * Private helper function to send a command and wait for its completion.
+ */
+void scmi_send_sync_command(scmi_channel_t *ch)
+{
+	scmi_send_command(ch);
+
+	/* Wait for channel to be free */
+	while (scmi_command_done(ch) == 0)
+		;
+
+#if SCMI_LATENCY_STATS
+	scmi_stats_update(ch);
+#endif
 }
 
 /*
@@ -84,6 +209,60 @@ void scmi_put_channel(scmi_channel_t *ch)
 	scmi_lock_release(ch->lock);
 }
 
+/*
+ * Private helper function to release the SCMI channel while the command sent
+ * with scmi_send_command() is still in flight. Only the status of its
+ * response is kept: scmi_channel_wait() returns it, or the next owner of the
+ * channel, which waits for the command to complete, reports a failure.
+ */
+void scmi_put_channel_posted(scmi_channel_t *ch)
+{
+	ch->posted = 1;
+
+	assert(ch->lock);
+	scmi_lock_release(ch->lock);
+}
+
+/*
+ * API to check, without blocking, whether the channel is idle. Returns 1 when
+ * no command, posted or not, is in flight on the channel.
+ */
+int scmi_channel_poll(void *p)
+{
+	scmi_channel_t *ch = (scmi_channel_t *)p;
+	int ret;
+
+	validate_scmi_channel(ch);
+
+	scmi_lock_get(ch->lock);
+	ret = scmi_posted_done(ch);
+	scmi_lock_release(ch->lock);
+
+	return ret;
+}
+
+/*
+ * API to wait until any command posted on the channel has completed. Returns
+ * the SCMI status of the last posted command, or SCMI_E_SUCCESS if that was
+ * already reported.
+ */
+int scmi_channel_wait(void *p)
+{
+	scmi_channel_t *ch = (scmi_channel_t *)p;
+	int ret;
+
+	validate_scmi_channel(ch);
+
+	scmi_lock_get(ch->lock);
+	while (scmi_posted_done(ch) == 0)
+		;
+	ret = ch->posted_status;
+	ch->posted_status = SCMI_E_SUCCESS;
+	scmi_lock_release(ch->lock);
+
+	return ret;
+}
+
 /*
  * API to query the SCMI protocol version.
  */
@@ -153,8 +153,11 @@ typedef struct mailbox_mem {
 
 /* Private APIs for use within SCMI driver */
 void scmi_get_channel(scmi_channel_t *ch);
+void scmi_send_command(scmi_channel_t *ch);
+int scmi_command_done(scmi_channel_t *ch);
 void scmi_send_sync_command(scmi_channel_t *ch);
 void scmi_put_channel(scmi_channel_t *ch);
+void scmi_put_channel_posted(scmi_channel_t *ch);
 
 static inline void validate_scmi_channel(scmi_channel_t *ch)
 {
@@ -8,6 +8,7 @@
 
 #include <common/debug.h>
 #include <drivers/auth/crypto_mod.h>
+#include <plat/common/platform.h>
 
 /* Variable exported by the crypto library through REGISTER_CRYPTO_LIB() */
 
@@ -187,3 +188,110 @@ int crypto_mod_auth_decrypt(enum crypto_dec_algo dec_algo, void *data_ptr,
 					    key_len, key_flags, iv, iv_len, tag,
 					    tag_len);
 }
+
+/* Backend of the chunked decryption in progress */
+static const crypto_dec_ops_t *dec_ops;
+
+/*
+ * Start a chunked authenticated decryption
+ *
+ * The backend returned by plat_get_dec_ops(), typically a crypto engine, is
+ * tried first, then the one of the crypto library. CRYPTO_ERR_INIT is
+ * returned if neither can do the decryption, in which case the caller may
+ * fall back to crypto_mod_auth_decrypt().
+ *
+ * Parameters:
+ *
+ *   dec_algo: authenticated decryption algorithm
+ *   key, key_len, key_flags: symmetric decryption key
+ *   iv, iv_len: initialization vector
+ */
+int crypto_mod_auth_decrypt_start(enum crypto_dec_algo dec_algo,
+				  const void *key, unsigned int key_len,
+				  unsigned int key_flags, const void *iv,
+				  unsigned int iv_len)
+{
+	const crypto_dec_ops_t *ops;
+	int rc;
+
+	assert(dec_ops == NULL);
+	assert(key != NULL);
+	assert(key_len != 0U);
+	assert(iv != NULL);
+	assert((iv_len != 0U) && (iv_len <= CRYPTO_MAX_IV_SIZE));
+
+	ops = plat_get_dec_ops();
+	if (ops != NULL) {
+		rc = ops->start(dec_algo, key, key_len, key_flags, iv, iv_len);
+		if (rc != CRYPTO_ERR_INIT) {
+			if (rc == CRYPTO_SUCCESS) {
+				VERBOSE("Decrypting with %s\n", ops->name);
+				dec_ops = ops;
+			}
+			return rc;
+		}
+		VERBOSE("%s cannot decrypt, trying %s\n", ops->name,
+			crypto_lib_desc.name);
+	}
+
+	ops = crypto_lib_desc.dec_ops;
+	if (ops == NULL) {
+		return CRYPTO_ERR_INIT;
+	}
+
+	rc = ops->start(dec_algo, key, key_len, key_flags, iv, iv_len);
+	if (rc == CRYPTO_SUCCESS) {
+		VERBOSE("Decrypting with %s\n", ops->name);
+		dec_ops = ops;
+	}
+
+	return rc;
+}
+
+/*
+ * Decrypt the next chunk in place
+ *
+ * Parameters:
+ *
+ *   data_ptr, len: data to be decrypted (inout param)
+ */
+int crypto_mod_auth_decrypt_update(void *data_ptr, size_t len)
+{
+	assert(dec_ops != NULL);
+	assert(data_ptr != NULL);
+
+	if (len == 0U) {
+		return CRYPTO_SUCCESS;
+	}
+
+	return dec_ops->update(data_ptr, len);
+}
+
+/*
+ * Check the authentication tag and end the decryption
+ *
+ * Parameters:
+ *
+ *   tag, tag_len: authentication tag
+ */
+int crypto_mod_auth_decrypt_finish(const void *tag, unsigned int tag_len)
+{
+	const crypto_dec_ops_t *ops = dec_ops;
+
+	assert(ops != NULL);
+	assert(tag != NULL);
+	assert((tag_len != 0U) && (tag_len <= CRYPTO_MAX_TAG_SIZE));
+
+	dec_ops = NULL;
+
+	return ops->finish(tag, tag_len);
+}
+
+/* End the decryption without checking the tag */
+void crypto_mod_auth_decrypt_abort(void)
+{
+	if (dec_ops != NULL) {
+		dec_ops->abort();
+		dec_ops = NULL;
+	}
+}
@@ -0,0 +1,266 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * SHA-256 block compression and AES block encryption for mbed TLS, see
+ * mbedtls_armv8_crypto.c. The ARMv8 Cryptographic Extension is used when the
+ * CPU implements it, and the portable versions below otherwise.
+ *
+ * Only BL1 and BL2 use the extension: BL31 does not save the FP/SIMD
+ * registers of the lower ELs unless CTX_INCLUDE_FPREGS is set, so it keeps to
+ * the portable versions.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <arch_features.h>
+#include <drivers/auth/mbedtls/armv8_crypto.h>
+
+#if defined(IMAGE_BL1) || defined(IMAGE_BL2)
+#define ARMV8_CRYPTO_USE_CE	1
+#else
+#define ARMV8_CRYPTO_USE_CE	0
+#endif
+
+#define ROR32(x, n)		(((x) >> (n)) | ((x) << (32U - (n))))
+
+#define SHA256_CH(x, y, z)	(((x) & (y)) ^ (~(x) & (z)))
+#define SHA256_MAJ(x, y, z)	(((x) & (y)) | ((z) & ((x) | (y))))
+#define SHA256_S0(x)		(ROR32(x, 2U) ^ ROR32(x, 13U) ^ ROR32(x, 22U))
+#define SHA256_S1(x)		(ROR32(x, 6U) ^ ROR32(x, 11U) ^ ROR32(x, 25U))
+#define SHA256_G0(x)		(ROR32(x, 7U) ^ ROR32(x, 18U) ^ ((x) >> 3))
+#define SHA256_G1(x)		(ROR32(x, 17U) ^ ROR32(x, 19U) ^ ((x) >> 10))
+
+static const uint32_t sha256_k[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+	0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+	0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+	0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+	0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+	0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+	0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+	0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static const uint8_t aes_sbox[256] = {
+	0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5,
+	0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+	0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0,
+	0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+	0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc,
+	0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+	0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a,
+	0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+	0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0,
+	0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+	0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b,
+	0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+	0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85,
+	0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+	0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5,
+	0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+	0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17,
+	0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+	0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88,
+	0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+	0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c,
+	0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+	0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9,
+	0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+	0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6,
+	0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+	0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e,
+	0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+	0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94,
+	0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+	0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68,
+	0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16,
+};
+
+static inline uint32_t load_be32(const uint8_t *p)
+{
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+	       ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+/* Word i of the message schedule, kept in a circular buffer of 16 words */
+static inline uint32_t sha256_w(uint32_t *w, unsigned int i)
+{
+	if (i >= 16U) {
+		w[i & 15U] += SHA256_G1(w[(i - 2U) & 15U]) + w[(i - 7U) & 15U] +
+			      SHA256_G0(w[(i - 15U) & 15U]);
+	}
+
+	return w[i & 15U];
+}
+
+/* One round, the caller rotating the roles of the working variables */
+#define SHA256_ROUND(a, b, c, d, e, f, g, h, i)				\
+	do {								\
+		uint32_t t = (h) + SHA256_S1(e) + SHA256_CH(e, f, g) +	\
+			     sha256_k[i] + sha256_w(w, i);		\
+		(d) += t;						\
+		(h) = t + SHA256_S0(a) + SHA256_MAJ(a, b, c);		\
+	} while (false)
+
+void sha256_blocks_c(uint32_t state[8], const uint8_t *data, size_t blocks)
+{
+	uint32_t w[16];
+	uint32_t a, b, c, d, e, f, g, h;
+	unsigned int i;
+
+	for (; blocks != 0U; blocks--) {
+		for (i = 0U; i < 16U; i++) {
+			w[i] = load_be32(data);
+			data += 4;
+		}
+
+		a = state[0];
+		b = state[1];
+		c = state[2];
+		d = state[3];
+		e = state[4];
+		f = state[5];
+		g = state[6];
+		h = state[7];
+
+		for (i = 0U; i < 64U; i += 8U) {
+			SHA256_ROUND(a, b, c, d, e, f, g, h, i);
+			SHA256_ROUND(h, a, b, c, d, e, f, g, i + 1U);
+			SHA256_ROUND(g, h, a, b, c, d, e, f, i + 2U);
+			SHA256_ROUND(f, g, h, a, b, c, d, e, i + 3U);
+			SHA256_ROUND(e, f, g, h, a, b, c, d, i + 4U);
+			SHA256_ROUND(d, e, f, g, h, a, b, c, i + 5U);
+			SHA256_ROUND(c, d, e, f, g, h, a, b, i + 6U);
+			SHA256_ROUND(b, c, d, e, f, g, h, a, i + 7U);
+		}
+
+		state[0] += a;
+		state[1] += b;
+		state[2] += c;
+		state[3] += d;
+		state[4] += e;
+		state[5] += f;
+		state[6] += g;
+		state[7] += h;
+	}
+}
+
+static inline uint8_t aes_xtime(uint8_t x)
+{
+	return (uint8_t)((x << 1) ^ (((x >> 7) & 1U) * 0x1BU));
+}
+
+/*
+ * Byte oriented, to keep the code and tables small: none of the cores this
+ * is meant for lacks the AES instructions.
+ */
+void aes_encrypt_block_c(const uint32_t *rk, unsigned int nr,
+			 const uint8_t in[16], uint8_t out[16])
+{
+	const uint8_t *k = (const uint8_t *)rk;
+	uint8_t s[16], t[16];
+	uint8_t x;
+	unsigned int r, c, i;
+
+	for (i = 0U; i < 16U; i++) {
+		s[i] = in[i] ^ k[i];
+	}
+
+	for (r = 1U; r <= nr; r++) {
+		k += 16;
+
+		/* SubBytes and ShiftRows, the state being column major */
+		for (c = 0U; c < 4U; c++) {
+			for (i = 0U; i < 4U; i++) {
+				t[(4U * c) + i] =
+					aes_sbox[s[((4U * (c + i)) + i) & 15U]];
+			}
+		}
+
+		for (c = 0U; c < 16U; c += 4U) {
+			if (r == nr) {
+				/* The last round has no MixColumns */
+				for (i = 0U; i < 4U; i++) {
+					s[c + i] = t[c + i] ^ k[c + i];
+				}
+				continue;
+			}
+
+			x = t[c] ^ t[c + 1U] ^ t[c + 2U] ^ t[c + 3U];
+			s[c] = t[c] ^ x ^ aes_xtime(t[c] ^ t[c + 1U]) ^ k[c];
+			s[c + 1U] = t[c + 1U] ^ x ^
+				    aes_xtime(t[c + 1U] ^ t[c + 2U]) ^ k[c + 1U];
+			s[c + 2U] = t[c + 2U] ^ x ^
+				    aes_xtime(t[c + 2U] ^ t[c + 3U]) ^ k[c + 2U];
+			s[c + 3U] = t[c + 3U] ^ x ^
+				    aes_xtime(t[c + 3U] ^ t[c]) ^ k[c + 3U];
+		}
+	}
+
+	for (i = 0U; i < 16U; i++) {
+		out[i] = s[i];
+	}
+}
+
+#if ARMV8_CRYPTO_USE_CE
+/* The ID register is read once rather than for every block */
+static bool ce_sha256_present(void)
+{
+	static int present = -1;
+
+	if (present < 0) {
+		present = is_feat_sha256_present() ? 1 : 0;
+	}
+
+	return present == 1;
+}
+
+static bool ce_aes_present(void)
+{
+	static int present = -1;
+
+	if (present < 0) {
+		present = is_feat_aes_present() ? 1 : 0;
+	}
+
+	return present == 1;
+}
+#endif /* ARMV8_CRYPTO_USE_CE */
+
+void armv8_crypto_sha256_blocks(uint32_t state[8], const uint8_t *data,
+				size_t blocks)
+{
+#if ARMV8_CRYPTO_USE_CE
+	if (ce_sha256_present()) {
+		sha256_blocks_ce(state, data, blocks);
+		return;
+	}
+#endif
+	sha256_blocks_c(state, data, blocks);
+}
+
+void armv8_crypto_aes_encrypt(const uint32_t *rk, unsigned int nr,
+			      const uint8_t in[16], uint8_t out[16])
+{
+#if ARMV8_CRYPTO_USE_CE
+	if (ce_aes_present()) {
+		aes_encrypt_block_ce(rk, nr, in, out);
+		return;
+	}
+#endif
+	aes_encrypt_block_c(rk, nr, in, out);
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Replacements of the mbed TLS SHA-256 compression and AES block encryption
+ * functions, selected with TF_MBEDTLS_USE_ARMV8_CRYPTO=1 through
+ * MBEDTLS_SHA256_PROCESS_ALT and MBEDTLS_AES_ENCRYPT_ALT. The rest of both
+ * modules, including the AES key schedule, is that of mbed TLS.
+ */
+
+/* The contexts are only accessed through their members */
+#define MBEDTLS_ALLOW_PRIVATE_ACCESS
+
+#include <stdint.h>
+
+/* mbed TLS headers */
+#include <mbedtls/sha256.h>
+#include <mbedtls/version.h>
+#if TF_MBEDTLS_USE_AES_GCM
+#include <mbedtls/aes.h>
+#endif
+
+#include <drivers/auth/mbedtls/armv8_crypto.h>
+
+int mbedtls_internal_sha256_process(mbedtls_sha256_context *ctx,
+				    const unsigned char data[64])
+{
+	armv8_crypto_sha256_blocks(ctx->state, data, 1U);
+
+	return 0;
+}
+
+#if TF_MBEDTLS_USE_AES_GCM
+int mbedtls_internal_aes_encrypt(mbedtls_aes_context *ctx,
+				 const unsigned char input[16],
+				 unsigned char output[16])
+{
+#if (MBEDTLS_VERSION_MAJOR < 3)
+	const uint32_t *rk = ctx->rk;
+#else
+	const uint32_t *rk = ctx->buf + ctx->rk_offset;
+#endif
+
+	armv8_crypto_aes_encrypt(rk, (unsigned int)ctx->nr, input, output);
+
+	return 0;
+}
+#endif /* TF_MBEDTLS_USE_AES_GCM */
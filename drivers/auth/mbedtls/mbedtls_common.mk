@@ -150,6 +150,20 @@ else
     TF_MBEDTLS_USE_AES_GCM	:=	0
 endif
 
+# Use the ARMv8 Cryptographic Extension for SHA-256 and AES, when the CPU
+# implements it, in place of the mbed TLS C code.
+TF_MBEDTLS_USE_ARMV8_CRYPTO	?=	0
+$(eval $(call assert_boolean,TF_MBEDTLS_USE_ARMV8_CRYPTO))
+
+ifeq (${TF_MBEDTLS_USE_ARMV8_CRYPTO},1)
+    ifneq (${ARCH},aarch64)
+        $(error "TF_MBEDTLS_USE_ARMV8_CRYPTO=1 requires ARCH=aarch64")
+    endif
+    MBEDTLS_SOURCES	+=	drivers/auth/mbedtls/armv8_crypto.c		\
+				drivers/auth/mbedtls/aarch64/armv8_crypto.S	\
+				drivers/auth/mbedtls/mbedtls_armv8_crypto.c
+endif
+
 # Needs to be set to drive mbed TLS configuration correctly
 $(eval $(call add_defines,\
     $(sort \
@@ -157,6 +171,7 @@ $(eval $(call add_defines,\
         TF_MBEDTLS_KEY_SIZE \
         TF_MBEDTLS_HASH_ALG_ID \
         TF_MBEDTLS_USE_AES_GCM \
+        TF_MBEDTLS_USE_ARMV8_CRYPTO \
 )))
 
 $(eval $(call MAKE_LIB,mbedtls))
@@ -5,6 +5,7 @@
  */
 
 #include <assert.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <string.h>
 
@@ -18,6 +19,7 @@
 #include <mbedtls/x509.h>
 
 #include <common/debug.h>
+#include <common/tbbr/cot_def.h>
 #include <drivers/auth/crypto_mod.h>
 #include <drivers/auth/mbedtls/mbedtls_common.h>
 
@@ -65,6 +67,108 @@ static void init(void)
 
 #if CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_ONLY || \
 CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC
+/*
+ * Public keys parsed by verify_signature(), kept for the next signatures
+ * made with the same key: a parent key usually signs several certificates of
+ * the chain of trust, e.g. the trusted world key. This also keeps what mbed
+ * TLS precomputes on the first verification, such as the ECP comb table.
+ *
+ * Keys are matched on their DER encoding, which is copied in the entry. The
+ * contexts themselves use the mbed TLS heap, so only a few are kept.
+ */
+#define PK_CACHE_SIZE		2U
+
+typedef struct pk_cache_entry_s {
+	mbedtls_pk_context pk;
+	unsigned char der[PK_DER_LEN];
+	unsigned int der_len;		/* 0 if the entry is free */
+	unsigned int last_use;
+} pk_cache_entry_t;
+
+static pk_cache_entry_t pk_cache[PK_CACHE_SIZE];
+static unsigned int pk_cache_time;
+
+static void pk_cache_free(pk_cache_entry_t *entry)
+{
+	if (entry->der_len != 0U) {
+		mbedtls_pk_free(&entry->pk);
+		entry->der_len = 0U;
+	}
+}
+
+/*
+ * Free the entries other than the given one, so that their heap can be used.
+ * Returns whether any was freed.
+ */
+static bool pk_cache_flush(const pk_cache_entry_t *keep)
+{
+	bool freed = false;
+	unsigned int i;
+
+	for (i = 0U; i < PK_CACHE_SIZE; i++) {
+		if ((&pk_cache[i] != keep) && (pk_cache[i].der_len != 0U)) {
+			pk_cache_free(&pk_cache[i]);
+			freed = true;
+		}
+	}
+
+	return freed;
+}
+
+/*
+ * Get the parsed context of a public key, parsing it in the least recently
+ * used entry if it is not in the cache. Returns NULL if the key cannot be
+ * parsed.
+ */
+static pk_cache_entry_t *pk_cache_get(void *pk_ptr, unsigned int pk_len)
+{
+	pk_cache_entry_t *entry = &pk_cache[0];
+	unsigned char *p, *end;
+	unsigned int i;
+	int rc;
+
+	if ((pk_len == 0U) || (pk_len > PK_DER_LEN)) {
+		return NULL;
+	}
+
+	for (i = 0U; i < PK_CACHE_SIZE; i++) {
+		if ((pk_cache[i].der_len == pk_len) &&
+		    (memcmp(pk_cache[i].der, pk_ptr, pk_len) == 0)) {
+			pk_cache[i].last_use = ++pk_cache_time;
+			return &pk_cache[i];
+		}
+
+		if ((entry->der_len != 0U) &&
+		    ((pk_cache[i].der_len == 0U) ||
+		     (pk_cache[i].last_use < entry->last_use))) {
+			entry = &pk_cache[i];
+		}
+	}
+
+	pk_cache_free(entry);
+	mbedtls_pk_init(&entry->pk);
+	p = (unsigned char *)pk_ptr;
+	end = p + pk_len;
+	rc = mbedtls_pk_parse_subpubkey(&p, end, &entry->pk);
+	if ((rc != 0) && pk_cache_flush(entry)) {
+		/* Retry with the heap of the other keys */
+		mbedtls_pk_free(&entry->pk);
+		mbedtls_pk_init(&entry->pk);
+		p = (unsigned char *)pk_ptr;
+		rc = mbedtls_pk_parse_subpubkey(&p, end, &entry->pk);
+	}
+	if (rc != 0) {
+		mbedtls_pk_free(&entry->pk);
+		return NULL;
+	}
+
+	memcpy(entry->der, pk_ptr, pk_len);
+	entry->der_len = pk_len;
+	entry->last_use = ++pk_cache_time;
+
+	return entry;
+}
+
 /*
  * Verify a signature.
  *
@@ -80,7 +184,7 @@ static int verify_signature(void *data_ptr, unsigned int data_len,
 	mbedtls_asn1_buf signature;
 	mbedtls_md_type_t md_alg;
 	mbedtls_pk_type_t pk_alg;
-	mbedtls_pk_context pk = {0};
+	pk_cache_entry_t *pk;
 	int rc;
 	void *sig_opts = NULL;
 	const mbedtls_md_info_t *md_info;
@@ -101,12 +205,9 @@ static int verify_signature(void *data_ptr, unsigned int data_len,
 		return CRYPTO_ERR_SIGNATURE;
 	}
 
-	/* Parse the public key */
-	mbedtls_pk_init(&pk);
-	p = (unsigned char *)pk_ptr;
-	end = (unsigned char *)(p + pk_len);
-	rc = mbedtls_pk_parse_subpubkey(&p, end, &pk);
-	if (rc != 0) {
+	/* Get the public key, parsed by a previous call if possible */
+	pk = pk_cache_get(pk_ptr, pk_len);
+	if (pk == NULL) {
 		rc = CRYPTO_ERR_SIGNATURE;
 		goto end2;
 	}
@@ -136,9 +237,15 @@ static int verify_signature(void *data_ptr, unsigned int data_len,
 	}
 
 	/* Verify the signature */
-	rc = mbedtls_pk_verify_ext(pk_alg, sig_opts, &pk, md_alg, hash,
+	rc = mbedtls_pk_verify_ext(pk_alg, sig_opts, &pk->pk, md_alg, hash,
 			mbedtls_md_get_size(md_info),
 			signature.p, signature.len);
+	if ((rc != 0) && pk_cache_flush(pk)) {
+		/* The heap may have been short: retry without the other keys */
+		rc = mbedtls_pk_verify_ext(pk_alg, sig_opts, &pk->pk, md_alg,
+				hash, mbedtls_md_get_size(md_info),
+				signature.p, signature.len);
+	}
 	if (rc != 0) {
 		rc = CRYPTO_ERR_SIGNATURE;
 		goto end1;
@@ -148,7 +255,10 @@ static int verify_signature(void *data_ptr, unsigned int data_len,
 	rc = CRYPTO_SUCCESS;
 
 end1:
-	mbedtls_pk_free(&pk);
+	/* Only keys which verified a signature are kept */
+	if (rc != CRYPTO_SUCCESS) {
+		pk_cache_free(pk);
+	}
 end2:
 	mbedtls_free(sig_opts);
 	return rc;
@@ -280,89 +390,120 @@ static int calc_hash(enum crypto_md_algo md_algo, void *data_ptr,
 	  CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC */
 
 #if TF_MBEDTLS_USE_AES_GCM
-/*
- * Stack based buffer allocation for decryption operation. It could
- * be configured to balance stack usage vs execution speed.
- */
-#define DEC_OP_BUF_SIZE		128
+/* Context of the AES-GCM decryption in progress */
+static mbedtls_gcm_context gcm_ctx;
 
-static int aes_gcm_decrypt(void *data_ptr, size_t len, const void *key,
-			   unsigned int key_len, const void *iv,
-			   unsigned int iv_len, const void *tag,
-			   unsigned int tag_len)
+static int gcm_dec_start(enum crypto_dec_algo dec_algo, const void *key,
+			 unsigned int key_len, unsigned int key_flags,
+			 const void *iv, unsigned int iv_len)
 {
-	mbedtls_gcm_context ctx;
-	mbedtls_cipher_id_t cipher = MBEDTLS_CIPHER_ID_AES;
-	unsigned char buf[DEC_OP_BUF_SIZE];
-	unsigned char tag_buf[CRYPTO_MAX_TAG_SIZE];
-	unsigned char *pt = data_ptr;
-	size_t dec_len;
-	int diff, i, rc;
-	size_t output_length __unused;
-
-	mbedtls_gcm_init(&ctx);
+	int rc;
 
-	rc = mbedtls_gcm_setkey(&ctx, cipher, key, key_len * 8);
-	if (rc != 0) {
-		rc = CRYPTO_ERR_DECRYPTION;
-		goto exit_gcm;
+	/* A key identifier can only be used by a crypto engine */
+	if ((dec_algo != CRYPTO_GCM_DECRYPT) ||
+	    ((key_flags & ENC_KEY_IS_IDENTIFIER) != 0U)) {
+		return CRYPTO_ERR_INIT;
 	}
 
+	mbedtls_gcm_init(&gcm_ctx);
+
+	rc = mbedtls_gcm_setkey(&gcm_ctx, MBEDTLS_CIPHER_ID_AES, key,
+				key_len * 8);
+	if (rc == 0) {
 #if (MBEDTLS_VERSION_MAJOR < 3)
-	rc = mbedtls_gcm_starts(&ctx, MBEDTLS_GCM_DECRYPT, iv, iv_len, NULL, 0);
+		rc = mbedtls_gcm_starts(&gcm_ctx, MBEDTLS_GCM_DECRYPT, iv,
+					iv_len, NULL, 0);
 #else
-	rc = mbedtls_gcm_starts(&ctx, MBEDTLS_GCM_DECRYPT, iv, iv_len);
+		rc = mbedtls_gcm_starts(&gcm_ctx, MBEDTLS_GCM_DECRYPT, iv,
+					iv_len);
 #endif
+	}
+
 	if (rc != 0) {
-		rc = CRYPTO_ERR_DECRYPTION;
-		goto exit_gcm;
+		mbedtls_gcm_free(&gcm_ctx);
+		return CRYPTO_ERR_DECRYPTION;
 	}
 
-	while (len > 0) {
-		dec_len = MIN(sizeof(buf), len);
+	return CRYPTO_SUCCESS;
+}
+
+/*
+ * mbed TLS decrypts in place. Before version 3, every chunk but the last must
+ * be a multiple of the block size, as required by crypto_dec_ops_t.
+ */
+static int gcm_dec_update(void *data_ptr, size_t len)
+{
+	size_t output_length __unused;
+	int rc;
 
 #if (MBEDTLS_VERSION_MAJOR < 3)
-		rc = mbedtls_gcm_update(&ctx, dec_len, pt, buf);
+	rc = mbedtls_gcm_update(&gcm_ctx, len, data_ptr, data_ptr);
 #else
-		rc = mbedtls_gcm_update(&ctx, pt, dec_len, buf, sizeof(buf), &output_length);
+	rc = mbedtls_gcm_update(&gcm_ctx, data_ptr, len, data_ptr, len,
+				&output_length);
 #endif
 
-		if (rc != 0) {
-			rc = CRYPTO_ERR_DECRYPTION;
-			goto exit_gcm;
-		}
+	return (rc == 0) ? CRYPTO_SUCCESS : CRYPTO_ERR_DECRYPTION;
+}
 
-		memcpy(pt, buf, dec_len);
-		pt += dec_len;
-		len -= dec_len;
-	}
+static int gcm_dec_finish(const void *tag, unsigned int tag_len)
+{
+	unsigned char tag_buf[CRYPTO_MAX_TAG_SIZE];
+	size_t output_length __unused;
+	unsigned int i;
+	int diff, rc;
 
 #if (MBEDTLS_VERSION_MAJOR < 3)
-	rc = mbedtls_gcm_finish(&ctx, tag_buf, sizeof(tag_buf));
+	rc = mbedtls_gcm_finish(&gcm_ctx, tag_buf, sizeof(tag_buf));
 #else
-	rc = mbedtls_gcm_finish(&ctx, NULL, 0, &output_length, tag_buf, sizeof(tag_buf));
+	rc = mbedtls_gcm_finish(&gcm_ctx, NULL, 0, &output_length, tag_buf,
+				sizeof(tag_buf));
 #endif
+	mbedtls_gcm_free(&gcm_ctx);
 
 	if (rc != 0) {
-		rc = CRYPTO_ERR_DECRYPTION;
-		goto exit_gcm;
+		return CRYPTO_ERR_DECRYPTION;
 	}
 
 	/* Check tag in "constant-time" */
-	for (diff = 0, i = 0; i < tag_len; i++)
+	for (diff = 0, i = 0U; i < tag_len; i++)
 		diff |= ((const unsigned char *)tag)[i] ^ tag_buf[i];
 
-	if (diff != 0) {
-		rc = CRYPTO_ERR_DECRYPTION;
-		goto exit_gcm;
+	return (diff == 0) ? CRYPTO_SUCCESS : CRYPTO_ERR_DECRYPTION;
+}
+
+static void gcm_dec_abort(void)
+{
+	mbedtls_gcm_free(&gcm_ctx);
+}
+
+static const crypto_dec_ops_t gcm_dec_ops = {
+	.name = LIB_NAME,
+	.start = gcm_dec_start,
+	.update = gcm_dec_update,
+	.finish = gcm_dec_finish,
+	.abort = gcm_dec_abort,
+};
+
+static int aes_gcm_decrypt(void *data_ptr, size_t len, const void *key,
+			   unsigned int key_len, const void *iv,
+			   unsigned int iv_len, const void *tag,
+			   unsigned int tag_len)
+{
+	int rc;
+
+	rc = gcm_dec_start(CRYPTO_GCM_DECRYPT, key, key_len, 0U, iv, iv_len);
+	if (rc != CRYPTO_SUCCESS) {
+		return CRYPTO_ERR_DECRYPTION;
 	}
 
-	/* GCM decryption success */
-	rc = CRYPTO_SUCCESS;
+	rc = gcm_dec_update(data_ptr, len);
+	if (rc != CRYPTO_SUCCESS) {
+		gcm_dec_abort();
+		return rc;
+	}
 
-exit_gcm:
-	mbedtls_gcm_free(&ctx);
-	return rc;
+	return gcm_dec_finish(tag, tag_len);
 }
 
 /*
@@ -398,16 +539,16 @@ static int auth_decrypt(enum crypto_dec_algo dec_algo, void *data_ptr,
  */
 #if CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC
 #if TF_MBEDTLS_USE_AES_GCM
-REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash, calc_hash,
-		    auth_decrypt, NULL);
+REGISTER_CRYPTO_LIB_DEC_OPS(LIB_NAME, init, verify_signature, verify_hash,
+			    calc_hash, auth_decrypt, NULL, &gcm_dec_ops);
 #else
 REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash, calc_hash,
 		    NULL, NULL);
 #endif
 #elif CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_ONLY
 #if TF_MBEDTLS_USE_AES_GCM
-REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash, NULL,
-		    auth_decrypt, NULL);
+REGISTER_CRYPTO_LIB_DEC_OPS(LIB_NAME, init, verify_signature, verify_hash,
+			    NULL, auth_decrypt, NULL, &gcm_dec_ops);
 #else
 REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash, NULL,
 		    NULL, NULL);
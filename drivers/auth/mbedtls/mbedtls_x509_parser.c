@@ -13,6 +13,8 @@
  */
 
 #include <assert.h>
+#include <limits.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <string.h>
@@ -27,11 +29,40 @@
 #include <drivers/auth/mbedtls/mbedtls_common.h>
 #include <lib/utils.h>
 
-/* Maximum OID string length ("a.b.c.d.e.f ...") */
-#define MAX_OID_STR_LEN			64
+/*
+ * Maximum length of the DER contents of an extension ID. This is about the
+ * size of the 64-character strings "a.b.c.d.e.f ..." they used to be
+ * converted to.
+ */
+#define MAX_OID_DER_LEN			32U
+
+/*
+ * Maximum number of extensions indexed per certificate. The extensions of
+ * bigger certificates are walked again when not found in the index.
+ */
+#define MAX_X509_EXT			16U
+
+/* Number of OIDs requested by the CoT whose DER encoding is kept */
+#define OID_CACHE_SIZE			32U
 
 #define LIB_NAME	"mbed TLS X509v3"
 
+/* Extension of the certificate, as found by cert_parse() */
+typedef struct x509_ext_s {
+	const unsigned char *oid;	/* Contents of the extension ID */
+	unsigned char *val;		/* Contents of the extension value */
+	unsigned int oid_len;
+	unsigned int val_len;
+	bool val_is_der;		/* Value holds exactly one DER object */
+} x509_ext_t;
+
+/* OID string used as a cookie by the CoT, and its DER contents */
+typedef struct oid_der_s {
+	const char *str;
+	unsigned char der[MAX_OID_DER_LEN];
+	unsigned int len;
+} oid_der_t;
+
 /* Temporary variables to speed up the authentication parameters search. These
  * variables are assigned once during the integrity check and used any time an
  * authentication parameter is requested, so we do not have to parse the image
@@ -41,6 +72,15 @@ static mbedtls_asn1_buf v3_ext;
 static mbedtls_asn1_buf pk;
 static mbedtls_asn1_buf sig_alg;
 static mbedtls_asn1_buf signature;
+static x509_ext_t ext_idx[MAX_X509_EXT];
+static unsigned int ext_num;
+
+/*
+ * The cookies are constant strings of the CoT, so they are only encoded the
+ * first time they are requested.
+ */
+static oid_der_t oid_cache[OID_CACHE_SIZE];
+static unsigned int oid_cache_num;
 
 /*
  * Clear all static temporary variables.
@@ -58,123 +98,325 @@ static void clear_temp_vars(void)
 	ZERO_AND_CLEAN(pk);
 	ZERO_AND_CLEAN(sig_alg);
 	ZERO_AND_CLEAN(signature);
+	ZERO_AND_CLEAN(ext_idx);
+	ZERO_AND_CLEAN(ext_num);
 
 #undef ZERO_AND_CLEAN
 }
 
 /*
- * Get X509v3 extension
+ * Encode an OID string "a.b.c ..." into the contents of its DER encoding.
+ */
+static int oid_str_to_der(const char *str, unsigned char *der,
+			  unsigned int *der_len)
+{
+	unsigned long arc, first = 0UL;
+	unsigned int len = 0U, n, i, shift;
+
+	for (n = 0U; ; n++) {
+		if ((*str < '0') || (*str > '9')) {
+			return IMG_PARSER_ERR;
+		}
+
+		arc = 0UL;
+		while ((*str >= '0') && (*str <= '9')) {
+			if (arc > ((ULONG_MAX - 9UL) / 10UL)) {
+				return IMG_PARSER_ERR;
+			}
+			arc = (arc * 10UL) + (unsigned long)(*str++ - '0');
+		}
+
+		/* The first two arcs are encoded together */
+		if (n == 0U) {
+			if (arc > 2UL) {
+				return IMG_PARSER_ERR;
+			}
+			first = arc;
+		} else {
+			if (n == 1U) {
+				if ((first < 2UL) && (arc > 39UL)) {
+					return IMG_PARSER_ERR;
+				}
+				if (arc > (ULONG_MAX - 80UL)) {
+					return IMG_PARSER_ERR;
+				}
+				arc += first * 40UL;
+			}
+
+			/* Base 128, most significant group first */
+			for (shift = 0U; (arc >> shift) > 0x7FUL; shift += 7U) {
+			}
+			if ((len + (shift / 7U) + 1U) > MAX_OID_DER_LEN) {
+				return IMG_PARSER_ERR;
+			}
+			for (i = shift; i > 0U; i -= 7U) {
+				der[len++] = (unsigned char)(0x80UL |
+							     ((arc >> i) & 0x7FUL));
+			}
+			der[len++] = (unsigned char)(arc & 0x7FUL);
+		}
+
+		if (*str == '\0') {
+			break;
+		}
+		if (*str++ != '.') {
+			return IMG_PARSER_ERR;
+		}
+	}
+
+	if (n == 0U) {
+		return IMG_PARSER_ERR;
+	}
+
+	*der_len = len;
+
+	return IMG_PARSER_OK;
+}
+
+/*
+ * Get the DER contents of an OID string, from the cache if it has already been
+ * requested. buf is used when the cache is full.
+ */
+static int get_oid_der(const char *oid, unsigned char *buf,
+		       const unsigned char **der, unsigned int *der_len)
+{
+	oid_der_t *entry;
+	unsigned int i;
+	int rc;
+
+	for (i = 0U; i < oid_cache_num; i++) {
+		if (oid_cache[i].str == oid) {
+			*der = oid_cache[i].der;
+			*der_len = oid_cache[i].len;
+			return IMG_PARSER_OK;
+		}
+	}
+
+	if (oid_cache_num == OID_CACHE_SIZE) {
+		*der = buf;
+		return oid_str_to_der(oid, buf, der_len);
+	}
+
+	entry = &oid_cache[oid_cache_num];
+	rc = oid_str_to_der(oid, entry->der, &entry->len);
+	if (rc != IMG_PARSER_OK) {
+		return rc;
+	}
+	entry->str = oid;
+	oid_cache_num++;
+
+	*der = entry->der;
+	*der_len = entry->len;
+
+	return IMG_PARSER_OK;
+}
+
+/*
+ * Check that an extension value holds a single ASN.1 DER object.
+ */
+static bool ext_val_is_der(unsigned char *p, const unsigned char *end)
+{
+	size_t len;
+
+	if ((end - p) < 2) {
+		/* too short */
+		return false;
+	}
+
+	if ((p[0] & 0x1F) == 0x1F) {
+		/* multi-byte ASN.1 DER tag, not allowed */
+		return false;
+	}
+
+	if ((p[0] & 0xDF) == 0) {
+		/* UNIVERSAL 0 tag, not allowed */
+		return false;
+	}
+
+	/* Advance past the tag byte */
+	p++;
+
+	if (mbedtls_asn1_get_len(&p, end, &len)) {
+		/* not valid DER */
+		return false;
+	}
+
+	/* no junk after ASN.1 object */
+	return (p + len) == end;
+}
+
+/*
+ * Parse the extension at *p and advance *p past it.
  *
- * Global variable 'v3_ext' must point to the extensions region
- * in the certificate.  OID may be NULL to request that get_ext()
- * is only being called for integrity checking.
+ * Extension  ::=  SEQUENCE  {
+ *      extnID      OBJECT IDENTIFIER,
+ *      critical    BOOLEAN DEFAULT FALSE,
+ *      extnValue   OCTET STRING  }
  */
-static int get_ext(const char *oid, void **ext, unsigned int *ext_len)
+static int parse_ext(unsigned char **p, const unsigned char *end,
+		     x509_ext_t *ext)
 {
-	int oid_len, ret, is_critical;
+	int ret, is_critical;
 	size_t len;
+	unsigned char *end_ext_data;
+
+	ret = mbedtls_asn1_get_tag(p, end, &len, MBEDTLS_ASN1_CONSTRUCTED |
+				   MBEDTLS_ASN1_SEQUENCE);
+	if (ret != 0) {
+		return IMG_PARSER_ERR_FORMAT;
+	}
+	end_ext_data = *p + len;
+
+	/* Get extension ID */
+	ret = mbedtls_asn1_get_tag(p, end_ext_data, &len, MBEDTLS_ASN1_OID);
+	if (ret != 0) {
+		return IMG_PARSER_ERR_FORMAT;
+	}
+
+	/* The last byte of the ID must end an arc */
+	if ((len == 0U) || (len > MAX_OID_DER_LEN) ||
+	    (((*p)[len - 1U] & 0x80U) != 0U)) {
+		return IMG_PARSER_ERR;
+	}
+	ext->oid = *p;
+	ext->oid_len = (unsigned int)len;
+	*p += len;
+
+	/* Get optional critical */
+	ret = mbedtls_asn1_get_bool(p, end_ext_data, &is_critical);
+	if ((ret != 0) && (ret != MBEDTLS_ERR_ASN1_UNEXPECTED_TAG)) {
+		return IMG_PARSER_ERR_FORMAT;
+	}
+
+	/*
+	 * Data should be octet string type and must use all bytes in
+	 * the Extension.
+	 */
+	ret = mbedtls_asn1_get_tag(p, end_ext_data, &len,
+				   MBEDTLS_ASN1_OCTET_STRING);
+	if ((ret != 0) || ((*p + len) != end_ext_data)) {
+		return IMG_PARSER_ERR_FORMAT;
+	}
+	ext->val = *p;
+	ext->val_len = (unsigned int)len;
+
+	/*
+	 * The value must be ASN.1 DER to be returned, which is only checked
+	 * when it is requested.
+	 */
+	ext->val_is_der = ext_val_is_der(*p, end_ext_data);
+
+	*p = end_ext_data;
+
+	return IMG_PARSER_OK;
+}
+
+/*
+ * Check the integrity of the extensions and index them.
+ *
+ * Global variable 'v3_ext' must point to the extensions region in the
+ * certificate.
+ */
+static int index_ext(void)
+{
+	x509_ext_t ext;
 	unsigned char *p;
 	const unsigned char *end;
-	char oid_str[MAX_OID_STR_LEN];
-	mbedtls_asn1_buf extn_oid;
+	int ret;
 
 	p = v3_ext.p;
 	end = v3_ext.p + v3_ext.len;
+	ext_num = 0U;
 
 	/*
-	 * Check extensions integrity.  At least one extension is
-	 * required: the ASN.1 specifies a minimum size of 1, and at
-	 * least one extension is needed to authenticate the next stage
-	 * in the boot chain.
+	 * At least one extension is required: the ASN.1 specifies a minimum
+	 * size of 1, and at least one extension is needed to authenticate the
+	 * next stage in the boot chain.
 	 */
 	do {
-		unsigned char *end_ext_data;
-
-		ret = mbedtls_asn1_get_tag(&p, end, &len,
-					   MBEDTLS_ASN1_CONSTRUCTED |
-					   MBEDTLS_ASN1_SEQUENCE);
-		if (ret != 0) {
-			return IMG_PARSER_ERR_FORMAT;
+		ret = parse_ext(&p, end, &ext);
+		if (ret != IMG_PARSER_OK) {
+			return ret;
 		}
-		end_ext_data = p + len;
 
-		/* Get extension ID */
-		ret = mbedtls_asn1_get_tag(&p, end_ext_data, &extn_oid.len,
-					   MBEDTLS_ASN1_OID);
-		if (ret != 0) {
-			return IMG_PARSER_ERR_FORMAT;
-		}
-		extn_oid.tag = MBEDTLS_ASN1_OID;
-		extn_oid.p = p;
-		p += extn_oid.len;
-
-		/* Get optional critical */
-		ret = mbedtls_asn1_get_bool(&p, end_ext_data, &is_critical);
-		if ((ret != 0) && (ret != MBEDTLS_ERR_ASN1_UNEXPECTED_TAG)) {
-			return IMG_PARSER_ERR_FORMAT;
-		}
-
-		/*
-		 * Data should be octet string type and must use all bytes in
-		 * the Extension.
-		 */
-		ret = mbedtls_asn1_get_tag(&p, end_ext_data, &len,
-					   MBEDTLS_ASN1_OCTET_STRING);
-		if ((ret != 0) || ((p + len) != end_ext_data)) {
-			return IMG_PARSER_ERR_FORMAT;
+		if (ext_num < MAX_X509_EXT) {
+			ext_idx[ext_num] = ext;
 		}
+		ext_num++;
+	} while (p < end);
 
-		/* Detect requested extension */
-		oid_len = mbedtls_oid_get_numeric_string(oid_str,
-							 MAX_OID_STR_LEN,
-							 &extn_oid);
-		if ((oid_len == MBEDTLS_ERR_OID_BUF_TOO_SMALL) || (oid_len < 0)) {
-			return IMG_PARSER_ERR;
-		}
+	return IMG_PARSER_OK;
+}
 
-		if ((oid != NULL) &&
-		    ((size_t)oid_len == strlen(oid_str)) &&
-		    (strcmp(oid, oid_str) == 0)) {
-			/* Extension must be ASN.1 DER */
-			if (len < 2) {
-				/* too short */
-				return IMG_PARSER_ERR_FORMAT;
-			}
+static bool ext_has_oid(const x509_ext_t *ext, const unsigned char *oid,
+			unsigned int oid_len)
+{
+	return (ext->oid_len == oid_len) &&
+	       (memcmp(ext->oid, oid, oid_len) == 0);
+}
 
-			if ((p[0] & 0x1F) == 0x1F) {
-				/* multi-byte ASN.1 DER tag, not allowed */
-				return IMG_PARSER_ERR_FORMAT;
-			}
+/*
+ * Get X509v3 extension
+ *
+ * The extensions must have been indexed by index_ext(). The first one with
+ * the requested OID is returned.
+ */
+static int get_ext(const char *oid, void **ext, unsigned int *ext_len)
+{
+	unsigned char buf[MAX_OID_DER_LEN];
+	const unsigned char *oid_der;
+	const unsigned char *end;
+	const x509_ext_t *found = NULL;
+	x509_ext_t next;
+	unsigned char *p;
+	unsigned int oid_len, i;
+	int ret;
 
-			if ((p[0] & 0xDF) == 0) {
-				/* UNIVERSAL 0 tag, not allowed */
-				return IMG_PARSER_ERR_FORMAT;
-			}
+	if (oid == NULL) {
+		return IMG_PARSER_ERR_NOT_FOUND;
+	}
 
-			*ext = (void *)p;
-			*ext_len = (unsigned int)len;
+	ret = get_oid_der(oid, buf, &oid_der, &oid_len);
+	if (ret != IMG_PARSER_OK) {
+		return ret;
+	}
 
-			/* Advance past the tag byte */
-			p++;
+	for (i = 0U; (i < ext_num) && (i < MAX_X509_EXT); i++) {
+		if (ext_has_oid(&ext_idx[i], oid_der, oid_len)) {
+			found = &ext_idx[i];
+			break;
+		}
+	}
 
-			if (mbedtls_asn1_get_len(&p, end_ext_data, &len)) {
-				/* not valid DER */
-				return IMG_PARSER_ERR_FORMAT;
+	/* Walk the extensions which did not fit in the index */
+	if ((found == NULL) && (ext_num > MAX_X509_EXT)) {
+		p = (unsigned char *)ext_idx[MAX_X509_EXT - 1U].val +
+		    ext_idx[MAX_X509_EXT - 1U].val_len;
+		end = v3_ext.p + v3_ext.len;
+		while ((found == NULL) && (p < end)) {
+			ret = parse_ext(&p, end, &next);
+			if (ret != IMG_PARSER_OK) {
+				return ret;
 			}
-
-			if (p + len != end_ext_data) {
-				/* junk after ASN.1 object */
-				return IMG_PARSER_ERR_FORMAT;
+			if (ext_has_oid(&next, oid_der, oid_len)) {
+				found = &next;
 			}
-
-			return IMG_PARSER_OK;
 		}
+	}
 
-		/* Next */
-		p = end_ext_data;
-	} while (p < end);
+	if (found == NULL) {
+		return IMG_PARSER_ERR_NOT_FOUND;
+	}
 
-	return (oid == NULL) ? IMG_PARSER_OK : IMG_PARSER_ERR_NOT_FOUND;
+	/* Extension must be ASN.1 DER */
+	if (!found->val_is_der) {
+		return IMG_PARSER_ERR_FORMAT;
+	}
+
+	*ext = (void *)found->val;
+	*ext_len = found->val_len;
+
+	return IMG_PARSER_OK;
 }
 
 
@@ -360,7 +602,7 @@ static int cert_parse(void *img, unsigned int img_len)
 	 * always fail later on, as the extensions contain the
 	 * information needed to authenticate the next stage in the
 	 * boot chain.  Furthermore, get_ext() assumes that the
-	 * extensions have been parsed into v3_ext, and allowing
+	 * extensions have been indexed from v3_ext, and allowing
 	 * there to be no extensions would pointlessly complicate
 	 * the code.  Therefore, just reject certificates without
 	 * extensions.  This is also why version 1 and 2 certificates
@@ -386,8 +628,8 @@ static int cert_parse(void *img, unsigned int img_len)
 	v3_ext.len = len;
 	p += len;
 
-	/* Check extensions integrity */
-	ret = get_ext(NULL, NULL, NULL);
+	/* Check extensions integrity and index them */
+	ret = index_ext();
 	if (ret != IMG_PARSER_OK) {
 		return ret;
 	}
@@ -6,6 +6,7 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <string.h>
 
 #include <arch.h>
@@ -23,6 +24,8 @@ static int imx_usdhc_set_ios(unsigned int clk, unsigned int width);
 static int imx_usdhc_prepare(int lba, uintptr_t buf, size_t size);
 static int imx_usdhc_read(int lba, uintptr_t buf, size_t size);
 static int imx_usdhc_write(int lba, uintptr_t buf, size_t size);
+static int imx_usdhc_set_timing(unsigned int timing);
+static int imx_usdhc_execute_tuning(unsigned int cmd_idx);
 
 static const struct mmc_ops imx_usdhc_ops = {
 	.init		= imx_usdhc_initialize,
@@ -31,10 +34,16 @@ static const struct mmc_ops imx_usdhc_ops = {
 	.prepare	= imx_usdhc_prepare,
 	.read		= imx_usdhc_read,
 	.write		= imx_usdhc_write,
+	.set_timing	= imx_usdhc_set_timing,
+	.execute_tuning	= imx_usdhc_execute_tuning,
 };
 
 static imx_usdhc_params_t imx_usdhc_params;
 
+/* Set while a data transfer started by send_cmd is left to read/write */
+static bool imx_usdhc_data_pending;
+static unsigned int imx_usdhc_timing;
+
 #define IMX7_MMC_SRC_CLK_RATE (200 * 1000 * 1000)
 static void imx_usdhc_set_clk(int clk)
 {
@@ -45,6 +54,10 @@ static void imx_usdhc_set_clk(int clk)
 
 	assert(clk > 0);
 
+	/* The card clock is further divided by 2 in DDR mode */
+	if (imx_usdhc_timing == MMC_TIMING_HS400)
+		sdhc_clk /= 2;
+
 	while (sdhc_clk / (16 * pre_div) > clk && pre_div < 256)
 		pre_div *= 2;
 
@@ -85,6 +98,14 @@ static void imx_usdhc_initialize(void)
 
 	mmio_write_32(reg_base + VENDSPEC, VENDSPEC_INIT);
 	mmio_write_32(reg_base + DLLCTRL, 0);
+	mmio_write_32(reg_base + STROBE_DLLCTRL, 0);
+	imx_usdhc_timing = MMC_TIMING_LEGACY;
+
+	/* Standard tuning, from the first tap with a step of 1 */
+	mmio_clrsetbits32(reg_base + TUNINGCTRL,
+			  TUNINGCTRL_START_MASK | TUNINGCTRL_STEP_MASK,
+			  TUNINGCTRL_STD_EN | TUNINGCTRL_CRC_CHK_DIS |
+			  TUNINGCTRL_START(1) | TUNINGCTRL_STEP(1));
 	mmio_setbits32(reg_base + VENDSPEC, VENDSPEC_IPG_CLKEN | VENDSPEC_PER_CLKEN);
 
 	/* Set the initial boot clock rate */
@@ -127,6 +148,8 @@ static int imx_usdhc_send_cmd(struct mmc_cmd *cmd)
 	while (mmio_read_32(reg_base + PSTATE) & PSTATE_DLA)
 		;
 
+	imx_usdhc_data_pending = false;
+
 	mmio_write_32(reg_base + INTSIGEN, 0);
 	udelay(1000);
 
@@ -217,19 +240,12 @@ static int imx_usdhc_send_cmd(struct mmc_cmd *cmd)
 		cmd->resp_data[0] = mmio_read_32(reg_base + CMDRSP0);
 	}
 
-	/* Wait until all of the blocks are transferred */
-	if (data) {
-		flags = DATA_COMPLETE;
-		do {
-			state = mmio_read_32(reg_base + INTSTAT);
-
-			if (state & (INTSTATEN_DTOE | DATA_ERR)) {
-				err = -EIO;
-				ERROR("imx_usdhc mmc data state 0x%x\n", state);
-				goto out;
-			}
-		} while ((state & flags) != flags);
-	}
+	/*
+	 * The blocks are transferred by DMA while the caller goes on, read and
+	 * write wait for them.
+	 */
+	if (data)
+		imx_usdhc_data_pending = true;
 
 out:
 	/* Reset CMD and DATA on error */
@@ -245,18 +261,190 @@ out:
 		}
 	}
 
+	/* clear all irq status, but the data one if the transfer is running */
+	if (imx_usdhc_data_pending)
+		mmio_write_32(reg_base + INTSTAT, INTSTAT_CC);
+	else
+		mmio_write_32(reg_base + INTSTAT, 0xffffffff);
+
+	return err;
+}
+
+/* Wait until all of the blocks are transferred */
+static int imx_usdhc_wait_data(void)
+{
+	uintptr_t reg_base = imx_usdhc_params.reg_base;
+	unsigned int state;
+	int err = 0;
+
+	if (!imx_usdhc_data_pending)
+		return 0;
+
+	imx_usdhc_data_pending = false;
+
+	do {
+		state = mmio_read_32(reg_base + INTSTAT);
+
+		if (state & (INTSTATEN_DTOE | DATA_ERR)) {
+			err = -EIO;
+			ERROR("imx_usdhc mmc data state 0x%x\n", state);
+			mmio_setbits32(reg_base + SYSCTRL, SYSCTRL_RSTD);
+			while (mmio_read_32(reg_base + SYSCTRL) & SYSCTRL_RSTD)
+				;
+			break;
+		}
+	} while ((state & DATA_COMPLETE) != DATA_COMPLETE);
+
 	/* clear all irq status */
 	mmio_write_32(reg_base + INTSTAT, 0xffffffff);
 
 	return err;
 }
 
+#define IMX_USDHC_STROBE_DLL_RETRIES	50
+
+/* The HS400 data is sampled on the strobe of the card, delayed by a DLL */
+static void imx_usdhc_set_strobe_dll(void)
+{
+	uintptr_t reg_base = imx_usdhc_params.reg_base;
+	unsigned int lock = STROBE_DLLSTS_REF_LOCK | STROBE_DLLSTS_SLV_LOCK;
+	unsigned int retries = 0;
+
+	mmio_clrbits32(reg_base + VENDSPEC, VENDSPEC_CARD_CLKEN);
+
+	mmio_write_32(reg_base + STROBE_DLLCTRL, STROBE_DLLCTRL_RESET);
+	mmio_write_32(reg_base + STROBE_DLLCTRL, 0);
+	mmio_write_32(reg_base + STROBE_DLLCTRL,
+		      STROBE_DLLCTRL_ENABLE |
+		      STROBE_DLLCTRL_SLV_UPDATE_INT(4) |
+		      STROBE_DLLCTRL_SLV_DLY_TARGET(7));
+
+	while ((mmio_read_32(reg_base + STROBE_DLLSTS) & lock) != lock) {
+		if (++retries == IMX_USDHC_STROBE_DLL_RETRIES) {
+			WARN("imx_usdhc strobe DLL not locked: 0x%x\n",
+			     mmio_read_32(reg_base + STROBE_DLLSTS));
+			break;
+		}
+		udelay(1);
+	}
+
+	mmio_setbits32(reg_base + VENDSPEC, VENDSPEC_CARD_CLKEN);
+}
+
+static void imx_usdhc_reset_tuning(void)
+{
+	uintptr_t reg_base = imx_usdhc_params.reg_base;
+
+	mmio_clrbits32(reg_base + AUTOCERR,
+		       AUTOCERR_EXE_TUNE | AUTOCERR_SMPCLK_SEL);
+	mmio_clrbits32(reg_base + MIXCTRL,
+		       MIXCTRL_FBCLK_SEL | MIXCTRL_AUTO_TUNE_EN);
+}
+
+/* The clock rate is set by the next set_ios call */
+static int imx_usdhc_set_timing(unsigned int timing)
+{
+	uintptr_t reg_base = imx_usdhc_params.reg_base;
+
+	switch (timing) {
+	case MMC_TIMING_LEGACY:
+		imx_usdhc_reset_tuning();
+		/* fallthrough */
+	case MMC_TIMING_HS:
+	case MMC_TIMING_HS200:
+		mmio_clrbits32(reg_base + MIXCTRL,
+			       MIXCTRL_DDREN | MIXCTRL_HS400_EN);
+		mmio_write_32(reg_base + STROBE_DLLCTRL, 0);
+		break;
+	case MMC_TIMING_HS400:
+		mmio_setbits32(reg_base + MIXCTRL,
+			       MIXCTRL_DDREN | MIXCTRL_HS400_EN);
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	imx_usdhc_timing = timing;
+
+	return 0;
+}
+
+#define IMX_USDHC_TUNING_RETRIES	40
+#define IMX_USDHC_TUNING_TIMEOUT	1000
+
+/*
+ * With the standard tuning, the controller checks each tuning block sent by
+ * the card and moves the sampling point until it finds a good one.
+ */
+static int imx_usdhc_execute_tuning(unsigned int cmd_idx)
+{
+	uintptr_t reg_base = imx_usdhc_params.reg_base;
+	unsigned int blksz = 64, intstaten, state, timeout, retries;
+
+	if (imx_usdhc_params.bus_width == MMC_BUS_WIDTH_8)
+		blksz = 128;
+
+	intstaten = mmio_read_32(reg_base + INTSTATEN);
+	mmio_write_32(reg_base + INTSTATEN, intstaten | INTSTATEN_BRR);
+
+	mmio_clrsetbits32(reg_base + AUTOCERR, AUTOCERR_SMPCLK_SEL,
+			  AUTOCERR_EXE_TUNE);
+	mmio_setbits32(reg_base + MIXCTRL,
+		       MIXCTRL_FBCLK_SEL | MIXCTRL_AUTO_TUNE_EN);
+
+	for (retries = 0; retries < IMX_USDHC_TUNING_RETRIES; retries++) {
+		timeout = IMX_USDHC_TUNING_TIMEOUT;
+		while ((mmio_read_32(reg_base + PSTATE) &
+			(PSTATE_CDIHB | PSTATE_CIHB)) && --timeout)
+			udelay(1);
+
+		mmio_write_32(reg_base + INTSTAT, 0xffffffff);
+		mmio_write_32(reg_base + BLKATT, BIT(16) | blksz);
+		mmio_clrsetbits32(reg_base + MIXCTRL, MIXCTRL_DATMASK,
+				  MIXCTRL_DTDSEL);
+		mmio_write_32(reg_base + CMDARG, 0);
+		mmio_write_32(reg_base + XFERTYPE,
+			      XFERTYPE_CMD(cmd_idx) | XFERTYPE_DPSEL |
+			      XFERTYPE_RSPTYP_48 | XFERTYPE_CICEN |
+			      XFERTYPE_CCCEN);
+
+		/* The tuning block itself is dropped by the controller */
+		timeout = IMX_USDHC_TUNING_TIMEOUT;
+		do {
+			state = mmio_read_32(reg_base + INTSTAT);
+			udelay(1);
+		} while (!(state & INTSTATEN_BRR) && --timeout);
+
+		if (!(mmio_read_32(reg_base + AUTOCERR) & AUTOCERR_EXE_TUNE))
+			break;
+	}
+
+	mmio_write_32(reg_base + INTSTAT, 0xffffffff);
+	mmio_write_32(reg_base + INTSTATEN, intstaten);
+
+	state = mmio_read_32(reg_base + AUTOCERR);
+	if ((state & AUTOCERR_EXE_TUNE) || !(state & AUTOCERR_SMPCLK_SEL)) {
+		ERROR("imx_usdhc tuning failed, state 0x%x\n", state);
+		imx_usdhc_reset_tuning();
+		mmio_setbits32(reg_base + SYSCTRL, SYSCTRL_RSTC | SYSCTRL_RSTD);
+		while (mmio_read_32(reg_base + SYSCTRL) &
+		       (SYSCTRL_RSTC | SYSCTRL_RSTD))
+			;
+		return -EIO;
+	}
+
+	return 0;
+}
+
 static int imx_usdhc_set_ios(unsigned int clk, unsigned int width)
 {
 	uintptr_t reg_base = imx_usdhc_params.reg_base;
 
 	imx_usdhc_set_clk(clk);
 
+	if (imx_usdhc_timing == MMC_TIMING_HS400)
+		imx_usdhc_set_strobe_dll();
+
 	if (width == MMC_BUS_WIDTH_4)
 		mmio_clrsetbits32(reg_base + PROTCTRL, PROTCTRL_WIDTH_MASK,
 				  PROTCTRL_WIDTH_4);
@@ -271,6 +459,8 @@ static int imx_usdhc_prepare(int lba, uintptr_t buf, size_t size)
 {
 	uintptr_t reg_base = imx_usdhc_params.reg_base;
 
+	flush_dcache_range(buf, size);
+
 	mmio_write_32(reg_base + DSADDR, buf);
 	mmio_write_32(reg_base + BLKATT,
 		      (size / MMC_BLOCK_SIZE) << 16 | MMC_BLOCK_SIZE);
@@ -280,12 +470,17 @@ static int imx_usdhc_prepare(int lba, uintptr_t buf, size_t size)
 
 static int imx_usdhc_read(int lba, uintptr_t buf, size_t size)
 {
-	return 0;
+	int err = imx_usdhc_wait_data();
+
+	/* Drop the lines the CPU may have fetched during the transfer */
+	inv_dcache_range(buf, size);
+
+	return err;
 }
 
 static int imx_usdhc_write(int lba, uintptr_t buf, size_t size)
 {
-	return 0;
+	return imx_usdhc_wait_data();
 }
 
 void imx_usdhc_init(imx_usdhc_params_t *params,
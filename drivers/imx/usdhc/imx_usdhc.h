@@ -97,24 +97,42 @@ void imx_usdhc_init(imx_usdhc_params_t *params,
 
 #define INTSIGEN		0x038
 
+#define AUTOCERR		0x03c
+#define AUTOCERR_SMPCLK_SEL	BIT(23)
+#define AUTOCERR_EXE_TUNE	BIT(22)
+
 #define WATERMARKLEV		0x044
 #define WMKLV_RD_MASK		0xff
 #define WMKLV_WR_MASK		0x00ff0000
 #define WMKLV_MASK		(WMKLV_RD_MASK | WMKLV_WR_MASK)
 
 #define MIXCTRL			0x048
+#define MIXCTRL_HS400_EN	BIT(26)
+#define MIXCTRL_FBCLK_SEL	BIT(25)
+#define MIXCTRL_AUTO_TUNE_EN	BIT(24)
 #define MIXCTRL_MSBSEL		BIT(5)
 #define MIXCTRL_DTDSEL		BIT(4)
 #define MIXCTRL_DDREN		BIT(3)
 #define MIXCTRL_AC12EN		BIT(2)
 #define MIXCTRL_BCEN		BIT(1)
 #define MIXCTRL_DMAEN		BIT(0)
-#define MIXCTRL_DATMASK		0x7f
+/* DDREN is left to the timing selection */
+#define MIXCTRL_DATMASK		0x77
 
 #define DLLCTRL			0x060
 
 #define CLKTUNECTRLSTS		0x068
 
+#define STROBE_DLLCTRL		0x070
+#define STROBE_DLLCTRL_SLV_UPDATE_INT(x)	(((x) & 0xff) << 20)
+#define STROBE_DLLCTRL_SLV_DLY_TARGET(x)	(((x) & 0xf) << 3)
+#define STROBE_DLLCTRL_RESET	BIT(1)
+#define STROBE_DLLCTRL_ENABLE	BIT(0)
+
+#define STROBE_DLLSTS		0x074
+#define STROBE_DLLSTS_REF_LOCK	BIT(1)
+#define STROBE_DLLSTS_SLV_LOCK	BIT(0)
+
 #define VENDSPEC		0x0c0
 #define VENDSPEC_RSRV1		BIT(29)
 #define VENDSPEC_CARD_CLKEN	BIT(14)
@@ -130,6 +148,14 @@ void imx_usdhc_init(imx_usdhc_params_t *params,
 
 #define MMCBOOT			0x0c4
 
+#define TUNINGCTRL		0x0cc
+#define TUNINGCTRL_STD_EN	BIT(24)
+#define TUNINGCTRL_STEP_MASK	0x00070000
+#define TUNINGCTRL_STEP(x)	(((x) & 0x7) << 16)
+#define TUNINGCTRL_CRC_CHK_DIS	BIT(7)
+#define TUNINGCTRL_START_MASK	0x7f
+#define TUNINGCTRL_START(x)	((x) & 0x7f)
+
 #define mmio_clrsetbits32(addr, clear, set)	mmio_write_32(addr, (mmio_read_32(addr) & ~(clear)) | (set))
 #define mmio_clrbits32(addr, clear)		mmio_write_32(addr, mmio_read_32(addr) & ~(clear))
 #define mmio_setbits32(addr, set)		mmio_write_32(addr, mmio_read_32(addr) | (set))
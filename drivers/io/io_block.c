@@ -15,6 +15,7 @@
 #include <drivers/io/io_driver.h>
 #include <drivers/io/io_storage.h>
 #include <lib/utils.h>
+#include <lib/utils_def.h>
 
 typedef struct {
 	io_block_dev_spec_t	*dev_spec;
@@ -240,6 +241,10 @@ static int block_seek(io_entity_t *entity, int mode, signed long long offset)
  *
  * Additionally, the IO driver has an underlying buffer that is at least
  * one block-size and may be big enough to allow.
+ *
+ * With IO_BLOCK_FLAG_DIRECT_READ, the whole blocks of an iteration starting
+ * on a block boundary are read straight into a block-aligned user buffer,
+ * without going through the underlying buffer.
  */
 static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		      size_t *length_read)
@@ -273,6 +278,12 @@ static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 	       (length > 0U) &&
 	       (ops->read != NULL));
 
+	/* Don't let the device read ahead past the end of this request */
+	if (ops->read_limit != NULL) {
+		ops->read_limit((int)div_round_up(cur->base + cur->file_pos +
+						  length, block_size));
+	}
+
 	/*
 	 * We don't know the number of bytes that we are going
 	 * to read in every iteration, because it will depend
@@ -296,6 +307,21 @@ static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		 */
 		lba = (cur->file_pos + cur->base) / block_size;
 
+		if (((cur->dev_spec->flags & IO_BLOCK_FLAG_DIRECT_READ) != 0U) &&
+		    (skip == 0U) && (left >= block_size) &&
+		    (((buffer + count) & (block_size - 1U)) == 0U)) {
+			request = MIN(left & ~(block_size - 1U), buf->length);
+			nbytes = ops->read(lba, buffer + count, request);
+			if (nbytes == 0U) {
+				return -EIO;
+			}
+
+			nbytes = MIN(nbytes, request);
+			cur->file_pos += nbytes;
+			count += nbytes;
+			continue;
+		}
+
 		if ((skip + left) > buf->length) {
 			/*
 			 * The underlying read buffer is too small to
@@ -493,6 +519,13 @@ static int block_write(io_entity_t *entity, const uintptr_t buffer,
 
 static int block_close(io_entity_t *entity)
 {
+	block_dev_state_t *cur = (block_dev_state_t *)entity->info;
+
+	assert(cur != NULL);
+	if (cur->dev_spec->ops.flush != NULL) {
+		cur->dev_spec->ops.flush();
+	}
+
 	entity->info = (uintptr_t)NULL;
 	return 0;
 }
@@ -12,6 +12,7 @@
 
 #include <platform_def.h>
 
+#include <arch_helpers.h>
 #include <common/bl_common.h>
 #include <common/debug.h>
 #include <drivers/auth/crypto_mod.h>
@@ -23,6 +24,17 @@
 #include <tools_share/firmware_encrypted.h>
 #include <tools_share/uuid.h>
 
+/*
+ * Images are decrypted by chunks of this size as they are read. Zero reads
+ * the whole image before decrypting it.
+ */
+#ifndef PLAT_ENC_DEC_CHUNK_SIZE
+#define PLAT_ENC_DEC_CHUNK_SIZE		(64U * 1024U)
+#endif
+
+CASSERT((PLAT_ENC_DEC_CHUNK_SIZE % 16U) == 0U,
+	assert_enc_dec_chunk_size_block_multiple);
+
 static uintptr_t backend_dev_handle;
 static uintptr_t backend_dev_spec;
 static uintptr_t backend_handle;
@@ -150,6 +162,118 @@ static int enc_file_len(io_entity_t *entity, size_t *length)
 	return result;
 }
 
+/* Read up to length bytes, only stopping short at the end of the image */
+static int enc_backend_read(uintptr_t buffer, size_t length,
+			    size_t *length_read)
+{
+	size_t bytes_read;
+	int result;
+
+	*length_read = 0U;
+
+	while (*length_read < length) {
+		result = io_read(backend_handle, buffer + *length_read,
+				 length - *length_read, &bytes_read);
+		if (result != 0) {
+			return result;
+		}
+
+		if (bytes_read == 0U) {
+			break;
+		}
+
+		*length_read += bytes_read;
+	}
+
+	return 0;
+}
+
+/*
+ * Decrypt each chunk as soon as it is read, while it is still in the cache.
+ * With a crypto engine, the next chunk is read while the previous one is
+ * decrypted. On failure, the unauthenticated data is cleared.
+ */
+static int enc_read_chunked(const struct fw_enc_hdr *header, uintptr_t buffer,
+			    size_t length, size_t *length_read)
+{
+	size_t chunk, bytes_read;
+	int result;
+
+	*length_read = 0U;
+
+	while (*length_read < length) {
+		chunk = MIN(length - *length_read,
+			    (size_t)PLAT_ENC_DEC_CHUNK_SIZE);
+
+		result = enc_backend_read(buffer + *length_read, chunk,
+					  &bytes_read);
+		if (result != 0) {
+			WARN("Failed to read encrypted payload (%i)\n", result);
+			crypto_mod_auth_decrypt_abort();
+			result = -ENOENT;
+			goto err;
+		}
+
+		result = crypto_mod_auth_decrypt_update(
+				(void *)(buffer + *length_read), bytes_read);
+		*length_read += bytes_read;
+		if (result != 0) {
+			crypto_mod_auth_decrypt_abort();
+			break;
+		}
+
+		if (bytes_read < chunk) {
+			break;
+		}
+	}
+
+	if (result == 0) {
+		result = crypto_mod_auth_decrypt_finish(header->tag,
+							header->tag_len);
+	}
+
+	if (result != 0) {
+		ERROR("File decryption failed (%i)\n", result);
+		result = -ENOENT;
+		goto err;
+	}
+
+	return 0;
+
+err:
+	zeromem((void *)buffer, *length_read);
+	*length_read = 0U;
+
+	return result;
+}
+
+/* Read the whole image, then decrypt it */
+static int enc_read_whole(const struct fw_enc_hdr *header, uintptr_t buffer,
+			  size_t length, size_t *length_read,
+			  const uint8_t *key, size_t key_len,
+			  unsigned int key_flags)
+{
+	int result;
+
+	result = io_read(backend_handle, buffer, length, length_read);
+	if (result != 0) {
+		WARN("Failed to read encrypted payload (%i)\n", result);
+		return -ENOENT;
+	}
+
+	result = crypto_mod_auth_decrypt(header->dec_algo,
+					 (void *)buffer, *length_read, key,
+					 key_len, key_flags, header->iv,
+					 header->iv_len, header->tag,
+					 header->tag_len);
+	if (result != 0) {
+		ERROR("File decryption failed (%i)\n", result);
+		return -ENOENT;
+	}
+
+	return 0;
+}
+
 static int enc_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 			 size_t *length_read)
 {
@@ -161,6 +285,7 @@ static int enc_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 	size_t key_len = sizeof(key);
 	unsigned int key_flags = 0;
 	const io_uuid_spec_t *uuid_spec = (io_uuid_spec_t *)backend_image_spec;
+	uint64_t start;
 
 	assert(entity != NULL);
 	assert(length_read != NULL);
@@ -186,14 +311,6 @@ static int enc_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		return -ENOENT;
 	}
 
-	result = io_read(backend_handle, buffer, length, &bytes_read);
-	if (result != 0) {
-		WARN("Failed to read encrypted payload (%i)\n", result);
-		return -ENOENT;
-	}
-
-	*length_read = bytes_read;
-
 	result = plat_get_enc_key_info(fw_enc_status, key, &key_len, &key_flags,
 				       (uint8_t *)&uuid_spec->uuid,
 				       sizeof(uuid_t));
@@ -202,18 +319,38 @@ static int enc_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		return -ENOENT;
 	}
 
-	result = crypto_mod_auth_decrypt(header.dec_algo,
-					 (void *)buffer, *length_read, key,
-					 key_len, key_flags, header.iv,
-					 header.iv_len, header.tag,
-					 header.tag_len);
-	memset(key, 0, key_len);
+	start = read_cntpct_el0();
 
-	if (result != 0) {
+	if (PLAT_ENC_DEC_CHUNK_SIZE != 0U) {
+		result = crypto_mod_auth_decrypt_start(header.dec_algo, key,
+						       key_len, key_flags,
+						       header.iv,
+						       header.iv_len);
+	} else {
+		result = CRYPTO_ERR_INIT;
+	}
+
+	if (result == CRYPTO_SUCCESS) {
+		memset(key, 0, key_len);
+		result = enc_read_chunked(&header, buffer, length,
+					  length_read);
+	} else if (result == CRYPTO_ERR_INIT) {
+		result = enc_read_whole(&header, buffer, length, length_read,
+					key, key_len, key_flags);
+		memset(key, 0, key_len);
+	} else {
+		memset(key, 0, key_len);
 		ERROR("File decryption failed (%i)\n", result);
 		return -ENOENT;
 	}
 
+	if (result == 0) {
+		start = (read_cntpct_el0() - start) * 1000000U /
+			read_cntfrq_el0();
+		VERBOSE("Decrypted %zu bytes in %llu us\n", *length_read,
+			(unsigned long long)start);
+	}
+
 	return result;
 }
 
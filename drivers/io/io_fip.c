@@ -70,6 +70,8 @@ static unsigned int fip_dev_count;
 static int fip_dev_open(const uintptr_t dev_spec, io_dev_info_t **dev_info);
 static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 			  io_entity_t *entity);
+static int fip_file_seek(io_entity_t *entity, int mode,
+			 signed long long offset);
 static int fip_file_len(io_entity_t *entity, size_t *length);
 static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 			  size_t *length_read);
@@ -110,7 +112,7 @@ static const io_dev_connector_t fip_dev_connector = {
 static const io_dev_funcs_t fip_dev_funcs = {
 	.type = device_type_fip,
 	.open = fip_file_open,
-	.seek = NULL,
+	.seek = fip_file_seek,
 	.size = fip_file_len,
 	.read = fip_file_read,
 	.write = NULL,
@@ -363,6 +365,31 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 }
 
 
+/* Seek to a position in a file in package */
+static int fip_file_seek(io_entity_t *entity, int mode,
+			 signed long long offset)
+{
+	fip_file_state_t *fp;
+
+	assert(entity != NULL);
+	assert(entity->info != (uintptr_t)NULL);
+
+	/* We only support IO_SEEK_SET for the moment. */
+	if (mode != IO_SEEK_SET) {
+		return -ENOENT;
+	}
+
+	fp = (fip_file_state_t *)entity->info;
+	if ((offset < 0) || ((unsigned long long)offset > fp->entry.size)) {
+		return -EINVAL;
+	}
+
+	fp->file_pos = (unsigned int)offset;
+
+	return 0;
+}
+
+
 /* Return the size of a file in package */
 static int fip_file_len(io_entity_t *entity, size_t *length)
 {
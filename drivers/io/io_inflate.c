@@ -0,0 +1,276 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <common/debug.h>
+#include <drivers/io/io_driver.h>
+#include <drivers/io/io_inflate.h>
+#include <drivers/io/io_storage.h>
+#include <lib/utils_def.h>
+#include <plat/common/platform.h>
+#include <tf_gunzip.h>
+
+/* Size of the gzip trailer: CRC32 and ISIZE */
+#define GZIP_TRAILER_SIZE	8U
+
+static uintptr_t backend_dev_handle;
+static uintptr_t backend_dev_spec;
+static uintptr_t backend_handle;
+
+static const io_inflate_dev_spec_t *inflate_spec;
+
+/*
+ * Compressed data read from the backend but not consumed yet, and compressed
+ * data left to read from the backend
+ */
+static uintptr_t in_next;
+static size_t in_avail;
+static size_t in_left;
+static bool stream_end;
+
+/* Decompressed size, once known, and output produced so far */
+static size_t out_size;
+static size_t out_pos;
+
+static io_dev_info_t inflate_dev_info;
+
+/* Inflate driver functions */
+static int inflate_dev_open(const uintptr_t dev_spec, io_dev_info_t **dev_info);
+static int inflate_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
+			     io_entity_t *entity);
+static int inflate_file_len(io_entity_t *entity, size_t *length);
+static int inflate_file_read(io_entity_t *entity, uintptr_t buffer,
+			     size_t length, size_t *length_read);
+static int inflate_file_close(io_entity_t *entity);
+static int inflate_dev_init(io_dev_info_t *dev_info,
+			    const uintptr_t init_params);
+static int inflate_dev_close(io_dev_info_t *dev_info);
+
+static io_type_t device_type_inflate(void)
+{
+	return IO_TYPE_INFLATE;
+}
+
+static const io_dev_connector_t inflate_dev_connector = {
+	.dev_open = inflate_dev_open
+};
+
+static const io_dev_funcs_t inflate_dev_funcs = {
+	.type = device_type_inflate,
+	.open = inflate_file_open,
+	.seek = NULL,
+	.size = inflate_file_len,
+	.read = inflate_file_read,
+	.write = NULL,
+	.close = inflate_file_close,
+	.dev_init = inflate_dev_init,
+	.dev_close = inflate_dev_close,
+};
+
+static int inflate_dev_open(const uintptr_t dev_spec, io_dev_info_t **dev_info)
+{
+	assert(dev_spec != (uintptr_t)NULL);
+	assert(dev_info != NULL);
+
+	inflate_spec = (const io_inflate_dev_spec_t *)dev_spec;
+	assert(inflate_spec->chunk.length != 0U);
+
+	inflate_dev_info.funcs = &inflate_dev_funcs;
+	*dev_info = &inflate_dev_info;
+
+	return 0;
+}
+
+static int inflate_dev_init(io_dev_info_t *dev_info,
+			    const uintptr_t init_params)
+{
+	int result;
+	unsigned int image_id = (unsigned int)init_params;
+
+	/* Obtain a reference to the image by querying the platform layer */
+	result = plat_get_image_source(image_id, &backend_dev_handle,
+				       &backend_dev_spec);
+	if (result != 0) {
+		WARN("Failed to obtain reference to image id=%u (%i)\n",
+			image_id, result);
+		return -ENOENT;
+	}
+
+	return result;
+}
+
+static int inflate_dev_close(io_dev_info_t *dev_info)
+{
+	backend_dev_handle = (uintptr_t)NULL;
+	backend_dev_spec = (uintptr_t)NULL;
+
+	return 0;
+}
+
+static int inflate_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
+			     io_entity_t *entity)
+{
+	int result;
+
+	assert(spec != 0);
+	assert(entity != NULL);
+
+	result = io_open(backend_dev_handle, spec, &backend_handle);
+	if (result != 0) {
+		WARN("Failed to open backend device (%i)\n", result);
+		return -ENOENT;
+	}
+
+	/* Backends may not stop reads at the end of the file */
+	result = io_size(backend_handle, &in_left);
+	if (result != 0) {
+		WARN("Failed to read blob length (%i)\n", result);
+		io_close(backend_handle);
+		return -ENOENT;
+	}
+
+	result = gunzip_stream_init(inflate_spec->work.offset,
+				    inflate_spec->work.length);
+	if (result != 0) {
+		io_close(backend_handle);
+		return result;
+	}
+
+	in_next = inflate_spec->chunk.offset;
+	in_avail = 0U;
+	stream_end = false;
+	out_size = SIZE_MAX;
+	out_pos = 0U;
+
+	return 0;
+}
+
+/*
+ * The decompressed size is the ISIZE field of the gzip trailer, which is read
+ * by seeking the backend. It has to be called before reading the file.
+ */
+static int inflate_file_len(io_entity_t *entity, size_t *length)
+{
+	int result;
+	size_t bytes_read;
+	uint8_t trailer[GZIP_TRAILER_SIZE];
+
+	assert(entity != NULL);
+	assert(length != NULL);
+
+	if (in_left < GZIP_TRAILER_SIZE) {
+		return -EIO;
+	}
+
+	result = io_seek(backend_handle, IO_SEEK_SET,
+			 (signed long long)(in_left - GZIP_TRAILER_SIZE));
+	if (result == 0) {
+		result = io_read(backend_handle, (uintptr_t)trailer,
+				 sizeof(trailer), &bytes_read);
+	}
+	if (result == 0) {
+		result = io_seek(backend_handle, IO_SEEK_SET, 0);
+	}
+	if ((result != 0) || (bytes_read != sizeof(trailer))) {
+		WARN("Failed to read gzip trailer (%i)\n", result);
+		return -ENOENT;
+	}
+
+	/* ISIZE is little endian */
+	out_size = (size_t)trailer[4] | ((size_t)trailer[5] << 8) |
+		   ((size_t)trailer[6] << 16) | ((size_t)trailer[7] << 24);
+	*length = out_size;
+
+	return 0;
+}
+
+/*
+ * Read the compressed data one chunk at a time and inflate each chunk straight
+ * into the destination buffer, so that the compressed image is never staged
+ * in memory as a whole. Once the whole image has been output, the rest of the
+ * input is still consumed so that the gzip trailer (CRC32 and size) is checked.
+ */
+static int inflate_file_read(io_entity_t *entity, uintptr_t buffer,
+			     size_t length, size_t *length_read)
+{
+	int result;
+	uintptr_t out = buffer;
+	uintptr_t in_start, out_start;
+	size_t chunk_len;
+
+	assert(entity != NULL);
+	assert(length_read != NULL);
+
+	while (!stream_end && ((out < buffer + length) ||
+			       (out_pos + (out - buffer) >= out_size))) {
+		if (in_avail == 0U) {
+			if (in_left == 0U) {
+				ERROR("Compressed image is truncated\n");
+				return -EIO;
+			}
+
+			chunk_len = MIN(in_left, inflate_spec->chunk.length);
+			in_next = inflate_spec->chunk.offset;
+			result = io_read(backend_handle, in_next, chunk_len,
+					 &in_avail);
+			if ((result != 0) || (in_avail == 0U)) {
+				WARN("Failed to read compressed data (%i)\n",
+				     result);
+				return -ENOENT;
+			}
+			in_left -= in_avail;
+		}
+
+		in_start = in_next;
+		out_start = out;
+		result = gunzip_stream(&in_next, in_avail, &out,
+				       buffer + length - out, &stream_end);
+		if (result != 0) {
+			ERROR("Failed to decompress image (err=%d)\n", result);
+			return result;
+		}
+		if (!stream_end && (in_next == in_start) && (out == out_start)) {
+			ERROR("Compressed image is corrupted\n");
+			return -EIO;
+		}
+		in_avail -= in_next - in_start;
+	}
+
+	*length_read = out - buffer;
+	out_pos += *length_read;
+
+	return 0;
+}
+
+static int inflate_file_close(io_entity_t *entity)
+{
+	gunzip_stream_end();
+	io_close(backend_handle);
+
+	entity->info = 0;
+
+	return 0;
+}
+
+/* Exported functions */
+
+/* Register the inflate driver with the IO abstraction */
+int register_io_dev_inflate(const io_dev_connector_t **dev_con)
+{
+	int result;
+
+	assert(dev_con != NULL);
+
+	result = io_register_device(&inflate_dev_info);
+	if (result == 0)
+		*dev_con = &inflate_dev_connector;
+
+	return result;
+}
@@ -23,6 +23,8 @@
 
 #define MULT_BY_512K_SHIFT		19
 
+#define MMC_PART_NUM			(EXT_CSD_PART_CONFIG_ACC_MASK + 1U)
+
 static const struct mmc_ops *ops;
 static unsigned int mmc_ocr_value;
 static struct mmc_csd_emmc mmc_csd;
@@ -32,6 +34,27 @@ static unsigned int mmc_flags;
 static struct mmc_device_info *mmc_dev_info;
 static unsigned int rca;
 static unsigned int scr[2]__aligned(16) = { 0 };
+static unsigned char mmc_cur_part;
+static unsigned int mmc_timing;
+static unsigned long long mmc_enum_ticks;
+static struct mmc_part_stats mmc_stats[MMC_PART_NUM];
+
+/*
+ * A read following the previous one is issued ahead of time in a buffer given
+ * by the platform, so that the card transfers it while the caller consumes the
+ * data it asked for. Any other access waits for it to complete first.
+ */
+static struct {
+	uintptr_t	buf;
+	size_t		buf_size;
+	size_t		size;		/* Size of the read in flight, 0 if none */
+	int		lba;		/* First block of the read in flight */
+	int		next_lba;	/* Block following the last read */
+	int		end_lba;	/* Block past the caller's extent, or -1 */
+} mmc_ra = {
+	.next_lba = -1,
+	.end_lba = -1,
+};
 
 static const unsigned char tran_speed_base[16] = {
 	0, 10, 12, 13, 15, 20, 26, 30, 35, 40, 45, 52, 55, 60, 70, 80
@@ -253,6 +276,115 @@ static int mmc_set_ios(unsigned int clk, unsigned int bus_width)
 	return ops->set_ios(clk, width);
 }
 
+/*
+ * The card status can only be read once the host follows the new timing, so
+ * this cannot go through mmc_set_ext_csd().
+ */
+static int mmc_switch_timing(unsigned int timing, unsigned int clk,
+			     unsigned int width)
+{
+	int ret;
+
+	ret = mmc_send_cmd(MMC_CMD(6),
+			   EXTCSD_WRITE_BYTES |
+			   EXTCSD_CMD(CMD_EXTCSD_HS_TIMING) |
+			   EXTCSD_VALUE(timing) | EXTCSD_CMD_SET_NORMAL,
+			   MMC_RESPONSE_R1B, NULL);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = ops->set_timing(timing);
+	if (ret != 0) {
+		return ret;
+	}
+
+	ret = ops->set_ios(clk, width);
+	if (ret != 0) {
+		return ret;
+	}
+
+	do {
+		ret = mmc_device_state();
+		if (ret < 0) {
+			return ret;
+		}
+	} while (ret == MMC_STATE_PRG);
+
+	mmc_timing = timing;
+
+	return 0;
+}
+
+/* Go back to the timing and clock rate the platform asked for */
+static int mmc_emmc_fallback(unsigned int clk, unsigned int width)
+{
+	int ret;
+
+	ret = mmc_switch_timing(MMC_TIMING_LEGACY, clk, width);
+	if (ret != 0) {
+		return ret;
+	}
+
+	return mmc_set_ext_csd(CMD_EXTCSD_BUS_WIDTH, width);
+}
+
+/*
+ * HS200 is selected straight from the legacy timing, and HS400 from high speed
+ * once the HS200 tuning is done (JEDEC 4.51 chapter 6.6.2).
+ */
+static int mmc_emmc_select_timing(unsigned int clk, unsigned int width)
+{
+	unsigned char dev_type = mmc_ext_csd[CMD_EXTCSD_DEVICE_TYPE];
+	int ret;
+
+	if (((mmc_flags & (MMC_FLAG_HS200 | MMC_FLAG_HS400)) == 0U) ||
+	    (ops->set_timing == NULL) || (ops->execute_tuning == NULL)) {
+		return 0;
+	}
+
+	if (((dev_type & EXT_CSD_DEVICE_TYPE_HS200) == 0U) ||
+	    ((width != MMC_BUS_WIDTH_4) && (width != MMC_BUS_WIDTH_8))) {
+		VERBOSE("HS200 not supported, device type 0x%x\n", dev_type);
+		return 0;
+	}
+
+	ret = mmc_switch_timing(MMC_TIMING_HS200, MMC_HS200_CLK_RATE, width);
+	if (ret == 0) {
+		/* CMD21: SEND_TUNING_BLOCK */
+		ret = ops->execute_tuning(MMC_CMD(21));
+	}
+	if (ret != 0) {
+		WARN("Cannot switch to HS200 (%d), keep default timing\n", ret);
+		return mmc_emmc_fallback(clk, width);
+	}
+
+	mmc_dev_info->max_bus_freq = MMC_HS200_CLK_RATE;
+
+	if (((mmc_flags & MMC_FLAG_HS400) == 0U) ||
+	    ((dev_type & EXT_CSD_DEVICE_TYPE_HS400) == 0U) ||
+	    (width != MMC_BUS_WIDTH_8)) {
+		return 0;
+	}
+
+	ret = mmc_switch_timing(MMC_TIMING_HS, MMC_HS_CLK_RATE, width);
+	if (ret == 0) {
+		ret = mmc_set_ext_csd(CMD_EXTCSD_BUS_WIDTH,
+				      MMC_BUS_WIDTH_DDR_8);
+	}
+	if (ret == 0) {
+		ret = mmc_switch_timing(MMC_TIMING_HS400, MMC_HS200_CLK_RATE,
+					width);
+	}
+	if (ret != 0) {
+		WARN("Cannot switch to HS400 (%d), keep default timing\n", ret);
+		mmc_dev_info->max_bus_freq = clk;
+		return mmc_emmc_fallback(clk, width);
+	}
+
+	return 0;
+}
+
 static int mmc_fill_device_info(void)
 {
 	unsigned long long c_size;
@@ -557,6 +689,10 @@ static int mmc_enumerate(unsigned int clk, unsigned int bus_width)
 		return ret;
 	}
 
+	if (mmc_dev_info->mmc_dev_type == MMC_IS_EMMC) {
+		return mmc_emmc_select_timing(clk, bus_width);
+	}
+
 	if (is_sd_cmd6_enabled() &&
 	    (mmc_dev_info->mmc_dev_type == MMC_IS_SD_HC)) {
 		/* Try to switch to High Speed Mode */
@@ -587,19 +723,14 @@ static int mmc_enumerate(unsigned int clk, unsigned int bus_width)
 	return ret;
 }
 
-size_t mmc_read_blocks(int lba, uintptr_t buf, size_t size)
+static int mmc_read_start(int lba, uintptr_t buf, size_t size)
 {
 	int ret;
 	unsigned int cmd_idx, cmd_arg;
 
-	assert((ops != NULL) &&
-	       (ops->read != NULL) &&
-	       (size != 0U) &&
-	       ((size & MMC_BLOCK_MASK) == 0U));
-
 	ret = ops->prepare(lba, buf, size);
 	if (ret != 0) {
-		return 0;
+		return ret;
 	}
 
 	if (is_cmd23_enabled()) {
@@ -607,7 +738,7 @@ size_t mmc_read_blocks(int lba, uintptr_t buf, size_t size)
 		ret = mmc_send_cmd(MMC_CMD(23), size / MMC_BLOCK_SIZE,
 				   MMC_RESPONSE_R1, NULL);
 		if (ret != 0) {
-			return 0;
+			return ret;
 		}
 
 		cmd_idx = MMC_CMD(18);
@@ -626,36 +757,175 @@ size_t mmc_read_blocks(int lba, uintptr_t buf, size_t size)
 		cmd_arg = lba;
 	}
 
-	ret = mmc_send_cmd(cmd_idx, cmd_arg, MMC_RESPONSE_R1, NULL);
-	if (ret != 0) {
-		return 0;
-	}
+	mmc_stats[mmc_cur_part].read_cmds++;
+
+	return mmc_send_cmd(cmd_idx, cmd_arg, MMC_RESPONSE_R1, NULL);
+}
+
+static int mmc_read_end(int lba, uintptr_t buf, size_t size)
+{
+	int ret;
 
 	ret = ops->read(lba, buf, size);
 	if (ret != 0) {
-		return 0;
+		return ret;
 	}
 
 	/* Wait buffer empty */
 	do {
 		ret = mmc_device_state();
 		if (ret < 0) {
-			return 0;
+			return ret;
 		}
 	} while ((ret != MMC_STATE_TRAN) && (ret != MMC_STATE_DATA));
 
 	if (!is_cmd23_enabled() && (size > MMC_BLOCK_SIZE)) {
 		ret = mmc_send_cmd(MMC_CMD(12), 0, MMC_RESPONSE_R1B, NULL);
 		if (ret != 0) {
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+/* Complete the read issued ahead of time and forget about its data */
+static void mmc_read_ahead_drain(void)
+{
+	int ret;
+
+	mmc_ra.next_lba = -1;
+
+	if (mmc_ra.size == 0U) {
+		return;
+	}
+
+	ret = mmc_read_end(mmc_ra.lba, mmc_ra.buf, mmc_ra.size);
+	if (ret != 0) {
+		VERBOSE("Read-ahead of block %d failed: %d\n", mmc_ra.lba, ret);
+	}
+
+	mmc_stats[mmc_cur_part].read_ahead_drops++;
+	mmc_ra.size = 0U;
+}
+
+/*
+ * Complete the read issued ahead of time at the requested block, and copy as
+ * much of the request as it covers. Return the number of bytes copied.
+ */
+static size_t mmc_read_ahead_take(uintptr_t buf, size_t size)
+{
+	size_t len = MIN(size, mmc_ra.size);
+	int ret;
+
+	ret = mmc_read_end(mmc_ra.lba, mmc_ra.buf, mmc_ra.size);
+	mmc_ra.size = 0U;
+	if (ret != 0) {
+		/* Let the caller read the blocks again */
+		return 0U;
+	}
+
+	(void)memcpy((void *)buf, (void *)mmc_ra.buf, len);
+	mmc_stats[mmc_cur_part].read_ahead_hits++;
+
+	return len;
+}
+
+static void mmc_read_ahead_issue(int lba, size_t size)
+{
+	unsigned long long limit;
+	size_t ra_size;
+	int ra_lba = lba + (int)(size / MMC_BLOCK_SIZE);
+	bool sequential = (lba == mmc_ra.next_lba);
+	int ret;
+
+	mmc_ra.next_lba = ra_lba;
+
+	/* Only read ahead once the accesses are known to be sequential */
+	if ((mmc_ra.buf == 0U) || !sequential) {
+		return;
+	}
+
+	switch (mmc_cur_part) {
+	case PART_CFG_BOOT_PARTITION_NO_ACCESS:
+		limit = mmc_dev_info->device_size;
+		break;
+	case 1U:
+	case 2U:
+		limit = mmc_boot_part_size();
+		break;
+	default:
+		return;
+	}
+
+	limit /= MMC_BLOCK_SIZE;
+	if ((mmc_ra.end_lba >= 0) &&
+	    ((unsigned long long)mmc_ra.end_lba < limit)) {
+		limit = (unsigned long long)mmc_ra.end_lba;
+	}
+
+	if ((unsigned long long)ra_lba >= limit) {
+		return;
+	}
+
+	ra_size = MIN(size, mmc_ra.buf_size);
+	ra_size = MIN(ra_size, (size_t)(limit - ra_lba) * MMC_BLOCK_SIZE);
+
+	ret = mmc_read_start(ra_lba, mmc_ra.buf, ra_size);
+	if (ret != 0) {
+		VERBOSE("Cannot read ahead block %d: %d\n", ra_lba, ret);
+		return;
+	}
+
+	mmc_ra.lba = ra_lba;
+	mmc_ra.size = ra_size;
+}
+
+size_t mmc_read_blocks(int lba, uintptr_t buf, size_t size)
+{
+	unsigned long long start = read_cntpct_el0();
+	struct mmc_part_stats *stats = &mmc_stats[mmc_cur_part];
+	size_t done = 0U;
+	int ret;
+
+	assert((ops != NULL) &&
+	       (ops->read != NULL) &&
+	       (size != 0U) &&
+	       ((size & MMC_BLOCK_MASK) == 0U));
+
+	if (mmc_ra.size != 0U) {
+		if (lba == mmc_ra.lba) {
+			done = mmc_read_ahead_take(buf, size);
+		} else {
+			mmc_read_ahead_drain();
+		}
+	}
+
+	if (done < size) {
+		int rem_lba = lba + (int)(done / MMC_BLOCK_SIZE);
+
+		ret = mmc_read_start(rem_lba, buf + done, size - done);
+		if (ret == 0) {
+			ret = mmc_read_end(rem_lba, buf + done, size - done);
+		}
+		if (ret != 0) {
+			mmc_ra.next_lba = -1;
 			return 0;
 		}
 	}
 
+	mmc_read_ahead_issue(lba, size);
+
+	stats->read_bytes += size;
+	stats->read_ticks += read_cntpct_el0() - start;
+
 	return size;
 }
 
 size_t mmc_write_blocks(int lba, const uintptr_t buf, size_t size)
 {
+	unsigned long long start = read_cntpct_el0();
+	struct mmc_part_stats *stats = &mmc_stats[mmc_cur_part];
 	int ret;
 	unsigned int cmd_idx, cmd_arg;
 
@@ -665,6 +935,8 @@ size_t mmc_write_blocks(int lba, const uintptr_t buf, size_t size)
 	       ((buf & MMC_BLOCK_MASK) == 0U) &&
 	       ((size & MMC_BLOCK_MASK) == 0U));
 
+	mmc_read_ahead_drain();
+
 	ret = ops->prepare(lba, buf, size);
 	if (ret != 0) {
 		return 0;
@@ -718,6 +990,9 @@ size_t mmc_write_blocks(int lba, const uintptr_t buf, size_t size)
 		}
 	}
 
+	stats->write_bytes += size;
+	stats->write_ticks += read_cntpct_el0() - start;
+
 	return size;
 }
 
@@ -728,6 +1003,8 @@ size_t mmc_erase_blocks(int lba, size_t size)
 	assert(ops != NULL);
 	assert((size != 0U) && ((size & MMC_BLOCK_MASK) == 0U));
 
+	mmc_read_ahead_drain();
+
 	ret = mmc_send_cmd(MMC_CMD(35), lba, MMC_RESPONSE_R1, NULL);
 	if (ret != 0) {
 		return 0;
@@ -757,11 +1034,19 @@ size_t mmc_erase_blocks(int lba, size_t size)
 static int mmc_part_switch(unsigned char part_type)
 {
 	unsigned char part_config = mmc_ext_csd[CMD_EXTCSD_PARTITION_CONFIG];
+	int ret;
+
+	mmc_read_ahead_drain();
 
 	part_config &= ~EXT_CSD_PART_CONFIG_ACC_MASK;
 	part_config |= part_type;
 
-	return mmc_send_part_switch_cmd(part_config);
+	ret = mmc_send_part_switch_cmd(part_config);
+	if (ret == 0) {
+		mmc_cur_part = part_type & EXT_CSD_PART_CONFIG_ACC_MASK;
+	}
+
+	return ret;
 }
 
 static unsigned char mmc_current_boot_part(void)
@@ -824,10 +1109,73 @@ size_t mmc_boot_part_read_blocks(int lba, uintptr_t buf, size_t size)
 	return size_read;
 }
 
+void mmc_read_ahead_init(uintptr_t buf, size_t size)
+{
+	assert((size & MMC_BLOCK_MASK) == 0U);
+
+	mmc_read_ahead_drain();
+
+	mmc_ra.buf = (size != 0U) ? buf : 0U;
+	mmc_ra.buf_size = size;
+}
+
+void mmc_read_ahead_limit(int lba_end)
+{
+	mmc_ra.end_lba = lba_end;
+}
+
+void mmc_read_ahead_flush(void)
+{
+	mmc_read_ahead_drain();
+	mmc_ra.end_lba = -1;
+}
+
+const struct mmc_part_stats *mmc_get_part_stats(unsigned int part)
+{
+	assert(part < MMC_PART_NUM);
+
+	return &mmc_stats[part];
+}
+
+void mmc_print_part_stats(void)
+{
+	static const char * const timing_name[] = {
+		"legacy", "high speed", "HS200", "HS400"
+	};
+	unsigned long long freq = read_cntfrq_el0();
+	unsigned int part;
+
+	INFO("MMC: enumerated in %llu us, %s timing\n",
+	     (mmc_enum_ticks * 1000000ULL) / freq, timing_name[mmc_timing]);
+
+	for (part = 0U; part < MMC_PART_NUM; part++) {
+		const struct mmc_part_stats *stats = &mmc_stats[part];
+		unsigned long long us;
+
+		if ((stats->read_bytes == 0U) && (stats->write_bytes == 0U)) {
+			continue;
+		}
+
+		us = (stats->read_ticks * 1000000ULL) / freq;
+		INFO("MMC part %u: read %llu KiB in %llu us, %u cmds, read-ahead %u hits/%u drops\n",
+		     part, stats->read_bytes / 1024U, us, stats->read_cmds,
+		     stats->read_ahead_hits, stats->read_ahead_drops);
+
+		if (stats->write_bytes != 0U) {
+			us = (stats->write_ticks * 1000000ULL) / freq;
+			INFO("MMC part %u: wrote %llu KiB in %llu us\n",
+			     part, stats->write_bytes / 1024U, us);
+		}
+	}
+}
+
 int mmc_init(const struct mmc_ops *ops_ptr, unsigned int clk,
 	     unsigned int width, unsigned int flags,
 	     struct mmc_device_info *device_info)
 {
+	unsigned long long start;
+	int ret;
+
 	assert((ops_ptr != NULL) &&
 	       (ops_ptr->init != NULL) &&
 	       (ops_ptr->send_cmd != NULL) &&
@@ -846,6 +1194,14 @@ int mmc_init(const struct mmc_ops *ops_ptr, unsigned int clk,
 	ops = ops_ptr;
 	mmc_flags = flags;
 	mmc_dev_info = device_info;
+	mmc_cur_part = PART_CFG_BOOT_PARTITION_NO_ACCESS;
+	mmc_ra.size = 0U;
+	mmc_ra.next_lba = -1;
+	mmc_timing = MMC_TIMING_LEGACY;
+
+	start = read_cntpct_el0();
+	ret = mmc_enumerate(clk, width);
+	mmc_enum_ticks = read_cntpct_el0() - start;
 
-	return mmc_enumerate(clk, width);
+	return ret;
 }
@@ -105,23 +105,41 @@ static int deploy_rotpk_hash_table(void *srk_buffer, uint16_t num_srk)
 		return 0;
 	}
 
+	/*
+	 * Hash the keys in parallel, waiting for the hashes in progress when
+	 * all the contexts are in use.
+	 */
 	for (i = 0; i < num_srk; i++) {
 		ret = hash_init(algo, &ctx);
 		if (ret != 0) {
-			return -1;
+			ret = hash_wait_all();
+			if (ret == 0) {
+				ret = hash_init(algo, &ctx);
+			}
 		}
 
 		/* Update hash with that of SRK table */
-		ret = hash_update(algo, ctx, srktbl[i].pkey, srktbl[i].key_len);
-		if (ret != 0) {
-			return -1;
+		if (ret == 0) {
+			ret = hash_update(algo, ctx, srktbl[i].pkey,
+					  srktbl[i].key_len);
 		}
 
 		/* Copy hash at destination buffer */
-		ret = hash_final(algo, ctx, rotpk_hash_table[i], digest_size);
+		if (ret == 0) {
+			ret = hash_final_async(algo, ctx, rotpk_hash_table[i],
+					       digest_size);
+		}
+
 		if (ret != 0) {
-			return -1;
+			break;
 		}
+	}
+
+	if ((hash_wait_all() != 0) || (ret != 0)) {
+		return -1;
+	}
+
+	for (i = 0; i < num_srk; i++) {
 		VERBOSE("Table key %d HASH\n", i);
 		for (j = 0; j < 8; j++) {
 			VERBOSE("%x\n", *((uint32_t *)rotpk_hash_table[i] + j));
@@ -135,7 +153,9 @@ static int deploy_rotpk_hash_table(void *srk_buffer, uint16_t num_srk)
 
 /*
  * Calculate hash of ESBC hdr and ESBC. This function calculates the
- * single hash of ESBC header and ESBC image
+ * single hash of ESBC header and ESBC image. The hash is computed by SEC
+ * in the background: it is waited for by the signature verification, along
+ * with the RSA operation.
  */
 int calc_img_hash(struct csf_hdr *hdr,
 		  void *img_addr, uint32_t img_size,
@@ -173,18 +193,13 @@ int calc_img_hash(struct csf_hdr *hdr,
 	}
 
 	/* Copy hash at destination buffer */
-	ret = hash_final(algo, ctx, img_hash, digest_size);
+	ret = hash_final_async(algo, ctx, img_hash, digest_size);
 	if (ret != 0) {
 		return -1;
 	}
 
 	*hash_len = digest_size;
 
-	VERBOSE("IMG encoded HASH\n");
-	for (int i = 0; i < 8; i++) {
-		VERBOSE("%x\n", *((uint32_t *)img_hash + i));
-	}
-
 	return 0;
 }
 
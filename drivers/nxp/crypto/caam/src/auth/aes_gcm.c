@@ -0,0 +1,226 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <arch_helpers.h>
+#include "caam.h"
+#include <common/debug.h>
+#include <drivers/auth/crypto_mod.h>
+#include <plat/common/platform.h>
+
+#include "aes_gcm.h"
+#include "hash.h"
+#include "jobdesc.h"
+#include "sec_hw_specific.h"
+
+#define AES_MAX_KEY_SIZE	32U
+
+/*
+ * The chunks are collected in an SG table, contiguous chunks sharing the same
+ * entry, and the image is decrypted in place by a single job when the tag is
+ * given. As for hashing, only one decryption can be active at a time.
+ */
+struct gcm_ctx {
+	struct sg_entry sg_tbl[MAX_SG];
+	uint8_t key[AES_MAX_KEY_SIZE];
+	uint8_t iv[CRYPTO_MAX_IV_SIZE];
+	uint8_t tag[CRYPTO_MAX_TAG_SIZE];
+	uintptr_t sg_end;	/* End of the data of the last entry */
+	uint32_t sg_num;
+	uint32_t len;
+	uint32_t key_len;
+	uint32_t iv_len;
+	bool active;
+};
+
+static struct gcm_ctx glbl_ctx __aligned(CACHE_WRITEBACK_GRANULE);
+
+static void gcm_clear(void)
+{
+	memset(&glbl_ctx, 0, sizeof(struct gcm_ctx));
+#if defined(SEC_MEM_NON_COHERENT) && defined(IMAGE_BL2)
+	flush_dcache_range((uintptr_t)&glbl_ctx, sizeof(struct gcm_ctx));
+#endif
+}
+
+static uintptr_t sg_entry_addr(struct sg_entry *sg)
+{
+	uintptr_t addr = sec_in32(&sg->addr_lo);
+
+#ifdef CONFIG_PHYS_64BIT
+	addr |= (uintptr_t)sec_in32(&sg->addr_hi) << 32;
+#endif
+	return addr;
+}
+
+static void gcm_done(uint32_t *desc, uint32_t status, void *arg,
+		     void *job_ring)
+{
+	VERBOSE("AES-GCM Desc SUCCESS with status %x\n", status);
+}
+
+static int caam_gcm_start(enum crypto_dec_algo dec_algo, const void *key,
+			  unsigned int key_len, unsigned int key_flags,
+			  const void *iv, unsigned int iv_len)
+{
+	struct gcm_ctx *ctx = &glbl_ctx;
+
+	/* Leave what the job cannot take to the software implementation */
+	if ((dec_algo != CRYPTO_GCM_DECRYPT) ||
+	    ((key_flags & ENC_KEY_IS_IDENTIFIER) != 0U) ||
+	    ((key_len != 16U) && (key_len != 24U) && (key_len != 32U)) ||
+	    (iv_len == 0U) || (iv_len > CRYPTO_MAX_IV_SIZE)) {
+		return CRYPTO_ERR_INIT;
+	}
+
+	if (ctx->active) {
+		ERROR("AES-GCM decryption already active\n");
+		return CRYPTO_ERR_DECRYPTION;
+	}
+
+	memset(ctx, 0, sizeof(struct gcm_ctx));
+	memcpy(ctx->key, key, key_len);
+	ctx->key_len = key_len;
+	memcpy(ctx->iv, iv, iv_len);
+	ctx->iv_len = iv_len;
+	ctx->active = true;
+
+	return CRYPTO_SUCCESS;
+}
+
+static int caam_gcm_update(void *data_ptr, size_t len)
+{
+	struct gcm_ctx *ctx = &glbl_ctx;
+	struct sg_entry *sg;
+	uint32_t sg_len;
+
+	if (!ctx->active) {
+		return CRYPTO_ERR_DECRYPTION;
+	}
+
+	if (len > (SG_ENTRY_LENGTH_MASK - ctx->len)) {
+		ERROR("Reached size limit for calling %s\n", __func__);
+		gcm_clear();
+		return CRYPTO_ERR_DECRYPTION;
+	}
+
+#if defined(SEC_MEM_NON_COHERENT) && defined(IMAGE_BL2)
+	flush_dcache_range((uintptr_t)data_ptr, len);
+#endif
+
+	if ((ctx->sg_num != 0U) && ((uintptr_t)data_ptr == ctx->sg_end)) {
+		/* Follows the previous chunk: extend its entry */
+		sg = &ctx->sg_tbl[ctx->sg_num - 1U];
+		sg_len = sec_in32(&sg->len_flag) + (uint32_t)len;
+		sec_out32(&sg->len_flag, sg_len & SG_ENTRY_LENGTH_MASK);
+	} else {
+		if (ctx->sg_num >= MAX_SG) {
+			ERROR("Reached limit for calling %s\n", __func__);
+			gcm_clear();
+			return CRYPTO_ERR_DECRYPTION;
+		}
+
+		sg = &ctx->sg_tbl[ctx->sg_num];
+#ifdef CONFIG_PHYS_64BIT
+		sec_out32(&sg->addr_hi, (uint32_t)((uintptr_t)data_ptr >> 32));
+#else
+		sec_out32(&sg->addr_hi, 0x0);
+#endif
+		sec_out32(&sg->addr_lo, (uintptr_t)data_ptr);
+		sec_out32(&sg->len_flag, (uint32_t)len & SG_ENTRY_LENGTH_MASK);
+		ctx->sg_num++;
+	}
+
+	ctx->sg_end = (uintptr_t)data_ptr + len;
+	ctx->len += (uint32_t)len;
+
+	return CRYPTO_SUCCESS;
+}
+
+static int caam_gcm_finish(const void *tag, unsigned int tag_len)
+{
+	struct gcm_ctx *ctx = &glbl_ctx;
+	struct job_descriptor jobdesc __aligned(CACHE_WRITEBACK_GRANULE);
+	struct sg_entry *last;
+	uint8_t *data;
+	bool sg;
+	int ret;
+
+	if (!ctx->active) {
+		return CRYPTO_ERR_DECRYPTION;
+	}
+
+	if ((tag_len == 0U) || (tag_len > CRYPTO_MAX_TAG_SIZE) ||
+	    (ctx->sg_num == 0U)) {
+		gcm_clear();
+		return CRYPTO_ERR_DECRYPTION;
+	}
+
+	memcpy(ctx->tag, tag, tag_len);
+
+	jobdesc.arg = NULL;
+	jobdesc.callback = gcm_done;
+
+	/* A single entry is given to the job directly */
+	sg = ctx->sg_num > 1U;
+	if (sg) {
+		last = &ctx->sg_tbl[ctx->sg_num - 1U];
+		sec_out32(&last->len_flag,
+			  sec_in32(&last->len_flag) | SG_ENTRY_FINAL_BIT);
+		data = (uint8_t *)ctx->sg_tbl;
+	} else {
+		data = (uint8_t *)sg_entry_addr(&ctx->sg_tbl[0]);
+	}
+
+	dsb();
+
+	cnstr_aes_gcm_dec_jobdesc(jobdesc.desc, ctx->key, ctx->key_len,
+				  ctx->iv, ctx->iv_len, data, ctx->len, sg,
+				  ctx->tag, tag_len);
+
+#if defined(SEC_MEM_NON_COHERENT) && defined(IMAGE_BL2)
+	flush_dcache_range((uintptr_t)ctx, sizeof(struct gcm_ctx));
+	dmbsy();
+#endif
+
+	ret = run_descriptor_jr(&jobdesc);
+
+#if defined(SEC_MEM_NON_COHERENT) && defined(IMAGE_BL2)
+	/* Drop the lines of the data fetched while the job was running */
+	for (last = ctx->sg_tbl; last < &ctx->sg_tbl[ctx->sg_num]; last++) {
+		inv_dcache_range(sg_entry_addr(last),
+				 sec_in32(&last->len_flag) &
+				 SG_ENTRY_LENGTH_MASK);
+	}
+	dmbsy();
+#endif
+
+	gcm_clear();
+
+	if (ret != 0) {
+		ERROR("AES-GCM decryption failed\n");
+		return CRYPTO_ERR_DECRYPTION;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+static void caam_gcm_abort(void)
+{
+	gcm_clear();
+}
+
+const crypto_dec_ops_t caam_gcm_dec_ops = {
+	.name = "NXP CAAM",
+	.start = caam_gcm_start,
+	.update = caam_gcm_update,
+	.finish = caam_gcm_finish,
+	.abort = caam_gcm_abort,
+};
@@ -21,11 +21,11 @@
 #include "jobdesc.h"
 #include "sec_hw_specific.h"
 
-/* Since no Allocator is available . Taking a global static ctx.
- * This would mean that only one active ctx can be there at a time.
+/* Since no Allocator is available . Taking a global static pool of ctx.
+ * This would mean that only HASH_MAX_CTX ctx can be active at a time.
  */
 
-static struct hash_ctx glbl_ctx;
+static struct hash_ctx glbl_ctx[HASH_MAX_CTX] __aligned(CACHE_WRITEBACK_GRANULE);
 
 static void hash_done(uint32_t *desc, uint32_t status, void *arg,
 		      void *job_ring)
@@ -41,15 +41,19 @@ static void hash_done(uint32_t *desc, uint32_t status, void *arg,
  ***************************************************************************/
 int hash_init(enum hash_algo algo, void **ctx)
 {
-	if (glbl_ctx.active == false) {
-		memset(&glbl_ctx, 0, sizeof(struct hash_ctx));
-		glbl_ctx.active = true;
-		glbl_ctx.algo = algo;
-		*ctx = &glbl_ctx;
-		return 0;
-	} else {
-		return -1;
+	unsigned int i;
+
+	for (i = 0U; i < HASH_MAX_CTX; i++) {
+		if (glbl_ctx[i].active == false) {
+			memset(&glbl_ctx[i], 0, sizeof(struct hash_ctx));
+			glbl_ctx[i].active = true;
+			glbl_ctx[i].algo = algo;
+			*ctx = &glbl_ctx[i];
+			return 0;
+		}
 	}
+
+	return -1;
 }
 
 /***************************************************************************
@@ -103,22 +107,22 @@ int hash_update(enum hash_algo algo, void *context, void *data_ptr,
 }
 
 /***************************************************************************
- * Function	: hash_final
+ * Function	: hash_final_async
  * Arguments	: ctx - SHA context
  * Return	: SUCCESS or FAILURE
- * Description	: This function sets the final bit and enqueues the descriptor
+ * Description	: This function sets the final bit and enqueues the descriptor,
+ *		  without waiting for the hash to be computed
  ***************************************************************************/
-int hash_final(enum hash_algo algo, void *context, void *hash_ptr,
-	       unsigned int hash_len)
+int hash_final_async(enum hash_algo algo, void *context, void *hash_ptr,
+		     unsigned int hash_len)
 {
 	int ret = 0;
 	struct hash_ctx *ctx = context;
+	struct job_descriptor *jobdesc = &ctx->jobdesc;
 	uint32_t final = 0U;
 
-	struct job_descriptor jobdesc __aligned(CACHE_WRITEBACK_GRANULE);
-
-	jobdesc.arg = NULL;
-	jobdesc.callback = hash_done;
+	jobdesc->arg = NULL;
+	jobdesc->callback = hash_done;
 
 	if (ctx->algo != algo) {
 		ERROR("ctx for algo not correct\n");
@@ -133,7 +137,7 @@ int hash_final(enum hash_algo algo, void *context, void *hash_ptr,
 	dsb();
 
 	/* create the hw_rng descriptor */
-	cnstr_hash_jobdesc(jobdesc.desc, (uint8_t *) ctx->sg_tbl,
+	cnstr_hash_jobdesc(jobdesc->desc, (uint8_t *) ctx->sg_tbl,
 			   ctx->len, hash_ptr);
 
 #if defined(SEC_MEM_NON_COHERENT) && defined(IMAGE_BL2)
@@ -144,12 +148,90 @@ int hash_final(enum hash_algo algo, void *context, void *hash_ptr,
 	dmbsy();
 #endif
 
-	/* Finally, generate the requested random data bytes */
-	ret = run_descriptor_jr(&jobdesc);
+	ctx->hash_ptr = hash_ptr;
+	ctx->hash_len = hash_len;
+
+	ret = caam_job_submit(&jobdesc, 1U);
+	if (ret != 0) {
+		ERROR("Error in running descriptor\n");
+		ctx->active = false;
+		return -1;
+	}
+
+	ctx->submitted = true;
+
+	return 0;
+}
+
+/***************************************************************************
+ * Function	: hash_wait
+ * Arguments	: ctx - SHA context
+ * Return	: SUCCESS or FAILURE
+ * Description	: This function waits for the hash enqueued by
+ *		  hash_final_async() and releases the context
+ ***************************************************************************/
+int hash_wait(void *context)
+{
+	int ret = 0;
+	struct hash_ctx *ctx = context;
+
+	if (ctx->submitted == false) {
+		ERROR("Hash not submitted\n");
+		return -EINVAL;
+	}
+
+	ret = caam_job_wait(&ctx->jobdesc);
 	if (ret != 0) {
 		ERROR("Error in running descriptor\n");
 		ret = -1;
 	}
+
+#if defined(SEC_MEM_NON_COHERENT) && defined(IMAGE_BL2)
+	/* Drop lines of the hash which may have been fetched in the meantime */
+	inv_dcache_range((uintptr_t)ctx->hash_ptr, ctx->hash_len);
+	dmbsy();
+#endif
+
+	ctx->submitted = false;
 	ctx->active = false;
 	return ret;
 }
+
+/***************************************************************************
+ * Function	: hash_wait_all
+ * Return	: SUCCESS, or FAILURE if any hash failed
+ * Description	: This function waits for all the hashes enqueued by
+ *		  hash_final_async() and not waited for yet
+ ***************************************************************************/
+int hash_wait_all(void)
+{
+	int ret = 0;
+	unsigned int i;
+
+	for (i = 0U; i < HASH_MAX_CTX; i++) {
+		if (glbl_ctx[i].submitted && (hash_wait(&glbl_ctx[i]) != 0)) {
+			ret = -1;
+		}
+	}
+
+	return ret;
+}
+
+/***************************************************************************
+ * Function	: hash_final
+ * Arguments	: ctx - SHA context
+ * Return	: SUCCESS or FAILURE
+ * Description	: This function sets the final bit and enqueues the descriptor
+ ***************************************************************************/
+int hash_final(enum hash_algo algo, void *context, void *hash_ptr,
+	       unsigned int hash_len)
+{
+	int ret;
+
+	ret = hash_final_async(algo, context, hash_ptr, hash_len);
+	if (ret != 0) {
+		return ret;
+	}
+
+	return hash_wait(context);
+}
@@ -12,6 +12,7 @@
 #include <common/debug.h>
 #include <drivers/auth/crypto_mod.h>
 
+#include "aes_gcm.h"
 #include "hash.h"
 #include "rsa.h"
 
@@ -120,4 +121,5 @@ static int verify_hash(void *data_ptr, unsigned int data_len,
 /*
  * Register crypto library descriptor
  */
-REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash, NULL, NULL, NULL);
+REGISTER_CRYPTO_LIB_DEC_OPS(LIB_NAME, init, verify_signature, verify_hash, NULL,
+			    NULL, NULL, &caam_gcm_dec_ops);
@@ -17,6 +17,7 @@
 #include <common/debug.h>
 #include <drivers/auth/crypto_mod.h>
 
+#include "hash.h"
 #include "jobdesc.h"
 #include "rsa.h"
 #include "sec_hw_specific.h"
@@ -34,31 +35,35 @@ static void rsa_done(uint32_t *desc, uint32_t status, void *arg,
 	INFO("RSA Desc SUCCESS with status %x\n", status);
 }
 
-static int rsa_public_verif_sec(uint8_t *sign, uint8_t *to,
-				uint8_t *rsa_pub_key, uint32_t klen)
+/*
+ * Submit the RSA public key operation on the signature. The result is
+ * written to "to" once the job, which must then be waited for, completes.
+ */
+static int rsa_public_verif_sec(struct job_descriptor *jobdesc,
+				struct rsa_context *ctx, uint8_t *sign,
+				uint8_t *to, uint8_t *rsa_pub_key,
+				uint32_t klen)
 {
 	int ret = 0;
-	struct rsa_context ctx __aligned(CACHE_WRITEBACK_GRANULE);
-	struct job_descriptor jobdesc __aligned(CACHE_WRITEBACK_GRANULE);
 
-	jobdesc.arg = NULL;
-	jobdesc.callback = rsa_done;
+	jobdesc->arg = NULL;
+	jobdesc->callback = rsa_done;
 
-	memset(&ctx, 0, sizeof(struct rsa_context));
+	memset(ctx, 0, sizeof(struct rsa_context));
 
-	ctx.pkin.a = sign;
-	ctx.pkin.a_siz = klen;
-	ctx.pkin.n = rsa_pub_key;
-	ctx.pkin.n_siz = klen;
-	ctx.pkin.e = rsa_pub_key + klen;
-	ctx.pkin.e_siz = klen;
+	ctx->pkin.a = sign;
+	ctx->pkin.a_siz = klen;
+	ctx->pkin.n = rsa_pub_key;
+	ctx->pkin.n_siz = klen;
+	ctx->pkin.e = rsa_pub_key + klen;
+	ctx->pkin.e_siz = klen;
 
-	cnstr_jobdesc_pkha_rsaexp(jobdesc.desc, &ctx.pkin, to, klen);
+	cnstr_jobdesc_pkha_rsaexp(jobdesc->desc, &ctx->pkin, to, klen);
 
 #if defined(SEC_MEM_NON_COHERENT) && defined(IMAGE_BL2)
 	flush_dcache_range((uintptr_t)sign, klen);
 	flush_dcache_range((uintptr_t)rsa_pub_key, 2 * klen);
-	flush_dcache_range((uintptr_t)&ctx.pkin, sizeof(ctx.pkin));
+	flush_dcache_range((uintptr_t)&ctx->pkin, sizeof(ctx->pkin));
 	inv_dcache_range((uintptr_t)to, klen);
 
 	dmbsy();
@@ -66,18 +71,12 @@ static int rsa_public_verif_sec(uint8_t *sign, uint8_t *to,
 	isb();
 #endif
 
-	/* Finally, generate the requested random data bytes */
-	ret = run_descriptor_jr(&jobdesc);
+	ret = caam_job_submit(&jobdesc, 1U);
 	if (ret != 0) {
 		ERROR("Error in running descriptor\n");
 		ret = -1;
 	}
-#if defined(SEC_MEM_NON_COHERENT) && defined(IMAGE_BL2)
-	inv_dcache_range((uintptr_t)to, klen);
-	dmbsy();
-	dsbsy();
-	isb();
-#endif
+
 	return ret;
 }
 
@@ -153,19 +152,47 @@ int rsa_verify_signature(void *hash_ptr, unsigned int hash_len,
 {
 	uint8_t img_encoded_hash_second[RSA_4K_KEY_SZ_BYTES];
 	uint8_t encoded_hash[RSA_4K_KEY_SZ_BYTES] __aligned(CACHE_WRITEBACK_GRANULE);
+	struct rsa_context ctx __aligned(CACHE_WRITEBACK_GRANULE);
+	struct job_descriptor jobdesc __aligned(CACHE_WRITEBACK_GRANULE);
 	int ret = 0;
 
-	ret = construct_img_encoded_hash_second(hash_ptr, hash_len,
-						img_encoded_hash_second,
-						pk_len);
+	/*
+	 * The RSA operation does not depend on the hash: start it first, so
+	 * that it runs along with the hash of the image, which may still be
+	 * computed by SEC (see calc_img_hash()).
+	 */
+	ret = rsa_public_verif_sec(&jobdesc, &ctx, sig_ptr, encoded_hash,
+				   pk_ptr, pk_len / 2);
 	if (ret != 0) {
-		ERROR("Encoded Hash Failure\n");
+		ERROR("RSA signature Failure\n");
 		return CRYPTO_ERR_SIGNATURE;
 	}
 
-	ret = rsa_public_verif_sec(sig_ptr, encoded_hash, pk_ptr, pk_len / 2);
-	if (ret != 0) {
+	ret = hash_wait_all();
+	if (ret == 0) {
+		ret = construct_img_encoded_hash_second(hash_ptr, hash_len,
+							img_encoded_hash_second,
+							pk_len);
+		if (ret != 0) {
+			ERROR("Encoded Hash Failure\n");
+		}
+	} else {
+		ERROR("Hash Failure\n");
+	}
+
+	if (caam_job_wait(&jobdesc) != 0) {
 		ERROR("RSA signature Failure\n");
+		ret = -1;
+	}
+
+#if defined(SEC_MEM_NON_COHERENT) && defined(IMAGE_BL2)
+	inv_dcache_range((uintptr_t)encoded_hash, pk_len / 2);
+	dmbsy();
+	dsbsy();
+	isb();
+#endif
+
+	if (ret != 0) {
 		return CRYPTO_ERR_SIGNATURE;
 	}
 
@@ -16,6 +16,8 @@
 #include "caam.h"
 #include <common/debug.h>
 #include "jobdesc.h"
+#include <lib/utils_def.h>
+#include "nxp_timer.h"
 #include "sec_hw_specific.h"
 
 static uintptr_t g_nxp_caam_addr;
@@ -230,53 +232,181 @@ int config_sec_block(void)
 	return ret;
 }
 
-/* This function is used for sumbitting job to the Job Ring
- * [param] [in] - jobdesc to be submitted
+/*
+ * Jobs in flight. While a job is in flight, its callback is caam_job_done(),
+ * which records its status in its slot, so that the jobs can complete in any
+ * order and be waited for one by one.
+ */
+struct caam_job_slot {
+	struct job_descriptor *jobdesc;
+	user_callback callback;
+	void *arg;
+	int status;
+};
+
+#define CAAM_JOB_PENDING	1
+
+static struct caam_job_slot job_slots[SEC_JOB_RING_SIZE];
+
+static void caam_job_done(uint32_t *desc, uint32_t status, void *arg,
+			  void *jr)
+{
+	struct caam_job_slot *slot = arg;
+	struct job_descriptor *jobdesc = slot->jobdesc;
+
+	jobdesc->callback = slot->callback;
+	jobdesc->arg = slot->arg;
+	slot->status = (status == 0U) ? 0 : -1;
+
+	if ((status == 0U) && (jobdesc->callback != NULL)) {
+		jobdesc->callback(desc, status, jobdesc->arg, jr);
+	}
+}
+
+static struct caam_job_slot *caam_job_slot_get(struct job_descriptor *jobdesc)
+{
+	unsigned int i;
+
+	for (i = 0U; i < ARRAY_SIZE(job_slots); i++) {
+		if (job_slots[i].jobdesc == jobdesc) {
+			return &job_slots[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* This function is used for submitting jobs to the Job Ring, without waiting
+ * for them to complete. The cache maintenance and the notification of the
+ * hardware are done once for all the jobs.
+ * [param] [in] - jobdescs to be submitted, and their number
  * Return - -1 in case of error and 0 in case of SUCCESS
  */
-int run_descriptor_jr(struct job_descriptor *jobdesc)
+int caam_job_submit(struct job_descriptor **jobdescs, unsigned int num)
 {
-	int i = 0, ret = 0;
-	uint32_t *desc_addr = jobdesc->desc;
-	uint32_t desc_len = desc_length(jobdesc->desc);
-	uint32_t desc_word;
-
-	for (i = 0; i < desc_len; i++) {
-		desc_word = desc_addr[i];
-		VERBOSE("%x\n", desc_word);
-		sec_out32((uint32_t *)&desc_addr[i], desc_word);
+	struct caam_job_slot *slot;
+	uint32_t *desc_addr;
+	uint32_t desc_len;
+	unsigned int i, j;
+	int ret;
+
+	for (i = 0U; i < num; i++) {
+		slot = caam_job_slot_get(NULL);
+		if (slot == NULL) {
+			ERROR("Too many jobs in flight\n");
+			ret = -1;
+			goto err;
+		}
+
+		slot->jobdesc = jobdescs[i];
+		slot->callback = jobdescs[i]->callback;
+		slot->arg = jobdescs[i]->arg;
+		slot->status = CAAM_JOB_PENDING;
+		jobdescs[i]->callback = caam_job_done;
+		jobdescs[i]->arg = slot;
+
+		desc_addr = jobdescs[i]->desc;
+		desc_len = desc_length(desc_addr);
+		for (j = 0U; j < desc_len; j++) {
+			VERBOSE("%x\n", desc_addr[j]);
+			sec_out32((uint32_t *)&desc_addr[j], desc_addr[j]);
+		}
 	}
 	dsb();
 
 #if defined(SEC_MEM_NON_COHERENT) && defined(IMAGE_BL2)
-	flush_dcache_range((uintptr_t)desc_addr, desc_len * 4);
+	for (i = 0U; i < num; i++) {
+		flush_dcache_range((uintptr_t)jobdescs[i]->desc,
+				   desc_length(jobdescs[i]->desc) * 4);
+	}
 	dmbsy();
 	dsbsy();
 	isb();
 #endif
 
-	ret = enq_jr_desc(job_ring, jobdesc);
+	ret = enq_jr_descs(job_ring, jobdescs, num);
 	if (ret == 0) {
-		VERBOSE("JR enqueue done...\n");
-	} else {
-		ERROR("Error in Enqueue\n");
-		return ret;
+		VERBOSE("JR enqueue of %u jobs done...\n", num);
+		return 0;
+	}
+
+	ERROR("Error in Enqueue\n");
+
+err:
+	/* Give the slots taken back */
+	while (i-- > 0U) {
+		slot = jobdescs[i]->arg;
+		jobdescs[i]->callback = slot->callback;
+		jobdescs[i]->arg = slot->arg;
+		slot->jobdesc = NULL;
+	}
+
+	return ret;
+}
+
+/* This function waits for a job submitted by caam_job_submit(). Other jobs
+ * completing in the meantime are recorded for their own wait.
+ * [param] [in] - jobdesc to wait for
+ * Return - -1 in case of error and 0 in case of SUCCESS
+ */
+int caam_job_wait(struct job_descriptor *jobdesc)
+{
+	struct caam_job_slot *slot = caam_job_slot_get(jobdesc);
+	uint64_t start_time;
+	int ret;
+
+	if (slot == NULL) {
+		ERROR("Job not submitted\n");
+		return -1;
 	}
 
 	VERBOSE("Dequeue in progress");
 
-	ret = dequeue_jr(job_ring, -1);
-	if (ret >= 0) {
-		VERBOSE("Dequeue of %x desc success\n", ret);
-		ret = 0;
-	} else {
-		ERROR("deq_ret %x\n", ret);
-		ret = -1;
+	start_time = get_timer_val(0);
+
+	while (slot->status == CAAM_JOB_PENDING) {
+		ret = dequeue_jr(job_ring, -1);
+		if (ret >= 0) {
+			VERBOSE("Dequeue of %x desc success\n", ret);
+		}
+
+		if ((slot->status == CAAM_JOB_PENDING) &&
+		    (get_timer_val(start_time) >= CAAM_TIMEOUT)) {
+			/*
+			 * The slot is kept, as the job may still complete
+			 * and write to it.
+			 */
+			ERROR("Timeout waiting for job\n");
+			return -1;
+		}
+	}
+
+	ret = slot->status;
+	slot->jobdesc = NULL;
+
+	if (ret != 0) {
+		ERROR("Job failed\n");
 	}
 
 	return ret;
 }
 
+/* This function is used for sumbitting job to the Job Ring
+ * [param] [in] - jobdesc to be submitted
+ * Return - -1 in case of error and 0 in case of SUCCESS
+ */
+int run_descriptor_jr(struct job_descriptor *jobdesc)
+{
+	int ret;
+
+	ret = caam_job_submit(&jobdesc, 1U);
+	if (ret != 0) {
+		return ret;
+	}
+
+	return caam_job_wait(jobdesc);
+}
+
 /* this function returns a random number using HW RNG Algo
  * In case of failure, random number returned is 0
  * prngWidth = 0 - 32 bit random number
@@ -239,3 +239,61 @@ void cnstr_hash_jobdesc(uint32_t *desc, uint8_t *msg, uint32_t msgsz,
 	}
 
 }
+
+/***************************************************************************
+ * Function	: cnstr_aes_gcm_dec_jobdesc
+ * Arguments	: desc - Pointer to Descriptor
+ *		  key, key_len - AES key
+ *		  iv, iv_len - Initialization vector
+ *		  data, len - Data, or SG table if sg is set
+ *		  sg - Whether data points to an SG table
+ *		  tag, tag_len - Expected tag
+ * Return	: Void
+ * Description	: Creates the descriptor for in-place AES-GCM decryption,
+ *		  without additional authenticated data. The job fails if
+ *		  the tag does not match.
+ ***************************************************************************/
+void cnstr_aes_gcm_dec_jobdesc(uint32_t *desc, uint8_t *key, uint32_t key_len,
+			       uint8_t *iv, uint32_t iv_len, uint8_t *data,
+			       uint32_t len, bool sg, uint8_t *tag,
+			       uint32_t tag_len)
+{
+	phys_addr_t *ptr_addr_key, *ptr_addr_iv, *ptr_addr_data, *ptr_addr_tag;
+	uint32_t sgf = sg ? U(0x01000000) : 0U;
+
+	ptr_addr_key = vtop((void *)key);
+	ptr_addr_iv = vtop((void *)iv);
+	ptr_addr_data = vtop((void *)data);
+	ptr_addr_tag = vtop((void *)tag);
+
+	desc_init(desc);
+	desc_add_word(desc, U(0xb0800000));
+
+	/* Class 1 key */
+	desc_add_word(desc, U(0x02000000) | key_len);
+	desc_add_ptr(desc, ptr_addr_key);
+
+	/* Operation Command
+	 * OP_TYPE_CLASS1_ALG | OP_ALG_ALGSEL_AES | OP_ALG_AAI_GCM |
+	 * OP_ALG_AS_INITFINAL | OP_ALG_DECRYPT | OP_ALG_ICV_ON
+	 */
+	desc_add_word(desc, U(0x8210090e));
+
+	/* FIFO Load IV, flush as there is no AAD */
+	desc_add_word(desc, U(0x22210000) | iv_len);
+	desc_add_ptr(desc, ptr_addr_iv);
+
+	/* FIFO Load message, last class 1 data */
+	desc_add_word(desc, U(0x22520000) | sgf);
+	desc_add_ptr(desc, ptr_addr_data);
+	desc_add_word(desc, len);
+
+	/* FIFO Store message, in place */
+	desc_add_word(desc, U(0x60700000) | sgf);
+	desc_add_ptr(desc, ptr_addr_data);
+	desc_add_word(desc, len);
+
+	/* FIFO Load ICV, checked by the operation */
+	desc_add_word(desc, U(0x223a0000) | tag_len);
+	desc_add_ptr(desc, ptr_addr_tag);
+}
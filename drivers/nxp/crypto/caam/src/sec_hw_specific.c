@@ -516,9 +516,6 @@ int hw_poll_job_ring(struct sec_job_ring_t *job_ring, int32_t limit)
 					      sec_error_code,
 					      &error_descs_no,
 					      &do_driver_shutdown);
-			hw_remove_entries(job_ring, 1);
-
-			return -1;
 		}
 		/* Signal that the job has been processed & the slot is free */
 		hw_remove_entries(job_ring, 1);
@@ -531,6 +528,7 @@ int hw_poll_job_ring(struct sec_job_ring_t *job_ring, int32_t limit)
 					(MAX_DESC_SIZE_WORDS * sizeof(uint32_t)
 					+  sizeof(void *)));
 
+		/* The callback also tells the owner of a failed job */
 		arg = (void *)*(arg_addr);
 		if (*fnptr != 0) {
 			VERBOSE("Callback Function called\n");
@@ -538,6 +536,10 @@ int hw_poll_job_ring(struct sec_job_ring_t *job_ring, int32_t limit)
 			(*usercall) ((uint32_t *) current_desc,
 				     sec_error_code, arg, job_ring);
 		}
+
+		if (sec_error_code != 0) {
+			return -1;
+		}
 	}
 
 	return notified_descs_no;
@@ -192,8 +192,15 @@ int dequeue_jr(void *job_ring_handle, int32_t limit)
 }
 
 int enq_jr_desc(void *job_ring_handle, struct job_descriptor *jobdescr)
+{
+	return enq_jr_descs(job_ring_handle, &jobdescr, 1U);
+}
+
+int enq_jr_descs(void *job_ring_handle, struct job_descriptor **jobdescr,
+		 uint32_t num)
 {
 	struct sec_job_ring_t *job_ring;
+	uint32_t in_flight, i;
 
 	job_ring = (struct sec_job_ring_t *)job_ring_handle;
 
@@ -209,33 +216,36 @@ int enq_jr_desc(void *job_ring_handle, struct job_descriptor *jobdescr)
 		return -1;
 	}
 
-	if (SEC_JOB_RING_IS_FULL(job_ring->pidx, job_ring->cidx,
-				 SEC_JOB_RING_SIZE, SEC_JOB_RING_SIZE)) {
+	/* One entry is always left empty, see SEC_JOB_RING_IS_FULL() */
+	in_flight = (job_ring->pidx - job_ring->cidx) & (SEC_JOB_RING_SIZE - 1);
+	if ((num == 0U) || (num > (SEC_JOB_RING_SIZE - 1U - in_flight))) {
 		ERROR("Job ring is full\n");
 		return -1;
 	}
 
-	/* Set ptr in input ring to current descriptor  */
-	sec_write_addr(&job_ring->input_ring[job_ring->pidx],
-		       (phys_addr_t) vtop(jobdescr->desc));
+	/* Set ptrs in input ring to the descriptors */
+	for (i = 0U; i < num; i++) {
+		sec_write_addr(&job_ring->input_ring[job_ring->pidx],
+			       (phys_addr_t) vtop(jobdescr[i]->desc));
+		job_ring->pidx = SEC_CIRCULAR_COUNTER(job_ring->pidx,
+						      SEC_JOB_RING_SIZE);
+	}
 
 	dsb();
 
 #if defined(SEC_MEM_NON_COHERENT) && defined(IMAGE_BL2)
-	flush_dcache_range((uintptr_t)(&job_ring->input_ring[job_ring->pidx]),
-			   sizeof(phys_addr_t));
+	/* The rings are a few cache lines: maintain them as a whole */
+	flush_dcache_range((uintptr_t)job_ring->input_ring,
+			   SEC_DMA_MEM_INPUT_RING_SIZE);
 
-	inv_dcache_range((uintptr_t)(&job_ring->output_ring[job_ring->cidx]),
-			   sizeof(struct sec_outring_entry));
+	inv_dcache_range((uintptr_t)job_ring->output_ring,
+			 SEC_DMA_MEM_OUTPUT_RING_SIZE);
 	dmbsy();
 #endif
-	/* Notify HW that a new job is enqueued  */
+	/* Notify HW that new jobs are enqueued  */
 	hw_enqueue_desc_on_job_ring(
-			(struct jobring_regs *)job_ring->register_base_addr, 1);
-
-	/* increment the producer index for the current job ring */
-	job_ring->pidx = SEC_CIRCULAR_COUNTER(job_ring->pidx,
-					      SEC_JOB_RING_SIZE);
+			(struct jobring_regs *)job_ring->register_base_addr,
+			num);
 
 	return 0;
 }
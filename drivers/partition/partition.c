@@ -6,6 +6,7 @@
 
 #include <assert.h>
 #include <inttypes.h>
+#include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -16,10 +17,36 @@
 #include <drivers/partition/partition.h>
 #include <drivers/partition/gpt.h>
 #include <drivers/partition/mbr.h>
+#if TRANSFER_LIST
+#include <lib/transfer_list.h>
+#endif
+#include <lib/utils.h>
 #include <plat/common/platform.h>
 
+/*
+ * Open-addressed hash index over the entry list, holding the entry index plus
+ * one (0 marks a free slot). Sized to keep the load factor at or below 1/2.
+ */
+#define PARTITION_INDEX_SIZE	256U
+#define PARTITION_INDEX_MASK	(PARTITION_INDEX_SIZE - 1U)
+
+CASSERT(PLAT_PARTITION_MAX_ENTRIES <= (PARTITION_INDEX_SIZE / 2U),
+	assert_partition_index_size);
+
+/*
+ * Largest GPT entry array that is read for its CRC. The UEFI spec reserves at
+ * least 16KiB for the array and allows more; the bound only keeps a corrupted
+ * header with a valid CRC from making BL2 read gigabytes. Only the first
+ * PLAT_PARTITION_MAX_ENTRIES entries of the array are kept.
+ */
+#define GPT_ENTRY_ARRAY_MAX_SIZE	(1U << 20)
+
 static uint8_t mbr_sector[PLAT_PARTITION_BLOCK_SIZE];
+static uint8_t gpt_entry_buf[PLAT_PARTITION_READ_SIZE]
+	__aligned(PLAT_PARTITION_BLOCK_SIZE);
 static partition_entry_list_t list;
+static uint8_t name_index[PARTITION_INDEX_SIZE];
+static uint8_t uuid_index[PARTITION_INDEX_SIZE];
 
 #if LOG_LEVEL >= LOG_LEVEL_VERBOSE
 static void dump_entries(int num)
@@ -91,12 +118,10 @@ static int load_mbr_header(uintptr_t image_handle, mbr_entry_t *mbr_entry)
 
 /*
  * Load GPT header and check the GPT signature and header CRC.
- * If partition numbers could be found, check & update it.
  */
 static int load_gpt_header(uintptr_t image_handle, size_t header_offset,
-			   unsigned long long *part_lba)
+			   gpt_header_t *header)
 {
-	gpt_header_t header;
 	size_t bytes_read;
 	int result;
 	uint32_t header_crc, calc_crc;
@@ -107,7 +132,7 @@ static int load_gpt_header(uintptr_t image_handle, size_t header_offset,
 			header_offset);
 		return result;
 	}
-	result = io_read(image_handle, (uintptr_t)&header,
+	result = io_read(image_handle, (uintptr_t)header,
 			 sizeof(gpt_header_t), &bytes_read);
 	if ((result != 0) || (sizeof(gpt_header_t) != bytes_read)) {
 		VERBOSE("GPT header read error(%i) or read mismatch occurred,"
@@ -115,8 +140,8 @@ static int load_gpt_header(uintptr_t image_handle, size_t header_offset,
 			sizeof(gpt_header_t), bytes_read);
 		return result;
 	}
-	if (memcmp(header.signature, GPT_SIGNATURE,
-			   sizeof(header.signature)) != 0) {
+	if (memcmp(header->signature, GPT_SIGNATURE,
+			   sizeof(header->signature)) != 0) {
 		VERBOSE("GPT header signature failure\n");
 		return -EINVAL;
 	}
@@ -126,25 +151,32 @@ static int load_gpt_header(uintptr_t image_handle, size_t header_offset,
 	 * computed by setting this field to 0, and computing the
 	 * 32-bit CRC for HeaderSize bytes.
 	 */
-	header_crc = header.header_crc;
-	header.header_crc = 0U;
+	header_crc = header->header_crc;
+	header->header_crc = 0U;
 
-	calc_crc = tf_crc32(0U, (uint8_t *)&header, sizeof(gpt_header_t));
+	calc_crc = tf_crc32(0U, (uint8_t *)header, sizeof(gpt_header_t));
 	if (header_crc != calc_crc) {
 		ERROR("Invalid GPT Header CRC: Expected 0x%x but got 0x%x.\n",
 		      header_crc, calc_crc);
 		return -EINVAL;
 	}
 
-	header.header_crc = header_crc;
+	header->header_crc = header_crc;
+
+	/* The entry array is parsed as a packed array of gpt_entry_t */
+	if (header->part_size != sizeof(gpt_entry_t)) {
+		VERBOSE("Unsupported GPT entry size (%u)\n", header->part_size);
+		return -EINVAL;
+	}
 
-	/* partition numbers can't exceed PLAT_PARTITION_MAX_ENTRIES */
-	list.entry_count = header.list_num;
-	if (list.entry_count > PLAT_PARTITION_MAX_ENTRIES) {
-		list.entry_count = PLAT_PARTITION_MAX_ENTRIES;
+	/* The whole array is read for its CRC, bound it before doing so */
+	if (header->list_num >
+	    (GPT_ENTRY_ARRAY_MAX_SIZE / sizeof(gpt_entry_t))) {
+		VERBOSE("GPT entry array too large (%u entries)\n",
+			header->list_num);
+		return -EINVAL;
 	}
 
-	*part_lba = header.part_lba;
 	return 0;
 }
 
@@ -207,36 +239,21 @@ static int load_mbr_entries(uintptr_t image_handle)
 }
 
 /*
- * Try to read and load a single GPT entry.
- */
-static int load_gpt_entry(uintptr_t image_handle, gpt_entry_t *entry)
-{
-	size_t bytes_read = 0U;
-	int result;
-
-	assert(entry != NULL);
-	result = io_read(image_handle, (uintptr_t)entry, sizeof(gpt_entry_t),
-			&bytes_read);
-	if ((result != 0) || (sizeof(gpt_entry_t) != bytes_read)) {
-		VERBOSE("GPT Entry read error(%i) or read mismatch occurred,"
-			"expected(%zu) and actual(%zu)\n", result,
-			sizeof(gpt_entry_t), bytes_read);
-		return -EINVAL;
-	}
-
-	return result;
-}
-
-/*
- * Retrieve each entry in the partition table, parse the data from each
- * entry and store them in the list of partition table entries.
+ * Read the whole partition entry array, in PLAT_PARTITION_READ_SIZE chunks,
+ * check it against the entry array CRC from the header, parse the data from
+ * each entry and store them in the list of partition table entries.
  */
 static int load_partition_gpt(uintptr_t image_handle,
+			      const gpt_header_t *header,
 			      unsigned long long part_lba)
 {
 	const signed long long gpt_entry_offset = LBA(part_lba);
-	gpt_entry_t entry;
-	int result, i;
+	const gpt_entry_t *entry = (const gpt_entry_t *)gpt_entry_buf;
+	size_t left = (size_t)header->list_num * sizeof(gpt_entry_t);
+	size_t chunk, bytes_read, i;
+	uint32_t calc_crc = 0U;
+	bool parsing = true;
+	int result, count = 0;
 
 	result = io_seek(image_handle, IO_SEEK_SET, gpt_entry_offset);
 	if (result != 0) {
@@ -245,28 +262,44 @@ static int load_partition_gpt(uintptr_t image_handle,
 		return result;
 	}
 
-	for (i = 0; i < list.entry_count; i++) {
-		result = load_gpt_entry(image_handle, &entry);
-		if (result != 0) {
-			VERBOSE("Failed to load gpt entry data(%i) error is (%i)\n",
-				i, result);
-			return result;
+	while (left != 0U) {
+		chunk = MIN(left, sizeof(gpt_entry_buf));
+		result = io_read(image_handle, (uintptr_t)gpt_entry_buf, chunk,
+				 &bytes_read);
+		if ((result != 0) || (bytes_read != chunk)) {
+			VERBOSE("GPT Entry read error(%i) or read mismatch "
+				"occurred, expected(%zu) and actual(%zu)\n",
+				result, chunk, bytes_read);
+			return -EINVAL;
 		}
-
-		result = parse_gpt_entry(&entry, &list.list[i]);
-		if (result != 0) {
-			break;
+		calc_crc = tf_crc32(calc_crc, gpt_entry_buf, chunk);
+		left -= chunk;
+
+		/*
+		 * Only the entries up to the first unused one are recorded,
+		 * the rest of the array is still read for the CRC.
+		 */
+		for (i = 0U; parsing && (i < (chunk / sizeof(gpt_entry_t))); i++) {
+			if ((count == PLAT_PARTITION_MAX_ENTRIES) ||
+			    (parse_gpt_entry((gpt_entry_t *)&entry[i],
+					     &list.list[count]) != 0)) {
+				parsing = false;
+			} else {
+				count++;
+			}
 		}
 	}
-	if (i == 0) {
+
+	if (calc_crc != header->part_crc) {
+		ERROR("Invalid GPT Entries CRC: Expected 0x%x but got 0x%x.\n",
+		      header->part_crc, calc_crc);
+		return -EINVAL;
+	}
+	if (count == 0) {
 		VERBOSE("No Valid GPT Entries found\n");
 		return -EINVAL;
 	}
-	/*
-	 * Only records the valid partition number that is loaded from
-	 * partition table.
-	 */
-	list.entry_count = i;
+	list.entry_count = count;
 	dump_entries(list.entry_count);
 
 	return 0;
@@ -274,16 +307,17 @@ static int load_partition_gpt(uintptr_t image_handle,
 
 /*
  * Try retrieving and parsing the backup-GPT header and backup GPT entries.
- * Last 33 blocks contains the backup-GPT entries and header.
+ * The last block contains the backup-GPT header, and the entries are in the
+ * blocks right before it.
  */
 static int load_backup_gpt(unsigned int image_id, unsigned int sector_nums)
 {
 	int result;
-	unsigned long long part_lba = 0;
-	size_t gpt_header_offset;
+	gpt_header_t header;
 	uintptr_t dev_handle, image_spec, image_handle;
 	io_block_spec_t *block_spec;
-	int part_num_entries;
+	size_t base_offset;
+	unsigned int entry_blocks;
 
 	result = plat_get_image_source(image_id, &dev_handle, &image_spec);
 	if (result != 0) {
@@ -293,19 +327,11 @@ static int load_backup_gpt(unsigned int image_id, unsigned int sector_nums)
 	}
 
 	block_spec = (io_block_spec_t *)image_spec;
-	/*
-	 * We need to read 32 blocks of GPT entries and one block of GPT header
-	 * try mapping only last 33 last blocks from the image to read the
-	 * Backup-GPT header and its entries.
-	 */
-	part_num_entries = (PLAT_PARTITION_MAX_ENTRIES / 4);
-	/* Move the offset base to LBA-33 */
-	block_spec->offset += LBA(sector_nums - part_num_entries);
-	/*
-	 * Set length as LBA-33, 32 blocks of backup-GPT entries and one
-	 * block of backup-GPT header.
-	 */
-	block_spec->length = LBA(part_num_entries + 1);
+	base_offset = block_spec->offset;
+
+	/* Map the last block alone to read the backup-GPT header */
+	block_spec->offset = base_offset + LBA(sector_nums);
+	block_spec->length = LBA(1);
 
 	result = io_open(dev_handle, image_spec, &image_handle);
 	if (result != 0) {
@@ -314,22 +340,37 @@ static int load_backup_gpt(unsigned int image_id, unsigned int sector_nums)
 	}
 
 	INFO("Trying to retrieve back-up GPT header\n");
-	/* Last block is backup-GPT header, after the end of GPT entries */
-	gpt_header_offset = LBA(part_num_entries);
-	result = load_gpt_header(image_handle, gpt_header_offset, &part_lba);
-	if ((result != 0) || (part_lba == 0)) {
+	result = load_gpt_header(image_handle, 0, &header);
+	io_close(image_handle);
+	if ((result != 0) || (header.part_lba == 0)) {
 		ERROR("Failed to retrieve Backup GPT header,"
 		      "Partition maybe corrupted\n");
-		goto out;
+		return (result != 0) ? result : -EINVAL;
 	}
 
 	/*
-	 * Note we mapped last 33 blocks(LBA-33), first block here starts with
-	 * entries while last block was header.
+	 * Then map the entries in front of the header, as many blocks as the
+	 * entry array the header describes, which load_gpt_header() bounded.
 	 */
-	result = load_partition_gpt(image_handle, 0);
+	entry_blocks = div_round_up((size_t)header.list_num *
+				    sizeof(gpt_entry_t),
+				    PLAT_PARTITION_BLOCK_SIZE);
+	if ((entry_blocks == 0U) || (entry_blocks >= sector_nums)) {
+		ERROR("Invalid Backup GPT entry array size\n");
+		return -EINVAL;
+	}
+
+	block_spec->offset = base_offset + LBA(sector_nums - entry_blocks);
+	block_spec->length = LBA(entry_blocks);
+
+	result = io_open(dev_handle, image_spec, &image_handle);
+	if (result != 0) {
+		VERBOSE("Failed to access image id (%i)\n", result);
+		return result;
+	}
+
+	result = load_partition_gpt(image_handle, &header, 0);
 
-out:
 	io_close(image_handle);
 	return result;
 }
@@ -342,19 +383,68 @@ out:
 static int load_primary_gpt(uintptr_t image_handle, unsigned int first_lba)
 {
 	int result;
-	unsigned long long part_lba;
+	gpt_header_t header;
 	size_t gpt_header_offset;
 
 	/* Try to load Primary GPT header from LBA1 */
 	gpt_header_offset = LBA(first_lba);
-	result = load_gpt_header(image_handle, gpt_header_offset, &part_lba);
-	if ((result != 0) || (part_lba == 0)) {
+	result = load_gpt_header(image_handle, gpt_header_offset, &header);
+	if ((result != 0) || (header.part_lba == 0)) {
 		VERBOSE("Failed to retrieve Primary GPT header,"
 			"trying to retrieve back-up GPT header\n");
 		return result;
 	}
 
-	return load_partition_gpt(image_handle, part_lba);
+	return load_partition_gpt(image_handle, &header, header.part_lba);
+}
+
+/*
+ * FNV-1a hash of a partition name or GUID.
+ */
+static uint32_t partition_hash(const void *data, size_t size)
+{
+	const uint8_t *p = data;
+	uint32_t hash = 2166136261U;
+	size_t i;
+
+	for (i = 0U; i < size; i++) {
+		hash ^= p[i];
+		hash *= 16777619U;
+	}
+
+	return hash & PARTITION_INDEX_MASK;
+}
+
+static void partition_index_add(uint8_t *index, uint32_t slot, int i)
+{
+	while (index[slot] != 0U) {
+		slot = (slot + 1U) & PARTITION_INDEX_MASK;
+	}
+	index[slot] = (uint8_t)(i + 1);
+}
+
+/*
+ * Index the entry list by name and by unique partition GUID. Entries are
+ * added in list order, so a probe meets the first of several duplicates
+ * first, as the linear search did.
+ */
+static void build_partition_index(void)
+{
+	int i;
+
+	zeromem(name_index, sizeof(name_index));
+	zeromem(uuid_index, sizeof(uuid_index));
+
+	for (i = 0; i < list.entry_count; i++) {
+		partition_index_add(name_index,
+			partition_hash(list.list[i].name,
+				       strnlen(list.list[i].name, EFI_NAMELEN)),
+			i);
+		partition_index_add(uuid_index,
+			partition_hash(&list.list[i].part_guid,
+				       sizeof(struct efi_guid)),
+			i);
+	}
 }
 
 /*
@@ -388,8 +478,10 @@ int load_partition_table(unsigned int image_id)
 		result = load_primary_gpt(image_handle, mbr_entry.first_lba);
 		if (result != 0) {
 			io_close(image_handle);
-			return load_backup_gpt(BKUP_GPT_IMAGE_ID,
-					       mbr_entry.sector_nums);
+			result = load_backup_gpt(BKUP_GPT_IMAGE_ID,
+						 mbr_entry.sector_nums);
+			build_partition_index();
+			return result;
 		}
 	} else {
 		result = load_mbr_entries(image_handle);
@@ -397,6 +489,7 @@ int load_partition_table(unsigned int image_id)
 
 out:
 	io_close(image_handle);
+	build_partition_index();
 	return result;
 }
 
@@ -405,12 +498,15 @@ out:
  */
 const partition_entry_t *get_partition_entry(const char *name)
 {
-	int i;
+	uint32_t slot = partition_hash(name, strnlen(name, EFI_NAMELEN));
+	const partition_entry_t *entry;
 
-	for (i = 0; i < list.entry_count; i++) {
-		if (strcmp(name, list.list[i].name) == 0) {
-			return &list.list[i];
+	while (name_index[slot] != 0U) {
+		entry = &list.list[name_index[slot] - 1U];
+		if (strcmp(name, entry->name) == 0) {
+			return entry;
 		}
+		slot = (slot + 1U) & PARTITION_INDEX_MASK;
 	}
 	return NULL;
 }
@@ -436,12 +532,15 @@ const partition_entry_t *get_partition_entry_by_type(const uuid_t *type_uuid)
  */
 const partition_entry_t *get_partition_entry_by_uuid(const uuid_t *part_uuid)
 {
-	int i;
+	uint32_t slot = partition_hash(part_uuid, sizeof(struct efi_guid));
+	const partition_entry_t *entry;
 
-	for (i = 0; i < list.entry_count; i++) {
-		if (guidcmp(part_uuid, &list.list[i].part_guid) == 0) {
-			return &list.list[i];
+	while (uuid_index[slot] != 0U) {
+		entry = &list.list[uuid_index[slot] - 1U];
+		if (guidcmp(part_uuid, &entry->part_guid) == 0) {
+			return entry;
 		}
+		slot = (slot + 1U) & PARTITION_INDEX_MASK;
 	}
 
 	return NULL;
@@ -476,3 +575,34 @@ int gpt_partition_init(void)
 {
 	return load_partition_table(GPT_IMAGE_ID);
 }
+
+#if TRANSFER_LIST
+/*
+ * Hand the parsed entry list to later stages as a TL_TAG_PARTITION_LIST
+ * entry, a partition_tl_header_t followed by the partition_entry_t array.
+ */
+int partition_list_to_tl(struct transfer_list_header *tl)
+{
+	struct transfer_list_entry *te;
+	partition_tl_header_t *header;
+	size_t entries_size = (size_t)list.entry_count *
+			      sizeof(partition_entry_t);
+
+	te = transfer_list_add(tl, TL_TAG_PARTITION_LIST,
+			       sizeof(*header) + entries_size, NULL);
+	if (te == NULL) {
+		ERROR("Failed to add partition list to transfer list\n");
+		return -ENOMEM;
+	}
+
+	header = transfer_list_entry_data(te);
+	header->version = PARTITION_TL_VERSION;
+	header->entry_size = sizeof(partition_entry_t);
+	header->entry_count = (uint32_t)list.entry_count;
+	header->reserved = 0U;
+	memcpy(header + 1, list.list, entries_size);
+	transfer_list_update_checksum(tl);
+
+	return 0;
+}
+#endif /* TRANSFER_LIST */
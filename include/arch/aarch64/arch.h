@@ -255,6 +255,10 @@
 /* ID_AA64ISAR0_EL1 definitions */
 #define ID_AA64ISAR0_RNDR_SHIFT	U(60)
 #define ID_AA64ISAR0_RNDR_MASK	ULL(0xf)
+#define ID_AA64ISAR0_SHA2_SHIFT	U(12)
+#define ID_AA64ISAR0_SHA2_MASK	ULL(0xf)
+#define ID_AA64ISAR0_AES_SHIFT	U(4)
+#define ID_AA64ISAR0_AES_MASK	ULL(0xf)
 
 /* ID_AA64ISAR1_EL1 definitions */
 #define ID_AA64ISAR1_EL1		S3_0_C0_C6_1
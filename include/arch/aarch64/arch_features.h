@@ -83,6 +83,18 @@ static inline bool is_armv8_4_ttst_present(void)
 		ID_AA64MMFR2_EL1_ST_MASK) == 1U;
 }
 
+static inline bool is_feat_aes_present(void)
+{
+	return ((read_id_aa64isar0_el1() >> ID_AA64ISAR0_AES_SHIFT) &
+		ID_AA64ISAR0_AES_MASK) != 0U;
+}
+
+static inline bool is_feat_sha256_present(void)
+{
+	return ((read_id_aa64isar0_el1() >> ID_AA64ISAR0_SHA2_SHIFT) &
+		ID_AA64ISAR0_SHA2_MASK) != 0U;
+}
+
 static inline bool is_armv8_5_bti_present(void)
 {
 	return ((read_id_aa64pfr1_el1() >> ID_AA64PFR1_EL1_BT_SHIFT) &
@@ -15,6 +15,11 @@
 #include <lib/psci/psci.h>
 #include <lib/spinlock.h>
 
+/* Collect per-protocol command latency counters */
+#ifndef SCMI_LATENCY_STATS
+#define SCMI_LATENCY_STATS			0
+#endif
+
 /* Supported SCMI Protocol Versions */
 #define SCMI_AP_CORE_PROTO_VER			MAKE_SCMI_VERSION(3, 0)
 #define SCMI_PWR_DMN_PROTO_VER			MAKE_SCMI_VERSION(3, 0)
@@ -147,6 +152,19 @@ typedef spinlock_t scmi_lock_t;
 typedef bakery_lock_t scmi_lock_t;
 #endif
 
+#if SCMI_LATENCY_STATS
+/* Number of protocols latency counters are kept for */
+#define SCMI_STATS_MAX_PROTO			8
+
+/* Command latency counters of one SCMI protocol, in counter ticks */
+struct scmi_proto_stats {
+	uint32_t proto_id;
+	uint32_t count;
+	uint64_t total;
+	uint64_t max;
+};
+#endif
+
 /*
  * Structure to represent an SCMI channel.
  */
@@ -156,6 +174,16 @@ typedef struct scmi_channel {
 	scmi_lock_t *lock;
 	/* Indicate whether the channel is initialized */
 	int is_initialized;
+	/* A posted command may still be in flight */
+	int posted;
+	/* SCMI status of the last posted command, until it is reported */
+	int posted_status;
+#if SCMI_LATENCY_STATS
+	/* Start time and protocol of the command in flight */
+	uint64_t cmd_start;
+	uint32_t cmd_proto;
+	struct scmi_proto_stats stats[SCMI_STATS_MAX_PROTO];
+#endif
 } scmi_channel_t;
 
 /* External Common API */
@@ -163,6 +191,11 @@ void *scmi_init(scmi_channel_t *ch);
 int scmi_proto_msg_attr(void *p, uint32_t proto_id, uint32_t command_id,
 						uint32_t *attr);
 int scmi_proto_version(void *p, uint32_t proto_id, uint32_t *version);
+int scmi_channel_poll(void *p);
+int scmi_channel_wait(void *p);
+#if SCMI_LATENCY_STATS
+void scmi_latency_stats_dump(void *p);
+#endif
 
 /*
  * Base protocol commands. Refer to the SCMI specification for more
@@ -39,6 +39,38 @@ enum crypto_md_algo {
 /* Maximum size as per the known stronger hash algorithm i.e.SHA512 */
 #define CRYPTO_MD_MAX_SIZE		64U
 
+/*
+ * Authenticated decryption done in place, chunk by chunk, so that an image can
+ * be decrypted while it is loaded. Only one decryption is in progress at a
+ * time. All functions return one of the 'enum crypto_ret_value' options.
+ */
+typedef struct crypto_dec_ops_s {
+	const char *name;
+
+	/*
+	 * Start a decryption. The key and IV are not used after the function
+	 * returns. CRYPTO_ERR_INIT means that the backend does not support
+	 * the algorithm or the key, and that another one may be tried.
+	 */
+	int (*start)(enum crypto_dec_algo dec_algo, const void *key,
+		     unsigned int key_len, unsigned int key_flags,
+		     const void *iv, unsigned int iv_len);
+
+	/*
+	 * Decrypt the next chunk. All chunks but the last one are a multiple
+	 * of 16 bytes. A backend working in the background may return before
+	 * the chunk is decrypted: the chunk must not be accessed until the
+	 * next update() or finish() has returned.
+	 */
+	int (*update)(void *data_ptr, size_t len);
+
+	/* Check the tag. The decryption is over, whatever the result. */
+	int (*finish)(const void *tag, unsigned int tag_len);
+
+	/* Stop a decryption without checking the tag */
+	void (*abort)(void);
+} crypto_dec_ops_t;
+
 /*
  * Cryptographic library descriptor
  */
@@ -79,6 +111,9 @@ typedef struct crypto_lib_desc_s {
 			    unsigned int key_flags, const void *iv,
 			    unsigned int iv_len, const void *tag,
 			    unsigned int tag_len);
+
+	/* Chunked authenticated decryption (optional) */
+	const crypto_dec_ops_t *dec_ops;
 } crypto_lib_desc_t;
 
 /* Public functions */
@@ -106,6 +141,13 @@ int crypto_mod_auth_decrypt(enum crypto_dec_algo dec_algo, void *data_ptr,
 			    unsigned int key_flags, const void *iv,
 			    unsigned int iv_len, const void *tag,
 			    unsigned int tag_len);
+int crypto_mod_auth_decrypt_start(enum crypto_dec_algo dec_algo,
+				  const void *key, unsigned int key_len,
+				  unsigned int key_flags, const void *iv,
+				  unsigned int iv_len);
+int crypto_mod_auth_decrypt_update(void *data_ptr, size_t len);
+int crypto_mod_auth_decrypt_finish(const void *tag, unsigned int tag_len);
+void crypto_mod_auth_decrypt_abort(void);
 
 #if (CRYPTO_SUPPORT == CRYPTO_HASH_CALC_ONLY) || \
     (CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC)
@@ -121,6 +163,14 @@ int crypto_mod_convert_pk(void *full_pk_ptr, unsigned int full_pk_len,
 /* Macro to register a cryptographic library */
 #define REGISTER_CRYPTO_LIB(_name, _init, _verify_signature, _verify_hash, \
 			    _calc_hash, _auth_decrypt, _convert_pk) \
+	REGISTER_CRYPTO_LIB_DEC_OPS(_name, _init, _verify_signature, \
+				    _verify_hash, _calc_hash, _auth_decrypt, \
+				    _convert_pk, NULL)
+
+/* Same, for a library that also supports chunked authenticated decryption */
+#define REGISTER_CRYPTO_LIB_DEC_OPS(_name, _init, _verify_signature, \
+				    _verify_hash, _calc_hash, _auth_decrypt, \
+				    _convert_pk, _dec_ops) \
 	const crypto_lib_desc_t crypto_lib_desc = { \
 		.name = _name, \
 		.init = _init, \
@@ -128,7 +178,8 @@ int crypto_mod_convert_pk(void *full_pk_ptr, unsigned int full_pk_len,
 		.verify_hash = _verify_hash, \
 		.calc_hash = _calc_hash, \
 		.auth_decrypt = _auth_decrypt, \
-		.convert_pk = _convert_pk \
+		.convert_pk = _convert_pk, \
+		.dec_ops = _dec_ops \
 	}
 
 extern const crypto_lib_desc_t crypto_lib_desc;
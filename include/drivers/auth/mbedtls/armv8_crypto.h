@@ -0,0 +1,37 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef ARMV8_CRYPTO_H
+#define ARMV8_CRYPTO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Compress whole 64-byte blocks into a SHA-256 state given in host order.
+ * Selects the ARMv8 Cryptographic Extension version when available.
+ */
+void armv8_crypto_sha256_blocks(uint32_t state[8], const uint8_t *data,
+				size_t blocks);
+
+/*
+ * Encrypt one block with the nr + 1 AES round keys at rk, stored in the byte
+ * order of FIPS-197 as done by mbed TLS.
+ */
+void armv8_crypto_aes_encrypt(const uint32_t *rk, unsigned int nr,
+			      const uint8_t in[16], uint8_t out[16]);
+
+/* Portable versions */
+void sha256_blocks_c(uint32_t state[8], const uint8_t *data, size_t blocks);
+void aes_encrypt_block_c(const uint32_t *rk, unsigned int nr,
+			 const uint8_t in[16], uint8_t out[16]);
+
+/* Cryptographic Extension versions, for AArch64 only */
+void sha256_blocks_ce(uint32_t state[8], const uint8_t *data, size_t blocks);
+void aes_encrypt_block_ce(const uint32_t *rk, unsigned int nr,
+			  const uint8_t in[16], uint8_t out[16]);
+
+#endif /* ARMV8_CRYPTO_H */
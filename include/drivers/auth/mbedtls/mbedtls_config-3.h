@@ -103,6 +103,17 @@
 #define MBEDTLS_GCM_C
 #endif
 
+/*
+ * SHA-256 compression and AES block encryption using the ARMv8 Cryptographic
+ * Extension when available, see drivers/auth/mbedtls/mbedtls_armv8_crypto.c
+ */
+#if TF_MBEDTLS_USE_ARMV8_CRYPTO
+#define MBEDTLS_SHA256_PROCESS_ALT
+#if TF_MBEDTLS_USE_AES_GCM
+#define MBEDTLS_AES_ENCRYPT_ALT
+#endif
+#endif
+
 /* MPI / BIGNUM options */
 #define MBEDTLS_MPI_WINDOW_SIZE			2
 
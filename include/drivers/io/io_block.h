@@ -13,12 +13,27 @@
 typedef struct io_block_ops {
 	size_t	(*read)(int lba, uintptr_t buf, size_t size);
 	size_t	(*write)(int lba, const uintptr_t buf, size_t size);
+	/*
+	 * Optional, for devices reading ahead: read_limit() gets the block
+	 * past the end of each read request before it is served, and flush()
+	 * is called when the file is closed.
+	 */
+	void	(*read_limit)(int lba_end);
+	void	(*flush)(void);
 } io_block_ops_t;
 
+/*
+ * Whole blocks are read straight into block-aligned caller buffers, in
+ * requests of up to the buffer length. The device must be able to reach the
+ * images' load addresses.
+ */
+#define IO_BLOCK_FLAG_DIRECT_READ	(1U << 0)
+
 typedef struct io_block_dev_spec {
 	io_block_spec_t	buffer;
 	io_block_ops_t	ops;
 	size_t		block_size;
+	unsigned int	flags;
 } io_block_dev_spec_t;
 
 struct io_dev_connector;
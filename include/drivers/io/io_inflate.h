@@ -0,0 +1,25 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef IO_INFLATE_H
+#define IO_INFLATE_H
+
+#include <drivers/io/io_storage.h>
+
+/*
+ * Buffers of the inflate device: the compressed data is read into 'chunk' one
+ * piece at a time, and 'work' holds the decompressor state and window.
+ */
+typedef struct io_inflate_dev_spec {
+	io_block_spec_t chunk;
+	io_block_spec_t work;
+} io_inflate_dev_spec_t;
+
+struct io_dev_connector;
+
+int register_io_dev_inflate(const struct io_dev_connector **dev_con);
+
+#endif /* IO_INFLATE_H */
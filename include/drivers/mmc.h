@@ -14,6 +14,8 @@
 #define MMC_BLOCK_SIZE			U(512)
 #define MMC_BLOCK_MASK			(MMC_BLOCK_SIZE - U(1))
 #define MMC_BOOT_CLK_RATE		(400 * 1000)
+#define MMC_HS_CLK_RATE			(52 * 1000 * 1000)
+#define MMC_HS200_CLK_RATE		(200 * 1000 * 1000)
 
 #define MMC_CMD(_x)			U(_x)
 
@@ -60,6 +62,7 @@
 #define CMD_EXTCSD_PARTITION_CONFIG	179
 #define CMD_EXTCSD_BUS_WIDTH		183
 #define CMD_EXTCSD_HS_TIMING		185
+#define CMD_EXTCSD_DEVICE_TYPE		196
 #define CMD_EXTCSD_PART_SWITCH_TIME	199
 #define CMD_EXTCSD_SEC_CNT		212
 #define CMD_EXTCSD_BOOT_SIZE_MULT	226
@@ -73,6 +76,9 @@
 #define PART_CFG_CURRENT_BOOT_PARTITION(x)	(((x) & PART_CFG_BOOT_PART_EN_MASK) >> \
 	PART_CFG_BOOT_PART_EN_SHIFT)
 
+#define EXT_CSD_DEVICE_TYPE_HS200	(BIT(4) | BIT(5))
+#define EXT_CSD_DEVICE_TYPE_HS400	(BIT(6) | BIT(7))
+
 /* Values in EXT CSD register */
 #define MMC_BUS_WIDTH_1			U(0)
 #define MMC_BUS_WIDTH_4			U(1)
@@ -82,6 +88,10 @@
 #define MMC_BOOT_MODE_BACKWARD		(U(0) << 3)
 #define MMC_BOOT_MODE_HS_TIMING		(U(1) << 3)
 #define MMC_BOOT_MODE_DDR		(U(2) << 3)
+#define MMC_TIMING_LEGACY		U(0)
+#define MMC_TIMING_HS			U(1)
+#define MMC_TIMING_HS200		U(2)
+#define MMC_TIMING_HS400		U(3)
 
 #define EXTCSD_SET_CMD			(U(0) << 24)
 #define EXTCSD_SET_BITS			(U(1) << 24)
@@ -113,6 +123,8 @@
 
 #define MMC_FLAG_CMD23			(U(1) << 0)
 #define MMC_FLAG_SD_CMD6		(U(1) << 1)
+#define MMC_FLAG_HS200			(U(1) << 2)
+#define MMC_FLAG_HS400			(U(1) << 3)
 
 #define CMD8_CHECK_PATTERN		U(0xAA)
 #define VHS_2_7_3_6_V			BIT(8)
@@ -138,6 +150,9 @@ struct mmc_ops {
 	int (*prepare)(int lba, uintptr_t buf, size_t size);
 	int (*read)(int lba, uintptr_t buf, size_t size);
 	int (*write)(int lba, const uintptr_t buf, size_t size);
+	/* Optional, both are needed for HS200 and HS400 */
+	int (*set_timing)(unsigned int timing);
+	int (*execute_tuning)(unsigned int cmd_idx);
 };
 
 struct mmc_csd_emmc {
@@ -258,6 +273,17 @@ struct mmc_device_info {
 	enum mmc_device_type	mmc_dev_type;	/* Type of MMC */
 };
 
+/* Transfer counters of an eMMC partition, indexed by its PARTITION_ACCESS */
+struct mmc_part_stats {
+	unsigned long long	read_bytes;	/* Bytes returned to callers */
+	unsigned long long	read_ticks;	/* Counter ticks spent reading */
+	unsigned long long	write_bytes;
+	unsigned long long	write_ticks;
+	unsigned int		read_cmds;	/* Read commands sent to the card */
+	unsigned int		read_ahead_hits;
+	unsigned int		read_ahead_drops;
+};
+
 size_t mmc_read_blocks(int lba, uintptr_t buf, size_t size);
 size_t mmc_write_blocks(int lba, const uintptr_t buf, size_t size);
 size_t mmc_erase_blocks(int lba, size_t size);
@@ -269,4 +295,24 @@ int mmc_init(const struct mmc_ops *ops_ptr, unsigned int clk,
 	     unsigned int width, unsigned int flags,
 	     struct mmc_device_info *device_info);
 
+/*
+ * Sequential reads are issued ahead of time in this buffer, which must meet
+ * the same DMA constraints as the buffers given to mmc_read_blocks(). It only
+ * pays off with controllers waiting for the data in their read() handler
+ * rather than in send_cmd(). A zero size disables read-ahead.
+ */
+void mmc_read_ahead_init(uintptr_t buf, size_t size);
+/*
+ * Don't read ahead at or past block lba_end until the next flush, e.g. past
+ * the end of the image being loaded. A negative lba_end removes the limit.
+ */
+void mmc_read_ahead_limit(int lba_end);
+/*
+ * Complete the read issued ahead of time, if any, and drop its data. Must be
+ * called before the read-ahead buffer is reused or the card handed over.
+ */
+void mmc_read_ahead_flush(void);
+const struct mmc_part_stats *mmc_get_part_stats(unsigned int part);
+void mmc_print_part_stats(void);
+
 #endif /* MMC_H */
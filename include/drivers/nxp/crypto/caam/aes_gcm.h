@@ -0,0 +1,16 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#ifndef __AES_GCM_H__
+#define __AES_GCM_H__
+
+#include <drivers/auth/crypto_mod.h>
+
+/* Chunked AES-GCM decryption by the SEC job ring */
+extern const crypto_dec_ops_t caam_gcm_dec_ops;
+
+#endif
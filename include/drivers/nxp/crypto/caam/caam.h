@@ -35,6 +35,13 @@ uintptr_t get_caam_addr(void);
 /* This function is used to submit jobs to JR */
 int run_descriptor_jr(struct job_descriptor *desc);
 
+/* These functions are used to have several jobs in flight: submitted
+ * together, then waited for one by one, in any order. A job and what it
+ * accesses must stay valid until it has been waited for.
+ */
+int caam_job_submit(struct job_descriptor **jobdescs, unsigned int num);
+int caam_job_wait(struct job_descriptor *jobdesc);
+
 /* This function is used to instatiate the HW RNG is already not instantiated */
 int hw_rng_instantiate(void);
 
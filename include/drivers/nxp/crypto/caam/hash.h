@@ -10,6 +10,8 @@
 
 #include <stdbool.h>
 
+#include "sec_jr_driver.h"
+
 /* List of hash algorithms */
 enum hash_algo {
 	SHA1 = 0,
@@ -67,19 +69,35 @@ struct sg_entry {
  */
 struct hash_ctx {
 	struct sg_entry sg_tbl[MAX_SG];
-	uint32_t hash_desc[64];
+	struct job_descriptor jobdesc;
 	uint8_t hash[SHA256_DIGEST_SIZE];
 	uint32_t sg_num;
 	uint32_t len;
 	uint8_t *data;
+	uint8_t *hash_ptr;
+	uint32_t hash_len;
 	enum hash_algo algo;
 	bool active;
+	bool submitted;
 };
 
+/* Number of hashes which can be in progress at the same time */
+#define HASH_MAX_CTX	4
+
 int hash_init(enum hash_algo algo, void **ctx);
 int hash_update(enum hash_algo algo, void *context, void *data_ptr,
 		unsigned int data_len);
 int hash_final(enum hash_algo algo, void *context, void *hash_ptr,
 	       unsigned int hash_len);
 
+/*
+ * hash_final() in two steps: the hash is computed by SEC while the caller
+ * goes on, until hash_wait() is called on the context. hash_wait_all() waits
+ * for all the hashes submitted and not waited for yet.
+ */
+int hash_final_async(enum hash_algo algo, void *context, void *hash_ptr,
+		     unsigned int hash_len);
+int hash_wait(void *context);
+int hash_wait_all(void);
+
 #endif
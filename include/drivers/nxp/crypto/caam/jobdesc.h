@@ -8,6 +8,8 @@
 #ifndef __JOBDESC_H
 #define __JOBDESC_H
 
+#include <stdbool.h>
+
 #include <rsa.h>
 
 #define DESC_LEN_MASK		0x7f
@@ -53,4 +55,9 @@ void cnstr_hash_jobdesc(uint32_t *desc, uint8_t *msg, uint32_t msgsz,
 void cnstr_jobdesc_pkha_rsaexp(uint32_t *desc,
 			       struct pk_in_params *pkin, uint8_t *out,
 			       uint32_t out_siz);
+
+void cnstr_aes_gcm_dec_jobdesc(uint32_t *desc, uint8_t *key, uint32_t key_len,
+			       uint8_t *iv, uint32_t iv_len, uint8_t *data,
+			       uint32_t len, bool sg, uint8_t *tag,
+			       uint32_t tag_len);
 #endif
@@ -148,12 +148,30 @@ int sec_release(void);
  */
 int enq_jr_desc(void *job_ring_handle, struct job_descriptor *jobdescr);
 
+/*
+ * @brief Submit several descriptors for SEC processing at once.
+ * Same as enq_jr_desc(), but the cache maintenance of the job ring is done
+ * once and SEC HW is notified of all the jobs with a single register write.
+ * Either all the descriptors are enqueued, or none is.
+ * @param [in]  job_ring_handle   The handle of the job ring on which
+ *                                descriptors are to be enqueued
+ * @param [in]  jobdescr          Array of num job descriptors
+ * @param [in]  num               Number of job descriptors
+ *
+ * @retval ::0                 is returned for successful execution
+ * @retval ::-1                is returned if there is some enqueue failure,
+ *                             including not enough free entries in the ring
+ */
+int enq_jr_descs(void *job_ring_handle, struct job_descriptor **jobdescr,
+		 uint32_t num);
+
 /*
  * @brief Polls for available descriptors processed by SEC on a specific
  * Job Ring
  * This function polls the SEC Job Rings and delivers processed descriptors
  * Each processed descriptor has a user_callback registered.
- * This user_callback is invoked for each processed descriptor.
+ * This user_callback is invoked for each processed descriptor, including
+ * the ones which completed with an error status.
  * The polling is stopped when "limit" descriptors are notified or when
  * there are no more descriptors to notify.
  * @note The dequeue_jr() API cannot be called from within a user_callback
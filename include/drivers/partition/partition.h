@@ -27,6 +27,18 @@ CASSERT((PLAT_PARTITION_BLOCK_SIZE == 512) ||
 	(PLAT_PARTITION_BLOCK_SIZE == 4096),
 	assert_plat_partition_block_size);
 
+/*
+ * Size of the buffer the GPT entry array is read through. Set it to the size
+ * of the whole array (PLAT_PARTITION_MAX_ENTRIES * 128) to fetch the table in
+ * a single transfer.
+ */
+#if !PLAT_PARTITION_READ_SIZE
+# define PLAT_PARTITION_READ_SIZE	(4 * PLAT_PARTITION_BLOCK_SIZE)
+#endif /* PLAT_PARTITION_READ_SIZE */
+
+CASSERT((PLAT_PARTITION_READ_SIZE % PLAT_PARTITION_BLOCK_SIZE) == 0,
+	assert_plat_partition_read_size);
+
 #define LEGACY_PARTITION_BLOCK_SIZE	512
 
 #define LBA(n) ((unsigned long long)(n) * PLAT_PARTITION_BLOCK_SIZE)
@@ -52,4 +64,23 @@ const partition_entry_list_t *get_partition_entry_list(void);
 void partition_init(unsigned int image_id);
 int gpt_partition_init(void);
 
+#if TRANSFER_LIST
+/*
+ * Payload of a TL_TAG_PARTITION_LIST transfer list entry: this header, then
+ * entry_count entries of entry_size bytes laid out as partition_entry_t.
+ */
+#define PARTITION_TL_VERSION	1U
+
+typedef struct partition_tl_header {
+	uint32_t	version;
+	uint32_t	entry_size;
+	uint32_t	entry_count;
+	uint32_t	reserved;
+} partition_tl_header_t;
+
+struct transfer_list_header;
+
+int partition_list_to_tl(struct transfer_list_header *tl);
+#endif /* TRANSFER_LIST */
+
 #endif /* PARTITION_H */
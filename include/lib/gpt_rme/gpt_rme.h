@@ -263,18 +263,26 @@ void gpt_disable(void);
  * transition request occurs it is routed to this function where the request is
  * validated then fulfilled if possible.
  *
- * TODO: implement support for transitioning multiple granules at once.
+ * A range of granules is transitioned as a single batch: the request fails
+ * unless every granule in it can be transitioned, and cache maintenance and
+ * TLB invalidation are done once for the whole range. A call transitions at
+ * most the granules covered by one L1 table, starting at base, and the caller
+ * calls again for the rest of the range.
  *
  * Parameters
  *   base: Base address of the region to transition, must be aligned to granule
  *         size.
- *   size: Size of region to transition, must be aligned to granule size.
+ *   size: Size of region to transition, must be aligned to granule size and
+ *         not zero.
  *   src_sec_state: Security state of the originating SMC invoking the API.
+ *   transitioned: Set to the size transitioned from base, 0 on failure.
  *
  * Return
  *    Negative Linux error code in the event of a failure, 0 for success.
  */
-int gpt_delegate_pas(uint64_t base, size_t size, unsigned int src_sec_state);
-int gpt_undelegate_pas(uint64_t base, size_t size, unsigned int src_sec_state);
+int gpt_delegate_pas(uint64_t base, size_t size, unsigned int src_sec_state,
+		     size_t *transitioned);
+int gpt_undelegate_pas(uint64_t base, size_t size, unsigned int src_sec_state,
+		       size_t *transitioned);
 
 #endif /* GPT_RME_H */
@@ -0,0 +1,16 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef UNLZ4_H
+#define UNLZ4_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+int unlz4(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
+	  size_t out_len, uintptr_t work_buf, size_t work_len);
+
+#endif /* UNLZ4_H */
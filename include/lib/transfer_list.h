@@ -26,6 +26,13 @@
 // Set to 1 for both AArch64 and AArch32 according to fw handoff spec v0.9
 #define REGISTER_CONVENTION_VERSION_MASK (1 << 24)
 
+#ifndef TRANSFER_LIST_INDEX
+#define TRANSFER_LIST_INDEX		0
+#endif
+
+// number of distinct tags held in the lookup index
+#define TRANSFER_LIST_INDEX_SIZE	U(16)
+
 #ifndef __ASSEMBLER__
 
 enum transfer_list_tag_id {
@@ -34,6 +41,12 @@ enum transfer_list_tag_id {
 	TL_TAG_HOB_BLOCK = 2,
 	TL_TAG_HOB_LIST = 3,
 	TL_TAG_ACPI_TABLE_AGGREGATE = 4,
+	/*
+	 * TF-A private tags, from the non-standard range 0xfff000-0xffffff of
+	 * the Firmware Handoff specification. Their layout is only known to
+	 * TF-A images.
+	 */
+	TL_TAG_PARTITION_LIST = 0xfff000,
 };
 
 enum transfer_list_ops {
@@ -64,8 +77,7 @@ struct transfer_list_header {
 };
 
 struct transfer_list_entry {
-	uint16_t	tag_id;
-	uint8_t		reserved0;	// place holder
+	uint32_t	tag_id : 24;	// 24-bit tag, as in the handoff spec
 	uint8_t		hdr_size;
 	uint32_t	data_size;
 	/*
@@ -95,20 +107,21 @@ bool transfer_list_set_data_size(struct transfer_list_header *tl,
 
 void *transfer_list_entry_data(struct transfer_list_entry *entry);
 bool transfer_list_rem(struct transfer_list_header *tl, struct transfer_list_entry *entry);
+bool transfer_list_compact(struct transfer_list_header *tl);
 
 struct transfer_list_entry *transfer_list_add(struct transfer_list_header *tl,
-					      uint16_t tag_id, uint32_t data_size,
+					      uint32_t tag_id, uint32_t data_size,
 					      const void *data);
 
 struct transfer_list_entry *transfer_list_add_with_align(struct transfer_list_header *tl,
-							 uint16_t tag_id, uint32_t data_size,
+							 uint32_t tag_id, uint32_t data_size,
 							 const void *data, uint8_t alignment);
 
 struct transfer_list_entry *transfer_list_next(struct transfer_list_header *tl,
 					       struct transfer_list_entry *last);
 
 struct transfer_list_entry *transfer_list_find(struct transfer_list_header *tl,
-					       uint16_t tag_id);
+					       uint32_t tag_id);
 
 #endif /*__ASSEMBLER__*/
 #endif /*__TRANSFER_LIST_H*/
@@ -7,10 +7,16 @@
 #ifndef TF_GUNZIP_H
 #define TF_GUNZIP_H
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
 int gunzip(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
 	   size_t out_len, uintptr_t work_buf, size_t work_len);
 
+int gunzip_stream_init(uintptr_t work_buf, size_t work_len);
+int gunzip_stream(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
+		  size_t out_len, bool *stream_end);
+void gunzip_stream_end(void);
+
 #endif /* TF_GUNZIP_H */
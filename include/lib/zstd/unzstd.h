@@ -0,0 +1,19 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef UNZSTD_H
+#define UNZSTD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Workspace needed by unzstd(), mostly for the literals of one block */
+#define UNZSTD_WORK_SIZE	(144U * 1024U)
+
+int unzstd(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
+	   size_t out_len, uintptr_t work_buf, size_t work_len);
+
+#endif /* UNZSTD_H */
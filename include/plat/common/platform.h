@@ -38,6 +38,7 @@ struct mmap_region;
 struct spm_mm_boot_info;
 struct sp_res_desc;
 struct rmm_manifest;
+struct crypto_dec_ops_s;
 enum fw_enc_status_t;
 
 /*******************************************************************************
@@ -378,6 +379,7 @@ int get_mbedtls_heap_helper(void **heap_addr, size_t *heap_size);
 int plat_get_enc_key_info(enum fw_enc_status_t fw_enc_status, uint8_t *key,
 			  size_t *key_len, unsigned int *flags,
 			  const uint8_t *img_id, size_t img_id_len);
+const struct crypto_dec_ops_s *plat_get_dec_ops(void);
 
 /*******************************************************************************
  * Secure Partitions functions
@@ -135,6 +135,23 @@
 /* ECC Curve types for attest key generation */
 #define ATTEST_KEY_CURVE_ECC_SECP384R1		0
 
+/*
+ * Delegate / undelegate a contiguous range of granules. A call transitions at
+ * most the granules covered by one L1 GPT table, starting at the base, as a
+ * whole or not at all. The RMM calls again for the rest of the range.
+ * The arguments to these SMCs are :
+ *    arg0 - Function ID.
+ *    arg1 - Base physical address of the range, aligned to the granule size.
+ *    arg2 - Size of the range (in bytes), a non-zero multiple of the granule
+ *           size.
+ * The return arguments are :
+ *    ret0 - Status / error.
+ *    ret1 - Size transitioned from the base (in bytes), 0 on error.
+ */
+					/* 0x1C0 - 0x1C1 */
+#define RMM_GTSI_DELEGATE_RANGE		SMC64_RMMD_EL3_FID(U(0x10))
+#define RMM_GTSI_UNDELEGATE_RANGE	SMC64_RMMD_EL3_FID(U(0x11))
+
 /*
  * RMM_BOOT_COMPLETE originates on RMM when the boot finishes (either cold
  * or warm boot). This is handled by the RMM-EL3 interface SMC handler.
@@ -156,7 +173,7 @@
  * Increase this when a bug is fixed, or a feature is added without
  * breaking compatibility.
  */
-#define RMM_EL3_IFC_VERSION_MINOR	(U(2))
+#define RMM_EL3_IFC_VERSION_MINOR	(U(3))
 
 #define RMM_EL3_INTERFACE_VERSION				\
 	(((RMM_EL3_IFC_VERSION_MAJOR << 16) & 0x7FFFF) |	\
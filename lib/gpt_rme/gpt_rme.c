@@ -14,6 +14,7 @@
 #include <arch_helpers.h>
 #include <common/debug.h>
 #include "gpt_rme_private.h"
+#include <lib/cassert.h>
 #include <lib/gpt_rme/gpt_rme.h>
 #include <lib/smccc.h>
 #include <lib/spinlock.h>
@@ -954,75 +955,166 @@ int gpt_runtime_init(void)
 }
 
 /*
- * The L1 descriptors are protected by a spinlock to ensure that multiple
- * CPUs do not attempt to change the descriptors at once. In the future it
- * would be better to have separate spinlocks for each L1 descriptor.
+ * The L1 descriptors are protected by spinlocks to ensure that multiple CPUs
+ * do not attempt to change the same descriptor at once. The L1 table of each
+ * L0 region is covered by one of GPT_L1_LOCK_COUNT locks, selected by the L0
+ * index, so that transitions in unrelated regions can run in parallel. Each
+ * lock is aligned to the GPT_L1_LOCK_ALIGN build option, which should be at
+ * least the cache writeback granule, to avoid false sharing between CPUs.
  */
-static spinlock_t gpt_lock;
+typedef struct gpt_l1_lock {
+	spinlock_t lock;
+} __aligned(GPT_L1_LOCK_ALIGN) gpt_l1_lock_t;
+
+static gpt_l1_lock_t gpt_l1_locks[GPT_L1_LOCK_COUNT];
 
 /*
- * A helper to write the value (target_pas << gpi_shift) to the index of
- * the gpt_l1_addr
+ * Helper to get the lock of the L1 table covering pa.
  */
-static inline void write_gpt(uint64_t *gpt_l1_desc, uint64_t *gpt_l1_addr,
-			     unsigned int gpi_shift, unsigned int idx,
-			     unsigned int target_pas)
+static spinlock_t *gpt_l1_lock_of(uint64_t pa)
 {
-	*gpt_l1_desc &= ~(GPT_L1_GRAN_DESC_GPI_MASK << gpi_shift);
-	*gpt_l1_desc |= ((uint64_t)target_pas << gpi_shift);
-	gpt_l1_addr[idx] = *gpt_l1_desc;
+	return &gpt_l1_locks[GPT_L0_IDX(pa) % GPT_L1_LOCK_COUNT].lock;
+}
+
+/*
+ * Helper to cap a transition of [base, base + size) to the granules covered
+ * by the L1 table of base, so that a call takes a single L1 lock and its time
+ * is bounded by the size of one table.
+ */
+static size_t gpt_cap_to_l1_tbl(uint64_t base, size_t size)
+{
+	uint64_t span = GPT_L0_REGION_SIZE - (base & (GPT_L0_REGION_SIZE - 1UL));
+
+	return (span < size) ? (size_t)span : size;
 }
 
 /*
- * Helper to retrieve the gpt_l1_* information from the base address
- * returned in gpi_info
+ * Helper to get the L1 descriptor holding the GPI of the granule at pa, along
+ * with the mask of the GPI fields in it for the granules in [pa, end). next is
+ * set to the address of the first granule after these.
+ *
+ * Returns NULL if pa is not covered by an L1 table.
  */
-static int get_gpi_params(uint64_t base, gpi_info_t *gpi_info)
+static uint64_t *gpt_get_l1_desc(uint64_t pa, uint64_t end, uint64_t *mask,
+				 uint64_t *next)
 {
 	uint64_t gpt_l0_desc, *gpt_l0_base;
+	uint64_t desc_end;
+	unsigned int first, last;
 
 	gpt_l0_base = (uint64_t *)gpt_config.plat_gpt_l0_base;
-	gpt_l0_desc = gpt_l0_base[GPT_L0_IDX(base)];
+	gpt_l0_desc = gpt_l0_base[GPT_L0_IDX(pa)];
 	if (GPT_L0_TYPE(gpt_l0_desc) != GPT_L0_TYPE_TBL_DESC) {
 		VERBOSE("[GPT] Granule is not covered by a table descriptor!\n");
-		VERBOSE("      Base=0x%" PRIx64 "\n", base);
-		return -EINVAL;
+		VERBOSE("      Base=0x%" PRIx64 "\n", pa);
+		return NULL;
 	}
 
-	/* Get the table index and GPI shift from PA. */
-	gpi_info->gpt_l1_addr = GPT_L0_TBLD_ADDR(gpt_l0_desc);
-	gpi_info->idx = GPT_L1_IDX(gpt_config.p, base);
-	gpi_info->gpi_shift = GPT_L1_GPI_IDX(gpt_config.p, base) << 2;
+	/* Each L1 descriptor holds the GPIs of 16 granules. */
+	desc_end = (pa | ((GPT_PGS_ACTUAL_SIZE(gpt_config.p) << 4) - 1UL)) + 1UL;
+	*next = (desc_end < end) ? desc_end : end;
+
+	first = GPT_L1_GPI_IDX(gpt_config.p, pa);
+	last = GPT_L1_GPI_IDX(gpt_config.p, *next - 1UL);
+	*mask = (~0UL >> ((15U - last) << 2)) & (~0UL << (first << 2));
 
-	gpi_info->gpt_l1_desc = (gpi_info->gpt_l1_addr)[gpi_info->idx];
-	gpi_info->gpi = (gpi_info->gpt_l1_desc >> gpi_info->gpi_shift) &
-		GPT_L1_GRAN_DESC_GPI_MASK;
+	return &GPT_L0_TBLD_ADDR(gpt_l0_desc)[GPT_L1_IDX(gpt_config.p, pa)];
+}
+
+/*
+ * Helper to check that all granules in [base, base + size) have the GPI gpi.
+ *
+ * Returns -EINVAL if part of the range is not covered by L1 tables, -EPERM if
+ * a granule has another GPI, in which case that GPI is returned in cur_gpi.
+ */
+static int gpt_check_range_gpi(uint64_t base, size_t size, unsigned int gpi,
+			       unsigned int *cur_gpi)
+{
+	uint64_t *desc, mask, next, diff;
+	uint64_t end = base + size;
+	unsigned int shift;
+
+	for (uint64_t pa = base; pa < end; pa = next) {
+		desc = gpt_get_l1_desc(pa, end, &mask, &next);
+		if (desc == NULL) {
+			return -EINVAL;
+		}
+
+		diff = (*desc ^ GPT_BUILD_L1_DESC(gpi)) & mask;
+		if (diff != 0UL) {
+			shift = (__builtin_ctzll(diff) >> 2) << 2;
+			*cur_gpi = (*desc >> shift) & GPT_L1_GRAN_DESC_GPI_MASK;
+			VERBOSE("[GPT] Granule 0x%" PRIx64 " has GPI 0x%x\n",
+				(pa & ~((GPT_PGS_ACTUAL_SIZE(gpt_config.p) << 4) - 1UL)) +
+				((uint64_t)(shift >> 2) << gpt_config.p), *cur_gpi);
+			return -EPERM;
+		}
+	}
+
+	*cur_gpi = gpi;
 	return 0;
 }
 
+/*
+ * Helper to set the GPI of all granules in [base, base + size) to gpi, writing
+ * each L1 descriptor once. The range must have been checked with
+ * gpt_check_range_gpi().
+ */
+static void gpt_write_range_gpi(uint64_t base, size_t size, unsigned int gpi)
+{
+	uint64_t *desc, mask, next;
+	uint64_t end = base + size;
+
+	for (uint64_t pa = base; pa < end; pa = next) {
+		desc = gpt_get_l1_desc(pa, end, &mask, &next);
+		assert(desc != NULL);
+		*desc = (*desc & ~mask) | (GPT_BUILD_L1_DESC(gpi) & mask);
+	}
+}
+
+/*
+ * Helper to invalidate the GPT TLB entries for [base, base + size). A range of
+ * granules is invalidated with a single TLBI PAALLOS instead of one TLBI
+ * RPALOS per granule.
+ */
+static void gpt_tlbi_range(uint64_t base, size_t size)
+{
+	if (size == GPT_PGS_ACTUAL_SIZE(gpt_config.p)) {
+		gpt_tlbi_by_pa_ll(base, size);
+	} else {
+		tlbipaallos();
+	}
+}
+
 /*
  * This function is the granule transition delegate service. When a granule
  * transition request occurs it is routed to this function to have the request,
  * if valid, fulfilled following A1.1.1 Delegate of RME supplement
  *
- * TODO: implement support for transitioning multiple granules at once.
+ * A range of granules is transitioned as one batch: all of them must be in the
+ * NS state, and the cache maintenance and TLB invalidation are done once for
+ * the whole range. At most the granules covered by the L1 table of base are
+ * transitioned per call.
  *
  * Parameters
  *   base		Base address of the region to transition, must be
  *			aligned to granule size.
  *   size		Size of region to transition, must be aligned to granule
- *			size.
+ *			size and not zero.
  *   src_sec_state	Security state of the caller.
+ *   transitioned	Set to the size transitioned from base, 0 on failure.
  *
  * Return
  *   Negative Linux error code in the event of a failure, 0 for success.
  */
-int gpt_delegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
+int gpt_delegate_pas(uint64_t base, size_t size, unsigned int src_sec_state,
+		     size_t *transitioned)
 {
-	gpi_info_t gpi_info;
 	uint64_t nse;
+	spinlock_t *lock;
 	int res;
 	unsigned int target_pas;
+	unsigned int cur_gpi;
 
 	/* Ensure that the tables have been set up before taking requests. */
 	assert(gpt_config.plat_gpt_l0_base != 0UL);
@@ -1034,8 +1126,12 @@ int gpt_delegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 	assert(src_sec_state == SMC_FROM_REALM ||
 	       src_sec_state == SMC_FROM_SECURE);
 
-	/* See if this is a single or a range of granule transition. */
-	if (size != GPT_PGS_ACTUAL_SIZE(gpt_config.p)) {
+	*transitioned = 0UL;
+
+	/* An empty request must not reach the cache and TLB maintenance. */
+	if (size == 0UL) {
+		VERBOSE("[GPT] Empty granule transition request!\n");
+		VERBOSE("      Base=0x%" PRIx64 "\n", base);
 		return -EINVAL;
 	}
 
@@ -1050,7 +1146,6 @@ int gpt_delegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 	/* Make sure base and size are valid. */
 	if (((base & (GPT_PGS_ACTUAL_SIZE(gpt_config.p) - 1)) != 0UL) ||
 	    ((size & (GPT_PGS_ACTUAL_SIZE(gpt_config.p) - 1)) != 0UL) ||
-	    (size == 0UL) ||
 	    ((base + size) >= GPT_PPS_ACTUAL_SIZE(gpt_config.t))) {
 		VERBOSE("[GPT] Invalid granule transition address range!\n");
 		VERBOSE("      Base=0x%" PRIx64 "\n", base);
@@ -1058,32 +1153,34 @@ int gpt_delegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 		return -EINVAL;
 	}
 
+	/* The caller asks again for the granules of the next L1 tables. */
+	size = gpt_cap_to_l1_tbl(base, size);
+
 	target_pas = GPT_GPI_REALM;
 	if (src_sec_state == SMC_FROM_SECURE) {
 		target_pas = GPT_GPI_SECURE;
 	}
 
 	/*
-	 * Access to L1 tables is controlled by a global lock to ensure
-	 * that no more than one CPU is allowed to make changes at any
-	 * given time.
+	 * Access to the L1 table covering the range is controlled by its lock
+	 * to ensure that no more than one CPU is allowed to make changes to a
+	 * descriptor at any given time.
 	 */
-	spin_lock(&gpt_lock);
-	res = get_gpi_params(base, &gpi_info);
+	lock = gpt_l1_lock_of(base);
+	spin_lock(lock);
+
+	/* Check that the current address range is in NS state */
+	res = gpt_check_range_gpi(base, size, GPT_GPI_NS, &cur_gpi);
 	if (res != 0) {
-		spin_unlock(&gpt_lock);
+		if (res == -EPERM) {
+			VERBOSE("[GPT] Only Granule in NS state can be delegated.\n");
+			VERBOSE("      Caller: %u, Current GPI: %u\n",
+				src_sec_state, cur_gpi);
+		}
+		spin_unlock(lock);
 		return res;
 	}
 
-	/* Check that the current address is in NS state */
-	if (gpi_info.gpi != GPT_GPI_NS) {
-		VERBOSE("[GPT] Only Granule in NS state can be delegated.\n");
-		VERBOSE("      Caller: %u, Current GPI: %u\n", src_sec_state,
-			gpi_info.gpi);
-		spin_unlock(&gpt_lock);
-		return -EPERM;
-	}
-
 	if (src_sec_state == SMC_FROM_SECURE) {
 		nse = (uint64_t)GPT_NSE_SECURE << GPT_NSE_SHIFT;
 	} else {
@@ -1095,30 +1192,28 @@ int gpt_delegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 	 * states, remove any data speculatively fetched into the target
 	 * physical address space. Issue DC CIPAPA over address range
 	 */
-	flush_dcache_to_popa_range(nse | base,
-				   GPT_PGS_ACTUAL_SIZE(gpt_config.p));
+	flush_dcache_to_popa_range(nse | base, size);
 
-	write_gpt(&gpi_info.gpt_l1_desc, gpi_info.gpt_l1_addr,
-		  gpi_info.gpi_shift, gpi_info.idx, target_pas);
+	gpt_write_range_gpi(base, size, target_pas);
 	dsboshst();
 
-	gpt_tlbi_by_pa_ll(base, GPT_PGS_ACTUAL_SIZE(gpt_config.p));
+	gpt_tlbi_range(base, size);
 	dsbosh();
 
 	nse = (uint64_t)GPT_NSE_NS << GPT_NSE_SHIFT;
 
-	flush_dcache_to_popa_range(nse | base,
-				   GPT_PGS_ACTUAL_SIZE(gpt_config.p));
+	flush_dcache_to_popa_range(nse | base, size);
 
-	/* Unlock access to the L1 tables. */
-	spin_unlock(&gpt_lock);
+	/* Unlock access to the L1 table. */
+	spin_unlock(lock);
+	*transitioned = size;
 
 	/*
 	 * The isb() will be done as part of context
 	 * synchronization when returning to lower EL
 	 */
-	VERBOSE("[GPT] Granule 0x%" PRIx64 ", GPI 0x%x->0x%x\n",
-		base, gpi_info.gpi, target_pas);
+	VERBOSE("[GPT] Granules 0x%" PRIx64 "+0x%lx, GPI 0x%x->0x%x\n",
+		base, size, GPT_GPI_NS, target_pas);
 
 	return 0;
 }
@@ -1128,23 +1223,30 @@ int gpt_delegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
  * transition request occurs it is routed to this function where the request is
  * validated then fulfilled if possible.
  *
- * TODO: implement support for transitioning multiple granules at once.
+ * A range of granules is transitioned as one batch: all of them must be in the
+ * caller's state, and the cache maintenance and TLB invalidation are done once
+ * for the whole range. At most the granules covered by the L1 table of base
+ * are transitioned per call.
  *
  * Parameters
  *   base		Base address of the region to transition, must be
  *			aligned to granule size.
  *   size		Size of region to transition, must be aligned to granule
- *			size.
+ *			size and not zero.
  *   src_sec_state	Security state of the caller.
+ *   transitioned	Set to the size transitioned from base, 0 on failure.
  *
  * Return
  *    Negative Linux error code in the event of a failure, 0 for success.
  */
-int gpt_undelegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
+int gpt_undelegate_pas(uint64_t base, size_t size, unsigned int src_sec_state,
+		       size_t *transitioned)
 {
-	gpi_info_t gpi_info;
 	uint64_t nse;
+	spinlock_t *lock;
 	int res;
+	unsigned int cur_pas;
+	unsigned int cur_gpi;
 
 	/* Ensure that the tables have been set up before taking requests. */
 	assert(gpt_config.plat_gpt_l0_base != 0UL);
@@ -1156,8 +1258,12 @@ int gpt_undelegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 	assert(src_sec_state == SMC_FROM_REALM ||
 	       src_sec_state == SMC_FROM_SECURE);
 
-	/* See if this is a single or a range of granule transition. */
-	if (size != GPT_PGS_ACTUAL_SIZE(gpt_config.p)) {
+	*transitioned = 0UL;
+
+	/* An empty request must not reach the cache and TLB maintenance. */
+	if (size == 0UL) {
+		VERBOSE("[GPT] Empty granule transition request!\n");
+		VERBOSE("      Base=0x%" PRIx64 "\n", base);
 		return -EINVAL;
 	}
 
@@ -1172,7 +1278,6 @@ int gpt_undelegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 	/* Make sure base and size are valid. */
 	if (((base & (GPT_PGS_ACTUAL_SIZE(gpt_config.p) - 1)) != 0UL) ||
 	    ((size & (GPT_PGS_ACTUAL_SIZE(gpt_config.p) - 1)) != 0UL) ||
-	    (size == 0UL) ||
 	    ((base + size) >= GPT_PPS_ACTUAL_SIZE(gpt_config.t))) {
 		VERBOSE("[GPT] Invalid granule transition address range!\n");
 		VERBOSE("      Base=0x%" PRIx64 "\n", base);
@@ -1180,42 +1285,44 @@ int gpt_undelegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 		return -EINVAL;
 	}
 
+	/* The caller asks again for the granules of the next L1 tables. */
+	size = gpt_cap_to_l1_tbl(base, size);
+
+	cur_pas = GPT_GPI_REALM;
+	if (src_sec_state == SMC_FROM_SECURE) {
+		cur_pas = GPT_GPI_SECURE;
+	}
+
 	/*
-	 * Access to L1 tables is controlled by a global lock to ensure
-	 * that no more than one CPU is allowed to make changes at any
-	 * given time.
+	 * Access to the L1 table covering the range is controlled by its lock
+	 * to ensure that no more than one CPU is allowed to make changes to a
+	 * descriptor at any given time.
 	 */
-	spin_lock(&gpt_lock);
+	lock = gpt_l1_lock_of(base);
+	spin_lock(lock);
 
-	res = get_gpi_params(base, &gpi_info);
+	/* Check that the current address range is in the delegated state */
+	res = gpt_check_range_gpi(base, size, cur_pas, &cur_gpi);
 	if (res != 0) {
-		spin_unlock(&gpt_lock);
+		if (res == -EPERM) {
+			VERBOSE("[GPT] Only Granule in REALM or SECURE state can be undelegated.\n");
+			VERBOSE("      Caller: %u, Current GPI: %u\n",
+				src_sec_state, cur_gpi);
+		}
+		spin_unlock(lock);
 		return res;
 	}
 
-	/* Check that the current address is in the delegated state */
-	if ((src_sec_state == SMC_FROM_REALM  &&
-	     gpi_info.gpi != GPT_GPI_REALM) ||
-	    (src_sec_state == SMC_FROM_SECURE &&
-	     gpi_info.gpi != GPT_GPI_SECURE)) {
-		VERBOSE("[GPT] Only Granule in REALM or SECURE state can be undelegated.\n");
-		VERBOSE("      Caller: %u, Current GPI: %u\n", src_sec_state,
-			gpi_info.gpi);
-		spin_unlock(&gpt_lock);
-		return -EPERM;
-	}
-
 
 	/* In order to maintain mutual distrust between Realm and Secure
 	 * states, remove access now, in order to guarantee that writes
 	 * to the currently-accessible physical address space will not
 	 * later become observable.
 	 */
-	write_gpt(&gpi_info.gpt_l1_desc, gpi_info.gpt_l1_addr,
-		  gpi_info.gpi_shift, gpi_info.idx, GPT_GPI_NO_ACCESS);
+	gpt_write_range_gpi(base, size, GPT_GPI_NO_ACCESS);
 	dsboshst();
 
-	gpt_tlbi_by_pa_ll(base, GPT_PGS_ACTUAL_SIZE(gpt_config.p));
+	gpt_tlbi_range(base, size);
 	dsbosh();
 
 	if (src_sec_state == SMC_FROM_SECURE) {
@@ -1225,8 +1332,7 @@ int gpt_undelegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 	}
 
 	/* Ensure that the scrubbed data has made it past the PoPA */
-	flush_dcache_to_popa_range(nse | base,
-				   GPT_PGS_ACTUAL_SIZE(gpt_config.p));
+	flush_dcache_to_popa_range(nse | base, size);
 
 	/*
 	 * Remove any data loaded speculatively
@@ -1234,27 +1340,26 @@ int gpt_undelegate_pas(uint64_t base, size_t size, unsigned int src_sec_state)
 	 */
 	nse = (uint64_t)GPT_NSE_NS << GPT_NSE_SHIFT;
 
-	flush_dcache_to_popa_range(nse | base,
-				   GPT_PGS_ACTUAL_SIZE(gpt_config.p));
+	flush_dcache_to_popa_range(nse | base, size);
 
-	/* Clear existing GPI encoding and transition granule. */
-	write_gpt(&gpi_info.gpt_l1_desc, gpi_info.gpt_l1_addr,
-		  gpi_info.gpi_shift, gpi_info.idx, GPT_GPI_NS);
+	/* Clear existing GPI encoding and transition granules. */
+	gpt_write_range_gpi(base, size, GPT_GPI_NS);
 	dsboshst();
 
 	/* Ensure that all agents observe the new NS configuration */
-	gpt_tlbi_by_pa_ll(base, GPT_PGS_ACTUAL_SIZE(gpt_config.p));
+	gpt_tlbi_range(base, size);
 	dsbosh();
 
-	/* Unlock access to the L1 tables. */
-	spin_unlock(&gpt_lock);
+	/* Unlock access to the L1 table. */
+	spin_unlock(lock);
+	*transitioned = size;
 
 	/*
 	 * The isb() will be done as part of context
 	 * synchronization when returning to lower EL
 	 */
-	VERBOSE("[GPT] Granule 0x%" PRIx64 ", GPI 0x%x->0x%x\n",
-		base, gpi_info.gpi, GPT_GPI_NS);
+	VERBOSE("[GPT] Granules 0x%" PRIx64 "+0x%lx, GPI 0x%x->0x%x\n",
+		base, size, cur_pas, GPT_GPI_NS);
 
 	return 0;
 }
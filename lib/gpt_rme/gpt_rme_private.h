@@ -32,6 +32,9 @@
 /* GPT level 1 descriptor bit definitions */
 #define GPT_L1_GRAN_DESC_GPI_MASK	UL(0xF)
 
+/* Number of locks protecting the L1 tables, selected by L0 index. */
+#define GPT_L1_LOCK_COUNT		U(32)
+
 /*
  * This macro fills out every GPI entry in a granules descriptor to the same
  * value.
@@ -106,17 +109,6 @@ typedef enum {
 	PGS_64KB_P =	16U
 } gpt_p_val_e;
 
-/*
- * Internal structure to retrieve the values from get_gpi_info();
- */
-typedef struct gpi_info {
-	uint64_t gpt_l1_desc;
-	uint64_t *gpt_l1_addr;
-	unsigned int idx;
-	unsigned int gpi_shift;
-	unsigned int gpi;
-} gpi_info_t;
-
 /* Max valid value for PGS. */
 #define GPT_PGS_MAX			(2U)
 
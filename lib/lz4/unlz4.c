@@ -0,0 +1,417 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * LZ4 decoder for image_decompress(), supporting the LZ4 frame format and the
+ * legacy format used for Linux kernel images ("lz4 -l"). The output buffer
+ * holds the whole image, so matches are copied straight from the output and
+ * no history window or workspace is needed.
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <common/debug.h>
+#include <unlz4.h>
+
+#define LZ4_FRAME_MAGIC		0x184D2204U
+#define LZ4_LEGACY_MAGIC	0x184C2102U
+#define LZ4_SKIP_MAGIC		0x184D2A50U
+#define LZ4_SKIP_MAGIC_MASK	0xFFFFFFF0U
+
+/* Frame descriptor */
+#define LZ4_FLG_VERSION_MASK	0xC0U
+#define LZ4_FLG_VERSION		0x40U
+#define LZ4_FLG_BLOCK_CSUM	(1U << 4)
+#define LZ4_FLG_CONTENT_SIZE	(1U << 3)
+#define LZ4_FLG_CONTENT_CSUM	(1U << 2)
+#define LZ4_FLG_RESERVED	(1U << 1)
+#define LZ4_FLG_DICT_ID		(1U << 0)
+#define LZ4_BD_MAX_SIZE_SHIFT	4
+#define LZ4_BD_MAX_SIZE_MASK	0x7U
+
+#define LZ4_BLOCK_UNCOMPRESSED	(1U << 31)
+#define LZ4_LEGACY_BLOCK_MAX	(8U << 20)
+
+#define LZ4_MIN_MATCH		4U
+#define LZ4_RUN_MASK		15U
+
+#define XXH32_P1		2654435761U
+#define XXH32_P2		2246822519U
+#define XXH32_P3		3266489917U
+#define XXH32_P4		668265263U
+#define XXH32_P5		374761393U
+
+static inline uint32_t read_le32(const uint8_t *p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+	       ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint32_t rotl32(uint32_t x, unsigned int r)
+{
+	return (x << r) | (x >> (32U - r));
+}
+
+static inline uint32_t xxh32_round(uint32_t acc, uint32_t in)
+{
+	return rotl32(acc + (in * XXH32_P2), 13U) * XXH32_P1;
+}
+
+/* XXH32 with a zero seed, used by the frame checksums */
+static uint32_t xxh32(const uint8_t *p, size_t len)
+{
+	const uint8_t *end = p + len;
+	uint32_t h, v1, v2, v3, v4;
+
+	if (len >= 16U) {
+		v1 = XXH32_P1 + XXH32_P2;
+		v2 = XXH32_P2;
+		v3 = 0U;
+		v4 = 0U - XXH32_P1;
+		do {
+			v1 = xxh32_round(v1, read_le32(p));
+			v2 = xxh32_round(v2, read_le32(p + 4));
+			v3 = xxh32_round(v3, read_le32(p + 8));
+			v4 = xxh32_round(v4, read_le32(p + 12));
+			p += 16;
+		} while ((size_t)(end - p) >= 16U);
+		h = rotl32(v1, 1U) + rotl32(v2, 7U) + rotl32(v3, 12U) +
+		    rotl32(v4, 18U);
+	} else {
+		h = XXH32_P5;
+	}
+
+	h += (uint32_t)len;
+
+	while ((size_t)(end - p) >= 4U) {
+		h = rotl32(h + (read_le32(p) * XXH32_P3), 17U) * XXH32_P4;
+		p += 4;
+	}
+
+	while (p < end) {
+		h = rotl32(h + (*p * XXH32_P5), 11U) * XXH32_P1;
+		p++;
+	}
+
+	h ^= h >> 15;
+	h *= XXH32_P2;
+	h ^= h >> 13;
+	h *= XXH32_P3;
+	h ^= h >> 16;
+
+	return h;
+}
+
+/* Read a length continued by 255-valued bytes */
+static int read_length(const uint8_t **ip, const uint8_t *iend, size_t *len)
+{
+	uint8_t b;
+
+	do {
+		if (*ip >= iend) {
+			return -EIO;
+		}
+		b = *(*ip)++;
+		*len += b;
+	} while (b == 255U);
+
+	return 0;
+}
+
+/*
+ * Decode one compressed block into [*op, oend). Matches may refer back to any
+ * data already output since out_start.
+ */
+static int lz4_decode_block(const uint8_t *ip, size_t in_len, uint8_t **op,
+			    uint8_t *oend, const uint8_t *out_start)
+{
+	const uint8_t *iend = ip + in_len;
+	const uint8_t *match;
+	uint8_t *out = *op;
+	size_t lit_len, match_len, offset;
+	uint8_t token;
+
+	while (ip < iend) {
+		token = *ip++;
+
+		lit_len = token >> 4;
+		if ((lit_len == LZ4_RUN_MASK) &&
+		    (read_length(&ip, iend, &lit_len) != 0)) {
+			return -EIO;
+		}
+		if ((lit_len > (size_t)(iend - ip)) ||
+		    (lit_len > (size_t)(oend - out))) {
+			return -EIO;
+		}
+		memcpy(out, ip, lit_len);
+		ip += lit_len;
+		out += lit_len;
+
+		/* The last sequence of a block only has literals */
+		if (ip == iend) {
+			break;
+		}
+
+		if ((size_t)(iend - ip) < 2U) {
+			return -EIO;
+		}
+		offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+		ip += 2;
+		if ((offset == 0U) || (offset > (size_t)(out - out_start))) {
+			return -EIO;
+		}
+
+		match_len = token & LZ4_RUN_MASK;
+		if ((match_len == LZ4_RUN_MASK) &&
+		    (read_length(&ip, iend, &match_len) != 0)) {
+			return -EIO;
+		}
+		match_len += LZ4_MIN_MATCH;
+		if (match_len > (size_t)(oend - out)) {
+			return -EIO;
+		}
+
+		match = out - offset;
+		if (offset >= match_len) {
+			memcpy(out, match, match_len);
+			out += match_len;
+		} else {
+			/* Overlapping match: repeats the last offset bytes */
+			while (match_len-- != 0U) {
+				*out++ = *match++;
+			}
+		}
+	}
+
+	*op = out;
+
+	return 0;
+}
+
+/* Decode an LZ4 frame, whose magic has been consumed */
+static int lz4_decode_frame(const uint8_t **ipp, const uint8_t *iend,
+			    uint8_t **op, uint8_t *oend)
+{
+	const uint8_t *ip = *ipp;
+	const uint8_t *desc = ip;
+	uint8_t *frame_start = *op;
+	uint8_t flg, bd;
+	uint32_t block_size, block_max, csum;
+	size_t desc_len, len;
+	int ret;
+
+	if ((iend - ip) < 3) {
+		return -EIO;
+	}
+
+	flg = ip[0];
+	bd = ip[1];
+	if (((flg & LZ4_FLG_VERSION_MASK) != LZ4_FLG_VERSION) ||
+	    ((flg & LZ4_FLG_RESERVED) != 0U) || ((bd & 0x8FU) != 0U)) {
+		ERROR("LZ4: unsupported frame descriptor\n");
+		return -EIO;
+	}
+	if ((flg & LZ4_FLG_DICT_ID) != 0U) {
+		ERROR("LZ4: dictionaries are not supported\n");
+		return -EIO;
+	}
+
+	block_max = 1U << (8U + (2U * ((bd >> LZ4_BD_MAX_SIZE_SHIFT) &
+				       LZ4_BD_MAX_SIZE_MASK)));
+	if (block_max < (64U << 10)) {
+		return -EIO;
+	}
+
+	desc_len = 2U;
+	if ((flg & LZ4_FLG_CONTENT_SIZE) != 0U) {
+		desc_len += 8U;
+	}
+	if ((size_t)(iend - ip) < (desc_len + 1U)) {
+		return -EIO;
+	}
+	if (((xxh32(desc, desc_len) >> 8) & 0xFFU) != ip[desc_len]) {
+		ERROR("LZ4: frame descriptor checksum mismatch\n");
+		return -EIO;
+	}
+	ip += desc_len + 1U;
+
+	while (true) {
+		if ((iend - ip) < 4) {
+			return -EIO;
+		}
+		block_size = read_le32(ip);
+		ip += 4;
+
+		/* EndMark */
+		if (block_size == 0U) {
+			break;
+		}
+
+		len = block_size & ~LZ4_BLOCK_UNCOMPRESSED;
+		if ((len > block_max) || (len > (size_t)(iend - ip))) {
+			return -EIO;
+		}
+
+		if ((flg & LZ4_FLG_BLOCK_CSUM) != 0U) {
+			if ((size_t)(iend - ip) < (len + 4U)) {
+				return -EIO;
+			}
+			if (xxh32(ip, len) != read_le32(ip + len)) {
+				ERROR("LZ4: block checksum mismatch\n");
+				return -EIO;
+			}
+		}
+
+		if ((block_size & LZ4_BLOCK_UNCOMPRESSED) != 0U) {
+			if (len > (size_t)(oend - *op)) {
+				return -EIO;
+			}
+			memcpy(*op, ip, len);
+			*op += len;
+		} else {
+			ret = lz4_decode_block(ip, len, op, oend, frame_start);
+			if (ret != 0) {
+				return ret;
+			}
+		}
+
+		ip += len;
+		if ((flg & LZ4_FLG_BLOCK_CSUM) != 0U) {
+			ip += 4;
+		}
+	}
+
+	if ((flg & LZ4_FLG_CONTENT_SIZE) != 0U) {
+		/* Only the low 32 bits matter for images */
+		if (read_le32(desc + 2) != (uint32_t)(*op - frame_start)) {
+			ERROR("LZ4: content size mismatch\n");
+			return -EIO;
+		}
+	}
+
+	if ((flg & LZ4_FLG_CONTENT_CSUM) != 0U) {
+		if ((iend - ip) < 4) {
+			return -EIO;
+		}
+		csum = xxh32(frame_start, *op - frame_start);
+		if (csum != read_le32(ip)) {
+			ERROR("LZ4: content checksum mismatch\n");
+			return -EIO;
+		}
+		ip += 4;
+	}
+
+	*ipp = ip;
+
+	return 0;
+}
+
+/*
+ * Decode a legacy frame, whose magic has been consumed. It has no end marker:
+ * it runs until the end of input or the magic number of the next frame.
+ */
+static int lz4_decode_legacy(const uint8_t **ipp, const uint8_t *iend,
+			     uint8_t **op, uint8_t *oend)
+{
+	const uint8_t *ip = *ipp;
+	uint8_t *frame_start = *op;
+	uint32_t len;
+	int ret;
+
+	while ((iend - ip) >= 4) {
+		len = read_le32(ip);
+		if ((len == LZ4_LEGACY_MAGIC) || (len == LZ4_FRAME_MAGIC) ||
+		    ((len & LZ4_SKIP_MAGIC_MASK) == LZ4_SKIP_MAGIC)) {
+			break;
+		}
+		ip += 4;
+
+		if ((len > LZ4_LEGACY_BLOCK_MAX) ||
+		    (len > (size_t)(iend - ip))) {
+			return -EIO;
+		}
+
+		ret = lz4_decode_block(ip, len, op, oend, frame_start);
+		if (ret != 0) {
+			return ret;
+		}
+		ip += len;
+	}
+
+	*ipp = ip;
+
+	return 0;
+}
+
+/*
+ * unlz4 - decompress LZ4 data
+ * @in_buf: source of compressed input. Upon exit, the end of input.
+ * @in_len: length of in_buf
+ * @out_buf: destination of decompressed output. Upon exit, the end of output.
+ * @out_len: length of out_buf
+ * @work_buf: workspace (unused)
+ * @work_len: length of workspace (unused)
+ *
+ * The input can hold several frames, which are decoded one after another.
+ */
+int unlz4(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
+	  size_t out_len, uintptr_t work_buf, size_t work_len)
+{
+	const uint8_t *ip = (const uint8_t *)*in_buf;
+	const uint8_t *iend = ip + in_len;
+	uint8_t *op = (uint8_t *)*out_buf;
+	uint8_t *oend = op + out_len;
+	uint32_t magic, skip;
+	int ret = 0;
+
+	if ((in_len < 4U) || ((read_le32(ip) != LZ4_FRAME_MAGIC) &&
+			      (read_le32(ip) != LZ4_LEGACY_MAGIC))) {
+		ERROR("LZ4: not an LZ4 image\n");
+		return -EIO;
+	}
+
+	while ((ret == 0) && ((iend - ip) >= 4)) {
+		magic = read_le32(ip);
+		ip += 4;
+
+		if (magic == LZ4_FRAME_MAGIC) {
+			ret = lz4_decode_frame(&ip, iend, &op, oend);
+		} else if (magic == LZ4_LEGACY_MAGIC) {
+			ret = lz4_decode_legacy(&ip, iend, &op, oend);
+		} else if ((magic & LZ4_SKIP_MAGIC_MASK) == LZ4_SKIP_MAGIC) {
+			if ((iend - ip) < 4) {
+				ret = -EIO;
+				break;
+			}
+			skip = read_le32(ip);
+			ip += 4;
+			if (skip > (size_t)(iend - ip)) {
+				ret = -EIO;
+				break;
+			}
+			ip += skip;
+		} else {
+			/* Trailing data, e.g. padding added after the image */
+			ip -= 4;
+			break;
+		}
+	}
+
+	if (ret != 0) {
+		ERROR("LZ4: corrupted input\n");
+	}
+
+	VERBOSE("LZ4: %lu byte input\n", (unsigned long)(ip - iend + in_len));
+	VERBOSE("LZ4: %lu byte output\n", (unsigned long)(op - oend + out_len));
+
+	*in_buf = (uintptr_t)ip;
+	*out_buf = (uintptr_t)op;
+
+	return ret;
+}
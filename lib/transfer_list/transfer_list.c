@@ -9,9 +9,193 @@
 #include <string.h>
 
 #include <common/debug.h>
+#include <lib/cassert.h>
 #include <lib/transfer_list.h>
 #include <lib/utils_def.h>
 
+/* The 24-bit tag and the header size share the first word of an entry */
+CASSERT(sizeof(struct transfer_list_entry) == 8U,
+	assert_transfer_list_entry_size);
+
+#if TRANSFER_LIST_INDEX
+/*
+ * Lookup index of the first entry of each tag in the last transfer list that
+ * was created or checked. Entries are kept as offsets from the list header so
+ * that the index survives a relocation. The index is only used while the list
+ * address and size match, and every hit is checked against the entry it
+ * points to, so a list changed behind the library's back is walked instead.
+ */
+static struct {
+	uintptr_t tl;
+	uint32_t size;
+	uint32_t count;
+	bool complete;		// every tag in the list is indexed
+	struct {
+		uint32_t tag_id;
+		uint32_t offset;
+	} entries[TRANSFER_LIST_INDEX_SIZE];
+} tl_index;
+
+static bool tl_index_valid(const struct transfer_list_header *tl)
+{
+	return tl_index.tl == (uintptr_t)tl && tl_index.size == tl->size;
+}
+
+static void tl_index_add(const struct transfer_list_header *tl,
+			 const struct transfer_list_entry *te)
+{
+	uint32_t offset = (uintptr_t)te - (uintptr_t)tl;
+	uint32_t i;
+
+	tl_index.size = tl->size;
+
+	if (te->tag_id == TL_TAG_EMPTY) {
+		return;
+	}
+
+	for (i = 0; i < tl_index.count; i++) {
+		if (tl_index.entries[i].tag_id == te->tag_id) {
+			// only the first entry of a tag is found
+			if (offset < tl_index.entries[i].offset) {
+				tl_index.entries[i].offset = offset;
+			}
+			return;
+		}
+	}
+
+	if (tl_index.count == TRANSFER_LIST_INDEX_SIZE) {
+		tl_index.complete = false;
+		return;
+	}
+
+	tl_index.entries[tl_index.count].tag_id = te->tag_id;
+	tl_index.entries[tl_index.count].offset = offset;
+	tl_index.count++;
+}
+
+static void tl_index_build(struct transfer_list_header *tl)
+{
+	struct transfer_list_entry *te = NULL;
+
+	tl_index.tl = (uintptr_t)tl;
+	tl_index.count = 0;
+	tl_index.complete = true;
+
+	while ((te = transfer_list_next(tl, te)) != NULL) {
+		tl_index_add(tl, te);
+	}
+	tl_index.size = tl->size;
+}
+
+/*
+ * Update the index after the entry te was added to tl, or after tl changed in
+ * some other way if te is NULL.
+ */
+static void tl_index_update(struct transfer_list_header *tl,
+			    const struct transfer_list_entry *te)
+{
+	if (tl_index.tl != (uintptr_t)tl) {
+		return;
+	}
+
+	if (te) {
+		tl_index_add(tl, te);
+	} else {
+		tl_index_build(tl);
+	}
+}
+
+/*
+ * Update the index after the entry te, which had the tag tag_id, was removed
+ * from tl. Only the first entry of each tag is indexed, so the index is only
+ * rebuilt when te was one of those.
+ */
+static void tl_index_rem(struct transfer_list_header *tl,
+			 const struct transfer_list_entry *te, uint32_t tag_id)
+{
+	uint32_t offset = (uintptr_t)te - (uintptr_t)tl;
+	uint32_t i;
+
+	if (tl_index.tl != (uintptr_t)tl) {
+		return;
+	}
+
+	if (!tl_index_valid(tl)) {
+		tl_index_build(tl);
+		return;
+	}
+
+	for (i = 0; i < tl_index.count; i++) {
+		if (tl_index.entries[i].tag_id == tag_id) {
+			if (tl_index.entries[i].offset == offset) {
+				tl_index_build(tl);
+			}
+			return;
+		}
+	}
+}
+
+/*
+ * Look up tag_id in the index. Return true if the index has the answer, with
+ * the found entry (or NULL if there is none) in *te.
+ */
+static bool tl_index_find(struct transfer_list_header *tl, uint32_t tag_id,
+			  struct transfer_list_entry **te)
+{
+	struct transfer_list_entry *e;
+	uint32_t i;
+
+	if (!tl_index_valid(tl)) {
+		return false;
+	}
+
+	for (i = 0; i < tl_index.count; i++) {
+		if (tl_index.entries[i].tag_id != tag_id) {
+			continue;
+		}
+		if (tl_index.entries[i].offset + sizeof(*e) > tl->size) {
+			return false;
+		}
+		e = (struct transfer_list_entry *)((uintptr_t)tl +
+						   tl_index.entries[i].offset);
+		if (e->tag_id != tag_id) {
+			return false;
+		}
+		*te = e;
+		return true;
+	}
+
+	if (tl_index.complete) {
+		*te = NULL;
+		return true;
+	}
+
+	return false;
+}
+#else
+static inline void tl_index_build(struct transfer_list_header *tl)
+{
+}
+
+static inline void tl_index_update(struct transfer_list_header *tl,
+				   const struct transfer_list_entry *te)
+{
+}
+
+static inline void tl_index_rem(struct transfer_list_header *tl,
+				const struct transfer_list_entry *te,
+				uint32_t tag_id)
+{
+}
+
+static inline bool tl_index_find(struct transfer_list_header *tl,
+				 uint32_t tag_id,
+				 struct transfer_list_entry **te)
+{
+	return false;
+}
+#endif /* TRANSFER_LIST_INDEX */
+
 void transfer_list_dump(struct transfer_list_header *tl)
 {
 	struct transfer_list_entry *te = NULL;
@@ -70,6 +254,7 @@ struct transfer_list_header *transfer_list_init(void *addr, size_t max_size)
 	tl->max_size = max_size;
 
 	transfer_list_update_checksum(tl);
+	tl_index_build(tl);
 
 	return tl;
 }
@@ -112,6 +297,13 @@ struct transfer_list_header *transfer_list_relocate(
 
 	transfer_list_update_checksum(new_tl);
 
+#if TRANSFER_LIST_INDEX
+	// entry offsets are unchanged by the move
+	if (tl_index.tl == (uintptr_t)tl) {
+		tl_index.tl = (uintptr_t)new_tl;
+	}
+#endif
+
 	return new_tl;
 }
 
@@ -157,7 +349,11 @@ enum transfer_list_ops transfer_list_check_header(
 	if (tl->version == 0) {
 		ERROR("Transfer list version is invalid\n");
 		return TL_OPS_NON;
-	} else if (tl->version == TRANSFER_LIST_VERSION) {
+	}
+
+	tl_index_build((struct transfer_list_header *)tl);
+
+	if (tl->version == TRANSFER_LIST_VERSION) {
 		INFO("Transfer list version is valid for all operations\n");
 		return TL_OPS_ALL;
 	} else if (tl->version > TRANSFER_LIST_VERSION) {
@@ -217,24 +413,67 @@ struct transfer_list_entry *transfer_list_next(struct transfer_list_header *tl,
 }
 
 /*******************************************************************************
- * Calculate the byte sum of a transfer list
- * Return byte sum of the transfer list
+ * Calculate the byte sum of a memory range
+ * Return byte sum of the range
  ******************************************************************************/
-static uint8_t calc_byte_sum(const struct transfer_list_header *tl)
+static uint8_t calc_bytes_sum(const void *addr, size_t size)
 {
-	uint8_t *b = (uint8_t *)tl;
+	const uint8_t *b = addr;
 	uint8_t cs = 0;
 	size_t n = 0;
 
+	for (n = 0; n < size; n++) {
+		cs += b[n];
+	}
+
+	return cs;
+}
+
+/*******************************************************************************
+ * Calculate the byte sum of a transfer list
+ * Return byte sum of the transfer list
+ ******************************************************************************/
+static uint8_t calc_byte_sum(const struct transfer_list_header *tl)
+{
 	if (!tl) {
 		return 0;
 	}
 
-	for (n = 0; n < tl->size; n++) {
-		cs += b[n];
-	}
+	return calc_bytes_sum(tl, tl->size);
+}
 
-	return cs;
+/*******************************************************************************
+ * Calculate the byte sum of the header of a transfer list, without the
+ * checksum itself
+ * Return byte sum of the transfer list header
+ ******************************************************************************/
+static uint8_t calc_hdr_sum(const struct transfer_list_header *tl)
+{
+	return calc_bytes_sum(tl, tl->hdr_size) - tl->checksum;
+}
+
+#if ENABLE_ASSERTIONS
+#define tl_checksum_ok(tl)	transfer_list_verify_checksum(tl)
+#else
+#define tl_checksum_ok(tl)	false
+#endif
+
+/*******************************************************************************
+ * Update the checksum of a transfer list after a change that turned the bytes
+ * summing to old_sum into bytes summing to new_sum, so that only the changed
+ * bytes need to be summed. The checksum byte must not be part of either sum.
+ * Debug builds cross-check the result against a full recompute when the list
+ * verified before the change (sum_ok, from tl_checksum_ok()). A checksum that
+ * was already stale, e.g. because the caller filled in the data of an entry
+ * added without data, stays stale until the next
+ * transfer_list_update_checksum().
+ ******************************************************************************/
+static void transfer_list_adjust_checksum(struct transfer_list_header *tl,
+					  uint8_t old_sum, uint8_t new_sum,
+					  bool sum_ok)
+{
+	tl->checksum -= (uint8_t)(new_sum - old_sum);
+	assert(!sum_ok || transfer_list_verify_checksum(tl));
 }
 
 /*******************************************************************************
@@ -278,11 +517,14 @@ bool transfer_list_set_data_size(struct transfer_list_header *tl,
 	size_t gap = 0;
 	size_t mov_dis = 0;
 	size_t sz = 0;
+	uint8_t old_sum, new_sum;
+	bool sum_ok;
 
 	if (!tl || !te) {
 		return false;
 	}
 	tl_old_ev = (uintptr_t)tl + tl->size;
+	sum_ok = tl_checksum_ok(tl);
 
 	// calculate the old and new end of TE
 	// both must be roundup to align with TRANSFER_LIST_GRANULE
@@ -308,25 +550,43 @@ bool transfer_list_set_data_size(struct transfer_list_header *tl,
 			return false;
 		}
 		ru_new_ev = old_ev + mov_dis;
+		old_sum = calc_hdr_sum(tl) + calc_bytes_sum(te, sizeof(*te));
 		memmove((void *)ru_new_ev, (void *)old_ev, tl_old_ev - old_ev);
 		tl->size += mov_dis;
 		gap = ru_new_ev - new_ev;
 	} else {
+		ru_new_ev = old_ev;
 		gap = old_ev - new_ev;
+		old_sum = calc_bytes_sum(te, sizeof(*te));
+		if (gap >= sizeof(*dummy_te)) {
+			old_sum += calc_bytes_sum((void *)new_ev,
+						  sizeof(*dummy_te));
+		}
 	}
 
 	if (gap >= sizeof(*dummy_te)) {
 		// create a dummy TE to fill up the gap
 		dummy_te = (struct transfer_list_entry *)new_ev;
 		dummy_te->tag_id = TL_TAG_EMPTY;
-		dummy_te->reserved0 = 0;
 		dummy_te->hdr_size = sizeof(*dummy_te);
 		dummy_te->data_size = gap - sizeof(*dummy_te);
 	}
 
 	te->data_size = new_data_size;
 
-	transfer_list_update_checksum(tl);
+	// the moved tail of the list keeps its byte sum
+	if (ru_new_ev > old_ev) {
+		new_sum = calc_hdr_sum(tl) + calc_bytes_sum(te, sizeof(*te)) +
+			  calc_bytes_sum((void *)old_ev, ru_new_ev - old_ev);
+	} else {
+		new_sum = calc_bytes_sum(te, sizeof(*te));
+		if (gap >= sizeof(*dummy_te)) {
+			new_sum += calc_bytes_sum((void *)new_ev,
+						  sizeof(*dummy_te));
+		}
+	}
+	transfer_list_adjust_checksum(tl, old_sum, new_sum, sum_ok);
+	tl_index_update(tl, NULL);
 	return true;
 }
 
@@ -337,49 +597,131 @@ bool transfer_list_set_data_size(struct transfer_list_header *tl,
 bool transfer_list_rem(struct transfer_list_header *tl,
 			struct transfer_list_entry *te)
 {
+	uint32_t tag_id;
+	uint8_t old_sum;
+	bool sum_ok;
+
 	if (!tl || !te || (uintptr_t)te > (uintptr_t)tl + tl->size) {
 		return false;
 	}
+	sum_ok = tl_checksum_ok(tl);
+	tag_id = te->tag_id;
+	old_sum = calc_bytes_sum(te, sizeof(*te));
 	te->tag_id = TL_TAG_EMPTY;
-	te->reserved0 = 0;
+	transfer_list_adjust_checksum(tl, old_sum,
+				      calc_bytes_sum(te, sizeof(*te)), sum_ok);
+	tl_index_rem(tl, te, tag_id);
+	return true;
+}
+
+/*******************************************************************************
+ * Get the size of the entry at va, rounded up to TRANSFER_LIST_GRANULE, and
+ * check that it ends within the list ending at tl_ev
+ * Return true on success or false if the entry is malformed
+ ******************************************************************************/
+static bool transfer_list_entry_size(uintptr_t va, uintptr_t tl_ev, size_t *sz)
+{
+	const struct transfer_list_entry *te =
+		(const struct transfer_list_entry *)va;
+
+	return !(va + sizeof(*te) > tl_ev || te->hdr_size < sizeof(*te) ||
+		 add_overflow(te->hdr_size, te->data_size, sz) ||
+		 round_up_overflow(*sz, TRANSFER_LIST_GRANULE, sz) ||
+		 *sz > tl_ev - va);
+}
+
+/*******************************************************************************
+ * Compact a transfer list by moving the entries down over the void entries
+ * before them and shrinking the list. Entries are only moved by multiples of
+ * the list alignment, so the alignment of every entry data is preserved; the
+ * remainder of a gap that cannot be reclaimed is left as a void entry.
+ * All entries are checked before any is moved, so a malformed list is left
+ * untouched.
+ * Pointers to entries of the list are invalid after the call.
+ * Return true on success or false on error
+ ******************************************************************************/
+bool transfer_list_compact(struct transfer_list_header *tl)
+{
+	struct transfer_list_entry *te, *dummy_te;
+	uintptr_t rd, wr, dst, tl_ev;
+	size_t sz = 0;
+
+	if (!tl) {
+		return false;
+	}
+
+	rd = (uintptr_t)tl + tl->hdr_size;
+	tl_ev = (uintptr_t)tl + tl->size;
+
+	while (rd < tl_ev) {
+		if (!transfer_list_entry_size(rd, tl_ev, &sz)) {
+			return false;
+		}
+		rd += sz;
+	}
+
+	rd = (uintptr_t)tl + tl->hdr_size;
+	wr = rd;
+
+	while (rd < tl_ev) {
+		te = (struct transfer_list_entry *)rd;
+		(void)transfer_list_entry_size(rd, tl_ev, &sz);
+
+		if (te->tag_id == TL_TAG_EMPTY) {
+			rd += sz;
+			continue;
+		}
+
+		dst = rd - round_down(rd - wr, 1 << tl->alignment);
+		memmove((void *)dst, (void *)rd, sz);
+		if (dst != wr) {
+			// keep the remainder of the gap as a void entry
+			dummy_te = (struct transfer_list_entry *)wr;
+			dummy_te->tag_id = TL_TAG_EMPTY;
+			dummy_te->hdr_size = sizeof(*dummy_te);
+			dummy_te->data_size = dst - wr - sizeof(*dummy_te);
+		}
+		wr = dst + sz;
+		rd += sz;
+	}
+
+	tl->size = wr - (uintptr_t)tl;
+
 	transfer_list_update_checksum(tl);
+	tl_index_update(tl, NULL);
 	return true;
 }
 
 /*******************************************************************************
- * Add a new transfer entry into a transfer list
- * Compliant to 2.4.3 of Firmware handoff specification (v0.9)
+ * Add a new transfer entry at the tail of a transfer list
  * Return pointer to the added transfer entry or NULL on error
  ******************************************************************************/
-struct transfer_list_entry *transfer_list_add(struct transfer_list_header *tl,
-					      uint16_t tag_id,
-					      uint32_t data_size,
-					      const void *data)
+static struct transfer_list_entry *transfer_list_add_tail(
+					struct transfer_list_header *tl,
+					uint32_t tag_id, uint32_t data_size,
+					const void *data)
 {
 	uintptr_t max_tl_ev, tl_ev, ev;
 	struct transfer_list_entry *te = NULL;
 	uint8_t *te_data = NULL;
+	uint8_t old_sum;
+	bool sum_ok;
 	size_t sz = 0;
 
-	if (!tl) {
-		return NULL;
-	}
-
 	max_tl_ev = (uintptr_t)tl + tl->max_size;
 	tl_ev = (uintptr_t)tl + tl->size;
 	ev = tl_ev;
 
-	// skip the step 1 (optional step)
-	// new TE will be added into the tail
 	if (add_overflow(sizeof(*te), data_size, &sz) ||
 		add_with_round_up_overflow(ev, sz,
 		TRANSFER_LIST_GRANULE, &ev) || ev > max_tl_ev) {
 		return NULL;
 	}
 
+	sum_ok = tl_checksum_ok(tl);
+	old_sum = calc_hdr_sum(tl);
 	te = (struct transfer_list_entry *)tl_ev;
 	te->tag_id = tag_id;
-	te->reserved0 = 0;
 	te->hdr_size = sizeof(*te);
 	te->data_size = data_size;
 	tl->size += ev - tl_ev;
@@ -393,11 +735,114 @@ struct transfer_list_entry *transfer_list_add(struct transfer_list_header *tl,
 		memmove(te_data, data, data_size);
 	}
 
-	transfer_list_update_checksum(tl);
+	transfer_list_adjust_checksum(tl, old_sum, calc_hdr_sum(tl) +
+				      calc_bytes_sum(te, ev - tl_ev), sum_ok);
+	tl_index_update(tl, te);
 
 	return te;
 }
 
+/*******************************************************************************
+ * Add a new transfer entry into the first run of void entries of a transfer
+ * list that can hold it with its data aligned to (1 << alignment). The parts
+ * of the run left unused before and after the new entry stay void.
+ * Compliant to step 1 of 2.4.3 of Firmware handoff specification (v0.9)
+ * Return pointer to the added transfer entry or NULL if there is no such run
+ ******************************************************************************/
+static struct transfer_list_entry *transfer_list_add_in_hole(
+					struct transfer_list_header *tl,
+					uint32_t tag_id, uint32_t data_size,
+					const void *data, uint8_t alignment)
+{
+	struct transfer_list_entry *te = NULL, *dummy_te;
+	uintptr_t hole = 0, hole_ev, va;
+	uint8_t old_sum;
+	bool sum_ok;
+	size_t sz = 0;
+
+	if (add_overflow(sizeof(*te), data_size, &sz) ||
+		round_up_overflow(sz, TRANSFER_LIST_GRANULE, &sz)) {
+		return NULL;
+	}
+
+	while ((te = transfer_list_next(tl, te)) != NULL) {
+		if (te->tag_id != TL_TAG_EMPTY) {
+			hole = 0;
+			continue;
+		}
+		if (!hole) {
+			hole = (uintptr_t)te;
+		}
+
+		// transfer_list_next() has checked this for overflow
+		hole_ev = round_up((uintptr_t)te + te->hdr_size + te->data_size,
+				   TRANSFER_LIST_GRANULE);
+		va = round_up(hole + sizeof(*te), 1 << alignment) - sizeof(*te);
+		if (va >= hole_ev || hole_ev - va < sz) {
+			continue;
+		}
+
+		sum_ok = tl_checksum_ok(tl);
+		old_sum = calc_bytes_sum((void *)hole, hole_ev - hole);
+
+		if (va != hole) {
+			dummy_te = (struct transfer_list_entry *)hole;
+			dummy_te->tag_id = TL_TAG_EMPTY;
+			dummy_te->hdr_size = sizeof(*dummy_te);
+			dummy_te->data_size = va - hole - sizeof(*dummy_te);
+		}
+		if (va + sz != hole_ev) {
+			dummy_te = (struct transfer_list_entry *)(va + sz);
+			dummy_te->tag_id = TL_TAG_EMPTY;
+			dummy_te->hdr_size = sizeof(*dummy_te);
+			dummy_te->data_size = hole_ev - va - sz -
+						sizeof(*dummy_te);
+		}
+
+		te = (struct transfer_list_entry *)va;
+		te->tag_id = tag_id;
+		te->hdr_size = sizeof(*te);
+		te->data_size = data_size;
+		if (data) {
+			memmove(transfer_list_entry_data(te), data, data_size);
+		}
+
+		transfer_list_adjust_checksum(tl, old_sum,
+				calc_bytes_sum((void *)hole, hole_ev - hole),
+				sum_ok);
+		tl_index_update(tl, te);
+
+		return te;
+	}
+
+	return NULL;
+}
+
+/*******************************************************************************
+ * Add a new transfer entry into a transfer list
+ * Compliant to 2.4.3 of Firmware handoff specification (v0.9)
+ * Return pointer to the added transfer entry or NULL on error
+ ******************************************************************************/
+struct transfer_list_entry *transfer_list_add(struct transfer_list_header *tl,
+					      uint32_t tag_id,
+					      uint32_t data_size,
+					      const void *data)
+{
+	struct transfer_list_entry *te;
+
+	if (!tl) {
+		return NULL;
+	}
+
+	// reuse the space of removed entries before growing the list
+	te = transfer_list_add_in_hole(tl, tag_id, data_size, data, 0);
+	if (te) {
+		return te;
+	}
+
+	return transfer_list_add_tail(tl, tag_id, data_size, data);
+}
+
 /*******************************************************************************
  * Add a new transfer entry into a transfer list with specified new data
  * alignment requirement
@@ -406,39 +851,49 @@ struct transfer_list_entry *transfer_list_add(struct transfer_list_header *tl,
  ******************************************************************************/
 struct transfer_list_entry *transfer_list_add_with_align(
 					struct transfer_list_header *tl,
-					uint16_t tag_id, uint32_t data_size,
+					uint32_t tag_id, uint32_t data_size,
 					const void *data, uint8_t alignment)
 {
 	struct transfer_list_entry *te = NULL;
 	uintptr_t tl_ev, ev, new_tl_ev;
 	size_t dummy_te_data_sz = 0;
+	uint8_t old_sum;
+	bool sum_ok;
 
 	if (!tl) {
 		return NULL;
 	}
 
-	tl_ev = (uintptr_t)tl + tl->size;
-	ev = tl_ev + sizeof(struct transfer_list_entry);
-
-	if (!is_aligned(ev, 1 << alignment)) {
-		// TE data address is not aligned to the new alignment
-		// fill the gap with an empty TE as a placeholder before
-		// adding the desire TE
-		new_tl_ev = round_up(ev, 1 << alignment) -
-				sizeof(struct transfer_list_entry);
-		dummy_te_data_sz = new_tl_ev - tl_ev -
+	// reuse the space of removed entries before growing the list
+	te = transfer_list_add_in_hole(tl, tag_id, data_size, data,
+				       alignment);
+	if (!te) {
+		tl_ev = (uintptr_t)tl + tl->size;
+		ev = tl_ev + sizeof(struct transfer_list_entry);
+
+		if (!is_aligned(ev, 1 << alignment)) {
+			// TE data address is not aligned to the new alignment
+			// fill the gap with an empty TE as a placeholder before
+			// adding the desire TE
+			new_tl_ev = round_up(ev, 1 << alignment) -
 					sizeof(struct transfer_list_entry);
-		if (!transfer_list_add(tl, TL_TAG_EMPTY, dummy_te_data_sz,
-					NULL)) {
-			return NULL;
+			dummy_te_data_sz = new_tl_ev - tl_ev -
+						sizeof(struct transfer_list_entry);
+			if (!transfer_list_add_tail(tl, TL_TAG_EMPTY,
+						    dummy_te_data_sz, NULL)) {
+				return NULL;
+			}
 		}
-	}
 
-	te = transfer_list_add(tl, tag_id, data_size, data);
+		te = transfer_list_add_tail(tl, tag_id, data_size, data);
+	}
 
 	if (alignment > tl->alignment) {
+		sum_ok = tl_checksum_ok(tl);
+		old_sum = calc_hdr_sum(tl);
 		tl->alignment = alignment;
-		transfer_list_update_checksum(tl);
+		transfer_list_adjust_checksum(tl, old_sum, calc_hdr_sum(tl),
+					      sum_ok);
 	}
 
 	return te;
@@ -450,13 +905,17 @@ struct transfer_list_entry *transfer_list_add_with_align(
  * Return pointer to the found transfer entry or NULL on error
  ******************************************************************************/
 struct transfer_list_entry *transfer_list_find(struct transfer_list_header *tl,
-					       uint16_t tag_id)
+					       uint32_t tag_id)
 {
 	struct transfer_list_entry *te = NULL;
 
+	if (tl_index_find(tl, tag_id, &te)) {
+		return te;
+	}
+
 	do {
 		te = transfer_list_next(tl, te);
-	} while (te && (te->tag_id != tag_id || te->reserved0 != 0));
+	} while (te && (te->tag_id != tag_id));
 
 	return te;
 }
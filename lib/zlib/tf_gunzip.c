@@ -102,6 +102,89 @@ int gunzip(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
 	return ret;
 }
 
+/* State of the stream decompressed with gunzip_stream() */
+static z_stream gunzip_strm;
+
+/*
+ * gunzip_stream_init - start decompressing gzip data delivered in pieces
+ * @work_buf: workspace, used until gunzip_stream_end()
+ * @work_len: length of workspace
+ *
+ * The workspace holds the inflate state and its 32KB sliding window, so the
+ * memory needed does not depend on the size of the data.
+ */
+int gunzip_stream_init(uintptr_t work_buf, size_t work_len)
+{
+	int zret;
+
+	zalloc_start = work_buf;
+	zalloc_end = work_buf + work_len;
+	zalloc_current = zalloc_start;
+
+	zeromem(&gunzip_strm, sizeof(gunzip_strm));
+	gunzip_strm.zalloc = zcalloc;
+	gunzip_strm.zfree = zfree;
+	gunzip_strm.opaque = (voidpf)0;
+
+	zret = inflateInit(&gunzip_strm);
+	if (zret != Z_OK) {
+		ERROR("zlib: inflate init failed (ret = %d)\n", zret);
+		return (zret == Z_MEM_ERROR) ? -ENOMEM : -EIO;
+	}
+
+	return 0;
+}
+
+/*
+ * gunzip_stream - decompress the next piece of a gzip stream
+ * @in_buf: source of compressed input. Upon exit, the end of consumed input.
+ * @in_len: length of in_buf
+ * @out_buf: destination of decompressed output. Upon exit, the end of output.
+ * @out_len: length of out_buf
+ * @stream_end: set when the end of the gzip stream has been reached and its
+ *              trailer checked
+ *
+ * Returns once all the input has been consumed, the output buffer is full or
+ * the stream has ended. Input that is not consumed must be passed again to
+ * the next call.
+ */
+int gunzip_stream(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
+		  size_t out_len, bool *stream_end)
+{
+	int zret;
+
+	gunzip_strm.next_in = (typeof(gunzip_strm.next_in))*in_buf;
+	gunzip_strm.avail_in = in_len;
+	gunzip_strm.next_out = (typeof(gunzip_strm.next_out))*out_buf;
+	gunzip_strm.avail_out = out_len;
+
+	zret = inflate(&gunzip_strm, Z_NO_FLUSH);
+
+	*in_buf = (uintptr_t)gunzip_strm.next_in;
+	*out_buf = (uintptr_t)gunzip_strm.next_out;
+	*stream_end = (zret == Z_STREAM_END);
+
+	/* Z_BUF_ERROR only means that no progress was possible this time */
+	if ((zret == Z_OK) || (zret == Z_STREAM_END) || (zret == Z_BUF_ERROR)) {
+		return 0;
+	}
+
+	if (gunzip_strm.msg)
+		ERROR("%s\n", gunzip_strm.msg);
+	ERROR("zlib: inflate failed (ret = %d)\n", zret);
+
+	return (zret == Z_MEM_ERROR) ? -ENOMEM : -EIO;
+}
+
+/* gunzip_stream_end - release the stream started by gunzip_stream_init() */
+void gunzip_stream_end(void)
+{
+	VERBOSE("zlib: %lu byte input\n", gunzip_strm.total_in);
+	VERBOSE("zlib: %lu byte output\n", gunzip_strm.total_out);
+
+	inflateEnd(&gunzip_strm);
+}
+
 /* Wrapper function to calculate CRC
  * @crc: previous accumulated CRC
  * @buf: buffer base address
@@ -0,0 +1,388 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * inflate_fast() tuned for firmware, a drop-in replacement of inffast.c
+ * selected with ZLIB_FAST_INFLATE=1.
+ *
+ * Compared to the generic loop:
+ *  - The bit buffer is 64-bit and refilled once per iteration, with up to
+ *    eight bytes at a time taken from two aligned loads. This is enough for a complete length/distance
+ *    pair, so the decoding itself has no refill branches, and up to three
+ *    literals are decoded per refill.
+ *  - Long matches are copied with word stores. Alignment checking is
+ *    enabled in TF-A and the code is built with -mstrict-align, so the
+ *    destination is aligned first and misaligned sources are merged from
+ *    two aligned loads. The aligned loads never cross the word holding the
+ *    first or the last source byte.
+ *  - Overlapping matches with a distance of 1, 2 or 4 are filled with a
+ *    repeated pattern word.
+ *
+ * The entry and exit conditions are those of inffast.c. Little-endian only.
+ */
+
+#include <stdint.h>
+
+#include "zutil.h"
+#include "inftrees.h"
+#include "inflate.h"
+#include "inffast.h"
+
+#ifdef INFLATE_ALLOW_INVALID_DISTANCE_TOOFAR_ARRR
+#error "INFLATE_ALLOW_INVALID_DISTANCE_TOOFAR_ARRR is not supported"
+#endif
+
+/* Copy unit: a register, which does not need more than its own alignment */
+typedef unsigned long __attribute__((__may_alias__)) zword_t;
+#define ZWORD_SIZE	sizeof(zword_t)
+#define ZWORD_MASK	(ZWORD_SIZE - 1U)
+
+/* Matches shorter than this are copied byte by byte */
+#define COPY_WORD_MIN	16U
+
+/* Bits needed to decode a length/distance pair: 15 + 5 + 15 + 13 */
+#define PAIR_BITS	48U
+
+/*
+ * Load eight input bytes from the two aligned words holding them. The second
+ * word is always loaded, so p + 16 must not be past the input.
+ */
+static inline uint64_t load_in64(const unsigned char *p)
+{
+	const uint64_t __attribute__((__may_alias__)) *w;
+	unsigned int shift;
+
+	w = (const uint64_t *)((uintptr_t)p & ~(uintptr_t)7U);
+	shift = ((uintptr_t)p & 7U) * 8U;
+
+	/* Two shifts for the second word, as shifting by 64 is undefined */
+	return (w[0] >> shift) | ((w[1] << 1) << (63U - shift));
+}
+
+static inline unsigned char *copy_bytes(unsigned char *out,
+					const unsigned char *from,
+					unsigned int len)
+{
+	while (len > 2U) {
+		*out++ = *from++;
+		*out++ = *from++;
+		*out++ = *from++;
+		len -= 3U;
+	}
+	if (len != 0U) {
+		*out++ = *from++;
+		if (len > 1U) {
+			*out++ = *from++;
+		}
+	}
+
+	return out;
+}
+
+/*
+ * Copy len >= COPY_WORD_MIN bytes from a source which is either outside the
+ * output or at least ZWORD_SIZE bytes behind out. Each source word is loaded
+ * before the destination word is stored, so that with the shortest distance
+ * the bytes used have all been written by the previous stores.
+ */
+static unsigned char *copy_words(unsigned char *out, const unsigned char *from,
+				 unsigned int len)
+{
+	const zword_t *src;
+	zword_t *dst;
+	zword_t lo, hi;
+	unsigned int shift, n;
+
+	while (((uintptr_t)out & ZWORD_MASK) != 0U) {
+		*out++ = *from++;
+		len--;
+	}
+
+	dst = (zword_t *)out;
+	n = len / ZWORD_SIZE;
+	shift = ((uintptr_t)from & ZWORD_MASK) * 8U;
+	src = (const zword_t *)((uintptr_t)from & ~(uintptr_t)ZWORD_MASK);
+
+	if (shift == 0U) {
+		for (; n != 0U; n--) {
+			*dst++ = *src++;
+		}
+	} else {
+		for (; n != 0U; n--) {
+			lo = src[0];
+			hi = src[1];
+			*dst++ = (lo >> shift) |
+				 (hi << ((ZWORD_SIZE * 8U) - shift));
+			src++;
+		}
+	}
+
+	n = len & ~(unsigned int)ZWORD_MASK;
+
+	return copy_bytes(out + n, from + n, len - n);
+}
+
+/*
+ * Copy len >= COPY_WORD_MIN bytes from out - dist, where dist divides the
+ * word size, by storing a word of the repeated pattern.
+ */
+static unsigned char *copy_pattern(unsigned char *out, unsigned int dist,
+				   unsigned int len)
+{
+	zword_t *dst;
+	zword_t pat = 0;
+	unsigned int i, n;
+
+	while (((uintptr_t)out & ZWORD_MASK) != 0U) {
+		*out = *(out - dist);
+		out++;
+		len--;
+	}
+
+	for (i = 0U; i < ZWORD_SIZE; i++) {
+		pat |= (zword_t)*(out - dist + (i % dist)) << (i * 8U);
+	}
+
+	dst = (zword_t *)out;
+	for (n = len / ZWORD_SIZE; n != 0U; n--) {
+		*dst++ = pat;
+	}
+
+	n = len & ~(unsigned int)ZWORD_MASK;
+	out += n;
+
+	return copy_bytes(out, out - dist, len - n);
+}
+
+/* Copy a match of len >= 3 bytes from the output, dist bytes behind out */
+static inline __attribute__((__always_inline__))
+unsigned char *copy_match(unsigned char *out, unsigned int dist,
+			  unsigned int len)
+{
+	if (len >= COPY_WORD_MIN) {
+		if (dist >= ZWORD_SIZE) {
+			return copy_words(out, out - dist, len);
+		}
+		if ((ZWORD_SIZE % dist) == 0U) {
+			return copy_pattern(out, dist, len);
+		}
+	}
+
+	return copy_bytes(out, out - dist, len);
+}
+
+/* Copy from the window, which does not overlap the output */
+static inline __attribute__((__always_inline__))
+unsigned char *copy_window(unsigned char *out, const unsigned char *from,
+			   unsigned int len)
+{
+	if (len >= COPY_WORD_MIN) {
+		return copy_words(out, from, len);
+	}
+
+	return copy_bytes(out, from, len);
+}
+
+void ZLIB_INTERNAL inflate_fast(z_streamp strm, unsigned start)
+{
+	struct inflate_state FAR *state;
+	z_const unsigned char FAR *in;		/* local strm->next_in */
+	z_const unsigned char FAR *in_end;	/* end of the input */
+	z_const unsigned char FAR *last;	/* fast refill while in < last */
+	unsigned char FAR *out;			/* local strm->next_out */
+	unsigned char FAR *beg;			/* inflate()'s initial next_out */
+	unsigned char FAR *end;			/* space for a match while < end */
+#ifdef INFLATE_STRICT
+	unsigned int dmax;			/* zlib header max distance */
+#endif
+	unsigned int wsize;			/* window size or zero */
+	unsigned int whave;			/* valid bytes in the window */
+	unsigned int wnext;			/* window write index */
+	unsigned char FAR *window;		/* sliding window, if wsize */
+	uint64_t hold;				/* local strm->hold */
+	unsigned int bits;			/* local strm->bits */
+	code const FAR *lcode;			/* local strm->lencode */
+	code const FAR *dcode;			/* local strm->distcode */
+	unsigned int lmask;			/* first level length mask */
+	unsigned int dmask;			/* first level distance mask */
+	code const *here;			/* retrieved table entry */
+	unsigned int op;			/* code bits, operation, extra */
+	unsigned int len;			/* match length, unused bytes */
+	unsigned int dist;			/* match distance */
+	unsigned char FAR *from;		/* where to copy match from */
+
+	state = (struct inflate_state FAR *)strm->state;
+	in = strm->next_in;
+	in_end = in + strm->avail_in;
+	last = (strm->avail_in >= 16U) ? (in_end - 15) : in;
+	out = strm->next_out;
+	beg = out - (start - strm->avail_out);
+	end = out + (strm->avail_out - 257);
+#ifdef INFLATE_STRICT
+	dmax = state->dmax;
+#endif
+	wsize = state->wsize;
+	whave = state->whave;
+	wnext = state->wnext;
+	window = state->window;
+	hold = state->hold;
+	bits = state->bits;
+	lcode = state->lencode;
+	dcode = state->distcode;
+	lmask = (1U << state->lenbits) - 1U;
+	dmask = (1U << state->distbits) - 1U;
+
+	/*
+	 * The bits of hold above "bits" may hold a copy of the next input byte
+	 * after a fast refill. The next refill ORs the same byte at the same
+	 * place, and they are masked out on exit.
+	 */
+	do {
+		if (in < last) {
+			hold |= load_in64(in) << bits;
+			in += (63U - bits) >> 3;
+			bits |= 56U;
+		} else {
+			while ((bits < 56U) && (in < in_end)) {
+				hold |= (uint64_t)*in++ << bits;
+				bits += 8U;
+			}
+			if (bits < PAIR_BITS) {
+				break;
+			}
+		}
+
+		here = lcode + (hold & lmask);
+dolen:
+		op = here->bits;
+		hold >>= op;
+		bits -= op;
+		op = here->op;
+		if (op == 0U) {
+			/*
+			 * Literal. At most 15 bits have been used since the
+			 * refill, which leaves enough for two more literals.
+			 */
+			*out++ = (unsigned char)here->val;
+			here = lcode + (hold & lmask);
+			if (here->op == 0U) {
+				hold >>= here->bits;
+				bits -= here->bits;
+				*out++ = (unsigned char)here->val;
+				here = lcode + (hold & lmask);
+				if (here->op == 0U) {
+					hold >>= here->bits;
+					bits -= here->bits;
+					*out++ = (unsigned char)here->val;
+				}
+			}
+		} else if ((op & 16U) != 0U) {
+			/* Length base, then its extra bits and the distance */
+			len = here->val;
+			op &= 15U;
+			len += (unsigned int)hold & ((1U << op) - 1U);
+			hold >>= op;
+			bits -= op;
+
+			here = dcode + (hold & dmask);
+dodist:
+			op = here->bits;
+			hold >>= op;
+			bits -= op;
+			op = here->op;
+			if ((op & 16U) == 0U) {
+				if ((op & 64U) == 0U) {
+					/* 2nd level distance code */
+					here = dcode + here->val +
+					       (hold & ((1U << op) - 1U));
+					goto dodist;
+				}
+				strm->msg = (char *)"invalid distance code";
+				state->mode = BAD;
+				break;
+			}
+
+			dist = here->val;
+			op &= 15U;
+			dist += (unsigned int)hold & ((1U << op) - 1U);
+#ifdef INFLATE_STRICT
+			if (dist > dmax) {
+				strm->msg = (char *)"invalid distance too far back";
+				state->mode = BAD;
+				break;
+			}
+#endif
+			hold >>= op;
+			bits -= op;
+
+			op = (unsigned int)(out - beg);	/* max distance in output */
+			if (dist <= op) {
+				out = copy_match(out, dist, len);
+				continue;
+			}
+
+			/* Copy from the window first */
+			op = dist - op;			/* distance back in window */
+			if ((op > whave) && (state->sane != 0)) {
+				strm->msg = (char *)"invalid distance too far back";
+				state->mode = BAD;
+				break;
+			}
+
+			from = window;
+			if (wnext == 0U) {
+				from += wsize - op;
+			} else if (wnext < op) {
+				/* Wrap around the window */
+				from += wsize + wnext - op;
+				op -= wnext;
+				if (op < len) {
+					len -= op;
+					out = copy_window(out, from, op);
+					from = window;
+					op = wnext;
+				}
+			} else {
+				from += wnext - op;
+			}
+
+			if (op < len) {
+				/* The rest is from the output */
+				len -= op;
+				out = copy_window(out, from, op);
+				out = copy_match(out, dist, len);
+			} else {
+				out = copy_window(out, from, len);
+			}
+		} else if ((op & 64U) == 0U) {
+			/* 2nd level length code */
+			here = lcode + here->val + (hold & ((1U << op) - 1U));
+			goto dolen;
+		} else if ((op & 32U) != 0U) {
+			/* End of block */
+			state->mode = TYPE;
+			break;
+		} else {
+			strm->msg = (char *)"invalid literal/length code";
+			state->mode = BAD;
+			break;
+		}
+	} while (out < end);
+
+	/* Return unused bytes, and drop the bits above "bits" */
+	len = bits >> 3;
+	in -= len;
+	bits -= len << 3;
+	hold &= ((uint64_t)1U << bits) - 1U;
+
+	strm->next_in = in;
+	strm->next_out = out;
+	strm->avail_in = (unsigned int)(in_end - in);
+	strm->avail_out = (unsigned int)(out < end ? 257 + (end - out) :
+					 257 - (out - end));
+	state->hold = (unsigned long)hold;
+	state->bits = bits;
+}
@@ -6,15 +6,23 @@
 
 ZLIB_PATH	:=	lib/zlib
 
+# Use the inflate fast loop tuned for firmware (tf_inffast.c)
+ZLIB_FAST_INFLATE	?=	0
+
 # Imported from zlib 1.2.11 (do not modify them)
 ZLIB_SOURCES	:=	$(addprefix $(ZLIB_PATH)/,	\
 					adler32.c	\
 					crc32.c		\
-					inffast.c	\
 					inflate.c	\
 					inftrees.c	\
 					zutil.c)
 
+ifeq (${ZLIB_FAST_INFLATE},1)
+ZLIB_SOURCES	+=	$(ZLIB_PATH)/tf_inffast.c
+else
+ZLIB_SOURCES	+=	$(ZLIB_PATH)/inffast.c
+endif
+
 # Implemented for TF
 ZLIB_SOURCES	+=	$(addprefix $(ZLIB_PATH)/,	\
 					tf_gunzip.c)
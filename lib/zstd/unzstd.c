@@ -0,0 +1,1202 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Zstandard decoder for image_decompress(), following RFC 8878. The output
+ * buffer holds the whole image, so matches are copied straight from the
+ * output and no history window is needed. The workspace holds the literals
+ * of the current block and the decoding tables. Dictionaries are not
+ * supported.
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <common/debug.h>
+#include <unzstd.h>
+
+#define ZSTD_MAGIC		0xFD2FB528U
+#define ZSTD_SKIP_MAGIC		0x184D2A50U
+#define ZSTD_SKIP_MAGIC_MASK	0xFFFFFFF0U
+
+#define ZSTD_BLOCK_SIZE_MAX	(128U * 1024U)
+
+/* Frame header descriptor */
+#define ZSTD_FHD_FCS_SHIFT	6
+#define ZSTD_FHD_SINGLE_SEGMENT	(1U << 5)
+#define ZSTD_FHD_RESERVED	(1U << 3)
+#define ZSTD_FHD_CHECKSUM	(1U << 2)
+#define ZSTD_FHD_DICT_ID_MASK	0x3U
+
+/* Block types */
+#define ZSTD_BLOCK_RAW		0U
+#define ZSTD_BLOCK_RLE		1U
+#define ZSTD_BLOCK_COMPRESSED	2U
+
+/* Literals block types */
+#define ZSTD_LIT_RAW		0U
+#define ZSTD_LIT_RLE		1U
+#define ZSTD_LIT_COMPRESSED	2U
+#define ZSTD_LIT_TREELESS	3U
+
+/* Sequence table modes */
+#define ZSTD_MODE_PREDEFINED	0U
+#define ZSTD_MODE_RLE		1U
+#define ZSTD_MODE_FSE		2U
+#define ZSTD_MODE_REPEAT	3U
+
+#define HUF_MAX_BITS		11U
+#define HUF_MAX_WEIGHTS		255U
+#define HUF_WEIGHT_MAX_LOG	6U
+
+#define LL_MAX_SYMBOL		35U
+#define ML_MAX_SYMBOL		52U
+#define OF_MAX_SYMBOL		31U
+#define LL_MAX_LOG		9U
+#define ML_MAX_LOG		9U
+#define OF_MAX_LOG		8U
+#define LL_DEFAULT_LOG		6U
+#define ML_DEFAULT_LOG		6U
+#define OF_DEFAULT_LOG		5U
+
+#define XXH64_P1		11400714785074694791ULL
+#define XXH64_P2		14029467366897019727ULL
+#define XXH64_P3		1609587929392839161ULL
+#define XXH64_P4		9650029242287828579ULL
+#define XXH64_P5		2870177450012600261ULL
+
+typedef struct {
+	uint8_t symbol;
+	uint8_t nb_bits;
+	uint16_t new_state;
+} fse_entry_t;
+
+typedef struct {
+	uint8_t symbol;
+	uint8_t nb_bits;
+} huf_entry_t;
+
+typedef struct {
+	fse_entry_t *entries;
+	unsigned int log;
+	bool valid;
+} fse_table_t;
+
+/* Layout of the workspace */
+struct zstd_work {
+	uint8_t literals[ZSTD_BLOCK_SIZE_MAX];
+	huf_entry_t huf[1U << HUF_MAX_BITS];
+	fse_entry_t ll[1U << LL_MAX_LOG];
+	fse_entry_t ml[1U << ML_MAX_LOG];
+	fse_entry_t of[1U << OF_MAX_LOG];
+	fse_entry_t weights[1U << HUF_WEIGHT_MAX_LOG];
+};
+
+/* State kept across the blocks of a frame */
+typedef struct {
+	struct zstd_work *work;
+	uint8_t *frame_start;
+	unsigned int huf_bits;		/* 0 until a Huffman table is read */
+	fse_table_t ll, ml, of;
+	size_t rep[3];
+} zstd_frame_t;
+
+/* Backward bitstream, read from its last bit towards its first one */
+typedef struct {
+	const uint8_t *start;
+	const uint8_t *ptr;
+	uint64_t bits;			/* the low 'avail' bits are valid */
+	unsigned int avail;
+	bool overflow;			/* more bits read than available */
+} bitrev_t;
+
+static const int16_t ll_default_norm[LL_MAX_SYMBOL + 1] = {
+	4, 3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1,
+	2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 2, 1, 1, 1, 1, 1,
+	-1, -1, -1, -1
+};
+
+static const int16_t ml_default_norm[ML_MAX_SYMBOL + 1] = {
+	1, 4, 3, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, -1, -1,
+	-1, -1, -1, -1, -1
+};
+
+static const int16_t of_default_norm[OF_MAX_SYMBOL + 1] = {
+	1, 1, 1, 1, 1, 1, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, -1, -1, -1, -1, -1
+};
+
+static const uint32_t ll_base[LL_MAX_SYMBOL + 1] = {
+	0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+	16, 18, 20, 22, 24, 28, 32, 40, 48, 64, 128, 256, 512, 1024, 2048,
+	4096, 8192, 16384, 32768, 65536
+};
+
+static const uint8_t ll_bits[LL_MAX_SYMBOL + 1] = {
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	1, 1, 1, 1, 2, 2, 3, 3, 4, 6, 7, 8, 9, 10, 11, 12,
+	13, 14, 15, 16
+};
+
+static const uint32_t ml_base[ML_MAX_SYMBOL + 1] = {
+	3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18,
+	19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34,
+	35, 37, 39, 41, 43, 47, 51, 59, 67, 83, 99, 131, 259, 515, 1027,
+	2051, 4099, 8195, 16387, 32771, 65539
+};
+
+static const uint8_t ml_bits[ML_MAX_SYMBOL + 1] = {
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	1, 1, 1, 1, 2, 2, 3, 3, 4, 4, 5, 7, 8, 9, 10, 11,
+	12, 13, 14, 15, 16
+};
+
+static inline uint32_t read_le16(const uint8_t *p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8);
+}
+
+static inline uint32_t read_le24(const uint8_t *p)
+{
+	return read_le16(p) | ((uint32_t)p[2] << 16);
+}
+
+static inline uint32_t read_le32(const uint8_t *p)
+{
+	return read_le24(p) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint64_t read_le64(const uint8_t *p)
+{
+	return (uint64_t)read_le32(p) | ((uint64_t)read_le32(p + 4) << 32);
+}
+
+/* Index of the highest bit set, v must not be 0 */
+static inline unsigned int highbit32(uint32_t v)
+{
+	return 31U - (unsigned int)__builtin_clz(v);
+}
+
+static inline uint64_t rotl64(uint64_t x, unsigned int r)
+{
+	return (x << r) | (x >> (64U - r));
+}
+
+static inline uint64_t xxh64_round(uint64_t acc, uint64_t in)
+{
+	return rotl64(acc + (in * XXH64_P2), 31U) * XXH64_P1;
+}
+
+static inline uint64_t xxh64_merge(uint64_t acc, uint64_t v)
+{
+	return ((acc ^ xxh64_round(0U, v)) * XXH64_P1) + XXH64_P4;
+}
+
+/* XXH64 with a zero seed, used by the content checksum */
+static uint64_t xxh64(const uint8_t *p, size_t len)
+{
+	const uint8_t *end = p + len;
+	uint64_t h, v1, v2, v3, v4;
+
+	if (len >= 32U) {
+		v1 = XXH64_P1 + XXH64_P2;
+		v2 = XXH64_P2;
+		v3 = 0U;
+		v4 = 0U - XXH64_P1;
+		do {
+			v1 = xxh64_round(v1, read_le64(p));
+			v2 = xxh64_round(v2, read_le64(p + 8));
+			v3 = xxh64_round(v3, read_le64(p + 16));
+			v4 = xxh64_round(v4, read_le64(p + 24));
+			p += 32;
+		} while ((size_t)(end - p) >= 32U);
+		h = rotl64(v1, 1U) + rotl64(v2, 7U) + rotl64(v3, 12U) +
+		    rotl64(v4, 18U);
+		h = xxh64_merge(h, v1);
+		h = xxh64_merge(h, v2);
+		h = xxh64_merge(h, v3);
+		h = xxh64_merge(h, v4);
+	} else {
+		h = XXH64_P5;
+	}
+
+	h += (uint64_t)len;
+
+	while ((size_t)(end - p) >= 8U) {
+		h ^= xxh64_round(0U, read_le64(p));
+		h = (rotl64(h, 27U) * XXH64_P1) + XXH64_P4;
+		p += 8;
+	}
+
+	if ((size_t)(end - p) >= 4U) {
+		h ^= (uint64_t)read_le32(p) * XXH64_P1;
+		h = (rotl64(h, 23U) * XXH64_P2) + XXH64_P3;
+		p += 4;
+	}
+
+	while (p < end) {
+		h ^= *p * XXH64_P5;
+		h = rotl64(h, 11U) * XXH64_P1;
+		p++;
+	}
+
+	h ^= h >> 33;
+	h *= XXH64_P2;
+	h ^= h >> 29;
+	h *= XXH64_P3;
+	h ^= h >> 32;
+
+	return h;
+}
+
+static inline void br_refill(bitrev_t *br)
+{
+	while ((br->avail <= 56U) && (br->ptr > br->start)) {
+		br->bits = (br->bits << 8) | *--br->ptr;
+		br->avail += 8U;
+	}
+}
+
+/* The stream ends with a 1 bit marking where its content ends */
+static int br_init(bitrev_t *br, const uint8_t *src, size_t len)
+{
+	if ((len == 0U) || (src[len - 1U] == 0U)) {
+		return -EIO;
+	}
+
+	br->start = src;
+	br->ptr = src + len;
+	br->bits = 0U;
+	br->avail = 0U;
+	br->overflow = false;
+	br_refill(br);
+	br->avail -= 8U - highbit32(src[len - 1U]);
+
+	return 0;
+}
+
+/* Look at the next n bits (n <= 56), padding with zeros past the start */
+static inline uint64_t br_peek(bitrev_t *br, unsigned int n)
+{
+	if (br->avail < n) {
+		br_refill(br);
+		if (br->avail < n) {
+			return (br->bits & ((1ULL << br->avail) - 1U)) <<
+			       (n - br->avail);
+		}
+	}
+
+	return (br->bits >> (br->avail - n)) & ((1ULL << n) - 1U);
+}
+
+static inline void br_skip(bitrev_t *br, unsigned int n)
+{
+	if (br->avail < n) {
+		br->overflow = true;
+		br->avail = 0U;
+	} else {
+		br->avail -= n;
+	}
+}
+
+static inline uint64_t br_read(bitrev_t *br, unsigned int n)
+{
+	uint64_t v = br_peek(br, n);
+
+	br_skip(br, n);
+
+	return v;
+}
+
+/* Whether all the bits of the stream have been read, and no more */
+static inline bool br_done(const bitrev_t *br)
+{
+	return !br->overflow && (br->avail == 0U) && (br->ptr == br->start);
+}
+
+/* Read 25 bits from bit position pos of a forward bitstream */
+static inline uint32_t fwd_peek(const uint8_t *src, size_t len, size_t pos)
+{
+	size_t i, byte = pos / 8U;
+	uint32_t v = 0U;
+
+	for (i = 0U; (i < 4U) && ((byte + i) < len); i++) {
+		v |= (uint32_t)src[byte + i] << (8U * i);
+	}
+
+	return v >> (pos % 8U);
+}
+
+/*
+ * Read an FSE table description (normalized symbol probabilities). Returns
+ * the number of bytes used, or a negative error.
+ */
+static int fse_read_ncount(const uint8_t *src, size_t len, int16_t *norm,
+			   unsigned int max_symbol, unsigned int max_log,
+			   unsigned int *log)
+{
+	int remaining, threshold, max, count;
+	unsigned int nb_bits, sym = 0U, rep, i;
+	size_t pos = 0U;
+	uint32_t v;
+
+	*log = (fwd_peek(src, len, pos) & 0xFU) + 5U;
+	pos += 4U;
+	if (*log > max_log) {
+		return -EIO;
+	}
+
+	remaining = (1 << *log) + 1;
+	threshold = 1 << *log;
+	nb_bits = *log + 1U;
+
+	while (remaining > 1) {
+		if (sym > max_symbol) {
+			return -EIO;
+		}
+
+		v = fwd_peek(src, len, pos);
+		max = (2 * threshold - 1) - remaining;
+		if ((int)(v & (uint32_t)(threshold - 1)) < max) {
+			count = (int)(v & (uint32_t)(threshold - 1));
+			pos += nb_bits - 1U;
+		} else {
+			count = (int)(v & (uint32_t)(2 * threshold - 1));
+			if (count >= threshold) {
+				count -= max;
+			}
+			pos += nb_bits;
+		}
+
+		/* Probability, where -1 means "less than 1" */
+		count--;
+		remaining -= (count < 0) ? -count : count;
+		norm[sym++] = (int16_t)count;
+
+		if (count == 0) {
+			/* Repeat flags for following symbols of probability 0 */
+			do {
+				rep = fwd_peek(src, len, pos) & 0x3U;
+				pos += 2U;
+				if ((sym + rep) > (max_symbol + 1U)) {
+					return -EIO;
+				}
+				for (i = 0U; i < rep; i++) {
+					norm[sym++] = 0;
+				}
+			} while (rep == 3U);
+		}
+
+		if (remaining < 1) {
+			return -EIO;
+		}
+		while (remaining < threshold) {
+			nb_bits--;
+			threshold >>= 1;
+		}
+	}
+
+	if ((remaining != 1) || (((pos + 7U) / 8U) > len)) {
+		return -EIO;
+	}
+
+	while (sym <= max_symbol) {
+		norm[sym++] = 0;
+	}
+
+	return (int)((pos + 7U) / 8U);
+}
+
+/* Build an FSE decoding table from normalized probabilities */
+static void fse_build(fse_table_t *table, const int16_t *norm,
+		      unsigned int max_symbol, unsigned int log)
+{
+	fse_entry_t *e = table->entries;
+	uint16_t next[ML_MAX_SYMBOL + 1];
+	uint32_t size = 1U << log;
+	uint32_t high = size - 1U;
+	uint32_t step = (size >> 1) + (size >> 3) + 3U;
+	uint32_t mask = size - 1U;
+	uint32_t pos = 0U, u, state;
+	unsigned int s;
+	int i;
+
+	/* Symbols of probability "less than 1" take the last cells */
+	for (s = 0U; s <= max_symbol; s++) {
+		if (norm[s] == -1) {
+			e[high--].symbol = (uint8_t)s;
+			next[s] = 1U;
+		} else {
+			next[s] = (uint16_t)norm[s];
+		}
+	}
+
+	for (s = 0U; s <= max_symbol; s++) {
+		for (i = 0; i < norm[s]; i++) {
+			e[pos].symbol = (uint8_t)s;
+			do {
+				pos = (pos + step) & mask;
+			} while (pos > high);
+		}
+	}
+
+	for (u = 0U; u < size; u++) {
+		state = next[e[u].symbol]++;
+		e[u].nb_bits = (uint8_t)(log - highbit32(state));
+		e[u].new_state = (uint16_t)((state << e[u].nb_bits) - size);
+	}
+
+	table->log = log;
+	table->valid = true;
+}
+
+/* Table of a single symbol, for the RLE mode */
+static void fse_build_rle(fse_table_t *table, uint8_t symbol)
+{
+	table->entries[0].symbol = symbol;
+	table->entries[0].nb_bits = 0U;
+	table->entries[0].new_state = 0U;
+	table->log = 0U;
+	table->valid = true;
+}
+
+static inline uint8_t fse_symbol(const fse_table_t *table, uint32_t state)
+{
+	return table->entries[state].symbol;
+}
+
+static inline uint32_t fse_update(const fse_table_t *table, uint32_t state,
+				  bitrev_t *br)
+{
+	const fse_entry_t *e = &table->entries[state];
+
+	return e->new_state + (uint32_t)br_read(br, e->nb_bits);
+}
+
+/*
+ * Read the Huffman tree description and build the decoding table. Returns the
+ * number of bytes used, or a negative error.
+ */
+static int huf_read_table(zstd_frame_t *zf, const uint8_t *src, size_t len)
+{
+	uint8_t weights[HUF_MAX_WEIGHTS + 1U];
+	uint32_t rank_start[HUF_MAX_BITS + 2U] = { 0U };
+	uint32_t rank_count[HUF_MAX_BITS + 2U] = { 0U };
+	int16_t norm[HUF_MAX_BITS + 1U];
+	fse_table_t table = { zf->work->weights, 0U, false };
+	huf_entry_t *huf = zf->work->huf;
+	unsigned int n = 0U, i, log, max_bits, w;
+	uint32_t total = 0U, rest, s1, s2, pos, u, count;
+	bitrev_t br;
+	size_t used;
+	int ret;
+
+	if (len < 1U) {
+		return -EIO;
+	}
+
+	if (src[0] < 128U) {
+		/* Weights compressed with FSE, using two interleaved states */
+		used = 1U + src[0];
+		if (used > len) {
+			return -EIO;
+		}
+		ret = fse_read_ncount(src + 1, src[0], norm, HUF_MAX_BITS,
+				      HUF_WEIGHT_MAX_LOG, &log);
+		if (ret < 0) {
+			return ret;
+		}
+		fse_build(&table, norm, HUF_MAX_BITS, log);
+		if (br_init(&br, src + 1 + ret, src[0] - (size_t)ret) != 0) {
+			return -EIO;
+		}
+
+		s1 = (uint32_t)br_read(&br, log);
+		s2 = (uint32_t)br_read(&br, log);
+		while (true) {
+			if (n > (HUF_MAX_WEIGHTS - 2U)) {
+				return -EIO;
+			}
+			weights[n++] = fse_symbol(&table, s1);
+			s1 = fse_update(&table, s1, &br);
+			if (br.overflow) {
+				weights[n++] = fse_symbol(&table, s2);
+				break;
+			}
+			weights[n++] = fse_symbol(&table, s2);
+			s2 = fse_update(&table, s2, &br);
+			if (br.overflow) {
+				weights[n++] = fse_symbol(&table, s1);
+				break;
+			}
+		}
+	} else {
+		/* Weights stored as 4-bit values */
+		n = src[0] - 127U;
+		used = 1U + ((n + 1U) / 2U);
+		if (used > len) {
+			return -EIO;
+		}
+		for (i = 0U; i < n; i++) {
+			w = src[1U + (i / 2U)];
+			weights[i] = (uint8_t)(((i % 2U) == 0U) ? (w >> 4) :
+						(w & 0xFU));
+		}
+	}
+
+	for (i = 0U; i < n; i++) {
+		if (weights[i] > HUF_MAX_BITS) {
+			return -EIO;
+		}
+		rank_count[weights[i]]++;
+		total += (1U << weights[i]) >> 1;
+	}
+	if (total == 0U) {
+		return -EIO;
+	}
+
+	/* The weight of the last symbol completes the total to a power of 2 */
+	max_bits = highbit32(total) + 1U;
+	if (max_bits > HUF_MAX_BITS) {
+		return -EIO;
+	}
+	rest = (1U << max_bits) - total;
+	if ((rest & (rest - 1U)) != 0U) {
+		return -EIO;
+	}
+	weights[n] = (uint8_t)(highbit32(rest) + 1U);
+	rank_count[weights[n]]++;
+	n++;
+
+	/* A valid tree has an even number, at least 2, of longest codes */
+	if ((rank_count[1] < 2U) || ((rank_count[1] & 1U) != 0U)) {
+		return -EIO;
+	}
+
+	/* Codes are assigned by increasing weight, then by symbol order */
+	pos = 0U;
+	for (w = 1U; w <= max_bits; w++) {
+		rank_start[w] = pos;
+		pos += rank_count[w] << (w - 1U);
+	}
+
+	for (i = 0U; i < n; i++) {
+		w = weights[i];
+		if (w == 0U) {
+			continue;
+		}
+		count = 1U << (w - 1U);
+		for (u = rank_start[w]; u < (rank_start[w] + count); u++) {
+			huf[u].symbol = (uint8_t)i;
+			huf[u].nb_bits = (uint8_t)(max_bits + 1U - w);
+		}
+		rank_start[w] += count;
+	}
+
+	zf->huf_bits = max_bits;
+
+	return (int)used;
+}
+
+/* Decode one Huffman-coded stream of literals */
+static int huf_decode_stream(const zstd_frame_t *zf, const uint8_t *src,
+			     size_t len, uint8_t *dst, size_t dst_len)
+{
+	const huf_entry_t *huf = zf->work->huf;
+	const huf_entry_t *e;
+	unsigned int bits = zf->huf_bits;
+	bitrev_t br;
+	size_t i;
+
+	if (br_init(&br, src, len) != 0) {
+		return -EIO;
+	}
+
+	for (i = 0U; i < dst_len; i++) {
+		e = &huf[br_peek(&br, bits)];
+		dst[i] = e->symbol;
+		br_skip(&br, e->nb_bits);
+	}
+
+	return br_done(&br) ? 0 : -EIO;
+}
+
+/*
+ * Decode the literals section of a compressed block. Returns the number of
+ * bytes used, or a negative error.
+ */
+static int zstd_decode_literals(zstd_frame_t *zf, const uint8_t *src,
+				size_t len, const uint8_t **lit,
+				size_t *lit_len)
+{
+	unsigned int type = src[0] & 0x3U;
+	unsigned int format = (src[0] >> 2) & 0x3U;
+	size_t hdr_len, regen, comp, total, seg, sizes[4];
+	uint8_t *dst = zf->work->literals;
+	bool four_streams;
+	uint64_t hdr;
+	int ret, i;
+
+	if ((type == ZSTD_LIT_RAW) || (type == ZSTD_LIT_RLE)) {
+		switch (format) {
+		case 1U:
+			hdr_len = 2U;
+			break;
+		case 3U:
+			hdr_len = 3U;
+			break;
+		default:
+			hdr_len = 1U;
+			break;
+		}
+		if (len < hdr_len) {
+			return -EIO;
+		}
+		if (hdr_len == 1U) {
+			regen = src[0] >> 3;
+		} else if (hdr_len == 2U) {
+			regen = read_le16(src) >> 4;
+		} else {
+			regen = read_le24(src) >> 4;
+		}
+		if (regen > ZSTD_BLOCK_SIZE_MAX) {
+			return -EIO;
+		}
+
+		*lit_len = regen;
+		if (type == ZSTD_LIT_RAW) {
+			/* Used straight from the input */
+			if ((len - hdr_len) < regen) {
+				return -EIO;
+			}
+			*lit = src + hdr_len;
+			return (int)(hdr_len + regen);
+		}
+
+		if ((len - hdr_len) < 1U) {
+			return -EIO;
+		}
+		memset(dst, src[hdr_len], regen);
+		*lit = dst;
+		return (int)(hdr_len + 1U);
+	}
+
+	/* Huffman-coded literals */
+	hdr_len = (format <= 1U) ? 3U : (format + 2U);
+	if (len < hdr_len) {
+		return -EIO;
+	}
+	hdr = read_le32(src);
+	if (hdr_len == 5U) {
+		hdr |= (uint64_t)src[4] << 32;
+	}
+	four_streams = (format != 0U);
+	switch (hdr_len) {
+	case 3U:
+		regen = (hdr >> 4) & 0x3FFU;
+		comp = (hdr >> 14) & 0x3FFU;
+		break;
+	case 4U:
+		regen = (hdr >> 4) & 0x3FFFU;
+		comp = (hdr >> 18) & 0x3FFFU;
+		break;
+	default:
+		regen = (hdr >> 4) & 0x3FFFFU;
+		comp = (hdr >> 22) & 0x3FFFFU;
+		break;
+	}
+	if ((regen > ZSTD_BLOCK_SIZE_MAX) || (comp > (len - hdr_len))) {
+		return -EIO;
+	}
+	total = hdr_len + comp;
+	src += hdr_len;
+
+	if (type == ZSTD_LIT_COMPRESSED) {
+		ret = huf_read_table(zf, src, comp);
+		if (ret < 0) {
+			return ret;
+		}
+		src += ret;
+		comp -= (size_t)ret;
+	} else if (zf->huf_bits == 0U) {
+		return -EIO;
+	}
+
+	if (!four_streams) {
+		ret = huf_decode_stream(zf, src, comp, dst, regen);
+	} else {
+		/* Jump table with the sizes of the first three streams */
+		if (comp < 6U) {
+			return -EIO;
+		}
+		sizes[0] = read_le16(src);
+		sizes[1] = read_le16(src + 2);
+		sizes[2] = read_le16(src + 4);
+		if ((sizes[0] + sizes[1] + sizes[2]) > (comp - 6U)) {
+			return -EIO;
+		}
+		sizes[3] = comp - 6U - sizes[0] - sizes[1] - sizes[2];
+		src += 6;
+
+		seg = (regen + 3U) / 4U;
+		if ((3U * seg) > regen) {
+			return -EIO;
+		}
+		ret = 0;
+		for (i = 0; (i < 4) && (ret == 0); i++) {
+			ret = huf_decode_stream(zf, src, sizes[i],
+						dst + (i * seg),
+						(i < 3) ? seg :
+						(regen - (3U * seg)));
+			src += sizes[i];
+		}
+	}
+	if (ret != 0) {
+		return ret;
+	}
+
+	*lit = dst;
+	*lit_len = regen;
+
+	return (int)total;
+}
+
+/*
+ * Read the decoding table of one sequence symbol type. Returns the number of
+ * bytes used, or a negative error.
+ */
+static int zstd_read_seq_table(fse_table_t *table, unsigned int mode,
+			       const uint8_t *src, size_t len,
+			       const int16_t *default_norm,
+			       unsigned int default_log,
+			       unsigned int max_symbol, unsigned int max_log)
+{
+	int16_t norm[ML_MAX_SYMBOL + 1];
+	unsigned int log;
+	int ret;
+
+	switch (mode) {
+	case ZSTD_MODE_PREDEFINED:
+		fse_build(table, default_norm, max_symbol, default_log);
+		return 0;
+	case ZSTD_MODE_RLE:
+		if ((len < 1U) || (src[0] > max_symbol)) {
+			return -EIO;
+		}
+		fse_build_rle(table, src[0]);
+		return 1;
+	case ZSTD_MODE_FSE:
+		ret = fse_read_ncount(src, len, norm, max_symbol, max_log,
+				      &log);
+		if (ret < 0) {
+			return ret;
+		}
+		fse_build(table, norm, max_symbol, log);
+		return ret;
+	default:
+		/* Repeat the table of the previous block */
+		return table->valid ? 0 : -EIO;
+	}
+}
+
+/* Copy a match, which may overlap the bytes it produces */
+static inline void zstd_copy_match(uint8_t *op, size_t offset, size_t len)
+{
+	const uint8_t *match = op - offset;
+
+	if (offset >= len) {
+		memcpy(op, match, len);
+	} else {
+		while (len-- != 0U) {
+			*op++ = *match++;
+		}
+	}
+}
+
+/* Decode the sequences section and execute the sequences */
+static int zstd_decode_sequences(zstd_frame_t *zf, const uint8_t *src,
+				 size_t len, const uint8_t *lit,
+				 size_t lit_len, uint8_t **op, uint8_t *oend)
+{
+	const uint8_t *end = src + len;
+	uint8_t *out = *op;
+	uint32_t nb_seq, ll_state, ml_state, of_state;
+	uint32_t ll_code, ml_code, of_code;
+	size_t ll, ml, offset, idx;
+	unsigned int modes;
+	bitrev_t br;
+	int ret;
+
+	if (len < 1U) {
+		return -EIO;
+	}
+
+	nb_seq = src[0];
+	if (nb_seq < 128U) {
+		src += 1;
+	} else if (nb_seq < 255U) {
+		if (len < 2U) {
+			return -EIO;
+		}
+		nb_seq = ((nb_seq - 128U) << 8) + src[1];
+		src += 2;
+	} else {
+		if (len < 3U) {
+			return -EIO;
+		}
+		nb_seq = read_le16(src + 1) + 0x7F00U;
+		src += 3;
+	}
+
+	if (nb_seq != 0U) {
+		if (src >= end) {
+			return -EIO;
+		}
+		modes = *src++;
+		if ((modes & 0x3U) != 0U) {
+			return -EIO;
+		}
+
+		ret = zstd_read_seq_table(&zf->ll, (modes >> 6) & 0x3U, src,
+					  end - src, ll_default_norm,
+					  LL_DEFAULT_LOG, LL_MAX_SYMBOL,
+					  LL_MAX_LOG);
+		if (ret < 0) {
+			return ret;
+		}
+		src += ret;
+
+		ret = zstd_read_seq_table(&zf->of, (modes >> 4) & 0x3U, src,
+					  end - src, of_default_norm,
+					  OF_DEFAULT_LOG, OF_MAX_SYMBOL,
+					  OF_MAX_LOG);
+		if (ret < 0) {
+			return ret;
+		}
+		src += ret;
+
+		ret = zstd_read_seq_table(&zf->ml, (modes >> 2) & 0x3U, src,
+					  end - src, ml_default_norm,
+					  ML_DEFAULT_LOG, ML_MAX_SYMBOL,
+					  ML_MAX_LOG);
+		if (ret < 0) {
+			return ret;
+		}
+		src += ret;
+
+		if (br_init(&br, src, end - src) != 0) {
+			return -EIO;
+		}
+		ll_state = (uint32_t)br_read(&br, zf->ll.log);
+		of_state = (uint32_t)br_read(&br, zf->of.log);
+		ml_state = (uint32_t)br_read(&br, zf->ml.log);
+
+		while (nb_seq-- != 0U) {
+			of_code = fse_symbol(&zf->of, of_state);
+			ll_code = fse_symbol(&zf->ll, ll_state);
+			ml_code = fse_symbol(&zf->ml, ml_state);
+
+			/* Extra bits: offset, match length, literals length */
+			offset = ((size_t)1U << of_code) +
+				 (size_t)br_read(&br, of_code);
+			ml = ml_base[ml_code] + (size_t)br_read(&br,
+							ml_bits[ml_code]);
+			ll = ll_base[ll_code] + (size_t)br_read(&br,
+							ll_bits[ll_code]);
+
+			if (offset > 3U) {
+				offset -= 3U;
+				zf->rep[2] = zf->rep[1];
+				zf->rep[1] = zf->rep[0];
+				zf->rep[0] = offset;
+			} else {
+				/* Repeat offset, shifted when there is no literal */
+				idx = offset - 1U + ((ll == 0U) ? 1U : 0U);
+				if (idx != 0U) {
+					offset = (idx == 3U) ? (zf->rep[0] - 1U) :
+						 zf->rep[idx];
+					if (idx > 1U) {
+						zf->rep[2] = zf->rep[1];
+					}
+					zf->rep[1] = zf->rep[0];
+					zf->rep[0] = offset;
+				} else {
+					offset = zf->rep[0];
+				}
+			}
+
+			if (nb_seq != 0U) {
+				ll_state = fse_update(&zf->ll, ll_state, &br);
+				ml_state = fse_update(&zf->ml, ml_state, &br);
+				of_state = fse_update(&zf->of, of_state, &br);
+			}
+
+			if ((ll > lit_len) ||
+			    ((ll + ml) > (size_t)(oend - out)) ||
+			    (offset == 0U) ||
+			    (offset > (size_t)(out + ll - zf->frame_start))) {
+				return -EIO;
+			}
+
+			memcpy(out, lit, ll);
+			out += ll;
+			lit += ll;
+			lit_len -= ll;
+
+			zstd_copy_match(out, offset, ml);
+			out += ml;
+		}
+
+		if (!br_done(&br)) {
+			return -EIO;
+		}
+	} else if (src != end) {
+		return -EIO;
+	}
+
+	/* Literals left after the last sequence */
+	if (lit_len > (size_t)(oend - out)) {
+		return -EIO;
+	}
+	memcpy(out, lit, lit_len);
+	out += lit_len;
+
+	*op = out;
+
+	return 0;
+}
+
+static int zstd_decode_block(zstd_frame_t *zf, const uint8_t *src, size_t len,
+			     uint8_t **op, uint8_t *oend)
+{
+	const uint8_t *lit = NULL;
+	size_t lit_len = 0U;
+	int ret;
+
+	if (len < 1U) {
+		return -EIO;
+	}
+
+	ret = zstd_decode_literals(zf, src, len, &lit, &lit_len);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return zstd_decode_sequences(zf, src + ret, len - (size_t)ret, lit,
+				     lit_len, op, oend);
+}
+
+/* Decode a Zstandard frame, whose magic has been consumed */
+static int zstd_decode_frame(zstd_frame_t *zf, const uint8_t **ipp,
+			     const uint8_t *iend, uint8_t **op, uint8_t *oend)
+{
+	const uint8_t *ip = *ipp;
+	uint32_t block_hdr, block_type, block_size;
+	unsigned int fhd, fcs_flag, dict_size, fcs_size;
+	uint64_t fcs = 0U;
+	bool last = false;
+	unsigned int i;
+	int ret;
+
+	if (ip >= iend) {
+		return -EIO;
+	}
+	fhd = *ip++;
+	if ((fhd & ZSTD_FHD_RESERVED) != 0U) {
+		return -EIO;
+	}
+
+	/* The window size is not needed, the whole output is addressable */
+	if ((fhd & ZSTD_FHD_SINGLE_SEGMENT) == 0U) {
+		ip++;
+	}
+
+	dict_size = (1U << (fhd & ZSTD_FHD_DICT_ID_MASK)) >> 1;
+	fcs_flag = fhd >> ZSTD_FHD_FCS_SHIFT;
+	if (fcs_flag != 0U) {
+		fcs_size = 1U << fcs_flag;
+	} else {
+		fcs_size = ((fhd & ZSTD_FHD_SINGLE_SEGMENT) != 0U) ? 1U : 0U;
+	}
+	if ((size_t)(iend - ip) < (dict_size + fcs_size)) {
+		return -EIO;
+	}
+
+	for (i = 0U; i < dict_size; i++) {
+		if (ip[i] != 0U) {
+			ERROR("zstd: dictionaries are not supported\n");
+			return -EIO;
+		}
+	}
+	ip += dict_size;
+
+	for (i = 0U; i < fcs_size; i++) {
+		fcs |= (uint64_t)ip[i] << (8U * i);
+	}
+	if (fcs_size == 2U) {
+		fcs += 256U;
+	}
+	ip += fcs_size;
+
+	zf->frame_start = *op;
+	zf->huf_bits = 0U;
+	zf->ll.valid = false;
+	zf->ml.valid = false;
+	zf->of.valid = false;
+	zf->rep[0] = 1U;
+	zf->rep[1] = 4U;
+	zf->rep[2] = 8U;
+
+	while (!last) {
+		if ((iend - ip) < 3) {
+			return -EIO;
+		}
+		block_hdr = read_le24(ip);
+		ip += 3;
+		last = (block_hdr & 0x1U) != 0U;
+		block_type = (block_hdr >> 1) & 0x3U;
+		block_size = block_hdr >> 3;
+
+		if (block_size > ZSTD_BLOCK_SIZE_MAX) {
+			return -EIO;
+		}
+
+		switch (block_type) {
+		case ZSTD_BLOCK_RAW:
+			if ((block_size > (size_t)(iend - ip)) ||
+			    (block_size > (size_t)(oend - *op))) {
+				return -EIO;
+			}
+			memcpy(*op, ip, block_size);
+			*op += block_size;
+			ip += block_size;
+			break;
+		case ZSTD_BLOCK_RLE:
+			if ((ip >= iend) ||
+			    (block_size > (size_t)(oend - *op))) {
+				return -EIO;
+			}
+			memset(*op, *ip, block_size);
+			*op += block_size;
+			ip++;
+			break;
+		case ZSTD_BLOCK_COMPRESSED:
+			if (block_size > (size_t)(iend - ip)) {
+				return -EIO;
+			}
+			ret = zstd_decode_block(zf, ip, block_size, op, oend);
+			if (ret != 0) {
+				return ret;
+			}
+			ip += block_size;
+			break;
+		default:
+			return -EIO;
+		}
+	}
+
+	if ((fcs_size != 0U) && (fcs != (uint64_t)(*op - zf->frame_start))) {
+		ERROR("zstd: content size mismatch\n");
+		return -EIO;
+	}
+
+	if ((fhd & ZSTD_FHD_CHECKSUM) != 0U) {
+		if ((iend - ip) < 4) {
+			return -EIO;
+		}
+		if ((uint32_t)xxh64(zf->frame_start, *op - zf->frame_start) !=
+		    read_le32(ip)) {
+			ERROR("zstd: content checksum mismatch\n");
+			return -EIO;
+		}
+		ip += 4;
+	}
+
+	*ipp = ip;
+
+	return 0;
+}
+
+/*
+ * unzstd - decompress Zstandard data
+ * @in_buf: source of compressed input. Upon exit, the end of input.
+ * @in_len: length of in_buf
+ * @out_buf: destination of decompressed output. Upon exit, the end of output.
+ * @out_len: length of out_buf
+ * @work_buf: workspace, of at least UNZSTD_WORK_SIZE bytes
+ * @work_len: length of workspace
+ *
+ * The input can hold several frames, which are decoded one after another.
+ */
+int unzstd(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
+	   size_t out_len, uintptr_t work_buf, size_t work_len)
+{
+	const uint8_t *ip = (const uint8_t *)*in_buf;
+	const uint8_t *iend = ip + in_len;
+	uint8_t *op = (uint8_t *)*out_buf;
+	uint8_t *oend = op + out_len;
+	uintptr_t work = (work_buf + 7U) & ~(uintptr_t)7U;
+	zstd_frame_t zf;
+	uint32_t magic, skip;
+	int ret = 0;
+
+	if ((work - work_buf + sizeof(struct zstd_work)) > work_len) {
+		ERROR("zstd: workspace too small\n");
+		return -ENOMEM;
+	}
+
+	if ((in_len < 4U) || (read_le32(ip) != ZSTD_MAGIC)) {
+		ERROR("zstd: not a Zstandard image\n");
+		return -EIO;
+	}
+
+	zf.work = (struct zstd_work *)work;
+	zf.ll.entries = zf.work->ll;
+	zf.ml.entries = zf.work->ml;
+	zf.of.entries = zf.work->of;
+
+	while ((ret == 0) && ((iend - ip) >= 4)) {
+		magic = read_le32(ip);
+		ip += 4;
+
+		if (magic == ZSTD_MAGIC) {
+			ret = zstd_decode_frame(&zf, &ip, iend, &op, oend);
+		} else if ((magic & ZSTD_SKIP_MAGIC_MASK) == ZSTD_SKIP_MAGIC) {
+			if ((iend - ip) < 4) {
+				ret = -EIO;
+				break;
+			}
+			skip = read_le32(ip);
+			ip += 4;
+			if (skip > (size_t)(iend - ip)) {
+				ret = -EIO;
+				break;
+			}
+			ip += skip;
+		} else {
+			/* Trailing data, e.g. padding added after the image */
+			ip -= 4;
+			break;
+		}
+	}
+
+	if (ret != 0) {
+		ERROR("zstd: corrupted input\n");
+	}
+
+	VERBOSE("zstd: %lu byte input\n", (unsigned long)(ip - iend + in_len));
+	VERBOSE("zstd: %lu byte output\n", (unsigned long)(op - oend + out_len));
+
+	*in_buf = (uintptr_t)ip;
+	*out_buf = (uintptr_t)op;
+
+	return ret;
+}
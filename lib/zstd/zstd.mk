@@ -0,0 +1,12 @@
+#
+# Copyright 2026 NXP
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+
+ZSTD_PATH	:=	lib/zstd
+
+ZSTD_SOURCES	:=	$(addprefix $(ZSTD_PATH)/,	\
+					unzstd.c)
+
+INCLUDES	+=	-Iinclude/lib/zstd
@@ -143,6 +143,10 @@ GENERATE_COT			:= 0
 # default, they are for Secure EL1.
 GICV2_G0_FOR_EL3		:= 0
 
+# Alignment in bytes of the locks of the GPT L1 tables, so that each lock has
+# a cache writeback granule of its own
+GPT_L1_LOCK_ALIGN		:= 64
+
 # Route NS External Aborts to EL3. Disabled by default; External Aborts are handled
 # by lower ELs.
 HANDLE_EA_EL3_FIRST_NS		:= 0
@@ -150,6 +154,9 @@ HANDLE_EA_EL3_FIRST_NS		:= 0
 # Enable Handoff protocol using transfer lists
 TRANSFER_LIST			:= 0
 
+# Keep a lookup index of transfer list entries by tag
+TRANSFER_LIST_INDEX		:= 0
+
 # Secure hash algorithm flag, accepts 3 values: sha256, sha384 and sha512.
 # The default value is sha256.
 HASH_ALG			:= sha256
@@ -9,6 +9,7 @@
 #include <common/debug.h>
 #include <common/desc_image_load.h>
 #include <drivers/arm/sp804_delay_timer.h>
+#include <drivers/partition/partition.h>
 #include <lib/fconf/fconf.h>
 #include <lib/fconf/fconf_dyn_cfg_getter.h>
 #include <lib/transfer_list.h>
@@ -36,6 +37,10 @@ void bl2_platform_setup(void)
 #if TRANSFER_LIST
 	ns_tl = transfer_list_init((void *)FW_NS_HANDOFF_BASE, FW_HANDOFF_SIZE);
 	assert(ns_tl != NULL);
+#if ARM_GPT_SUPPORT
+	/* Spare BL33 from parsing the GPT again, a failure is not fatal */
+	(void)partition_list_to_tl(ns_tl);
+#endif /* ARM_GPT_SUPPORT */
 #endif
 	/* Initialize System level generic or SP804 timer */
 	fvp_timer_init();
@@ -26,6 +26,7 @@
 #pragma weak bl2_plat_handle_post_image_load
 #pragma weak plat_try_next_boot_source
 #pragma weak plat_get_enc_key_info
+#pragma weak plat_get_dec_ops
 #pragma weak plat_is_smccc_feature_available
 #pragma weak plat_get_soc_version
 #pragma weak plat_get_soc_revision
@@ -99,6 +100,15 @@ int plat_get_enc_key_info(enum fw_enc_status_t fw_enc_status, uint8_t *key,
 	return 0;
 }
 
+/*
+ * Weak implementation: there is no crypto engine, so chunked decryption is
+ * done by the crypto library, if it supports it.
+ */
+const struct crypto_dec_ops_s *plat_get_dec_ops(void)
+{
+	return NULL;
+}
+
 /*
  * Set up the page tables for the generic and platform-specific memory regions.
  * The size of the Trusted SRAM seen by the BL image must be specified as well
@@ -30,18 +30,26 @@ static const io_block_spec_t mmc_fip_spec = {
 	.length = IMX_FIP_SIZE
 };
 
+/*
+ * The first half of the FIP area is used as temp buffer in block driver, the
+ * second one to read the next blocks ahead while the current ones are copied.
+ */
+#define IMX_MMC_BUF_SIZE	(IMX_FIP_SIZE / 2U)
+#define IMX_MMC_RA_BASE		(IMX_FIP_BASE + IMX_MMC_BUF_SIZE)
+
 static const io_block_dev_spec_t mmc_dev_spec = {
-	/* It's used as temp buffer in block driver. */
 	.buffer		= {
 		.offset	= IMX_FIP_BASE,
-		/* do we need a new value? */
-		.length = IMX_FIP_SIZE
+		.length = IMX_MMC_BUF_SIZE
 	},
 	.ops		= {
 		.read	= mmc_read_blocks,
 		.write	= mmc_write_blocks,
+		.read_limit = mmc_read_ahead_limit,
+		.flush	= mmc_read_ahead_flush,
 	},
 	.block_size	= MMC_BLOCK_SIZE,
+	.flags		= IO_BLOCK_FLAG_DIRECT_READ,
 };
 
 static int open_mmc(const uintptr_t spec);
@@ -283,6 +291,8 @@ void plat_imx_io_setup(void)
 			     &mmc_dev_handle);
 	assert(result == 0);
 
+	mmc_read_ahead_init(IMX_MMC_RA_BASE, IMX_MMC_BUF_SIZE);
+
 #else
 	result = register_io_dev_memmap(&memmap_dev_con);
 	assert(result == 0);
@@ -0,0 +1,45 @@
+/*
+ * Copyright 2023 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdint.h>
+
+#include <arch_helpers.h>
+#include <common/debug.h>
+
+#include <imx_pm_steps.h>
+
+void imx_pm_run_steps(const struct imx_pm_step *steps, unsigned int num,
+		      unsigned int core_id)
+{
+	unsigned int i;
+#if IMX_PM_STEP_TIMING
+	uint64_t ticks_per_us = read_cntfrq_el0() / 1000000U;
+	uint64_t start, total = 0U;
+
+	if (ticks_per_us == 0U) {
+		ticks_per_us = 1U;
+	}
+#endif
+
+	for (i = 0U; i < num; i++) {
+#if IMX_PM_STEP_TIMING
+		start = read_cntpct_el0();
+		steps[i].run(core_id);
+		start = read_cntpct_el0() - start;
+		total += start;
+
+		NOTICE("pm step %s: %llu us\n", steps[i].name,
+		       (unsigned long long)(start / ticks_per_us));
+#else
+		steps[i].run(core_id);
+#endif
+	}
+
+#if IMX_PM_STEP_TIMING
+	NOTICE("pm steps total %llu us\n",
+	       (unsigned long long)(total / ticks_per_us));
+#endif
+}
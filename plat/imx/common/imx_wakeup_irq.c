@@ -0,0 +1,99 @@
+/*
+ * Copyright 2023 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <arch_helpers.h>
+#include <common/debug.h>
+#include <common/runtime_svc.h>
+#include <drivers/arm/gic_common.h>
+#include <lib/mmio.h>
+#include <lib/spinlock.h>
+
+#include <imx_pm_steps.h>
+#include <imx_sip_svc.h>
+#include <imx_wakeup_irq.h>
+
+/*
+ * Wakeup irqs registered by the OS through the IMX_SIP_GPC SET_WAKE call,
+ * one bit per SPI. Once the OS has used the call, the GPC IMRs are built
+ * from this bitmap on suspend instead of scanning the GIC enable state.
+ */
+static uint32_t wakeup_irqs[IMX_WAKEUP_IMR_MAX];
+static bool wakeup_irqs_tracked;
+static spinlock_t wakeup_irqs_lock;
+
+void imx_wakeup_irq_set(unsigned int hwirq, bool on)
+{
+	uint32_t mask = BIT_32(hwirq % 32U);
+	unsigned int idx = hwirq / 32U;
+
+	if (idx >= IMX_WAKEUP_IMR_MAX) {
+		return;
+	}
+
+	spin_lock(&wakeup_irqs_lock);
+	if (on) {
+		wakeup_irqs[idx] |= mask;
+	} else {
+		wakeup_irqs[idx] &= ~mask;
+	}
+	wakeup_irqs_tracked = true;
+	spin_unlock(&wakeup_irqs_lock);
+}
+
+/*
+ * Fill irq_mask with the GPC IMR values for system suspend: a set bit masks
+ * the irq. Falls back to the GIC SPI enable state if the OS never registered
+ * its wakeup irqs.
+ */
+void imx_wakeup_irq_mask(uintptr_t gicd_base, uint32_t *irq_mask,
+			 unsigned int num)
+{
+	unsigned int i;
+#if IMX_PM_STEP_TIMING
+	uint64_t start = read_cntpct_el0();
+#endif
+
+	if (num > IMX_WAKEUP_IMR_MAX) {
+		num = IMX_WAKEUP_IMR_MAX;
+	}
+
+	if (wakeup_irqs_tracked) {
+		for (i = 0U; i < num; i++) {
+			irq_mask[i] = ~wakeup_irqs[i];
+		}
+	} else {
+		/* SPI 32 * (i + 1) is the first irq of IMR word i */
+		for (i = 0U; i < num; i++) {
+			irq_mask[i] = ~mmio_read_32(gicd_base + GICD_ISENABLER +
+						    ((i + 1U) << 2));
+		}
+	}
+
+#if IMX_PM_STEP_TIMING
+	NOTICE("wakeup mask (%s): %llu ticks\n",
+	       wakeup_irqs_tracked ? "bitmap" : "gic scan",
+	       (unsigned long long)(read_cntpct_el0() - start));
+#endif
+}
+
+#if defined(PLAT_imx93) || defined(PLAT_imx95)
+int imx_gpc_handler(uint32_t smc_fid, u_register_t x1, u_register_t x2,
+		    u_register_t x3)
+{
+	switch (x1) {
+	case IMX_SIP_GPC_SET_WAKE:
+		imx_wakeup_irq_set(x2, x3 != 0U);
+		break;
+	default:
+		return SMC_UNK;
+	}
+
+	return 0;
+}
+#endif
@@ -0,0 +1,28 @@
+/*
+ * Copyright 2023 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef IMX_PM_STEPS_H
+#define IMX_PM_STEPS_H
+
+/* Report the duration of each power up/down step on the console */
+#ifndef IMX_PM_STEP_TIMING
+#define IMX_PM_STEP_TIMING	0
+#endif
+
+/*
+ * One step of a power domain up/down sequence. Steps that only kick off a
+ * hardware operation are followed by a separate step that waits for it, so
+ * the steps in between overlap with the hardware settle time.
+ */
+struct imx_pm_step {
+	const char *name;
+	void (*run)(unsigned int core_id);
+};
+
+void imx_pm_run_steps(const struct imx_pm_step *steps, unsigned int num,
+		      unsigned int core_id);
+
+#endif /* IMX_PM_STEPS_H */
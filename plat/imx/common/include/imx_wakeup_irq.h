@@ -0,0 +1,23 @@
+/*
+ * Copyright 2023 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef IMX_WAKEUP_IRQ_H
+#define IMX_WAKEUP_IRQ_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* sub-function of IMX_SIP_GPC, same id as used by the imx8mq gpc driver */
+#define IMX_SIP_GPC_SET_WAKE		U(0x02)
+
+/* max number of 32-bit IMR words covered by the wakeup bitmap */
+#define IMX_WAKEUP_IMR_MAX		U(12)
+
+void imx_wakeup_irq_set(unsigned int hwirq, bool on);
+void imx_wakeup_irq_mask(uintptr_t gicd_base, uint32_t *irq_mask,
+			 unsigned int num);
+
+#endif /* IMX_WAKEUP_IRQ_H */
@@ -27,6 +27,8 @@
 
 #define SC_RPC_MAX_MSG          8U
 
+#define SC_RPC_BATCH_MAX        8U
+
 #define RPC_VER(MESG)           ((MESG)->version)
 #define RPC_SIZE(MESG)          ((MESG)->size)
 #define RPC_SVC(MESG)           ((MESG)->svc)
@@ -122,6 +124,22 @@ typedef struct {
 	uint32_t timeStamp;
 } sc_rpc_async_msg_t;
 
+/*!
+ * Batch of RPC messages pipelined over a single IPC channel. Requests
+ * are sent in order and the SCU answers them in order, so responses
+ * are collected back into the same message slots.
+ */
+typedef struct {
+	sc_ipc_t ipc;
+	sc_rpc_msg_t msg[SC_RPC_BATCH_MAX];
+	sc_bool_t no_resp[SC_RPC_BATCH_MAX];
+	uint8_t count;		/* messages queued */
+	uint8_t sent;		/* messages written to the MU */
+	uint8_t done;		/* messages completed */
+	uint8_t rd_word;	/* words read of the current response */
+	uint8_t failed;		/* bitmap of messages rejected before sending */
+} sc_rpc_batch_t;
+
 /* Functions */
 
 /*!
@@ -137,4 +155,46 @@ typedef struct {
  */
 void sc_call_rpc(sc_ipc_t ipc, sc_rpc_msg_t *msg, sc_bool_t no_resp);
 
+/*!
+ * This function initializes an empty RPC batch.
+ *
+ * @param[out]    batch       batch to initialize
+ * @param[in]     ipc         IPC handle the batch is sent on
+ */
+void sc_rpc_batch_init(sc_rpc_batch_t *batch, sc_ipc_t ipc);
+
+/*!
+ * This function reserves the next message slot of a batch.
+ *
+ * @param[in,out] batch       batch to add the message to
+ * @param[in]     no_resp     response flag
+ *
+ * @return Returns a pointer to the message slot to fill in, or NULL if
+ *         the batch is full or has already been sent.
+ */
+sc_rpc_msg_t *sc_rpc_batch_add(sc_rpc_batch_t *batch, sc_bool_t no_resp);
+
+/*!
+ * This function sends a batch and waits for every message of it to
+ * complete. Messages are written to the MU as long as that cannot
+ * deadlock against unread responses, so the SCU handles the next
+ * request while the response to the previous one is read.
+ *
+ * @param[in,out] batch       batch to send
+ *
+ * @return Returns the first error code returned by the SCU for any
+ *         message in the batch (SC_ERR_NONE = success).
+ */
+sc_err_t sc_call_rpc_batch(sc_rpc_batch_t *batch);
+
+/*!
+ * This function returns the error code of one completed batch message.
+ *
+ * @param[in]     batch       completed batch
+ * @param[in]     idx         index of the message in the batch
+ *
+ * @return Returns the error code of the message (SC_ERR_NONE = success).
+ */
+sc_err_t sc_rpc_batch_err(const sc_rpc_batch_t *batch, uint8_t idx);
+
 #endif /* SCI_RPC_H */
@@ -24,6 +24,7 @@
 
 /* Includes */
 
+#include <sci/sci_rpc.h>
 #include <sci/sci_types.h>
 #include <sci/svc/rm/sci_rm_api.h>
 
@@ -868,6 +869,22 @@ sc_err_t sc_pm_resource_reset(sc_ipc_t ipc, sc_rsrc_t resource);
  */
 sc_bool_t sc_pm_is_partition_started(sc_ipc_t ipc, sc_rm_pt_t pt);
 
+/*!
+ * @name Batched RPC message builders
+ *
+ * These functions fill in an RPC message slot (see sc_rpc_batch_add())
+ * with the same request as the matching blocking function, so several
+ * PM requests can be pipelined to the SCU in one batch.
+ */
+/*@{*/
+void sc_pm_rpc_set_resource_power_mode(sc_rpc_msg_t *msg, sc_rsrc_t resource,
+				       sc_pm_power_mode_t mode);
+void sc_pm_rpc_req_low_power_mode(sc_rpc_msg_t *msg, sc_rsrc_t resource,
+				  sc_pm_power_mode_t mode);
+void sc_pm_rpc_cpu_start(sc_rpc_msg_t *msg, sc_rsrc_t resource,
+			 sc_bool_t enable, sc_faddr_t address);
+/*@}*/
+
 /* @} */
 
 #endif				/* SC_PM_API_H */
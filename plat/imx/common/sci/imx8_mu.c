@@ -51,6 +51,27 @@ void MU_SendMessage(uint32_t base, uint32_t regIndex, uint32_t msg)
 	mmio_write_32(base + MU_ATR0_OFFSET1 + (regIndex * 4), msg);
 }
 
+bool MU_IsTxEmpty(uint32_t base, uint32_t regIndex)
+{
+	uint32_t mask = MU_SR_TE0_MASK1 >> regIndex;
+
+	return (mmio_read_32(base + MU_ASR_OFFSET1) & mask) != 0U;
+}
+
+bool MU_IsAllTxEmpty(uint32_t base)
+{
+	uint32_t mask = MU_SR_TEn_MASK1;
+
+	return (mmio_read_32(base + MU_ASR_OFFSET1) & mask) == mask;
+}
+
+bool MU_IsRxFull(uint32_t base, uint32_t regIndex)
+{
+	uint32_t mask = MU_SR_RF0_MASK1 >> regIndex;
+
+	return (mmio_read_32(base + MU_ASR_OFFSET1) & mask) != 0U;
+}
+
 void MU_ReceiveMsg(uint32_t base, uint32_t regIndex, uint32_t *msg)
 {
 	uint32_t mask = MU_SR_RF0_MASK1 >> regIndex;
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #define MU_ATR0_OFFSET1		0x0
@@ -22,6 +23,7 @@
 
 #define MU_SR_TE0_MASK1		(1 << 23)
 #define MU_SR_RF0_MASK1		(1 << 27)
+#define MU_SR_TEn_MASK1		(0xF << 20)
 #define MU_CR_RIE0_MASK1	(1 << 27)
 #define MU_CR_GIE0_MASK1	(1U << 31)
 
@@ -31,6 +33,9 @@
 void MU_Init(uint32_t base);
 void MU_SendMessage(uint32_t base, uint32_t regIndex, uint32_t msg);
 void MU_ReceiveMsg(uint32_t base, uint32_t regIndex, uint32_t *msg);
+bool MU_IsTxEmpty(uint32_t base, uint32_t regIndex);
+bool MU_IsAllTxEmpty(uint32_t base);
+bool MU_IsRxFull(uint32_t base, uint32_t regIndex);
 void MU_EnableGeneralInt(uint32_t base, uint32_t index);
 void MU_EnableRxFullInt(uint32_t base, uint32_t index);
 void MU_Resume(uint32_t base);
@@ -31,6 +31,145 @@ void sc_call_rpc(sc_ipc_t ipc, sc_rpc_msg_t *msg, sc_bool_t no_resp)
 	sc_ipc_unlock();
 }
 
+void sc_rpc_batch_init(sc_rpc_batch_t *batch, sc_ipc_t ipc)
+{
+	batch->ipc = ipc;
+	batch->count = 0U;
+	batch->sent = 0U;
+	batch->done = 0U;
+	batch->rd_word = 0U;
+	batch->failed = 0U;
+}
+
+sc_rpc_msg_t *sc_rpc_batch_add(sc_rpc_batch_t *batch, sc_bool_t no_resp)
+{
+	if ((batch->count >= SC_RPC_BATCH_MAX) || (batch->sent != 0U))
+		return NULL;
+
+	batch->no_resp[batch->count] = no_resp;
+
+	return &batch->msg[batch->count++];
+}
+
+/* Complete the sent messages at the head of the batch that need no response */
+static void sc_rpc_batch_retire(sc_rpc_batch_t *batch)
+{
+	while ((batch->done < batch->sent) &&
+	       (batch->no_resp[batch->done] != SC_FALSE))
+		batch->done++;
+}
+
+static void sc_rpc_batch_tx(sc_rpc_batch_t *batch)
+{
+	uint32_t base = batch->ipc;
+	sc_rpc_msg_t *msg;
+
+	while (batch->sent < batch->count) {
+		msg = &batch->msg[batch->sent];
+
+		if ((batch->failed & (1U << batch->sent)) != 0U) {
+			batch->sent++;
+			continue;
+		}
+
+		/*
+		 * With no response outstanding the SCU drains the transmit
+		 * registers as we fill them, so a blocking write is safe.
+		 * Otherwise only queue a message that fits in the transmit
+		 * registers while they are all empty: blocking on a full one
+		 * while the SCU blocks on our unread receive registers would
+		 * deadlock.
+		 */
+		if ((batch->done < batch->sent) &&
+		    ((msg->size > MU_TR_COUNT) || !MU_IsAllTxEmpty(base)))
+			return;
+
+		sc_ipc_write(batch->ipc, msg);
+		batch->sent++;
+	}
+}
+
+static void sc_rpc_batch_rx(sc_rpc_batch_t *batch)
+{
+	uint32_t base = batch->ipc;
+	sc_rpc_msg_t *msg;
+	uint32_t idx;
+
+	sc_rpc_batch_retire(batch);
+
+	while (batch->done < batch->sent) {
+		msg = &batch->msg[batch->done];
+		idx = batch->rd_word % MU_RR_COUNT;
+
+		if (!MU_IsRxFull(base, idx))
+			return;
+
+		if (batch->rd_word == 0U) {
+			MU_ReceiveMsg(base, 0U, (uint32_t *) msg);
+			/* Same handling of a bad size as sc_ipc_read() */
+			if (msg->size > SC_RPC_MAX_MSG)
+				*((uint32_t *) msg) = 0;
+		} else {
+			MU_ReceiveMsg(base, idx,
+				&(msg->DATA.u32[batch->rd_word - 1U]));
+		}
+		batch->rd_word++;
+
+		if (batch->rd_word >= msg->size) {
+			batch->rd_word = 0U;
+			batch->done++;
+			sc_rpc_batch_retire(batch);
+		}
+	}
+}
+
+sc_err_t sc_call_rpc_batch(sc_rpc_batch_t *batch)
+{
+	sc_err_t err;
+	uint8_t i;
+
+	/* Messages the MU cannot carry complete at once with an IPC error */
+	for (i = 0U; i < batch->count; i++) {
+		if ((batch->msg[i].size == 0U) ||
+		    (batch->msg[i].size > SC_RPC_MAX_MSG)) {
+			batch->failed |= U8(1U << i);
+			batch->no_resp[i] = SC_TRUE;
+		}
+	}
+
+	sc_ipc_lock();
+
+	while (batch->done < batch->count) {
+		sc_rpc_batch_tx(batch);
+		sc_rpc_batch_retire(batch);
+		sc_rpc_batch_rx(batch);
+	}
+
+	sc_ipc_unlock();
+
+	for (i = 0U; i < batch->count; i++) {
+		err = sc_rpc_batch_err(batch, i);
+		if (err != SC_ERR_NONE)
+			return err;
+	}
+
+	return SC_ERR_NONE;
+}
+
+sc_err_t sc_rpc_batch_err(const sc_rpc_batch_t *batch, uint8_t idx)
+{
+	if (idx >= batch->count)
+		return SC_ERR_PARM;
+
+	if ((batch->failed & (1U << idx)) != 0U)
+		return SC_ERR_IPC;
+
+	if (batch->no_resp[idx] != SC_FALSE)
+		return SC_ERR_NONE;
+
+	return (sc_err_t)RPC_R8(&batch->msg[idx]);
+}
+
 sc_err_t sc_ipc_open(sc_ipc_t *ipc, sc_ipc_id_t id)
 {
 	uint32_t base = id;
@@ -28,6 +28,44 @@
 
 /* Local Functions */
 
+void sc_pm_rpc_set_resource_power_mode(sc_rpc_msg_t *msg, sc_rsrc_t resource,
+				       sc_pm_power_mode_t mode)
+{
+	RPC_VER(msg) = SC_RPC_VERSION;
+	RPC_SIZE(msg) = 2U;
+	RPC_SVC(msg) = U8(SC_RPC_SVC_PM);
+	RPC_FUNC(msg) = U8(PM_FUNC_SET_RESOURCE_POWER_MODE);
+
+	RPC_U16(msg, 0U) = U16(resource);
+	RPC_U8(msg, 2U) = U8(mode);
+}
+
+void sc_pm_rpc_req_low_power_mode(sc_rpc_msg_t *msg, sc_rsrc_t resource,
+				  sc_pm_power_mode_t mode)
+{
+	RPC_VER(msg) = SC_RPC_VERSION;
+	RPC_SIZE(msg) = 2U;
+	RPC_SVC(msg) = U8(SC_RPC_SVC_PM);
+	RPC_FUNC(msg) = U8(PM_FUNC_REQ_LOW_POWER_MODE);
+
+	RPC_U16(msg, 0U) = U16(resource);
+	RPC_U8(msg, 2U) = U8(mode);
+}
+
+void sc_pm_rpc_cpu_start(sc_rpc_msg_t *msg, sc_rsrc_t resource,
+			 sc_bool_t enable, sc_faddr_t address)
+{
+	RPC_VER(msg) = SC_RPC_VERSION;
+	RPC_SIZE(msg) = 4U;
+	RPC_SVC(msg) = U8(SC_RPC_SVC_PM);
+	RPC_FUNC(msg) = U8(PM_FUNC_CPU_START);
+
+	RPC_U32(msg, 0U) = U32(address >> 32ULL);
+	RPC_U32(msg, 4U) = U32(address);
+	RPC_U16(msg, 8U) = U16(resource);
+	RPC_U8(msg, 10U) = B2U8(enable);
+}
+
 sc_err_t sc_pm_set_sys_power_mode(sc_ipc_t ipc, sc_pm_power_mode_t mode)
 {
 	sc_rpc_msg_t msg;
@@ -117,13 +155,7 @@ sc_err_t sc_pm_set_resource_power_mode(sc_ipc_t ipc, sc_rsrc_t resource,
 	sc_rpc_msg_t msg;
 	sc_err_t err;
 
-	RPC_VER(&msg) = SC_RPC_VERSION;
-	RPC_SIZE(&msg) = 2U;
-	RPC_SVC(&msg) = U8(SC_RPC_SVC_PM);
-	RPC_FUNC(&msg) = U8(PM_FUNC_SET_RESOURCE_POWER_MODE);
-
-	RPC_U16(&msg, 0U) = U16(resource);
-	RPC_U8(&msg, 2U) = U8(mode);
+	sc_pm_rpc_set_resource_power_mode(&msg, resource, mode);
 
 	sc_call_rpc(ipc, &msg, SC_FALSE);
 
@@ -185,13 +217,7 @@ sc_err_t sc_pm_req_low_power_mode(sc_ipc_t ipc, sc_rsrc_t resource,
 	sc_rpc_msg_t msg;
 	sc_err_t err;
 
-	RPC_VER(&msg) = SC_RPC_VERSION;
-	RPC_SIZE(&msg) = 2U;
-	RPC_SVC(&msg) = U8(SC_RPC_SVC_PM);
-	RPC_FUNC(&msg) = U8(PM_FUNC_REQ_LOW_POWER_MODE);
-
-	RPC_U16(&msg, 0U) = U16(resource);
-	RPC_U8(&msg, 2U) = U8(mode);
+	sc_pm_rpc_req_low_power_mode(&msg, resource, mode);
 
 	sc_call_rpc(ipc, &msg, SC_FALSE);
 
@@ -584,15 +610,7 @@ sc_err_t sc_pm_cpu_start(sc_ipc_t ipc, sc_rsrc_t resource, sc_bool_t enable,
 	sc_rpc_msg_t msg;
 	sc_err_t err;
 
-	RPC_VER(&msg) = SC_RPC_VERSION;
-	RPC_SIZE(&msg) = 4U;
-	RPC_SVC(&msg) = U8(SC_RPC_SVC_PM);
-	RPC_FUNC(&msg) = U8(PM_FUNC_CPU_START);
-
-	RPC_U32(&msg, 0U) = U32(address >> 32ULL);
-	RPC_U32(&msg, 4U) = U32(address);
-	RPC_U16(&msg, 8U) = U16(resource);
-	RPC_U8(&msg, 10U) = B2U8(enable);
+	sc_pm_rpc_cpu_start(&msg, resource, enable, address);
 
 	sc_call_rpc(ipc, &msg, SC_FALSE);
 
@@ -17,6 +17,7 @@
 
 #include <gpc.h>
 #include <imx_sip_svc.h>
+#include <imx_wakeup_irq.h>
 #include <plat_imx8.h>
 #include <imx_rdc.h>
 
@@ -215,13 +216,6 @@ void imx_set_cluster_powerdown(unsigned int last_core, uint8_t power_state)
 	}
 }
 
-static unsigned int gicd_read_isenabler(uintptr_t base, unsigned int id)
-{
-	unsigned int n = id >> ISENABLER_SHIFT;
-
-	return mmio_read_32(base + GICD_ISENABLER + (n << 2));
-}
-
 /*
  * gic's clock will be gated in system suspend, so gic has no ability to
  * to wakeup the system, we need to config the imr based on the irq
@@ -229,8 +223,7 @@ static unsigned int gicd_read_isenabler(uintptr_t base, unsigned int id)
  */
 void imx_set_sys_wakeup(unsigned int last_core, bool pdn)
 {
-	uint32_t irq_mask;
-	uintptr_t gicd_base = PLAT_GICD_BASE;
+	uint32_t irq_mask[IRQ_IMR_NUM];
 
 	if (pdn)
 		mmio_clrsetbits_32(IMX_GPC_BASE + LPCR_A53_BSC, A53_CORE_WUP_SRC(last_core),
@@ -239,16 +232,14 @@ void imx_set_sys_wakeup(unsigned int last_core, bool pdn)
 		mmio_clrsetbits_32(IMX_GPC_BASE + LPCR_A53_BSC, IRQ_SRC_A53_WUP,
 			A53_CORE_WUP_SRC(last_core));
 
-	/* clear last core's IMR based on GIC's mask setting */
-	for (int i = 0; i < IRQ_IMR_NUM; i++) {
-		if (pdn)
-			/* set the wakeup irq base GIC */
-			irq_mask = ~gicd_read_isenabler(gicd_base, 32 * (i + 1));
-		else
-			irq_mask = IMR_MASK_ALL;
+	/* set the wakeup irqs registered by the OS, or enabled in GIC */
+	if (pdn)
+		imx_wakeup_irq_mask(PLAT_GICD_BASE, irq_mask, IRQ_IMR_NUM);
 
+	/* clear last core's IMR based on the wakeup irq mask */
+	for (int i = 0; i < IRQ_IMR_NUM; i++) {
 		mmio_write_32(IMX_GPC_BASE + gpc_imr_offset[last_core] + i * 4,
-			      irq_mask);
+			      pdn ? irq_mask[i] : IMR_MASK_ALL);
 	}
 
 	/* enable the MU wakeup */
@@ -351,6 +342,9 @@ int imx_gpc_handler(uint32_t smc_fid, u_register_t x1, u_register_t x2, u_regist
 	case FSL_SIP_CONFIG_GPC_PM_DOMAIN:
 		imx_gpc_pm_domain_enable(x2, x3);
 		break;
+	case IMX_SIP_GPC_SET_WAKE:
+		imx_wakeup_irq_set(x2, x3 != 0U);
+		break;
 	default:
 		return SMC_UNK;
 	}
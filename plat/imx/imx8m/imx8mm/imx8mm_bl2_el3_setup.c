@@ -123,6 +123,13 @@ int bl2_plat_handle_post_image_load(unsigned int image_id)
 			WARN("OPTEE header parse error.\n");
 		}
 
+		break;
+	case BL33_IMAGE_ID:
+		/*
+		 * BL33 is the last image loaded, report the bus setup and load
+		 * throughput of the boot device
+		 */
+		mmc_print_part_stats();
 		break;
 	default:
 		/* Do nothing in default case */
@@ -46,6 +46,7 @@ BL31_SOURCES		+=	plat/imx/common/imx8_helpers.S			\
 				plat/imx/common/imx8_topology.c			\
 				plat/imx/common/imx_sip_handler.c		\
 				plat/imx/common/imx_sip_svc.c			\
+				plat/imx/common/imx_wakeup_irq.c		\
 				plat/imx/common/imx_uart_console.S		\
 				lib/cpus/aarch64/cortex_a53.S			\
 				drivers/arm/tzc/tzc380.c			\
@@ -165,6 +166,9 @@ ifeq (${IMX_BOOT_UART_BASE},auto)
 endif
 $(eval $(call add_define,IMX_BOOT_UART_BASE))
 
+IMX_PM_STEP_TIMING	?=	0
+$(eval $(call add_define,IMX_PM_STEP_TIMING))
+
 EL3_EXCEPTION_HANDLING := $(SDEI_SUPPORT)
 ifeq (${SDEI_SUPPORT}, 1)
 BL31_SOURCES 		+= 	plat/imx/common/imx_ehf.c	\
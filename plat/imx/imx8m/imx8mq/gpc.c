@@ -18,11 +18,11 @@
 #include <plat/common/platform.h>
 
 #include <gpc.h>
+#include <imx_wakeup_irq.h>
 #include <platform_def.h>
 
 #define FSL_SIP_CONFIG_GPC_MASK		U(0x00)
 #define FSL_SIP_CONFIG_GPC_UNMASK	U(0x01)
-#define FSL_SIP_CONFIG_GPC_SET_WAKE	U(0x02)
 #define FSL_SIP_CONFIG_GPC_PM_DOMAIN	U(0x03)
 #define FSL_SIP_CONFIG_GPC_SET_AFF	U(0x04)
 #define FSL_SIP_CONFIG_GPC_CORE_WAKE	U(0x05)
@@ -33,7 +33,6 @@
 #ifndef IMX_ANDROID_BUILD
 static uint32_t gpc_saved_imrs[16];
 #endif
-static uint32_t gpc_wake_irqs[4];
 static uint32_t gpc_imr_offset[] = {
 	IMX_GPC_BASE + IMR1_CORE0_A53,
 	IMX_GPC_BASE + IMR1_CORE1_A53,
@@ -62,14 +61,15 @@ static void gpc_imr_core_spin_unlock(unsigned int core_id)
 }
 
 #ifndef IMX_ANDROID_BUILD
-static void gpc_save_imr_lpm(unsigned int core_id, unsigned int imr_idx)
+static void gpc_save_imr_lpm(unsigned int core_id, unsigned int imr_idx,
+			     uint32_t irq_mask)
 {
 	uint32_t reg = gpc_imr_offset[core_id] + imr_idx * 4;
 
 	gpc_imr_core_spin_lock(core_id);
 
 	gpc_saved_imrs[core_id + imr_idx * 4] = mmio_read_32(reg);
-	mmio_write_32(reg, ~gpc_wake_irqs[imr_idx]);
+	mmio_write_32(reg, irq_mask);
 
 	gpc_imr_core_spin_unlock(core_id);
 }
@@ -97,12 +97,16 @@ static void gpc_restore_imr_lpm(unsigned int core_id, unsigned int imr_idx)
  */
 void imx_set_sys_wakeup(unsigned int last_core, bool pdn)
 {
+	uint32_t irq_mask[MAX_IMR_NUM];
 	unsigned int imr, core;
 
 	if (pdn) {
+		/* the wakeup irqs registered by the OS, or enabled in GIC */
+		imx_wakeup_irq_mask(PLAT_GICD_BASE, irq_mask, MAX_IMR_NUM);
+
 		for (imr = 0U; imr < MAX_IMR_NUM; imr++) {
 			for (core = 0U; core < PLATFORM_CORE_COUNT; core++) {
-				gpc_save_imr_lpm(core, imr);
+				gpc_save_imr_lpm(core, imr, irq_mask[imr]);
 			}
 		}
 	} else {
@@ -149,20 +153,6 @@ static void imx_gpc_hwirq_unmask(unsigned int hwirq)
 	gpc_imr_core_spin_unlock(0);
 }
 
-static void imx_gpc_set_wake(uint32_t hwirq, bool on)
-{
-	uint32_t mask, idx;
-
-	if (hwirq >= MAX_HW_IRQ_NUM) {
-		return;
-	}
-
-	mask = 1 << hwirq % 32;
-	idx = hwirq / 32;
-	gpc_wake_irqs[idx] = on ? gpc_wake_irqs[idx] | mask :
-				 gpc_wake_irqs[idx] & ~mask;
-}
-
 static void imx_gpc_mask_irq0(uint32_t core_id, uint32_t mask)
 {
 	gpc_imr_core_spin_lock(core_id);
@@ -437,8 +427,10 @@ int imx_gpc_handler(uint32_t smc_fid,
 	case FSL_SIP_CONFIG_GPC_CORE_WAKE:
 		imx_gpc_core_wake(x2);
 		break;
-	case FSL_SIP_CONFIG_GPC_SET_WAKE:
-		imx_gpc_set_wake(x2, x3);
+	case IMX_SIP_GPC_SET_WAKE:
+		if (x2 < MAX_HW_IRQ_NUM) {
+			imx_wakeup_irq_set(x2, x3 != 0U);
+		}
 		break;
 	case FSL_SIP_CONFIG_GPC_MASK:
 		imx_gpc_hwirq_mask(x2);
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <assert.h>
 #include <stdbool.h>
 
 #include <arch.h>
@@ -11,7 +12,9 @@
 #include <common/debug.h>
 #include <drivers/arm/cci.h>
 #include <drivers/arm/gicv3.h>
+#include <lib/cassert.h>
 #include <lib/mmio.h>
+#include <lib/utils_def.h>
 #include <lib/psci/psci.h>
 
 #include <plat_imx8.h>
@@ -26,6 +29,11 @@
 #define SYSTEM_PWR_STATE(state) \
 	((state)->pwr_domain_state[PLAT_MAX_PWR_LVL])
 
+/* Messages sent in one batch to power up and start a core */
+#define CORE_ON_MSGS	4U
+
+CASSERT(CORE_ON_MSGS <= SC_RPC_BATCH_MAX, assert_core_on_msgs_fit_batch);
+
 #if (defined COCKPIT_A72)
 #define IRQSTR_PLAT_OS_MU_IRQ	210
 #else
@@ -79,24 +87,38 @@ int imx_pwr_domain_on(u_register_t mpidr)
 	int ret = PSCI_E_SUCCESS;
 	unsigned int cluster_id = MPIDR_AFFLVL1_VAL(mpidr);
 	unsigned int cpu_id = MPIDR_AFFLVL0_VAL(mpidr);
+	unsigned int core = cpu_id + PLATFORM_CLUSTER0_CORE_COUNT * cluster_id;
+	sc_rsrc_t cluster = cluster_id == 0 ? SC_R_A53 : SC_R_A72;
+	sc_rpc_batch_t batch;
+	sc_rpc_msg_t *msg[CORE_ON_MSGS];
+	unsigned int i;
+
+	/*
+	 * The SCU handles requests in order, so pipeline the cluster and
+	 * core power up with the core start instead of waiting for a
+	 * round trip after each of them.
+	 */
+	sc_rpc_batch_init(&batch, ipc_handle);
+	for (i = 0U; i < ARRAY_SIZE(msg); i++) {
+		msg[i] = sc_rpc_batch_add(&batch, SC_FALSE);
+		assert(msg[i] != NULL);
+	}
 
-	sc_pm_set_resource_power_mode(ipc_handle, cluster_id == 0 ?
-		SC_R_A53 : SC_R_A72, SC_PM_PW_MODE_ON);
+	sc_pm_rpc_set_resource_power_mode(msg[0], cluster, SC_PM_PW_MODE_ON);
+	sc_pm_rpc_req_low_power_mode(msg[1], cluster, SC_PM_PW_MODE_ON);
+	sc_pm_rpc_set_resource_power_mode(msg[2], ap_core_index[core],
+		SC_PM_PW_MODE_ON);
+	sc_pm_rpc_cpu_start(msg[3], ap_core_index[core], true, CPU_START_ADDR);
 
-	sc_pm_req_low_power_mode(ipc_handle, cluster_id == 0 ?
-		SC_R_A53 : SC_R_A72, SC_PM_PW_MODE_ON);
+	(void)sc_call_rpc_batch(&batch);
 
-	if (sc_pm_set_resource_power_mode(ipc_handle,
-		ap_core_index[cpu_id + PLATFORM_CLUSTER0_CORE_COUNT * cluster_id],
-		SC_PM_PW_MODE_ON) != SC_ERR_NONE) {
-		ERROR("core %d power on failed!\n", cpu_id + PLATFORM_CLUSTER0_CORE_COUNT * cluster_id);
+	if (sc_rpc_batch_err(&batch, 2U) != SC_ERR_NONE) {
+		ERROR("core %d power on failed!\n", core);
 		ret = PSCI_E_INTERN_FAIL;
 	}
 
-	if (sc_pm_cpu_start(ipc_handle,
-		ap_core_index[cpu_id + PLATFORM_CLUSTER0_CORE_COUNT * cluster_id],
-		true, CPU_START_ADDR) != SC_ERR_NONE) {
-		ERROR("boot core %d failed!\n", cpu_id + PLATFORM_CLUSTER0_CORE_COUNT * cluster_id);
+	if (sc_rpc_batch_err(&batch, 3U) != SC_ERR_NONE) {
+		ERROR("boot core %d failed!\n", core);
 		ret = PSCI_E_INTERN_FAIL;
 	}
 
@@ -4,13 +4,16 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <assert.h>
 #include <stdbool.h>
 
 #include <arch.h>
 #include <arch_helpers.h>
 #include <common/debug.h>
 #include <drivers/arm/gicv3.h>
+#include <lib/cassert.h>
 #include <lib/mmio.h>
+#include <lib/utils_def.h>
 #include <lib/psci/psci.h>
 
 #include <plat_imx8.h>
@@ -20,6 +23,11 @@
 
 #define IRQSTR_PLAT_OS_MU_IRQ	209
 
+/* Messages sent in one batch to power up and start a core */
+#define CORE_ON_MSGS	2U
+
+CASSERT(CORE_ON_MSGS <= SC_RPC_BATCH_MAX, assert_core_on_msgs_fit_batch);
+
 static const int ap_core_index[PLATFORM_CORE_COUNT] = {
 	SC_R_A35_0, SC_R_A35_1, SC_R_A35_2, SC_R_A35_3
 };
@@ -62,19 +70,33 @@ int imx_pwr_domain_on(u_register_t mpidr)
 {
 	int ret = PSCI_E_SUCCESS;
 	unsigned int cpu_id;
+	sc_rpc_batch_t batch;
+	sc_rpc_msg_t *msg[CORE_ON_MSGS];
+	unsigned int i;
 
 	cpu_id = MPIDR_AFFLVL0_VAL(mpidr);
 
 	printf("imx_pwr_domain_on cpu_id %d\n", cpu_id);
 
-	if (sc_pm_set_resource_power_mode(ipc_handle, ap_core_index[cpu_id],
-	    SC_PM_PW_MODE_ON) != SC_ERR_NONE) {
+	/* Pipeline the core power up with its start request */
+	sc_rpc_batch_init(&batch, ipc_handle);
+	for (i = 0U; i < ARRAY_SIZE(msg); i++) {
+		msg[i] = sc_rpc_batch_add(&batch, SC_FALSE);
+		assert(msg[i] != NULL);
+	}
+
+	sc_pm_rpc_set_resource_power_mode(msg[0], ap_core_index[cpu_id],
+		SC_PM_PW_MODE_ON);
+	sc_pm_rpc_cpu_start(msg[1], ap_core_index[cpu_id], true, BL31_BASE);
+
+	(void)sc_call_rpc_batch(&batch);
+
+	if (sc_rpc_batch_err(&batch, 0U) != SC_ERR_NONE) {
 		ERROR("core %d power on failed!\n", cpu_id);
 		ret = PSCI_E_INTERN_FAIL;
 	}
 
-	if (sc_pm_cpu_start(ipc_handle, ap_core_index[cpu_id],
-	    true, BL31_BASE) != SC_ERR_NONE) {
+	if (sc_rpc_batch_err(&batch, 1U) != SC_ERR_NONE) {
 		ERROR("boot core %d failed!\n", cpu_id);
 		ret = PSCI_E_INTERN_FAIL;
 	}
@@ -29,6 +29,7 @@
 
 extern void imx8ulp_caam_init();
 extern void upower_wait_resp();
+extern void upower_req_drain(void);
 
 struct plat_gic_ctx imx_gicv3_ctx;
 static uint32_t cmc1_pmprot;
@@ -493,6 +494,13 @@ void imx_apd_ctx_save(unsigned int proc_num)
 	if (is_lpav_owned_by_apd()) {
 		lpav_ctx_save();
 	}
+
+	/*
+	 * don't leave a uPower request in flight across PD mode, e.g. the
+	 * BUCK3 voltage change of the last DFS: the first uPower message
+	 * after wakeup must be the one acked in imx_apd_ctx_restore().
+	 */
+	upower_req_drain();
 }
 
 void xrdc_reinit(void)
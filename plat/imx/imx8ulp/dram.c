@@ -16,6 +16,7 @@
 
 #include <upower_soc_defs.h>
 #include <upower_api.h>
+#include <upower_hal.h>
 
 #define PHY_FREQ_SEL_INDEX(x) 		((x) << 16)
 #define PHY_FREQ_MULTICAST_EN(x)	((x) << 8)
@@ -90,7 +91,6 @@
 #define LPDDR3_TYPE	U(0x7)
 #define LPDDR4_TYPE	U(0xB)
 
-extern void upower_wait_resp();
 
 struct dram_cfg_param {
 	uint32_t reg;
@@ -440,8 +440,7 @@ void dram_exit_retention(void)
 	mmio_write_32(IMX_DDRC_BASE + DENALI_CTL_153, 0x04040000);
 	/* 5. Disable automatic LP entry and PCPCS modes LP_AUTO_ENTRY_EN to 1b'0, PCPCS_PD_EN to 1b'0 */
 
-	upwr_xcp_set_ddr_retention(APD_DOMAIN, 0, NULL);
-	upower_wait_resp();
+	upower_set_ddr_retention(false);
 
 	if (dram_class == LPDDR4_TYPE) {
 		/* 7. Write PI START parameter to 1'b1 */
@@ -542,7 +541,8 @@ static void set_ddr_clk(uint32_t ddr_freq)
 #define DDR_DFS_GET_FSP_COUNT	0x10
 #define DDR_BYPASS_DRATE	U(400)
 
-extern int upower_pmic_i2c_write(uint32_t reg_addr, uint32_t reg_val);
+/* BUCK3 voltage decrease left in flight by the last DFS to bypass */
+static struct upower_req dfs_volt_req = { .completed = true };
 
 /* Normally, we only switch frequency between 1(bypass) and 2(highest) */
 int lpddr4_dfs(uint32_t freq_index)
@@ -559,6 +559,9 @@ int lpddr4_dfs(uint32_t freq_index)
 	if (freq_index > 2)
 		return -1;
 
+	/* the previous voltage change must be done before touching it again */
+	upower_req_wait(&dfs_volt_req);
+
 	/*
 	 * increase the voltage to 1.1V firstly before increase frequency
 	 * and APD enter OD mode
@@ -619,10 +622,11 @@ int lpddr4_dfs(uint32_t freq_index)
 	}
 
 	/* decrease the BUCK3 voltage after frequency changed to lower
-	 * and APD in ND_MODE
+	 * and APD in ND_MODE. Lowering it is not urgent, so don't wait
+	 * for the PMIC write to finish here.
 	 */
 	if (freq_index == 1 && sys_dvfs)
-		upower_pmic_i2c_write(0x22, 0x20);
+		upower_pmic_i2c_write_async(&dfs_volt_req, 0x22, 0x20);
 
 	/* DFS done successfully */
 	return 0;
@@ -17,6 +17,7 @@
 #include <plat_imx8.h>
 #include <upower_soc_defs.h>
 #include <upower_api.h>
+#include <upower_hal.h>
 
 static uintptr_t secure_entrypoint;
 
@@ -61,7 +62,6 @@ static uintptr_t secure_entrypoint;
 		.mask = (m),	\
 	}
 
-extern void upower_wait_resp();
 
 static int imx_pwr_set_cpu_entry(unsigned int cpu, unsigned int entry)
 {
@@ -265,7 +265,6 @@ ps_apd_pmic_reg_data_cfgs_t dpd_pmic_reg_cfgs = {
 
 struct ps_pwr_mode_cfg_t *pwr_sys_cfg = (struct ps_pwr_mode_cfg_t *)UPWR_DRAM_SHARED_BASE_ADDR;
 extern bool is_lpav_owned_by_apd(void);
-extern int upower_pmic_i2c_read(uint32_t reg_addr, uint32_t *reg_val);
 
 void imx_set_pwr_mode_cfg(abs_pwr_mode_t mode)
 {
@@ -356,8 +355,7 @@ void imx_domain_suspend(const psci_power_state_t *target_state)
 		imx_set_pwr_mode_cfg(PD_PWR_MODE);
 
 		/* clear the upower wakeup */
-		upwr_xcp_set_rtd_apd_llwu(APD_DOMAIN, 0, NULL);
-		upower_wait_resp();
+		upower_set_apd_llwu(false);
 
 		/* enable the USB wakeup */
 		usb_wakeup_enable(true);
@@ -402,8 +400,7 @@ void imx_domain_suspend_finish(const psci_power_state_t *target_state)
 		imx_apd_ctx_restore(cpu);
 
 		/* clear the upower wakeup */
-		upwr_xcp_set_rtd_apd_llwu(APD_DOMAIN, 0, NULL);
-		upower_wait_resp();
+		upower_set_apd_llwu(false);
 
 		/* disable all pad wakeup */
 		mmio_write_32(IMX_WUU1_BASE + 0x8, 0x0);
@@ -531,8 +528,7 @@ void __dead2 imx_system_off(void)
 	mmio_write_32(IMX_CMC1_BASE + 0x20, 0x1f);
 
 	/* make sure no pending upower wakeup */
-	upwr_xcp_set_rtd_apd_llwu(APD_DOMAIN, 0, NULL);
-	upower_wait_resp();
+	upower_set_apd_llwu(false);
 
 	/* enable the upower wakeup from wuu, act as APD boot up method  */
 	mmio_write_32(IMX_PCC3_BASE + 0x98, 0xc0800000);
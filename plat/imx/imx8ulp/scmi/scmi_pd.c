@@ -16,14 +16,13 @@
 #include <scmi.h>
 #include <upower_soc_defs.h>
 #include <upower_api.h>
+#include <upower_hal.h>
 
 #include <platform_def.h>
 
 #define POWER_STATE_ON	(0 << 30)
 #define POWER_STATE_OFF	(1 << 30)
 
-extern int upower_pwm(int domain_id, int power_state);
-
 enum {
 	PS0 = 0,
 	PS1 = 1,
@@ -310,36 +309,6 @@ unsigned int plat_scmi_pd_get_state(unsigned int agent_id __unused,
 	return scmi_power_domains[pd_id].power_state;
 }
 
-extern void upower_wait_resp();
-int upwr_pwm_power(const uint32_t swton[], const uint32_t memon[], bool on)
-{
-	int ret_val;
-	int ret;
-
-	if (on)
-		ret = upwr_pwm_power_on(swton, memon, NULL);
-	else
-		ret = upwr_pwm_power_off(swton, memon, NULL);
-
-	if (ret) {
-		NOTICE("%s failed: ret: %d, state: %x\n", __func__, ret, on);
-		return ret;
-	}
-
-	upower_wait_resp();
-
-	ret = upwr_poll_req_status(UPWR_SG_PWRMGMT, NULL, NULL, &ret_val, 1000);
-	if (ret != UPWR_REQ_OK) {
-		NOTICE("Faliure %d, %s\n", ret, __func__);
-		if (ret == UPWR_REQ_BUSY)
-			return -EBUSY;
-		else
-			return -EINVAL;
-	}
-
-	return 0;
-}
-
 int32_t plat_scmi_pd_psw(unsigned int index, unsigned int state)
 {
 	uint32_t psw_parent = scmi_power_domains[index].psw_parent;
@@ -361,7 +330,7 @@ int32_t plat_scmi_pd_psw(unsigned int index, unsigned int state)
 				NOTICE("off PSW[%d] that alreay in off state\n", psw_parent);
 				ret = -EACCES;
 			} else {
-				ret = upwr_pwm_power((const uint32_t *)&swt, NULL, on);
+				ret = upower_pwm_power((const uint32_t *)&swt, NULL, on);
 				imx8ulp_psw[psw_parent].count++;
 			}
 		} else {
@@ -370,7 +339,7 @@ int32_t plat_scmi_pd_psw(unsigned int index, unsigned int state)
 			else
 				imx8ulp_psw[psw_parent].count--;
 			if (!imx8ulp_psw[psw_parent].count)
-				ret = upwr_pwm_power((const uint32_t *)&swt, NULL, on);
+				ret = upower_pwm_power((const uint32_t *)&swt, NULL, on);
 		}
 	}
 
@@ -381,7 +350,7 @@ int32_t plat_scmi_pd_psw(unsigned int index, unsigned int state)
 				NOTICE("off PSW[%d] that alreay in off state\n", sram_parent);
 				ret = -EACCES;
 			} else {
-				ret = upwr_pwm_power((const uint32_t *)&swt, NULL, on);
+				ret = upower_pwm_power((const uint32_t *)&swt, NULL, on);
 				imx8ulp_psw[sram_parent].count++;
 			}
 		} else {
@@ -390,7 +359,7 @@ int32_t plat_scmi_pd_psw(unsigned int index, unsigned int state)
 			else
 				imx8ulp_psw[sram_parent].count--;
 			if (!imx8ulp_psw[sram_parent].count)
-				ret = upwr_pwm_power((const uint32_t *)&swt, NULL, on);
+				ret = upower_pwm_power((const uint32_t *)&swt, NULL, on);
 		}
 	}
 
@@ -453,14 +422,14 @@ int32_t plat_scmi_pd_set_state(unsigned int agent_id __unused,
 		if (ret)
 			return SCMI_DENIED;
 
-		ret = upwr_pwm_power(NULL, (const uint32_t *)&mem, on);
+		ret = upower_pwm_power(NULL, (const uint32_t *)&mem, on);
 		if (ret)
 			return SCMI_DENIED;
 	} else {
 		if (!pd_allow_power_off(i))
 			return SCMI_DENIED;
 
-		ret = upwr_pwm_power(NULL, (const uint32_t *)&mem, on);
+		ret = upower_pwm_power(NULL, (const uint32_t *)&mem, on);
 		if (ret)
 			return SCMI_DENIED;
 
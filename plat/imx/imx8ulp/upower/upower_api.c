@@ -3100,7 +3100,7 @@ upwr_req_status_t upwr_req_status(upwr_sg_t     sg,
 							sg_rsp_msg[sg].hdr.ret);
 	}
 
-	status = ((sg_busy & (1UL << sg)) == 1U) ? UPWR_REQ_BUSY :
+	status = ((sg_busy & (1UL << sg)) != 0U) ? UPWR_REQ_BUSY :
 	         (sg_rsp_msg[sg].hdr.errcode == UPWR_RESP_OK)? UPWR_REQ_OK   :
 							       UPWR_REQ_ERR  ;
 	upwr_lock(0);
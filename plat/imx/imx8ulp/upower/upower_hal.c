@@ -4,21 +4,33 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <stdarg.h>
+
+#include <arch_helpers.h>
 #include <common/debug.h>
 #include <drivers/delay_timer.h>
 #include <errno.h>
 #include <lib/mmio.h>
+#include <lib/spinlock.h>
 
 #include <xrdc.h>
 
 #include "upower_soc_defs.h"
 #include "upower_api.h"
 #include "upower_defs.h"
+#include "upower_hal.h"
 
 #define UPOWER_AP_MU1_ADDR	0x29280000
 
 struct MU_tag *muptr = (struct MU_tag *)UPOWER_AP_MU1_ADDR;
 
+/* pending requests of each service group, the head one is in flight */
+static struct upower_req *req_head[UPWR_SG_COUNT];
+static struct upower_req *req_tail[UPWR_SG_COUNT];
+static spinlock_t upower_req_lock;
+/* set while one core is dispatching MU responses for all waiters */
+static volatile bool upower_req_polling;
+
 void upower_apd_inst_isr()
 {
 	INFO("%s: entry\n", __func__);
@@ -49,7 +61,7 @@ uint32_t upower_status(int status)
 }
 
 
-void upower_wait_resp()
+void upower_wait_resp(void)
 {
 	while(muptr->RSR.B.RF0 == 0) {
 		INFO("%s: poll the mu:%x\n", __func__, muptr->RSR.R);
@@ -88,9 +100,220 @@ uint32_t upower_init(void)
 	return 0;
 }
 
+static void upower_req_callb(upwr_sg_t sg, uint32_t func, upwr_resp_t errcode, ...);
+
+/*
+ * Issue the head request of a service group. Called with upower_req_lock
+ * held. A request that can't be sent is completed with an error so the
+ * queue keeps moving.
+ */
+static void upower_req_issue(upwr_sg_t sg)
+{
+	struct upower_req *req;
+
+	int rc;
+
+	while ((req = req_head[sg]) != NULL) {
+		rc = req->issue(req, upower_req_callb);
+		if (rc == 0)
+			return;
+
+		req->err = UPWR_RESP_BAD_STATE;
+		req->ret = rc;
+		req_head[sg] = req->next;
+		req->completed = true;
+		if (req->done != NULL)
+			req->done(req);
+	}
+
+	req_tail[sg] = NULL;
+}
+
+/*
+ * uPower response callback, called from upwr_txrx_isr() when the response of
+ * the in-flight request of a service group arrives.
+ */
+static void upower_req_callb(upwr_sg_t sg, uint32_t func, upwr_resp_t errcode, ...)
+{
+	struct upower_req *req;
+	va_list ap;
+	int ret;
+
+	va_start(ap, errcode);
+	ret = va_arg(ap, int);
+	va_end(ap);
+
+	spin_lock(&upower_req_lock);
+
+	req = req_head[sg];
+	if (req == NULL) {
+		/* unsolicited response, nobody is waiting for it */
+		spin_unlock(&upower_req_lock);
+		return;
+	}
+
+	req_head[sg] = req->next;
+	if (req_head[sg] == NULL)
+		req_tail[sg] = NULL;
+
+	req->err = errcode;
+	req->ret = ret;
+	req->completed = true;
+	if (req->done != NULL)
+		req->done(req);
+
+	/* send the next queued request of this service group */
+	upower_req_issue(sg);
+
+	spin_unlock(&upower_req_lock);
+
+	/* wake up the cores waiting in upower_req_wait() */
+	dsbish();
+	sev();
+}
+
+/*
+ * Queue a request on its service group. It is sent right away if the service
+ * group is idle, otherwise when the requests ahead of it have completed.
+ */
+int upower_req_submit(struct upower_req *req)
+{
+	if ((req == NULL) || (req->issue == NULL) || (req->sg >= UPWR_SG_COUNT))
+		return -EINVAL;
+
+	req->completed = false;
+	req->next = NULL;
+
+	spin_lock(&upower_req_lock);
+
+	if (req_tail[req->sg] != NULL) {
+		req_tail[req->sg]->next = req;
+		req_tail[req->sg] = req;
+	} else {
+		req_head[req->sg] = req;
+		req_tail[req->sg] = req;
+		upower_req_issue(req->sg);
+	}
+
+	spin_unlock(&upower_req_lock);
+
+	return 0;
+}
+
+/* Handle a pending uPower response, if any, without waiting */
+void upower_req_dispatch(void)
+{
+	if (muptr->RSR.B.RF0 != 0U)
+		upwr_txrx_isr();
+}
+
+/*
+ * Wait until no request is queued on any service group, so that the next MU
+ * message is not the response to one of them. Only used on the last core
+ * going down, with no other core waiting for uPower.
+ */
+void upower_req_drain(void)
+{
+	unsigned int sg;
+
+	for (sg = 0U; sg < UPWR_SG_COUNT; sg++) {
+		while (req_head[sg] != NULL)
+			upower_req_dispatch();
+	}
+}
+
+/*
+ * Wait for a request to complete. A single core polls the MU and dispatches
+ * the responses for everybody; the other waiters sleep in wfe and are woken
+ * by sev when a request completes or the polling core leaves.
+ */
+int upower_req_wait(struct upower_req *req)
+{
+	bool poller;
+
+	while (!req->completed) {
+		spin_lock(&upower_req_lock);
+		poller = !upower_req_polling;
+		upower_req_polling = true;
+		spin_unlock(&upower_req_lock);
+
+		if (!poller) {
+			wfe();
+			continue;
+		}
+
+		while (!req->completed)
+			upower_req_dispatch();
+
+		spin_lock(&upower_req_lock);
+		upower_req_polling = false;
+		spin_unlock(&upower_req_lock);
+
+		dsbish();
+		sev();
+	}
+
+	return (req->err == UPWR_RESP_OK) ? 0 : -EIO;
+}
+
+/* arg[3] flags of a power switch and memory request */
+#define UPOWER_PWM_ON		BIT_32(0)
+#define UPOWER_PWM_SWT		BIT_32(1)
+#define UPOWER_PWM_MEM		BIT_32(2)
+
+static int upower_pwm_issue(struct upower_req *req, upwr_callb callb)
+{
+	/* arg[0] holds the switch mask, arg[1..2] the memory mask */
+	const uint32_t *swt = NULL;
+	const uint32_t *mem = NULL;
+
+	if ((req->arg[3] & UPOWER_PWM_SWT) != 0U)
+		swt = &req->arg[0];
+	if ((req->arg[3] & UPOWER_PWM_MEM) != 0U)
+		mem = &req->arg[1];
+
+	if ((req->arg[3] & UPOWER_PWM_ON) != 0U)
+		return upwr_pwm_power_on(swt, mem, callb);
+
+	return upwr_pwm_power_off(swt, mem, callb);
+}
+
+/*
+ * Power the PMC switches in swton and the memories in memon on or off. Either
+ * mask may be NULL, as for upwr_pwm_power_on()/upwr_pwm_power_off().
+ */
+int upower_pwm_power(const uint32_t swton[], const uint32_t memon[], bool on)
+{
+	struct upower_req req = {
+		.sg = UPWR_SG_PWRMGMT,
+		.issue = upower_pwm_issue,
+		.arg = { 0U, 0U, 0U, on ? UPOWER_PWM_ON : 0U },
+	};
+	int ret;
+
+	if (swton != NULL) {
+		req.arg[0] = swton[0];
+		req.arg[3] |= UPOWER_PWM_SWT;
+	}
+
+	if (memon != NULL) {
+		req.arg[1] = memon[0];
+		req.arg[2] = memon[1];
+		req.arg[3] |= UPOWER_PWM_MEM;
+	}
+
+	upower_req_submit(&req);
+	ret = upower_req_wait(&req);
+	if (ret) {
+		NOTICE("%s failed: err: %d, pwr_on: %d\n", __func__, req.err, on);
+		return (req.err == UPWR_RESP_SG_BUSY) ? -EBUSY : -EINVAL;
+	}
+
+	return 0;
+}
+
 int upower_pwm(int domain_id, bool pwr_on)
 {
-	int ret, ret_val;
 	uint32_t swt;
 
 	if (domain_id == 9 || domain_id == 11 || domain_id == 12)
@@ -102,64 +325,67 @@ int upower_pwm(int domain_id, bool pwr_on)
 	 *	Add domain_id check
 	 *	mem switch?
 	 */
-	if (pwr_on)
-		ret = upwr_pwm_power_on(&swt, NULL, NULL);
-	else
-		ret = upwr_pwm_power_off(&swt, NULL, NULL);
-
-	if (ret) {
-		NOTICE("%s failed: ret: %d, pwr_on: %d\n", __func__, ret, pwr_on);
-		return ret;
-	}
-	upower_wait_resp();
-	ret = upwr_poll_req_status(UPWR_SG_PWRMGMT, NULL, NULL, &ret_val, 1000);
-	if (ret != UPWR_REQ_OK) {
-		NOTICE("Faliure %d, %s\n", ret, __func__);
-		if (ret == UPWR_REQ_BUSY)
-			return -EBUSY;
-		else
-			return -EINVAL;
-	}
+	return upower_pwm_power(&swt, NULL, pwr_on);
+}
 
-	return 0;
+static int upower_temp_issue(struct upower_req *req, upwr_callb callb)
+{
+	return upwr_tpm_get_temperature(req->arg[0], callb);
 }
 
 int upower_read_temperature(uint32_t sensor_id, int32_t *temperature)
 {
-	int ret, ret_val;
-	upwr_resp_t err_code;
+	struct upower_req req = {
+		.sg = UPWR_SG_TEMPM,
+		.issue = upower_temp_issue,
+		.arg = { sensor_id },
+	};
 	int64_t t;
+	int ret;
 
-	ret = upwr_tpm_get_temperature(sensor_id, NULL);
+	upower_req_submit(&req);
+	ret = upower_req_wait(&req);
 	if (ret)
 		return ret;
 
-	upower_wait_resp();
-	ret = upwr_poll_req_status(UPWR_SG_TEMPM, NULL, &err_code, &ret_val, 1000);
-	if (ret > UPWR_REQ_OK)
-		return ret;
-
-	t = ret_val & 0xff;
+	t = req.ret & 0xff;
 	*temperature = (2673049 * t * t * t / 10000000 + 3734262 * t * t / 100000 + 4487042 * t / 100 - 4698694) / 100000;
 
 	return 0;
 }
 
+static int upower_i2c_issue(struct upower_req *req, upwr_callb callb)
+{
+	/* arg[2] is the access size: > 0 for a write, < 0 for a read */
+	return upwr_xcp_i2c_access(0x32, (int8_t)req->arg[2], 1, req->arg[0],
+				   req->arg[1], callb);
+}
+
+/*
+ * Start a PMIC register write without waiting for it: the caller may carry
+ * on with other work and use upower_req_wait() when it needs the result.
+ */
+int upower_pmic_i2c_write_async(struct upower_req *req, uint32_t reg_addr,
+				uint32_t reg_val)
+{
+	req->sg = UPWR_SG_EXCEPT;
+	req->issue = upower_i2c_issue;
+	req->arg[0] = reg_addr;
+	req->arg[1] = reg_val;
+	req->arg[2] = 1U;
+
+	return upower_req_submit(req);
+}
+
 int upower_pmic_i2c_write(uint32_t reg_addr, uint32_t reg_val)
 {
-	int ret, ret_val;
-	upwr_resp_t err_code;
+	struct upower_req req = { .done = NULL };
+	int ret;
 
-	ret = upwr_xcp_i2c_access(0x32, 1, 1, reg_addr, reg_val, NULL);
+	upower_pmic_i2c_write_async(&req, reg_addr, reg_val);
+	ret = upower_req_wait(&req);
 	if (ret) {
-		NOTICE("pmic i2c read failed ret %d\n", ret);
-		return ret;
-	}
-
-	upower_wait_resp();
-	ret = upwr_poll_req_status(UPWR_SG_EXCEPT, NULL, &err_code, &ret_val, 1000);
-	if (ret != UPWR_REQ_OK) {
-		NOTICE("i2c poll Faliure %d, err_code %d, ret_val 0x%x\n", ret, err_code, ret_val);
+		NOTICE("i2c write failure, err_code %d, ret_val 0x%x\n", req.err, req.ret);
 		return ret;
 	}
 
@@ -170,28 +396,62 @@ int upower_pmic_i2c_write(uint32_t reg_addr, uint32_t reg_val)
 
 int upower_pmic_i2c_read(uint32_t reg_addr, uint32_t *reg_val)
 {
-	int ret, ret_val;
-	upwr_resp_t err_code;
+	struct upower_req req = {
+		.sg = UPWR_SG_EXCEPT,
+		.issue = upower_i2c_issue,
+		.arg = { reg_addr, 0U, (uint32_t)-1 },
+	};
+	int ret;
 
 	if (!reg_val)
 		return -1;
 
-	ret = upwr_xcp_i2c_access(0x32, -1, 1, reg_addr, 0, NULL);
+	upower_req_submit(&req);
+	ret = upower_req_wait(&req);
 	if (ret) {
-		NOTICE("pmic i2c read failed ret %d\n", ret);
+		NOTICE("i2c read failure, err_code %d, ret_val 0x%x\n", req.err, req.ret);
 		return ret;
 	}
 
-	upower_wait_resp();
-	ret = upwr_poll_req_status(UPWR_SG_EXCEPT, NULL, &err_code, &ret_val, 1000);
-	if (ret != UPWR_REQ_OK) {
-		NOTICE("i2c poll Faliure %d, err_code %d, ret_val 0x%x\n", ret, err_code, ret_val);
-		return ret;
-	}
-
-	*reg_val = ret_val;
+	*reg_val = req.ret;
 
 	VERBOSE("PMIC read reg[0x%x], val[0x%x]\n", reg_addr, *reg_val);
 
 	return 0;
 }
+
+static int upower_ddr_retention_issue(struct upower_req *req, upwr_callb callb)
+{
+	return upwr_xcp_set_ddr_retention(APD_DOMAIN, req->arg[0], callb);
+}
+
+int upower_set_ddr_retention(bool enable)
+{
+	struct upower_req req = {
+		.sg = UPWR_SG_EXCEPT,
+		.issue = upower_ddr_retention_issue,
+		.arg = { enable },
+	};
+
+	upower_req_submit(&req);
+
+	return upower_req_wait(&req);
+}
+
+static int upower_apd_llwu_issue(struct upower_req *req, upwr_callb callb)
+{
+	return upwr_xcp_set_rtd_apd_llwu(APD_DOMAIN, req->arg[0], callb);
+}
+
+int upower_set_apd_llwu(bool enable)
+{
+	struct upower_req req = {
+		.sg = UPWR_SG_EXCEPT,
+		.issue = upower_apd_llwu_issue,
+		.arg = { enable },
+	};
+
+	upower_req_submit(&req);
+
+	return upower_req_wait(&req);
+}
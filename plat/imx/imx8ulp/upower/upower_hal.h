@@ -0,0 +1,57 @@
+/*
+ * Copyright 2020 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef UPOWER_HAL_H
+#define UPOWER_HAL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "upower_soc_defs.h"
+#include "upower_api.h"
+
+/*
+ * A uPower service request. The uPower firmware handles one request per
+ * service group at a time, so requests are queued per service group and
+ * issued in order as the previous one completes. The storage is owned by
+ * the caller and must stay valid until the request has completed.
+ */
+struct upower_req {
+	upwr_sg_t sg;
+	/* sends the request to uPower, with callb as completion callback */
+	int (*issue)(struct upower_req *req, upwr_callb callb);
+	uint32_t arg[4];
+	/*
+	 * optional completion callback, called from the MU dispatch with the
+	 * request queue locked: it must not submit new requests
+	 */
+	void (*done)(struct upower_req *req);
+	/* filled in on completion */
+	upwr_resp_t err;
+	int ret;
+	volatile bool completed;
+	struct upower_req *next;
+};
+
+uint32_t upower_init(void);
+void upower_wait_resp(void);
+
+int upower_req_submit(struct upower_req *req);
+void upower_req_dispatch(void);
+void upower_req_drain(void);
+int upower_req_wait(struct upower_req *req);
+
+int upower_pwm(int domain_id, bool pwr_on);
+int upower_pwm_power(const uint32_t swton[], const uint32_t memon[], bool on);
+int upower_read_temperature(uint32_t sensor_id, int32_t *temperature);
+int upower_pmic_i2c_write(uint32_t reg_addr, uint32_t reg_val);
+int upower_pmic_i2c_write_async(struct upower_req *req, uint32_t reg_addr,
+				uint32_t reg_val);
+int upower_pmic_i2c_read(uint32_t reg_addr, uint32_t *reg_val);
+int upower_set_ddr_retention(bool enable);
+int upower_set_apd_llwu(bool enable);
+
+#endif /* UPOWER_HAL_H */
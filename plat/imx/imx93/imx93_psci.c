@@ -17,6 +17,8 @@
 #include <drivers/arm/gicv3.h>
 #include "../drivers/arm/gic/v3/gicv3_private.h"
 
+#include <imx_pm_steps.h>
+#include <imx_wakeup_irq.h>
 #include <plat_imx8.h>
 #include <pwr_ctrl.h>
 #include <sema42.h>
@@ -295,8 +297,7 @@ void s401_request_pwrdown(void)
 void imx_set_sys_wakeup(unsigned int last_core, bool pdn)
 {
 	unsigned int i;
-	uint32_t irq_mask;
-	uintptr_t gicd_base = PLAT_GICD_BASE;
+	uint32_t irq_mask[IMR_NUM];
 
 	if (pdn) {
 		/*
@@ -324,30 +325,30 @@ void imx_set_sys_wakeup(unsigned int last_core, bool pdn)
 		mmio_setbits_32(MU1B_GSR, MU_GPI1);
 	}
 
-	/* Set the GPC IMRs based on GIC IRQ mask setting */
-	for (i = 0; i < IMR_NUM; i++) {
-		if (pdn) {
-			/* set the wakeup irq base GIC */
-			irq_mask = ~gicd_read_isenabler(gicd_base, 32 * (i + 1));
-			/* IRQ220 controlled by IMR6 should be enabled in system sleep mode */
-			if (i == 6U) {
-				irq_mask &= ~(1 << 28);
-			}
-		} else {
-			irq_mask = 0xFFFFFFFF;
+	/* set the wakeup irqs registered by the OS, or enabled in GIC */
+	if (pdn) {
+		imx_wakeup_irq_mask(PLAT_GICD_BASE, irq_mask, IMR_NUM);
+		/* IRQ220 controlled by IMR6 should be enabled in system sleep mode */
+		irq_mask[6] &= ~(1 << 28);
+	} else {
+		for (i = 0; i < IMR_NUM; i++) {
+			irq_mask[i] = 0xFFFFFFFF;
 		}
+	}
 
+	/* Set the GPC IMRs based on the wakeup irq mask */
+	for (i = 0; i < IMR_NUM; i++) {
 		/*
 		 * if any of the non gpio is enabled, that means wakeupmix
 		 * should be keep on to make sure these irqs can wakeup system
 		 * successfully.
 		 */
-		if (irq_mask & wakeupmix_irq_mask[i]) {
+		if (irq_mask[i] & wakeupmix_irq_mask[i]) {
 			has_wakeup_irq = true;
 		}
 		/* set the mask into core & cluster GPC IMR */
-		gpc_set_irq_mask(CPU_A55C0, i, irq_mask);
-		gpc_set_irq_mask(CPU_A55_PLAT, i, irq_mask);
+		gpc_set_irq_mask(CPU_A55C0, i, irq_mask[i]);
+		gpc_set_irq_mask(CPU_A55_PLAT, i, irq_mask[i]);
 	}
 }
 
@@ -411,7 +412,7 @@ void nicmix_pwr_down(unsigned int core_id)
 	imx_set_sys_wakeup(core_id, true);
 }
 
-void nicmix_pwr_up(unsigned int core_id)
+static void nicmix_clk_restore(unsigned int core_id)
 {
 	mmio_setbits_32(CCM_ROOT_SLICE(WAKEUP_AXI_ROOT), clock_root[1] & ROOT_MUX_MASK);
 	mmio_setbits_32(CCM_ROOT_SLICE(HSIO_CLK_ROOT), clock_root[2] & ROOT_MUX_MASK);
@@ -420,13 +421,37 @@ void nicmix_pwr_up(unsigned int core_id)
 	/* keep nicmix on when exit from system suspend */
 	src_mix_set_lpm(SRC_NIC, 0x3, CM_MODE_SUSPEND);
 	mmio_clrbits_32(SRC_BASE + 0x1c00 + 0x4, BIT(2));
+}
 
+static void nicmix_trdc_restore(unsigned int core_id)
+{
 	trdc_n_reinit();
+}
+
+static void nicmix_qos_restore(unsigned int core_id)
+{
 	nicmix_qos_init();
+}
+
+static void nicmix_gic_restore(unsigned int core_id)
+{
 	plat_gic_restore(core_id, &imx_gicv3_ctx);
 	imx_set_sys_wakeup(core_id, false);
 }
 
+static const struct imx_pm_step nicmix_pwr_up_steps[] = {
+	{ "nicmix clk", nicmix_clk_restore },
+	{ "nicmix trdc", nicmix_trdc_restore },
+	{ "nicmix qos", nicmix_qos_restore },
+	{ "nicmix gic", nicmix_gic_restore },
+};
+
+void nicmix_pwr_up(unsigned int core_id)
+{
+	imx_pm_run_steps(nicmix_pwr_up_steps, ARRAY_SIZE(nicmix_pwr_up_steps),
+			 core_id);
+}
+
 extern int trdc_mbc_blk_config(unsigned long trdc_reg, uint32_t mbc_x,
 	 uint32_t dom_x, uint32_t mem_x, uint32_t blk_x,
 	 bool sec_access, uint32_t glbac_id);
@@ -519,7 +544,11 @@ void wdog_save(uintptr_t base, uint32_t index)
 	mmio_write_32(LPCG(WDOG3_LPCG + index), 0x0);
 }
 
-void wdog_restore(uintptr_t base, uint32_t index)
+/*
+ * Start restoring the wdog config. Returns true if the new config was written
+ * and wdog_restore_wait() needs to wait for the wdog to apply it.
+ */
+static bool wdog_restore_start(uintptr_t base, uint32_t index)
 {
 	uint32_t cs, toval;
 
@@ -531,7 +560,7 @@ void wdog_restore(uintptr_t base, uint32_t index)
 
 	if (cs == wdog_val[index][0] &&
 	    toval == wdog_val[index][1]) {
-		return;
+		return false;
 	}
 
 	/* reconfig the CS */
@@ -539,6 +568,11 @@ void wdog_restore(uintptr_t base, uint32_t index)
 	/* set the tiemout value */
 	mmio_write_32(base + 0x8, wdog_val[index][1]);
 
+	return true;
+}
+
+static void wdog_restore_wait(uintptr_t base, uint32_t index)
+{
 	/* wait for the lock status */
 	while((mmio_read_32(base) & BIT(11))) {
 		;
@@ -573,19 +607,70 @@ void wakeupmix_pwr_down(void)
 	}
 }
 
-void wakeupmix_pwr_up(void)
+static const uintptr_t wakeupmix_wdog_base[] = {
+	WDOG3_BASE, WDOG4_BASE, WDOG5_BASE,
+};
+
+/* wdogs whose config update is still being applied */
+static bool wdog_pending[ARRAY_SIZE(wakeupmix_wdog_base)];
+
+static void wakeupmix_clk_restore(unsigned int core_id)
+{
+	mmio_setbits_32(CCM_ROOT_SLICE(M33_ROOT), clock_root[0] & ROOT_MUX_MASK);
+	/* keep wakeupmix on when exit from system suspend */
+	src_mix_set_lpm(SRC_WKUP, 0x3, CM_MODE_SUSPEND);
+	mmio_clrbits_32(SRC_BASE + 0xc00 + 0x4, BIT(2));
+}
+
+static void wakeupmix_trdc_restore(unsigned int core_id)
+{
+	trdc_w_reinit();
+}
+
+/*
+ * The wdog takes several of its own clock cycles to apply a new config, so
+ * write all of them first and only wait for them after the other restores.
+ */
+static void wakeupmix_wdog_start(unsigned int core_id)
+{
+	for (unsigned int i = 0U; i < ARRAY_SIZE(wakeupmix_wdog_base); i++) {
+		wdog_pending[i] = wdog_restore_start(wakeupmix_wdog_base[i], i);
+	}
+}
+
+static void wakeupmix_qos_restore(unsigned int core_id)
+{
+	wakeupmix_qos_init();
+}
+
+static void wakeupmix_gpio_restore(unsigned int core_id)
+{
+	gpio_restore(wakeupmix_gpio_ctx, 3);
+}
+
+static void wakeupmix_wdog_wait(unsigned int core_id)
+{
+	for (unsigned int i = 0U; i < ARRAY_SIZE(wakeupmix_wdog_base); i++) {
+		if (wdog_pending[i]) {
+			wdog_restore_wait(wakeupmix_wdog_base[i], i);
+		}
+	}
+}
+
+static const struct imx_pm_step wakeupmix_pwr_up_steps[] = {
+	{ "wakeupmix clk", wakeupmix_clk_restore },
+	{ "wakeupmix trdc", wakeupmix_trdc_restore },
+	{ "wdog start", wakeupmix_wdog_start },
+	{ "wakeupmix qos", wakeupmix_qos_restore },
+	{ "wakeupmix gpio", wakeupmix_gpio_restore },
+	{ "wdog wait", wakeupmix_wdog_wait },
+};
+
+void wakeupmix_pwr_up(unsigned int core_id)
 {
 	if (!(gpio_wakeup || has_wakeup_irq)) {
-		mmio_setbits_32(CCM_ROOT_SLICE(M33_ROOT), clock_root[0] & ROOT_MUX_MASK);
-		/* keep wakeupmix on when exit from system suspend */
-		src_mix_set_lpm(SRC_WKUP, 0x3, CM_MODE_SUSPEND);
-		mmio_clrbits_32(SRC_BASE + 0xc00 + 0x4, BIT(2));
-		trdc_w_reinit();
-		wakeupmix_qos_init();
-		gpio_restore(wakeupmix_gpio_ctx, 3);
-		wdog_restore(WDOG3_BASE, 0);
-		wdog_restore(WDOG4_BASE, 1);
-		wdog_restore(WDOG5_BASE, 2);
+		imx_pm_run_steps(wakeupmix_pwr_up_steps,
+				 ARRAY_SIZE(wakeupmix_pwr_up_steps), core_id);
 	}
 
 	/*
@@ -861,7 +946,7 @@ void imx_pwr_domain_suspend_finish(const psci_power_state_t *target_state)
 			/* power down PLL */
 			pll_pwr_down(false);
 			nicmix_pwr_up(core_id);
-			wakeupmix_pwr_up();
+			wakeupmix_pwr_up(core_id);
 			dram_exit_retention();
 		}
 	}
@@ -37,6 +37,8 @@ BL31_SOURCES		+=	plat/common/aarch64/crash_console_helpers.S   \
 				plat/imx/imx93/imx93_psci.c			\
 				plat/imx/imx93/src.c			\
 				plat/imx/common/imx_sip_svc.c			\
+				plat/imx/common/imx_pm_steps.c			\
+				plat/imx/common/imx_wakeup_irq.c		\
 				plat/imx/common/imx_sip_handler.c			\
 				plat/imx/common/ele_api.c			\
 				lib/cpus/aarch64/cortex_a55.S			\
@@ -57,6 +59,9 @@ USE_COHERENT_MEM	:=	0
 PROGRAMMABLE_RESET_ADDRESS :=	1
 COLD_BOOT_SINGLE_CPU	:=	1
 
+IMX_PM_STEP_TIMING	?=	0
+$(eval $(call add_define,IMX_PM_STEP_TIMING))
+
 BL32_BASE               ?=      0x96000000
 BL32_SIZE               ?=      0x02000000
 $(eval $(call add_define,BL32_BASE))
@@ -18,6 +18,8 @@
 
 #include <drivers/arm/css/scmi.h>
 
+#include <imx_pm_steps.h>
+#include <imx_wakeup_irq.h>
 #include <plat_imx8.h>
 #include <scmi_imx9.h>
 
@@ -338,7 +340,6 @@ void imx_set_sys_wakeup(uint32_t last_core, bool pdn)
 
 	uint32_t wakeup_flags;
 	uint32_t mode;
-	uintptr_t gicd_base = PLAT_GICD_BASE;
 
 	if (pdn) {
 		/*
@@ -364,12 +365,14 @@ void imx_set_sys_wakeup(uint32_t last_core, bool pdn)
 	scmi_core_Irq_wake_set(imx95_scmi_handle, cpu_info[last_core].cpu_id,
 			       0, IMR_NUM, irq_mask);
 
-	/* Set the GPC IMRs based on GIC IRQ mask setting */
+	/* set the wakeup irqs registered by the OS, or enabled in GIC */
+	if (pdn) {
+		imx_wakeup_irq_mask(PLAT_GICD_BASE, irq_mask, IMR_NUM);
+	}
+
+	/* Set the GPC IMRs based on the wakeup irq mask */
 	for (i = 0; i < IMR_NUM; i++) {
 		if (pdn) {
-			/* set the wakeup irq based on GIC */
-			irq_mask[i] =
-				~gicd_read_isenabler(gicd_base, 32 * (i + 1));
 			is_wakeup_source(irq_mask[i], i);
 		}
 
@@ -404,13 +407,29 @@ void nocmix_pwr_down(uint32_t core_id)
 	imx_set_sys_wakeup(core_id, true);
 }
 
-void nocmix_pwr_up(uint32_t core_id)
+static void nocmix_gic_restore(unsigned int core_id)
 {
 	/* Restore GIC context. */
 	plat_gic_restore(core_id, &imx_gicv3_ctx);
 	imx_set_sys_wakeup(core_id, false);
 }
 
+static void wakeupmix_gpio_restore(unsigned int core_id)
+{
+	gpio_restore(wakeupmix_gpio_ctx, 4);
+}
+
+static const struct imx_pm_step nocmix_pwr_up_steps[] = {
+	{ "nocmix gic", nocmix_gic_restore },
+	{ "wakeupmix gpio", wakeupmix_gpio_restore },
+};
+
+void nocmix_pwr_up(uint32_t core_id)
+{
+	imx_pm_run_steps(nocmix_pwr_up_steps, ARRAY_SIZE(nocmix_pwr_up_steps),
+			 core_id);
+}
+
 int imx_validate_ns_entrypoint(uintptr_t ns_entrypoint)
 {
 	/* The non-secure entrypoint should be in RAM space */
@@ -475,9 +494,12 @@ int imx_pwr_domain_on(u_register_t mpidr)
 	/* Set the LPM state for cpuidle. */
 	struct scmi_lpm_config cpu_lpm_cfg = {cpu_info[core_id].cpu_pd_id,
 	   SCMI_CPU_PD_LPM_ON_RUN, 0};
-	/* Set the default LPM state for cpuidle */
-	scmi_core_lpm_mode_set(imx95_scmi_handle, cpu_info[core_id].cpu_id,
-			        1, &cpu_lpm_cfg);
+	/*
+	 * Set the default LPM state for cpuidle. The core is already started,
+	 * so don't wait for the response: the next SCMI user does that.
+	 */
+	scmi_core_lpm_mode_set_posted(imx95_scmi_handle, cpu_info[core_id].cpu_id,
+				      1, &cpu_lpm_cfg);
 
 	return PSCI_E_SUCCESS;
 }
@@ -524,8 +546,9 @@ void imx_pwr_domain_off(const psci_power_state_t *target_state)
 	 */
 	scmi_core_Irq_wake_set(imx95_scmi_handle, scmi_cpu_id[core_id], 0,
 			       IMR_NUM, mask);
-	scmi_core_set_sleep_mode(imx95_scmi_handle, scmi_cpu_id[core_id],
-				 SCMI_GPC_WAKEUP, SCMI_CPU_SLEEP_SUSPEND);
+	/* Completion is polled for in imx_pwr_domain_pwr_down_wfi() */
+	scmi_core_set_sleep_mode_posted(imx95_scmi_handle, scmi_cpu_id[core_id],
+					SCMI_GPC_WAKEUP, SCMI_CPU_SLEEP_SUSPEND);
 }
 
 
@@ -609,6 +632,9 @@ void imx_pwr_domain_suspend_finish(const psci_power_state_t *target_state)
 
 	/* system level */
 	if (is_local_state_off(SYSTEM_PWR_STATE(target_state))) {
+#if SCMI_LATENCY_STATS
+		scmi_latency_stats_dump(imx95_scmi_handle);
+#endif
 		sys_mode = SCMI_IMX_SYS_POWER_STATE_MODE_MASK;
 		if (has_netc_irq) {
 			scmi_sys_pwr_state_set(imx95_scmi_handle,
@@ -616,7 +642,6 @@ void imx_pwr_domain_suspend_finish(const psci_power_state_t *target_state)
 					       sys_mode);
 		}
 		nocmix_pwr_up(core_id);
-		gpio_restore(wakeupmix_gpio_ctx, 4);
 		struct scmi_lpm_config cpu_lpm_cfg[] = {
 			{
 				cpu_info[IMX95_A55P_IDX].cpu_pd_id,
@@ -671,6 +696,11 @@ void imx_get_sys_suspend_power_state(psci_power_state_t *req_state)
 
 void __dead2 imx_pwr_domain_pwr_down_wfi(const psci_power_state_t *target_state)
 {
+	/* The SM must have applied the sleep mode before the core enters WFI */
+	if (scmi_channel_wait(imx95_scmi_handle) != SCMI_E_SUCCESS) {
+		ERROR("Failed to set the sleep mode of the core\n");
+	}
+
 	while (1) {
 		wfi();
 	}
@@ -42,6 +42,8 @@ BL31_SOURCES		+=	drivers/arm/css/scmi/scmi_common.c		\
 				drivers/delay_timer/generic_delay_timer.c	\
 				plat/imx/common/imx_sip_handler.c		\
 				plat/imx/common/imx_sip_svc.c			\
+				plat/imx/common/imx_pm_steps.c			\
+				plat/imx/common/imx_wakeup_irq.c		\
 				plat/imx/common/ele_api.c			\
 				${IMX_GIC_SOURCES}				\
 				${XLAT_TABLES_LIB_SRCS}
@@ -57,6 +59,12 @@ PROGRAMMABLE_RESET_ADDRESS := 1
 COLD_BOOT_SINGLE_CPU := 1
 ERRATA_A55_1530923 := 1
 
+SCMI_LATENCY_STATS	?=	0
+$(eval $(call add_define,SCMI_LATENCY_STATS))
+
+IMX_PM_STEP_TIMING	?=	0
+$(eval $(call add_define,IMX_PM_STEP_TIMING))
+
 BL32_BASE               ?=      0x8C000000
 BL32_SIZE               ?=      0x02000000
 $(eval $(call add_define,BL32_BASE))
@@ -446,6 +446,7 @@ uint64_t rmmd_rmm_el3_handler(uint32_t smc_fid, uint64_t x1, uint64_t x2,
 				void *handle, uint64_t flags)
 {
 	uint32_t src_sec_state;
+	size_t transitioned;
 	int ret;
 
 	/* If RMM failed to boot, treat any RMM-EL3 interface SMC as unknown */
@@ -464,11 +465,21 @@ uint64_t rmmd_rmm_el3_handler(uint32_t smc_fid, uint64_t x1, uint64_t x2,
 
 	switch (smc_fid) {
 	case RMM_GTSI_DELEGATE:
-		ret = gpt_delegate_pas(x1, PAGE_SIZE_4KB, SMC_FROM_REALM);
+		ret = gpt_delegate_pas(x1, PAGE_SIZE_4KB, SMC_FROM_REALM,
+				       &transitioned);
 		SMC_RET1(handle, gpt_to_gts_error(ret, smc_fid, x1));
 	case RMM_GTSI_UNDELEGATE:
-		ret = gpt_undelegate_pas(x1, PAGE_SIZE_4KB, SMC_FROM_REALM);
+		ret = gpt_undelegate_pas(x1, PAGE_SIZE_4KB, SMC_FROM_REALM,
+					 &transitioned);
 		SMC_RET1(handle, gpt_to_gts_error(ret, smc_fid, x1));
+	case RMM_GTSI_DELEGATE_RANGE:
+		ret = gpt_delegate_pas(x1, x2, SMC_FROM_REALM, &transitioned);
+		SMC_RET2(handle, gpt_to_gts_error(ret, smc_fid, x1),
+			 transitioned);
+	case RMM_GTSI_UNDELEGATE_RANGE:
+		ret = gpt_undelegate_pas(x1, x2, SMC_FROM_REALM, &transitioned);
+		SMC_RET2(handle, gpt_to_gts_error(ret, smc_fid, x1),
+			 transitioned);
 	case RMM_ATTEST_GET_PLAT_TOKEN:
 		ret = rmmd_attest_get_platform_token(x1, &x2, x3);
 		SMC_RET2(handle, ret, x2);
@@ -18,8 +18,27 @@
 
 #include <platform_def.h>
 
+/* Size of the smallest object block, blocks of class n are this << n bytes. */
+#define SPMC_SHMEM_OBJ_MIN_SIZE		U(128)
+
 /**
  * struct spmc_shmem_obj - Shared memory object.
+ * @block_size:     Size of the block holding this object, a power of two.
+ * @hash_next:      Next object in the same @spmc_shmem_obj_state.hash bucket.
+ * @prev:           Previous object in @spmc_shmem_obj_state.objs, or previous
+ *                  block in the free list while the block is free.
+ * @next:           Next object in @spmc_shmem_obj_state.objs, or next free
+ *                  block in the free list while the block is free.
+ * @free:           Block is in a @spmc_shmem_obj_state.free_list.
+ * @hashed:         Object is in @spmc_shmem_obj_state.hash and
+ *                  @spmc_shmem_obj_state.objs.
+ * @lock:           Lock protecting @in_use once @desc is fully received. It
+ *                  is always taken with @spmc_shmem_obj_state.lock held.
+ * @v1_0_view:      Cached FF-A v1.0 version of @desc, built on the first
+ *                  retrieve by a v1.0 client and freed with this object.
+ * @cons_checked:   Offset in @desc up to which the constituent memory region
+ *                  descriptors have been added to @cons_page_count.
+ * @cons_page_count: Sum of the page counts of the checked constituents.
  * @desc_size:      Size of @desc.
  * @desc_filled:    Size of @desc already received.
  * @in_use:         Number of clients that have called ffa_mem_retrieve_req
@@ -27,6 +46,16 @@
  * @desc:           FF-A memory region descriptor passed in ffa_mem_share.
  */
 struct spmc_shmem_obj {
+	size_t block_size;
+	struct spmc_shmem_obj *hash_next;
+	struct spmc_shmem_obj *prev;
+	struct spmc_shmem_obj *next;
+	bool free;
+	bool hashed;
+	spinlock_t lock;
+	struct spmc_shmem_obj *v1_0_view;
+	size_t cons_checked;
+	unsigned long long cons_page_count;
 	size_t desc_size;
 	size_t desc_filled;
 	size_t in_use;
@@ -57,12 +86,267 @@ static size_t spmc_shmem_obj_size(size_t desc_size)
 	return desc_size + offsetof(struct spmc_shmem_obj, desc);
 }
 
+/**
+ * spmc_shmem_obj_class - Get the size class of an object.
+ * @obj_size:   Size of struct spmc_shmem_obj object.
+ *
+ * Return: Index of the smallest size class that can hold @obj_size bytes,
+ *         %SPMC_SHMEM_OBJ_CLASSES if @obj_size is too large for all classes.
+ */
+static unsigned int spmc_shmem_obj_class(size_t obj_size)
+{
+	unsigned int cls = 0U;
+
+	while ((cls < SPMC_SHMEM_OBJ_CLASSES) &&
+	       ((SPMC_SHMEM_OBJ_MIN_SIZE << cls) < obj_size)) {
+		cls++;
+	}
+	return cls;
+}
+
+/**
+ * spmc_shmem_block_at - Get the block at an offset in the datastore.
+ * @state:      Global state.
+ * @offset:     Offset of the block in @state->data.
+ *
+ * Return: Pointer to the block header.
+ */
+static struct spmc_shmem_obj *
+spmc_shmem_block_at(struct spmc_shmem_obj_state *state, size_t offset)
+{
+	return (struct spmc_shmem_obj *)(state->data + offset);
+}
+
+/**
+ * spmc_shmem_block_push - Put a block on the free list of its class.
+ * @state:      Global state.
+ * @block:      Block to add.
+ * @cls:        Size class of @block.
+ */
+static void spmc_shmem_block_push(struct spmc_shmem_obj_state *state,
+				  struct spmc_shmem_obj *block,
+				  unsigned int cls)
+{
+	block->block_size = SPMC_SHMEM_OBJ_MIN_SIZE << cls;
+	block->free = true;
+	block->prev = NULL;
+	block->next = state->free_list[cls];
+	if (block->next != NULL) {
+		block->next->prev = block;
+	}
+	state->free_list[cls] = block;
+}
+
+/**
+ * spmc_shmem_block_unlink - Take a block off the free list of its class.
+ * @state:      Global state.
+ * @block:      Free block to remove.
+ * @cls:        Size class of @block.
+ */
+static void spmc_shmem_block_unlink(struct spmc_shmem_obj_state *state,
+				    struct spmc_shmem_obj *block,
+				    unsigned int cls)
+{
+	block->free = false;
+	if (block->prev != NULL) {
+		block->prev->next = block->next;
+	} else {
+		state->free_list[cls] = block->next;
+	}
+	if (block->next != NULL) {
+		block->next->prev = block->prev;
+	}
+}
+
+/**
+ * spmc_shmem_block_trim - Give the free blocks at the end back.
+ * @state:      Global state.
+ *
+ * Called once @state->allocated has moved down. Only free blocks have their
+ * @free flag set, so a free header of the right size ending at
+ * @state->allocated is the last block.
+ */
+static void spmc_shmem_block_trim(struct spmc_shmem_obj_state *state)
+{
+	struct spmc_shmem_obj *block;
+	unsigned int cls = 0U;
+	size_t size;
+
+	while ((cls < SPMC_SHMEM_OBJ_CLASSES) && (state->allocated != 0U)) {
+		size = SPMC_SHMEM_OBJ_MIN_SIZE << cls;
+		if ((size > state->allocated) ||
+		    !is_aligned(state->allocated - size, size)) {
+			break;
+		}
+
+		block = spmc_shmem_block_at(state, state->allocated - size);
+		if (!block->free || (block->block_size != size)) {
+			cls++;
+			continue;
+		}
+
+		spmc_shmem_block_unlink(state, block, cls);
+		state->allocated -= size;
+		cls = 0U;
+	}
+}
+
+/**
+ * spmc_shmem_block_release - Return a block to the allocator.
+ * @state:      Global state.
+ * @offset:     Offset of the block in @state->data.
+ * @cls:        Size class of the block.
+ *
+ * Blocks are aligned to their size within @state->data, so the buddy of a
+ * block is found by flipping its size bit in @offset. The block is merged
+ * with its buddy for as long as the buddy is free and whole. If the result
+ * ends at @state->allocated, it and any free blocks below it are given back
+ * to the unused end of the datastore, otherwise it goes on the free list of
+ * its class.
+ */
+static void spmc_shmem_block_release(struct spmc_shmem_obj_state *state,
+				     size_t offset, unsigned int cls)
+{
+	size_t size = SPMC_SHMEM_OBJ_MIN_SIZE << cls;
+	struct spmc_shmem_obj *buddy;
+	size_t buddy_offset;
+
+	while ((cls + 1U) < SPMC_SHMEM_OBJ_CLASSES) {
+		buddy_offset = offset ^ size;
+		if (buddy_offset + size > state->allocated) {
+			break;
+		}
+
+		buddy = spmc_shmem_block_at(state, buddy_offset);
+		if (!buddy->free || (buddy->block_size != size)) {
+			break;
+		}
+
+		spmc_shmem_block_unlink(state, buddy, cls);
+		offset &= ~size;
+		size <<= 1;
+		cls++;
+	}
+
+	if ((offset + size) == state->allocated) {
+		state->allocated = offset;
+		spmc_shmem_block_trim(state);
+		return;
+	}
+
+	spmc_shmem_block_push(state, spmc_shmem_block_at(state, offset), cls);
+}
+
+/**
+ * spmc_shmem_block_get - Get a block from the free lists.
+ * @state:      Global state.
+ * @cls:        Size class of the block.
+ *
+ * Takes the smallest free block of class @cls or larger, and splits it down
+ * to @cls. The upper halves split off go on the free lists.
+ *
+ * Return: Pointer to the block, or %NULL if no free block is large enough.
+ */
+static struct spmc_shmem_obj *
+spmc_shmem_block_get(struct spmc_shmem_obj_state *state, unsigned int cls)
+{
+	struct spmc_shmem_obj *block = NULL;
+	unsigned int c;
+
+	for (c = cls; c < SPMC_SHMEM_OBJ_CLASSES; c++) {
+		block = state->free_list[c];
+		if (block != NULL) {
+			break;
+		}
+	}
+
+	if (block == NULL) {
+		return NULL;
+	}
+
+	spmc_shmem_block_unlink(state, block, c);
+	while (c > cls) {
+		c--;
+		spmc_shmem_block_push(state,
+			(struct spmc_shmem_obj *)((uint8_t *)block +
+						  (SPMC_SHMEM_OBJ_MIN_SIZE << c)),
+			c);
+	}
+
+	block->block_size = SPMC_SHMEM_OBJ_MIN_SIZE << cls;
+	return block;
+}
+
+/**
+ * spmc_shmem_block_carve - Carve a block from the unused end of the datastore.
+ * @state:      Global state.
+ * @cls:        Size class of the block.
+ *
+ * The block is aligned to its size. The gap below it is carved into the
+ * largest aligned blocks that fit and released, so that it can merge with
+ * the free blocks around it.
+ *
+ * Return: Pointer to the block, or %NULL if the datastore is full.
+ */
+static struct spmc_shmem_obj *
+spmc_shmem_block_carve(struct spmc_shmem_obj_state *state, unsigned int cls)
+{
+	size_t size = SPMC_SHMEM_OBJ_MIN_SIZE << cls;
+	size_t start = round_up(state->allocated, size);
+	struct spmc_shmem_obj *block;
+	struct spmc_shmem_obj *gap;
+	size_t gap_size;
+	size_t offset;
+	unsigned int c;
+
+	if ((start > state->data_size) || (size > state->data_size - start)) {
+		return NULL;
+	}
+
+	/*
+	 * Mark the gap blocks in use before releasing any of them, so that
+	 * none is merged with a stale header.
+	 */
+	for (offset = state->allocated; offset < start;
+	     offset += gap->block_size) {
+		c = 0U;
+		while ((c < cls) &&
+		       is_aligned(offset, SPMC_SHMEM_OBJ_MIN_SIZE << (c + 1U)) &&
+		       ((offset + (SPMC_SHMEM_OBJ_MIN_SIZE << (c + 1U))) <= start)) {
+			c++;
+		}
+		gap = spmc_shmem_block_at(state, offset);
+		gap->block_size = SPMC_SHMEM_OBJ_MIN_SIZE << c;
+		gap->free = false;
+	}
+
+	block = spmc_shmem_block_at(state, start);
+	block->block_size = size;
+	block->free = false;
+
+	offset = state->allocated;
+	state->allocated = start + size;
+
+	while (offset < start) {
+		gap_size = spmc_shmem_block_at(state, offset)->block_size;
+		spmc_shmem_block_release(state, offset,
+					 spmc_shmem_obj_class(gap_size));
+		offset += gap_size;
+	}
+
+	return block;
+}
+
 /**
  * spmc_shmem_obj_alloc - Allocate struct spmc_shmem_obj.
  * @state:      Global state.
  * @desc_size:  Size of struct ffa_memory_region_descriptor object that
  *              allocated object will hold.
  *
+ * Objects live in power-of-two blocks managed as a buddy allocator: a free
+ * block is split down to the size needed, or a new one is carved from the
+ * unused end of @state->data. Once allocated, an object never moves.
+ *
  * Return: Pointer to newly allocated object, or %NULL if there not enough space
  *         left. The returned pointer is only valid while @state is locked, to
  *         used it again after unlocking @state, spmc_shmem_obj_lookup must be
@@ -72,8 +356,8 @@ static struct spmc_shmem_obj *
 spmc_shmem_obj_alloc(struct spmc_shmem_obj_state *state, size_t desc_size)
 {
 	struct spmc_shmem_obj *obj;
-	size_t free = state->data_size - state->allocated;
 	size_t obj_size;
+	unsigned int cls;
 
 	if (state->data == NULL) {
 		ERROR("Missing shmem datastore!\n");
@@ -96,45 +380,120 @@ spmc_shmem_obj_alloc(struct spmc_shmem_obj_state *state, size_t desc_size)
 		return NULL;
 	}
 
-	if (obj_size > free) {
+	cls = spmc_shmem_obj_class(obj_size);
+	if (cls == SPMC_SHMEM_OBJ_CLASSES) {
+		WARN("%s(0x%zx) failed, too large\n", __func__, desc_size);
+		return NULL;
+	}
+
+	obj = spmc_shmem_block_get(state, cls);
+	if (obj == NULL) {
+		obj = spmc_shmem_block_carve(state, cls);
+	}
+
+	if (obj == NULL) {
 		WARN("%s(0x%zx) failed, free 0x%zx\n",
-		     __func__, desc_size, free);
+		     __func__, desc_size, state->data_size - state->allocated);
 		return NULL;
 	}
-	obj = (struct spmc_shmem_obj *)(state->data + state->allocated);
+
 	obj->desc = (struct ffa_mtd) {0};
 	obj->desc_size = desc_size;
 	obj->desc_filled = 0;
 	obj->in_use = 0;
-	state->allocated += obj_size;
+	obj->hashed = false;
+	obj->lock = (spinlock_t) {0};
+	obj->v1_0_view = NULL;
+	obj->cons_checked = 0;
+	obj->cons_page_count = 0;
 	return obj;
 }
 
+/**
+ * spmc_shmem_obj_hash - Get the hash bucket for a handle.
+ * @state:      Global state.
+ * @handle:     Handle to hash.
+ *
+ * Handles are allocated sequentially, so the low bits spread them evenly.
+ *
+ * Return: Pointer to the head of the bucket for @handle.
+ */
+static struct spmc_shmem_obj **
+spmc_shmem_obj_hash(struct spmc_shmem_obj_state *state, uint64_t handle)
+{
+	return &state->hash[handle & (SPMC_SHMEM_OBJ_HASH_SIZE - 1U)];
+}
+
+/**
+ * spmc_shmem_obj_index - Make an object findable by spmc_shmem_obj_lookup.
+ * @state:      Global state.
+ * @obj:        Object with its handle set.
+ *
+ * Also adds @obj to the list of objects checked for overlapping memory
+ * regions. Objects that are not indexed, like the v1.0 views, are private to
+ * the object or call that allocated them.
+ */
+static void spmc_shmem_obj_index(struct spmc_shmem_obj_state *state,
+				 struct spmc_shmem_obj *obj)
+{
+	struct spmc_shmem_obj **bucket = spmc_shmem_obj_hash(state,
+							     obj->desc.handle);
+
+	assert(!obj->hashed);
+	obj->hash_next = *bucket;
+	*bucket = obj;
+	obj->hashed = true;
+
+	obj->prev = NULL;
+	obj->next = state->objs;
+	if (state->objs != NULL) {
+		state->objs->prev = obj;
+	}
+	state->objs = obj;
+}
+
 /**
  * spmc_shmem_obj_free - Free struct spmc_shmem_obj.
  * @state:      Global state.
  * @obj:        Object to free.
  *
- * Release memory used by @obj. Other objects may move, so on return all
- * pointers to struct spmc_shmem_obj object should be considered invalid, not
- * just @obj.
- *
- * The current implementation always compacts the remaining objects to simplify
- * the allocator and to avoid fragmentation.
+ * Release memory used by @obj and its cached v1.0 view. The blocks are
+ * merged with their free buddies and returned to the allocator, other
+ * objects are not affected.
  */
 
 static void spmc_shmem_obj_free(struct spmc_shmem_obj_state *state,
 				  struct spmc_shmem_obj *obj)
 {
-	size_t free_size = spmc_shmem_obj_size(obj->desc_size);
-	uint8_t *shift_dest = (uint8_t *)obj;
-	uint8_t *shift_src = shift_dest + free_size;
-	size_t shift_size = state->allocated - (shift_src - state->data);
+	unsigned int cls = spmc_shmem_obj_class(obj->block_size);
+
+	if (obj->v1_0_view != NULL) {
+		spmc_shmem_obj_free(state, obj->v1_0_view);
+		obj->v1_0_view = NULL;
+	}
+
+	if (obj->hashed) {
+		struct spmc_shmem_obj **curr =
+			spmc_shmem_obj_hash(state, obj->desc.handle);
 
-	if (shift_size != 0U) {
-		memmove(shift_dest, shift_src, shift_size);
+		while (*curr != obj) {
+			curr = &(*curr)->hash_next;
+		}
+		*curr = obj->hash_next;
+		obj->hashed = false;
+
+		if (obj->prev != NULL) {
+			obj->prev->next = obj->next;
+		} else {
+			state->objs = obj->next;
+		}
+		if (obj->next != NULL) {
+			obj->next->prev = obj->prev;
+		}
 	}
-	state->allocated -= free_size;
+
+	spmc_shmem_block_release(state, (size_t)((uint8_t *)obj - state->data),
+				 cls);
 }
 
 /**
@@ -148,41 +507,73 @@ static void spmc_shmem_obj_free(struct spmc_shmem_obj_state *state,
 static struct spmc_shmem_obj *
 spmc_shmem_obj_lookup(struct spmc_shmem_obj_state *state, uint64_t handle)
 {
-	uint8_t *curr = state->data;
-
-	while (curr - state->data < state->allocated) {
-		struct spmc_shmem_obj *obj = (struct spmc_shmem_obj *)curr;
+	struct spmc_shmem_obj *obj = *spmc_shmem_obj_hash(state, handle);
 
+	while (obj != NULL) {
 		if (obj->desc.handle == handle) {
 			return obj;
 		}
-		curr += spmc_shmem_obj_size(obj->desc_size);
+		obj = obj->hash_next;
 	}
 	return NULL;
 }
 
 /**
- * spmc_shmem_obj_get_next - Get the next memory object from an offset.
- * @offset:     Offset used to track which objects have previously been
- *              returned.
+ * spmc_shmem_obj_get - Lookup a fully received object by handle and lock it.
+ * @handle:     Unique handle of object to return.
+ * @keep_state: Return with @spmc_shmem_obj_state.lock still held. Needed if
+ *              the caller may allocate or free objects.
  *
- * Return: the next struct spmc_shmem_obj_state object from the provided
- *	   offset.
- *	   %NULL, if there are no more objects.
+ * Once fully received, the descriptor of an object no longer changes and
+ * @in_use is protected by the object lock, so unless @keep_state is set, the
+ * caller can use the object without blocking operations on other objects.
+ * The object cannot be freed while its lock is held, spmc_ffa_mem_reclaim
+ * takes the object lock before freeing it.
+ *
+ * Return: Locked object with handle matching @handle, release it with
+ *         spmc_shmem_obj_put. %NULL, with no lock held, if there is no
+ *         fully received object with a matching handle.
  */
-static struct spmc_shmem_obj *
-spmc_shmem_obj_get_next(struct spmc_shmem_obj_state *state, size_t *offset)
+static struct spmc_shmem_obj *spmc_shmem_obj_get(uint64_t handle,
+						 bool keep_state)
 {
-	uint8_t *curr = state->data + *offset;
+	struct spmc_shmem_obj *obj;
+
+	spin_lock(&spmc_shmem_obj_state.lock);
+
+	obj = spmc_shmem_obj_lookup(&spmc_shmem_obj_state, handle);
+	if (obj == NULL) {
+		WARN("%s: invalid handle, 0x%lx, not a valid handle.\n",
+		     __func__, handle);
+		spin_unlock(&spmc_shmem_obj_state.lock);
+		return NULL;
+	}
 
-	if (curr - state->data < state->allocated) {
-		struct spmc_shmem_obj *obj = (struct spmc_shmem_obj *)curr;
+	if (obj->desc_filled != obj->desc_size) {
+		WARN("%s: incomplete object desc filled %zu < size %zu\n",
+		     __func__, obj->desc_filled, obj->desc_size);
+		spin_unlock(&spmc_shmem_obj_state.lock);
+		return NULL;
+	}
 
-		*offset += spmc_shmem_obj_size(obj->desc_size);
+	spin_lock(&obj->lock);
+	if (!keep_state) {
+		spin_unlock(&spmc_shmem_obj_state.lock);
+	}
+	return obj;
+}
 
-		return obj;
+/**
+ * spmc_shmem_obj_put - Unlock an object locked by spmc_shmem_obj_get.
+ * @obj:        Object to unlock.
+ * @keep_state: Value passed to spmc_shmem_obj_get.
+ */
+static void spmc_shmem_obj_put(struct spmc_shmem_obj *obj, bool keep_state)
+{
+	spin_unlock(&obj->lock);
+	if (keep_state) {
+		spin_unlock(&spmc_shmem_obj_state.lock);
 	}
-	return NULL;
 }
 
 /*******************************************************************************
@@ -631,51 +1022,62 @@ spmc_shm_convert_mtd_to_v1_0(struct spmc_shmem_obj *out_obj,
  * @out_desc_size:  Will be populated with the total size of the v1.0
  *                  descriptor.
  *
+ * The converted descriptor is kept with @orig_obj, so a descriptor retrieved
+ * in several fragments or by several v1.0 clients is only converted once.
+ * Must be called with spmc_shmem_obj_state.lock held.
+ *
  * Return: 0 if conversion and population succeeded.
- * Note: This function invalidates the reference to @orig therefore
- * `spmc_shmem_obj_lookup` must be called if further usage is required.
  */
 static uint32_t
 spmc_populate_ffa_v1_0_descriptor(void *dst, struct spmc_shmem_obj *orig_obj,
 				 size_t buf_size, size_t offset,
 				 size_t *copy_size, size_t *v1_0_desc_size)
 {
-		struct spmc_shmem_obj *v1_0_obj;
+		struct spmc_shmem_obj *v1_0_obj = orig_obj->v1_0_view;
 
-		/* Calculate the size that the v1.0 descriptor will require. */
-		*v1_0_desc_size = spmc_shm_get_v1_0_descriptor_size(
-					&orig_obj->desc, orig_obj->desc_size);
+		if (v1_0_obj == NULL) {
+			/*
+			 * Calculate the size that the v1.0 descriptor will
+			 * require.
+			 */
+			size_t desc_size = spmc_shm_get_v1_0_descriptor_size(
+						&orig_obj->desc,
+						orig_obj->desc_size);
 
-		if (*v1_0_desc_size == 0) {
-			ERROR("%s: cannot determine size of descriptor.\n",
-			      __func__);
-			return FFA_ERROR_INVALID_PARAMETER;
-		}
+			if (desc_size == 0) {
+				ERROR("%s: cannot determine size of descriptor.\n",
+				      __func__);
+				return FFA_ERROR_INVALID_PARAMETER;
+			}
+
+			/* Get a new obj to store the v1.0 descriptor. */
+			v1_0_obj = spmc_shmem_obj_alloc(&spmc_shmem_obj_state,
+							desc_size);
 
-		/* Get a new obj to store the v1.0 descriptor. */
-		v1_0_obj = spmc_shmem_obj_alloc(&spmc_shmem_obj_state,
-						*v1_0_desc_size);
+			if (!v1_0_obj) {
+				return FFA_ERROR_NO_MEMORY;
+			}
+
+			/* Perform the conversion from v1.1 to v1.0. */
+			if (!spmc_shm_convert_mtd_to_v1_0(v1_0_obj, orig_obj)) {
+				spmc_shmem_obj_free(&spmc_shmem_obj_state,
+						    v1_0_obj);
+				return FFA_ERROR_INVALID_PARAMETER;
+			}
 
-		if (!v1_0_obj) {
-			return FFA_ERROR_NO_MEMORY;
+			orig_obj->v1_0_view = v1_0_obj;
 		}
 
-		/* Perform the conversion from v1.1 to v1.0. */
-		if (!spmc_shm_convert_mtd_to_v1_0(v1_0_obj, orig_obj)) {
-			spmc_shmem_obj_free(&spmc_shmem_obj_state, v1_0_obj);
+		*v1_0_desc_size = v1_0_obj->desc_size;
+		if (offset >= v1_0_obj->desc_size) {
+			WARN("%s: invalid offset 0x%zx >= 0x%zx\n",
+			     __func__, offset, v1_0_obj->desc_size);
 			return FFA_ERROR_INVALID_PARAMETER;
 		}
 
 		*copy_size = MIN(v1_0_obj->desc_size - offset, buf_size);
 		memcpy(dst, (uint8_t *) &v1_0_obj->desc + offset, *copy_size);
 
-		/*
-		 * We're finished with the v1.0 descriptor for now so free it.
-		 * Note that this will invalidate any references to the v1.1
-		 * descriptor.
-		 */
-		spmc_shmem_obj_free(&spmc_shmem_obj_state, v1_0_obj);
-
 		return 0;
 }
 
@@ -768,6 +1170,67 @@ emad_advance(const struct ffa_emad_v1_0 *emad, size_t offset)
 	return (const struct ffa_emad_v1_0 *)((const uint8_t *)emad + offset);
 }
 
+/**
+ * spmc_shmem_obj_check_constituents - Check the constituent memory region
+ *                                     descriptors received so far.
+ * @obj:          Object containing ffa_memory_region_descriptor.
+ * @ffa_version:  FF-A version of the provided descriptor.
+ *
+ * Called as each fragment arrives, so that the constituents of large
+ * descriptors are summed while they are still in the cache, instead of
+ * walking the whole descriptor again once it is complete. The header must
+ * have been validated by spmc_validate_mtd_start. The offsets are only
+ * trusted here to stay in bounds, spmc_shmem_check_obj validates them.
+ */
+static void spmc_shmem_obj_check_constituents(struct spmc_shmem_obj *obj,
+					      uint32_t ffa_version)
+{
+	const struct ffa_emad_v1_0 *first_emad;
+	size_t emad_size;
+	size_t offset;
+
+	first_emad = spmc_shmem_obj_get_emad(&obj->desc, 0, ffa_version,
+					     &emad_size);
+
+	/* Wait for the emad giving the composite descriptor offset. */
+	if (((const uint8_t *)first_emad + emad_size) >
+	    ((const uint8_t *)&obj->desc + obj->desc_filled)) {
+		return;
+	}
+
+	offset = (size_t)first_emad->comp_mrd_offset +
+		 sizeof(struct ffa_comp_mrd);
+	if (!is_aligned(first_emad->comp_mrd_offset, 16) ||
+	    (offset > obj->desc_size)) {
+		return;
+	}
+
+	if (obj->cons_checked < offset) {
+		obj->cons_checked = offset;
+	}
+
+	while ((obj->desc_filled - obj->cons_checked) >=
+	       sizeof(struct ffa_cons_mrd)) {
+		const struct ffa_cons_mrd *mrd = (const struct ffa_cons_mrd *)
+			((const uint8_t *)&obj->desc + obj->cons_checked);
+
+		if (!is_aligned(mrd->address, PAGE_SIZE)) {
+			WARN("%s: invalid object, address in region descriptor "
+			     "at 0x%zx not 4K aligned (got 0x%016llx)",
+			     __func__, obj->cons_checked,
+			     (unsigned long long)mrd->address);
+		}
+
+		/*
+		 * No overflow possible: cons_page_count can hold at least
+		 * 2^64 - 1, but will be have at most 2^32 - 1 values added to
+		 * it, each of which cannot exceed 2^32 - 1.
+		 */
+		obj->cons_page_count += mrd->page_count;
+		obj->cons_checked += sizeof(struct ffa_cons_mrd);
+	}
+}
+
 /**
  * spmc_shmem_check_obj - Check that counts in descriptor match overall size.
  * @obj:	  Object containing ffa_memory_region_descriptor.
@@ -915,28 +1378,13 @@ static int spmc_shmem_check_obj(struct spmc_shmem_obj *obj,
 		return FFA_ERROR_INVALID_PARAMETER;
 	}
 
-	total_page_count = 0;
-
 	/*
-	 * comp->address_range_count is 32-bit, so 'count' must fit in a
-	 * uint32_t at this point.
+	 * The constituents have been summed as the fragments arrived, the
+	 * offsets used for that have now been validated above.
 	 */
-	for (size_t i = 0; i < count; i++) {
-		const struct ffa_cons_mrd *mrd = comp->address_range_array + i;
-
-		if (!is_aligned(mrd->address, PAGE_SIZE)) {
-			WARN("%s: invalid object, address in region descriptor "
-			     "%zu not 4K aligned (got 0x%016llx)",
-			     __func__, i, (unsigned long long)mrd->address);
-		}
-
-		/*
-		 * No overflow possible: total_page_count can hold at
-		 * least 2^64 - 1, but will be have at most 2^32 - 1.
-		 * values added to it, each of which cannot exceed 2^32 - 1.
-		 */
-		total_page_count += mrd->page_count;
-	}
+	spmc_shmem_obj_check_constituents(obj, ffa_version);
+	assert(obj->cons_checked == obj->desc_size);
+	total_page_count = obj->cons_page_count;
 
 	if (comp->total_page_count != total_page_count) {
 		WARN("%s: invalid object, desc total_page_count %u != %llu\n",
@@ -960,7 +1408,6 @@ static int spmc_shmem_check_obj(struct spmc_shmem_obj *obj,
 static int spmc_shmem_check_state_obj(struct spmc_shmem_obj *obj,
 				      uint32_t ffa_version)
 {
-	size_t obj_offset = 0;
 	struct spmc_shmem_obj *inflight_obj;
 
 	struct ffa_comp_mrd *other_mrd;
@@ -971,10 +1418,8 @@ static int spmc_shmem_check_state_obj(struct spmc_shmem_obj *obj,
 		return FFA_ERROR_INVALID_PARAMETER;
 	}
 
-	inflight_obj = spmc_shmem_obj_get_next(&spmc_shmem_obj_state,
-					       &obj_offset);
-
-	while (inflight_obj != NULL) {
+	for (inflight_obj = spmc_shmem_obj_state.objs; inflight_obj != NULL;
+	     inflight_obj = inflight_obj->next) {
 		/*
 		 * Don't compare the transaction to itself or to partially
 		 * transmitted descriptors.
@@ -991,9 +1436,6 @@ static int spmc_shmem_check_state_obj(struct spmc_shmem_obj *obj,
 				return FFA_ERROR_INVALID_PARAMETER;
 			}
 		}
-
-		inflight_obj = spmc_shmem_obj_get_next(&spmc_shmem_obj_state,
-						       &obj_offset);
 	}
 	return 0;
 }
@@ -1070,9 +1512,11 @@ static long spmc_ffa_fill_desc(struct mailbox *mbox,
 
 		obj->desc.handle = spmc_shmem_obj_state.next_handle++;
 		obj->desc.flags |= mtd_flag;
+		spmc_shmem_obj_index(&spmc_shmem_obj_state, obj);
 	}
 
 	obj->desc_filled += fragment_length;
+	spmc_shmem_obj_check_constituents(obj, ffa_version);
 
 	handle_low = (uint32_t)obj->desc.handle;
 	handle_high = obj->desc.handle >> 32;
@@ -1102,7 +1546,6 @@ static long spmc_ffa_fill_desc(struct mailbox *mbox,
 	 */
 	if (ffa_version == MAKE_FFA_VERSION(1, 0)) {
 		struct spmc_shmem_obj *v1_1_obj;
-		uint64_t mem_handle;
 
 		/* Calculate the size that the v1.1 descriptor will required. */
 		uint64_t v1_1_desc_size =
@@ -1136,15 +1579,9 @@ static long spmc_ffa_fill_desc(struct mailbox *mbox,
 		 * We're finished with the v1.0 descriptor so free it
 		 * and continue our checks with the new v1.1 descriptor.
 		 */
-		mem_handle = obj->desc.handle;
 		spmc_shmem_obj_free(&spmc_shmem_obj_state, obj);
-		obj = spmc_shmem_obj_lookup(&spmc_shmem_obj_state, mem_handle);
-		if (obj == NULL) {
-			ERROR("%s: Failed to find converted descriptor.\n",
-			     __func__);
-			ret = FFA_ERROR_INVALID_PARAMETER;
-			return spmc_ffa_error_return(smc_handle, ret);
-		}
+		obj = v1_1_obj;
+		spmc_shmem_obj_index(&spmc_shmem_obj_state, obj);
 	}
 
 	/* Allow for platform specific operations to be performed. */
@@ -1402,6 +1839,7 @@ spmc_ffa_mem_retrieve_req(uint32_t smc_fid,
 	struct mailbox *mbox = spmc_get_mbox_desc(secure_origin);
 	uint32_t ffa_version = get_partition_ffa_version(secure_origin);
 	struct secure_partition_desc *sp_ctx = spmc_get_current_sp_ctx();
+	bool keep_state;
 
 	if (!secure_origin) {
 		WARN("%s: unsupported retrieve req direction.\n", __func__);
@@ -1460,19 +1898,13 @@ spmc_ffa_mem_retrieve_req(uint32_t smc_fid,
 		goto err_unlock_mailbox;
 	}
 
-	spin_lock(&spmc_shmem_obj_state.lock);
+	/* A v1.0 caller needs a temporary object for the converted descriptor. */
+	keep_state = (ffa_version == MAKE_FFA_VERSION(1, 0));
 
-	obj = spmc_shmem_obj_lookup(&spmc_shmem_obj_state, req->handle);
+	obj = spmc_shmem_obj_get(req->handle, keep_state);
 	if (obj == NULL) {
 		ret = FFA_ERROR_INVALID_PARAMETER;
-		goto err_unlock_all;
-	}
-
-	if (obj->desc_filled != obj->desc_size) {
-		WARN("%s: incomplete object desc filled %zu < size %zu\n",
-		     __func__, obj->desc_filled, obj->desc_size);
-		ret = FFA_ERROR_INVALID_PARAMETER;
-		goto err_unlock_all;
+		goto err_unlock_mailbox;
 	}
 
 	if (req->emad_count != 0U && req->sender_id != obj->desc.sender_id) {
@@ -1616,14 +2048,14 @@ spmc_ffa_mem_retrieve_req(uint32_t smc_fid,
 	/* Set the NS bit in the response if applicable. */
 	spmc_ffa_mem_retrieve_set_ns_bit(resp, sp_ctx);
 
-	spin_unlock(&spmc_shmem_obj_state.lock);
+	spmc_shmem_obj_put(obj, keep_state);
 	spin_unlock(&mbox->lock);
 
 	SMC_RET8(handle, FFA_MEM_RETRIEVE_RESP, out_desc_size,
 		 copy_size, 0, 0, 0, 0, 0);
 
 err_unlock_all:
-	spin_unlock(&spmc_shmem_obj_state.lock);
+	spmc_shmem_obj_put(obj, keep_state);
 err_unlock_mailbox:
 	spin_unlock(&mbox->lock);
 	return spmc_ffa_error_return(handle, ret);
@@ -1662,6 +2094,7 @@ long spmc_ffa_mem_frag_rx(uint32_t smc_fid,
 	uint64_t mem_handle = handle_low | (((uint64_t)handle_high) << 32);
 	struct spmc_shmem_obj *obj;
 	uint32_t ffa_version = get_partition_ffa_version(secure_origin);
+	bool keep_state;
 
 	if (!secure_origin) {
 		WARN("%s: can only be called from swld.\n",
@@ -1670,14 +2103,19 @@ long spmc_ffa_mem_frag_rx(uint32_t smc_fid,
 					     FFA_ERROR_INVALID_PARAMETER);
 	}
 
-	spin_lock(&spmc_shmem_obj_state.lock);
+	/*
+	 * Take the mailbox lock first, in the same order as
+	 * spmc_ffa_mem_retrieve_req.
+	 */
+	spin_lock(&mbox->lock);
 
-	obj = spmc_shmem_obj_lookup(&spmc_shmem_obj_state, mem_handle);
+	/* A v1.0 caller needs a temporary object for the converted descriptor. */
+	keep_state = (ffa_version == MAKE_FFA_VERSION(1, 0));
+
+	obj = spmc_shmem_obj_get(mem_handle, keep_state);
 	if (obj == NULL) {
-		WARN("%s: invalid handle, 0x%lx, not a valid handle.\n",
-		     __func__, mem_handle);
 		ret = FFA_ERROR_INVALID_PARAMETER;
-		goto err_unlock_shmem;
+		goto err_unlock_mailbox;
 	}
 
 	desc_sender_id = (uint32_t)obj->desc.sender_id << 16;
@@ -1685,18 +2123,16 @@ long spmc_ffa_mem_frag_rx(uint32_t smc_fid,
 		WARN("%s: invalid sender_id 0x%x != 0x%x\n", __func__,
 		     sender_id, desc_sender_id);
 		ret = FFA_ERROR_INVALID_PARAMETER;
-		goto err_unlock_shmem;
+		goto err_unlock_all;
 	}
 
 	if (fragment_offset >= obj->desc_size) {
 		WARN("%s: invalid fragment_offset 0x%x >= 0x%zx\n",
 		     __func__, fragment_offset, obj->desc_size);
 		ret = FFA_ERROR_INVALID_PARAMETER;
-		goto err_unlock_shmem;
+		goto err_unlock_all;
 	}
 
-	spin_lock(&mbox->lock);
-
 	if (mbox->rxtx_page_count == 0U) {
 		WARN("%s: buffer pair not registered.\n", __func__);
 		ret = FFA_ERROR_INVALID_PARAMETER;
@@ -1738,16 +2174,16 @@ long spmc_ffa_mem_frag_rx(uint32_t smc_fid,
 		memcpy(mbox->rx_buffer, src + fragment_offset, copy_size);
 	}
 
+	spmc_shmem_obj_put(obj, keep_state);
 	spin_unlock(&mbox->lock);
-	spin_unlock(&spmc_shmem_obj_state.lock);
 
 	SMC_RET8(handle, FFA_MEM_FRAG_TX, handle_low, handle_high,
 		 copy_size, sender_id, 0, 0, 0);
 
 err_unlock_all:
+	spmc_shmem_obj_put(obj, keep_state);
+err_unlock_mailbox:
 	spin_unlock(&mbox->lock);
-err_unlock_shmem:
-	spin_unlock(&spmc_shmem_obj_state.lock);
 	return spmc_ffa_error_return(handle, ret);
 }
 
@@ -1806,12 +2242,10 @@ int spmc_ffa_mem_relinquish(uint32_t smc_fid,
 		goto err_unlock_mailbox;
 	}
 
-	spin_lock(&spmc_shmem_obj_state.lock);
-
-	obj = spmc_shmem_obj_lookup(&spmc_shmem_obj_state, req->handle);
+	obj = spmc_shmem_obj_get(req->handle, false);
 	if (obj == NULL) {
 		ret = FFA_ERROR_INVALID_PARAMETER;
-		goto err_unlock_all;
+		goto err_unlock_mailbox;
 	}
 
 	/*
@@ -1847,13 +2281,13 @@ int spmc_ffa_mem_relinquish(uint32_t smc_fid,
 	}
 	obj->in_use--;
 
-	spin_unlock(&spmc_shmem_obj_state.lock);
+	spmc_shmem_obj_put(obj, false);
 	spin_unlock(&mbox->lock);
 
 	SMC_RET1(handle, FFA_SUCCESS_SMC32);
 
 err_unlock_all:
-	spin_unlock(&spmc_shmem_obj_state.lock);
+	spmc_shmem_obj_put(obj, false);
 err_unlock_mailbox:
 	spin_unlock(&mbox->lock);
 	return spmc_ffa_error_return(handle, ret);
@@ -1898,37 +2332,31 @@ int spmc_ffa_mem_reclaim(uint32_t smc_fid,
 					     FFA_ERROR_INVALID_PARAMETER);
 	}
 
-	spin_lock(&spmc_shmem_obj_state.lock);
-
-	obj = spmc_shmem_obj_lookup(&spmc_shmem_obj_state, mem_handle);
+	/* Keep the state locked to free the object. */
+	obj = spmc_shmem_obj_get(mem_handle, true);
 	if (obj == NULL) {
-		ret = FFA_ERROR_INVALID_PARAMETER;
-		goto err_unlock;
+		return spmc_ffa_error_return(handle,
+					     FFA_ERROR_INVALID_PARAMETER);
 	}
 	if (obj->in_use != 0U) {
 		ret = FFA_ERROR_DENIED;
 		goto err_unlock;
 	}
 
-	if (obj->desc_filled != obj->desc_size) {
-		WARN("%s: incomplete object desc filled %zu < size %zu\n",
-		     __func__, obj->desc_filled, obj->desc_size);
-		ret = FFA_ERROR_INVALID_PARAMETER;
-		goto err_unlock;
-	}
-
 	/* Allow for platform specific operations to be performed. */
 	ret = plat_spmc_shmem_reclaim(&obj->desc);
 	if (ret != 0) {
 		goto err_unlock;
 	}
 
+	/* Nobody else can be waiting for the lock while the state is locked */
+	spin_unlock(&obj->lock);
 	spmc_shmem_obj_free(&spmc_shmem_obj_state, obj);
 	spin_unlock(&spmc_shmem_obj_state.lock);
 
 	SMC_RET1(handle, FFA_SUCCESS_SMC32);
 
 err_unlock:
-	spin_unlock(&spmc_shmem_obj_state.lock);
+	spmc_shmem_obj_put(obj, true);
 	return spmc_ffa_error_return(handle, ret);
 }
@@ -31,12 +31,23 @@ struct ffa_mem_relinquish_descriptor {
 CASSERT(sizeof(struct ffa_mem_relinquish_descriptor) == 16,
 	assert_ffa_mem_relinquish_descriptor_size_mismatch);
 
+/* Number of power of two object size classes, starting at 128 bytes. */
+#define SPMC_SHMEM_OBJ_CLASSES		U(24)
+/* Number of buckets in the handle to object hash, must be a power of two. */
+#define SPMC_SHMEM_OBJ_HASH_SIZE	U(128)
+
+struct spmc_shmem_obj;
+
 /**
  * struct spmc_shmem_obj_state - Global state.
  * @data:           Backing store for spmc_shmem_obj objects.
  * @data_size:      The size allocated for the backing store.
- * @allocated:      Number of bytes allocated in @data.
+ * @allocated:      Number of bytes of @data carved into object blocks. Free
+ *                  blocks ending here are given back to the unused area.
  * @next_handle:    Handle used for next allocated object.
+ * @free_list:      Free blocks, one doubly linked list per size class.
+ * @hash:           Objects with a handle, hashed by handle.
+ * @objs:           List of all allocated objects.
  * @lock:           Lock protecting all state in this file.
  */
 struct spmc_shmem_obj_state {
@@ -44,6 +55,9 @@ struct spmc_shmem_obj_state {
 	size_t data_size;
 	size_t allocated;
 	uint64_t next_handle;
+	struct spmc_shmem_obj *free_list[SPMC_SHMEM_OBJ_CLASSES];
+	struct spmc_shmem_obj *hash[SPMC_SHMEM_OBJ_HASH_SIZE];
+	struct spmc_shmem_obj *objs;
 	spinlock_t lock;
 };
 
@@ -0,0 +1,22 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host version of the barriers used by the CAAM driver. The SEC model runs in
+ * the same thread as the driver, so they only need to stop the compiler from
+ * reordering the accesses to the rings. The model is coherent, so the cache
+ * maintenance of SEC_MEM_NON_COHERENT is not built.
+ */
+
+#ifndef ARCH_HELPERS_H
+#define ARCH_HELPERS_H
+
+#define dsb()		__atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define dsbsy()		__atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define dmbsy()		__atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define isb()		__atomic_signal_fence(__ATOMIC_SEQ_CST)
+
+#endif /* ARCH_HELPERS_H */
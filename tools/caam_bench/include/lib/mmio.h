@@ -0,0 +1,31 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host version of the MMIO accessors used by the CAAM driver. Accesses to the
+ * job ring registers go to the SEC model of the test, the others, to the
+ * descriptors, the rings and the rest of the CCSR block, to memory.
+ */
+
+#ifndef MMIO_H
+#define MMIO_H
+
+#include <stdint.h>
+
+uint32_t host_sec_read_32(uintptr_t addr);
+void host_sec_write_32(uintptr_t addr, uint32_t value);
+
+static inline uint32_t mmio_read_32(uintptr_t addr)
+{
+	return host_sec_read_32(addr);
+}
+
+static inline void mmio_write_32(uintptr_t addr, uint32_t value)
+{
+	host_sec_write_32(addr, value);
+}
+
+#endif /* MMIO_H */
@@ -0,0 +1,1242 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host test and benchmark of the CAAM driver.
+ *
+ * The AES-GCM decryption and SHA-256 descriptors built by jobdesc.c are
+ * compared word by word with descriptors encoded here from the command
+ * fields of the SEC reference manual, so that a wrong field or command order
+ * is caught without a SEC to run the job.
+ *
+ * The job ring driver, the hashing and the RSA verification then run against
+ * a model of the SEC job ring. The model takes the jobs rung in by the
+ * driver, runs them on a few DECOs with a given latency each, so that they
+ * complete out of order, and writes them to the output ring as they complete.
+ * The hashes are not SHA-256 but a cheaper digest computed the same way by
+ * the test, and the RSA public key operation only supports e = 1, which is
+ * enough to check that every job gets its own result.
+ */
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <drivers/auth/crypto_mod.h>
+
+#include "caam.h"
+#include "hash.h"
+#include "jobdesc.h"
+#include "nxp_timer.h"
+#include "rsa.h"
+#include "sec_hw_specific.h"
+#include "sec_jr_driver.h"
+
+/*
+ * Command fields of the reference manual, prefixed with RM_ to keep them
+ * apart from the encodings of jobdesc.h that they check.
+ */
+
+/* Command type, bits 31-27 of every command */
+#define RM_CMD_TYPE(t)		((uint32_t)(t) << 27)
+#define RM_CMD_KEY		RM_CMD_TYPE(0x00U)
+#define RM_CMD_FIFO_LOAD	RM_CMD_TYPE(0x04U)
+#define RM_CMD_STORE		RM_CMD_TYPE(0x0aU)
+#define RM_CMD_FIFO_STORE	RM_CMD_TYPE(0x0cU)
+#define RM_CMD_OPERATION	RM_CMD_TYPE(0x10U)
+#define RM_CMD_HEADER		RM_CMD_TYPE(0x16U)
+#define RM_CMD_MASK		RM_CMD_TYPE(0x1fU)
+
+/* Job header: ONE is always set, the descriptor length is in bits 6-0 */
+#define RM_HDR_ONE		(1U << 23)
+#define RM_HDR_DESCLEN_MASK	0x7fU
+
+/* KEY, FIFO LOAD and STORE: class of the CHA, bits 26-25 */
+#define RM_CLASS_1		(1U << 25)
+#define RM_CLASS_2		(2U << 25)
+
+/* KEY destination, bits 17-16, and length, bits 9-0 */
+#define RM_KEY_DEST_PKHA_E	(1U << 16)
+#define RM_KEY_LEN_MASK		0x3ffU
+
+/*
+ * FIFO LOAD and FIFO STORE: the pointer is to an SG table, an extended
+ * length word follows the pointer, the length is in bits 15-0 otherwise.
+ */
+#define RM_FIFO_SGT		(1U << 24)
+#define RM_FIFO_EXT		(1U << 22)
+#define RM_FIFO_LEN_MASK	0xffffU
+
+/* FIFO LOAD input data type, bits 21-16 */
+#define RM_FIFOLD_TYPE(t)	((uint32_t)(t) << 16)
+#define RM_FIFOLD_TYPE_MSG	RM_FIFOLD_TYPE(0x10U)
+#define RM_FIFOLD_TYPE_IV	RM_FIFOLD_TYPE(0x20U)
+#define RM_FIFOLD_TYPE_ICV	RM_FIFOLD_TYPE(0x38U)
+#define RM_FIFOLD_TYPE_FLUSH1	RM_FIFOLD_TYPE(0x01U)
+#define RM_FIFOLD_TYPE_LAST1	RM_FIFOLD_TYPE(0x02U)
+#define RM_FIFOLD_TYPE_LAST2	RM_FIFOLD_TYPE(0x04U)
+#define RM_FIFOLD_TYPE_PK_N	RM_FIFOLD_TYPE(0x08U)
+#define RM_FIFOLD_TYPE_PK_A	RM_FIFOLD_TYPE(0x0cU)
+#define RM_FIFOLD_TYPE_MASK	RM_FIFOLD_TYPE(0x3fU)
+#define RM_FIFOLD_TYPE_MSG_MASK	RM_FIFOLD_TYPE(0x30U)
+
+/* FIFO STORE output data type, bits 21-16 */
+#define RM_FIFOST_TYPE_MSG	(0x30U << 16)
+#define RM_FIFOST_TYPE_PKHA_B	(0x0dU << 16)
+
+/* STORE source, bits 22-16, and length, bits 7-0 */
+#define RM_STORE_SRC_CONTEXT	(0x20U << 16)
+#define RM_STORE_LEN_MASK	0xffU
+
+/* OPERATION fields */
+#define RM_OP_TYPE_PK		(1U << 24)
+#define RM_OP_TYPE_CLASS1_ALG	(2U << 24)
+#define RM_OP_TYPE_CLASS2_ALG	(4U << 24)
+#define RM_OP_TYPE_MASK		(7U << 24)
+#define RM_OP_ALGSEL_MASK	(0xffU << 16)
+#define RM_OP_ALGSEL_AES	(0x10U << 16)
+#define RM_OP_ALGSEL_SHA256	(0x43U << 16)
+#define RM_OP_AAI_HASH		(0x00U << 4)
+#define RM_OP_AAI_GCM		(0x90U << 4)
+#define RM_OP_AS_INITFINAL	(3U << 2)
+#define RM_OP_ICV_ON		(1U << 1)
+#define RM_OP_DECRYPT		0U
+#define RM_OP_ENCRYPT		1U
+
+/* PKHA operation: B = A ^ E mod N */
+#define RM_OP_ALG_PK		(1U << 23)
+#define RM_OP_PKMODE_MOD_EXPO	0x006U
+
+/* A descriptor encoded from the fields above */
+typedef struct desc_s {
+	uint32_t word[MAX_DESC_SIZE_WORDS];
+	unsigned int len;
+} desc_t;
+
+static int failed;
+
+static void fail(const char *what, const char *fmt, ...)
+	__attribute__((format(printf, 2, 3)));
+
+static void fail(const char *what, const char *fmt, ...)
+{
+	va_list ap;
+
+	fprintf(stderr, "%s: ", what);
+	va_start(ap, fmt);
+	vfprintf(stderr, fmt, ap);
+	va_end(ap);
+	fprintf(stderr, "\n");
+	failed++;
+}
+
+static void exp_word(desc_t *d, uint32_t word)
+{
+	d->word[d->len++] = word;
+}
+
+/* Pointers are two words, in the order of ptr_addr_t on a little-endian SEC */
+static void exp_ptr(desc_t *d, const void *ptr)
+{
+	uint64_t addr = (uint64_t)(uintptr_t)ptr;
+
+	exp_word(d, (uint32_t)addr);
+	exp_word(d, (uint32_t)(addr >> 32));
+}
+
+static void exp_header(desc_t *d)
+{
+	d->word[0] = RM_CMD_HEADER | RM_HDR_ONE | d->len;
+}
+
+static void compare(const char *what, const uint32_t *desc, const desc_t *exp)
+{
+	unsigned int i, len = desc[0] & RM_HDR_DESCLEN_MASK;
+
+	if (len != exp->len) {
+		fail(what, "%u words, expected %u", len, exp->len);
+		return;
+	}
+
+	if (len >= MAX_DESC_SIZE_WORDS) {
+		fail(what, "%u words do not fit a job descriptor", len);
+		return;
+	}
+
+	for (i = 0U; i < len; i++) {
+		if (desc[i] != exp->word[i]) {
+			fail(what, "word %u is 0x%08x, expected 0x%08x", i,
+			     desc[i], exp->word[i]);
+		}
+	}
+}
+
+static void check_aes_gcm(uint32_t key_len, uint32_t iv_len, uint32_t len,
+			  bool sg, uint32_t tag_len)
+{
+	static uint8_t key[32], iv[16], data[64], tag[16];
+	uint32_t desc[MAX_DESC_SIZE_WORDS];
+	uint32_t sgt = sg ? RM_FIFO_SGT : 0U;
+	desc_t exp = { .len = 1U };
+	char what[96];
+
+	memset(desc, 0, sizeof(desc));
+	cnstr_aes_gcm_dec_jobdesc(desc, key, key_len, iv, iv_len, data, len,
+				  sg, tag, tag_len);
+
+	/* Class 1 key, by reference */
+	exp_word(&exp, RM_CMD_KEY | RM_CLASS_1 | key_len);
+	exp_ptr(&exp, key);
+
+	/* Decryption with ICV check, in one go */
+	exp_word(&exp, RM_CMD_OPERATION | RM_OP_TYPE_CLASS1_ALG |
+		 RM_OP_ALGSEL_AES | RM_OP_AAI_GCM | RM_OP_AS_INITFINAL |
+		 RM_OP_ICV_ON | RM_OP_DECRYPT);
+
+	/* IV, flushed as there is no AAD */
+	exp_word(&exp, RM_CMD_FIFO_LOAD | RM_CLASS_1 | RM_FIFOLD_TYPE_IV |
+		 RM_FIFOLD_TYPE_FLUSH1 | iv_len);
+	exp_ptr(&exp, iv);
+
+	/* Ciphertext, last class 1 data, with an extended length */
+	exp_word(&exp, RM_CMD_FIFO_LOAD | RM_CLASS_1 | sgt | RM_FIFO_EXT |
+		 RM_FIFOLD_TYPE_MSG | RM_FIFOLD_TYPE_LAST1);
+	exp_ptr(&exp, data);
+	exp_word(&exp, len);
+
+	/* Plaintext, in place */
+	exp_word(&exp, RM_CMD_FIFO_STORE | sgt | RM_FIFO_EXT |
+		 RM_FIFOST_TYPE_MSG);
+	exp_ptr(&exp, data);
+	exp_word(&exp, len);
+
+	/* Expected tag, checked by the operation */
+	exp_word(&exp, RM_CMD_FIFO_LOAD | RM_CLASS_1 | RM_FIFOLD_TYPE_ICV |
+		 RM_FIFOLD_TYPE_LAST1 | tag_len);
+	exp_ptr(&exp, tag);
+
+	exp_header(&exp);
+
+	snprintf(what, sizeof(what),
+		 "AES-GCM key %u, IV %u, tag %u, %u bytes%s", key_len, iv_len,
+		 tag_len, len, sg ? " in an SG table" : "");
+	compare(what, desc, &exp);
+}
+
+static void check_hash(uint32_t len)
+{
+	static uint8_t msg[64], digest[SHA256_DIGEST_SIZE];
+	uint32_t desc[MAX_DESC_SIZE_WORDS];
+	desc_t exp = { .len = 1U };
+	char what[64];
+
+	memset(desc, 0, sizeof(desc));
+	cnstr_hash_jobdesc(desc, msg, len, digest);
+
+	exp_word(&exp, RM_CMD_OPERATION | RM_OP_TYPE_CLASS2_ALG |
+		 RM_OP_ALGSEL_SHA256 | RM_OP_AAI_HASH | RM_OP_AS_INITFINAL |
+		 RM_OP_ENCRYPT);
+
+	/* The message is always given as an SG table */
+	if (len > RM_FIFO_LEN_MASK) {
+		exp_word(&exp, RM_CMD_FIFO_LOAD | RM_CLASS_2 | RM_FIFO_SGT |
+			 RM_FIFO_EXT | RM_FIFOLD_TYPE_MSG |
+			 RM_FIFOLD_TYPE_LAST2);
+		exp_ptr(&exp, msg);
+		exp_word(&exp, len);
+	} else {
+		exp_word(&exp, RM_CMD_FIFO_LOAD | RM_CLASS_2 | RM_FIFO_SGT |
+			 RM_FIFOLD_TYPE_MSG | RM_FIFOLD_TYPE_LAST2 | len);
+		exp_ptr(&exp, msg);
+	}
+
+	/* Digest, from the class 2 context */
+	exp_word(&exp, RM_CMD_STORE | RM_CLASS_2 | RM_STORE_SRC_CONTEXT |
+		 SHA256_DIGEST_SIZE);
+	exp_ptr(&exp, digest);
+
+	exp_header(&exp);
+
+	snprintf(what, sizeof(what), "SHA-256 of %u bytes", len);
+	compare(what, desc, &exp);
+}
+
+static void check_descriptors(void)
+{
+	static const uint32_t key_lens[] = { 16U, 24U, 32U };
+	static const uint32_t iv_lens[] = { 12U, 16U };
+	static const uint32_t tag_lens[] = { 12U, 16U };
+	static const uint32_t lens[] = {
+		1U, 16U, 0xffffU, 0x10000U, 0x100000U, 0x3fffffffU
+	};
+	unsigned int k, i, t, l;
+
+	for (k = 0U; k < ARRAY_SIZE(key_lens); k++) {
+		for (i = 0U; i < ARRAY_SIZE(iv_lens); i++) {
+			for (t = 0U; t < ARRAY_SIZE(tag_lens); t++) {
+				for (l = 0U; l < ARRAY_SIZE(lens); l++) {
+					check_aes_gcm(key_lens[k], iv_lens[i],
+						      lens[l], false,
+						      tag_lens[t]);
+					check_aes_gcm(key_lens[k], iv_lens[i],
+						      lens[l], true,
+						      tag_lens[t]);
+				}
+			}
+		}
+	}
+
+	for (l = 0U; l < ARRAY_SIZE(lens); l++) {
+		check_hash(lens[l]);
+	}
+}
+
+
+/*
+ * SEC model
+ */
+
+/* Status of the jobs that the model cannot run: DECO error */
+#define SEC_STATUS_DECO_ERR	0x40000001U
+
+#define SEC_DECOS_MAX		8U
+
+/* Commands of a descriptor, as read by the model */
+struct sec_cmds {
+	uint32_t op;
+	const uint8_t *msg;
+	uint32_t msg_len;
+	bool msg_sgt;
+	const uint8_t *pk_e, *pk_a, *pk_n;
+	uint32_t e_len, a_len, n_len;
+	uint8_t *out;
+	uint32_t out_len;
+};
+
+struct sec_job {
+	uint32_t *desc;
+	uint64_t done_at;
+	unsigned int seq;
+};
+
+static uint8_t ccsr[CAAM_JR3_OFFSET + 0x10000U] __aligned(4096);
+
+static struct {
+	struct jobring_regs *regs;	/* Registers of DEFAULT_JR */
+	unsigned int in_idx;		/* Next input ring entry to read */
+	unsigned int out_idx;		/* Next output ring entry to write */
+	uint32_t finished;		/* ORSF: jobs in the output ring */
+	struct sec_job jobs[SEC_JOB_RING_SIZE];
+	unsigned int running;
+	unsigned int seq;
+	uint64_t deco_free[SEC_DECOS_MAX];
+	unsigned int max_in_flight;
+
+	/* Job latencies: random, or from a hash rate and an RSA time */
+	unsigned int decos;
+	bool random_latency;
+	uint64_t hash_rate;		/* MB/s */
+	uint64_t pk_ns;
+} sec;
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+/* The CAAM driver timer, in ms */
+uint64_t get_timer_val(uint64_t start)
+{
+	return (now_ns() / 1000000U) - start;
+}
+
+static uint64_t read_ptr(const uint32_t *words)
+{
+	return (uint64_t)words[0] | ((uint64_t)words[1] << 32);
+}
+
+static void write_ptr(uint32_t *words, uint64_t addr)
+{
+	words[0] = (uint32_t)addr;
+	words[1] = (uint32_t)(addr >> 32);
+}
+
+/*
+ * Stand-in for SHA-256: four FNV-1a lanes over the 64-bit words, each data
+ * buffer being digested on its own, the SG entries by the model and the
+ * buffers passed to hash_update() by the test.
+ */
+#define DIGEST_LANES		(SHA256_DIGEST_SIZE / 8)
+#define FNV_OFFSET		0xcbf29ce484222325ULL
+#define FNV_PRIME		0x100000001b3ULL
+
+typedef struct digest_s {
+	uint64_t lane[DIGEST_LANES];
+} digest_t;
+
+static void digest_init(digest_t *d)
+{
+	unsigned int i;
+
+	for (i = 0U; i < DIGEST_LANES; i++) {
+		d->lane[i] = FNV_OFFSET + i;
+	}
+}
+
+static void digest_update(digest_t *d, const uint8_t *data, size_t len)
+{
+	uint64_t word;
+	size_t i;
+
+	for (i = 0U; (i + 8U) <= len; i += 8U) {
+		memcpy(&word, &data[i], 8U);
+		d->lane[(i / 8U) % DIGEST_LANES] =
+			(d->lane[(i / 8U) % DIGEST_LANES] ^ word) * FNV_PRIME;
+	}
+
+	for (; i < len; i++) {
+		d->lane[0] = (d->lane[0] ^ data[i]) * FNV_PRIME;
+	}
+
+	d->lane[1] = (d->lane[1] ^ len) * FNV_PRIME;
+}
+
+static void digest_final(const digest_t *d, uint8_t *out)
+{
+	memcpy(out, d->lane, SHA256_DIGEST_SIZE);
+}
+
+/* Read the commands of a descriptor, false if the model does not know one */
+static bool sec_parse(const uint32_t *desc, struct sec_cmds *c)
+{
+	unsigned int len = desc[0] & RM_HDR_DESCLEN_MASK;
+	unsigned int i = 1U;
+	uint32_t word, n, type;
+	uint8_t *ptr;
+
+	memset(c, 0, sizeof(*c));
+
+	if ((desc[0] & (RM_CMD_MASK | RM_HDR_ONE)) !=
+	    (RM_CMD_HEADER | RM_HDR_ONE)) {
+		return false;
+	}
+
+	while (i < len) {
+		word = desc[i++];
+
+		if ((word & RM_CMD_MASK) == RM_CMD_OPERATION) {
+			c->op = word;
+			continue;
+		}
+
+		ptr = (uint8_t *)(uintptr_t)read_ptr(&desc[i]);
+		i += 2U;
+
+		switch (word & RM_CMD_MASK) {
+		case RM_CMD_KEY:
+			if ((word & RM_KEY_DEST_PKHA_E) == 0U) {
+				return false;
+			}
+			c->pk_e = ptr;
+			c->e_len = word & RM_KEY_LEN_MASK;
+			break;
+		case RM_CMD_FIFO_LOAD:
+			n = ((word & RM_FIFO_EXT) != 0U) ? desc[i++] :
+							   word & RM_FIFO_LEN_MASK;
+			type = word & RM_FIFOLD_TYPE_MASK;
+			if (type == RM_FIFOLD_TYPE_PK_A) {
+				c->pk_a = ptr;
+				c->a_len = n;
+			} else if (type == RM_FIFOLD_TYPE_PK_N) {
+				c->pk_n = ptr;
+				c->n_len = n;
+			} else if ((type & RM_FIFOLD_TYPE_MSG_MASK) ==
+				   RM_FIFOLD_TYPE_MSG) {
+				c->msg = ptr;
+				c->msg_len = n;
+				c->msg_sgt = (word & RM_FIFO_SGT) != 0U;
+			} else {
+				return false;
+			}
+			break;
+		case RM_CMD_STORE:
+			c->out = ptr;
+			c->out_len = word & RM_STORE_LEN_MASK;
+			break;
+		case RM_CMD_FIFO_STORE:
+			c->out = ptr;
+			c->out_len = ((word & RM_FIFO_EXT) != 0U) ?
+				     desc[i++] : word & RM_FIFO_LEN_MASK;
+			break;
+		default:
+			return false;
+		}
+	}
+
+	return i == len;
+}
+
+static bool sec_is_hash(const struct sec_cmds *c)
+{
+	return ((c->op & (RM_CMD_MASK | RM_OP_TYPE_MASK | RM_OP_ALGSEL_MASK)) ==
+		(RM_CMD_OPERATION | RM_OP_TYPE_CLASS2_ALG | RM_OP_ALGSEL_SHA256)) &&
+	       (c->msg != NULL) && (c->out != NULL) &&
+	       (c->out_len == SHA256_DIGEST_SIZE);
+}
+
+static bool sec_is_mod_exp(const struct sec_cmds *c)
+{
+	return (c->op == (RM_CMD_OPERATION | RM_OP_TYPE_PK | RM_OP_ALG_PK |
+			  RM_OP_PKMODE_MOD_EXPO)) &&
+	       (c->pk_e != NULL) && (c->pk_a != NULL) && (c->pk_n != NULL) &&
+	       (c->out != NULL);
+}
+
+static uint32_t sec_hash(const struct sec_cmds *c)
+{
+	const struct sg_entry *sg = (const struct sg_entry *)c->msg;
+	uint32_t total = 0U, n;
+	unsigned int i;
+	digest_t d;
+
+	digest_init(&d);
+
+	if (!c->msg_sgt) {
+		digest_update(&d, c->msg, c->msg_len);
+	} else {
+		for (i = 0U; ; i++) {
+			if (i == MAX_SG) {
+				return SEC_STATUS_DECO_ERR;
+			}
+
+			n = sg[i].len_flag & SG_ENTRY_LENGTH_MASK;
+			digest_update(&d, (const uint8_t *)(uintptr_t)
+				      (((uint64_t)sg[i].addr_hi << 32) |
+				       sg[i].addr_lo), n);
+			total += n;
+
+			if ((sg[i].len_flag & SG_ENTRY_FINAL_BIT) != 0U) {
+				break;
+			}
+		}
+
+		if (total != c->msg_len) {
+			return SEC_STATUS_DECO_ERR;
+		}
+	}
+
+	digest_final(&d, c->out);
+
+	return 0U;
+}
+
+/* B = A ^ E mod N, for E = 1 and A < N only */
+static uint32_t sec_mod_exp(const struct sec_cmds *c)
+{
+	unsigned int i;
+
+	if ((c->e_len == 0U) || (c->pk_e[c->e_len - 1U] != 1U) ||
+	    (c->a_len != c->n_len) || (c->out_len != c->a_len) ||
+	    (memcmp(c->pk_a, c->pk_n, c->a_len) >= 0)) {
+		return SEC_STATUS_DECO_ERR;
+	}
+
+	for (i = 0U; i < (c->e_len - 1U); i++) {
+		if (c->pk_e[i] != 0U) {
+			return SEC_STATUS_DECO_ERR;
+		}
+	}
+
+	memcpy(c->out, c->pk_a, c->out_len);
+
+	return 0U;
+}
+
+static uint32_t sec_exec(const uint32_t *desc)
+{
+	struct sec_cmds c;
+
+	if (!sec_parse(desc, &c)) {
+		return SEC_STATUS_DECO_ERR;
+	}
+
+	if (sec_is_hash(&c)) {
+		return sec_hash(&c);
+	}
+
+	if (sec_is_mod_exp(&c)) {
+		return sec_mod_exp(&c);
+	}
+
+	return SEC_STATUS_DECO_ERR;
+}
+
+static uint64_t sec_latency(const uint32_t *desc)
+{
+	struct sec_cmds c;
+
+	if (sec.random_latency) {
+		return (uint64_t)(rand() % 50000);
+	}
+
+	if (sec_parse(desc, &c) && sec_is_hash(&c)) {
+		return ((uint64_t)c.msg_len * 1000U) / sec.hash_rate;
+	}
+
+	return sec.pk_ns;
+}
+
+static void sec_reset(void)
+{
+	if ((sec.running != 0U) || (sec.finished != 0U)) {
+		fail("job ring", "reset with %u jobs in flight",
+		     sec.running + sec.finished);
+	}
+
+	sec.in_idx = 0U;
+	sec.out_idx = 0U;
+	sec.running = 0U;
+	sec.finished = 0U;
+	sec.regs->jrint = JRINT_ERR_HALT_COMPLETE;
+}
+
+/* IRJA: start the next jobs of the input ring on the first free DECOs */
+static void sec_add_jobs(uint32_t num)
+{
+	uint32_t *ring = (uint32_t *)(uintptr_t)
+			 (((uint64_t)sec.regs->irba_h << 32) |
+			  sec.regs->irba_l);
+	struct sec_job *job;
+	uint64_t start;
+	unsigned int i, d, deco;
+
+	for (; num > 0U; num--) {
+		if ((sec.running + sec.finished) >= (SEC_JOB_RING_SIZE - 1U)) {
+			fail("job ring", "job added to a full ring");
+			return;
+		}
+
+		job = &sec.jobs[sec.running];
+		job->desc = (uint32_t *)(uintptr_t)
+			    read_ptr(&ring[sec.in_idx * 2U]);
+		job->seq = sec.seq++;
+		sec.in_idx = (sec.in_idx + 1U) % SEC_JOB_RING_SIZE;
+
+		for (i = 0U; i < sec.running; i++) {
+			if (sec.jobs[i].desc == job->desc) {
+				fail("job ring", "descriptor %p added twice",
+				     (void *)job->desc);
+			}
+		}
+
+		deco = 0U;
+		for (d = 1U; d < sec.decos; d++) {
+			if (sec.deco_free[d] < sec.deco_free[deco]) {
+				deco = d;
+			}
+		}
+
+		start = now_ns();
+		if (sec.deco_free[deco] > start) {
+			start = sec.deco_free[deco];
+		}
+		job->done_at = start + sec_latency(job->desc);
+		sec.deco_free[deco] = job->done_at;
+
+		sec.running++;
+		if ((sec.running + sec.finished) > sec.max_in_flight) {
+			sec.max_in_flight = sec.running + sec.finished;
+		}
+	}
+}
+
+/* Run the jobs done by now and write them to the output ring, in order */
+static void sec_run(void)
+{
+	uint32_t *ring = (uint32_t *)(uintptr_t)
+			 (((uint64_t)sec.regs->orba_h << 32) |
+			  sec.regs->orba_l);
+	uint64_t now = now_ns();
+	struct sec_job *job;
+	uint32_t *entry;
+	unsigned int i;
+
+	for (;;) {
+		job = NULL;
+		for (i = 0U; i < sec.running; i++) {
+			if ((sec.jobs[i].done_at <= now) &&
+			    ((job == NULL) ||
+			     (sec.jobs[i].done_at < job->done_at) ||
+			     ((sec.jobs[i].done_at == job->done_at) &&
+			      (sec.jobs[i].seq < job->seq)))) {
+				job = &sec.jobs[i];
+			}
+		}
+
+		if (job == NULL) {
+			return;
+		}
+
+		entry = (uint32_t *)((uintptr_t)ring + (sec.out_idx *
+				     sizeof(struct sec_outring_entry)));
+		write_ptr(entry, (uintptr_t)job->desc);
+		entry[2] = sec_exec(job->desc);
+		sec.out_idx = (sec.out_idx + 1U) % SEC_JOB_RING_SIZE;
+		sec.finished++;
+
+		*job = sec.jobs[--sec.running];
+	}
+}
+
+static bool sec_jr_reg(uintptr_t addr, size_t *off)
+{
+	uintptr_t base = (uintptr_t)sec.regs;
+
+	if ((sec.regs == NULL) || (addr < base) ||
+	    (addr >= (base + sizeof(struct jobring_regs)))) {
+		return false;
+	}
+
+	*off = addr - base;
+
+	return true;
+}
+
+uint32_t host_sec_read_32(uintptr_t addr)
+{
+	size_t off;
+
+	if (sec_jr_reg(addr, &off)) {
+		switch (off) {
+		case offsetof(struct jobring_regs, orsf):
+			sec_run();
+			return sec.finished;
+		case offsetof(struct jobring_regs, irsa):
+			return SEC_JOB_RING_SIZE - sec.running - sec.finished;
+		case offsetof(struct jobring_regs, jrcr):
+			/* Resets complete at once */
+			return 0U;
+		default:
+			break;
+		}
+	}
+
+	return *(volatile uint32_t *)addr;
+}
+
+void host_sec_write_32(uintptr_t addr, uint32_t value)
+{
+	size_t off;
+
+	if (sec_jr_reg(addr, &off)) {
+		switch (off) {
+		case offsetof(struct jobring_regs, irja):
+			sec_add_jobs(value);
+			return;
+		case offsetof(struct jobring_regs, orjr):
+			if (value > sec.finished) {
+				fail("job ring", "%u jobs removed, %u finished",
+				     value, sec.finished);
+				value = sec.finished;
+			}
+			sec.finished -= value;
+			return;
+		case offsetof(struct jobring_regs, jrcr):
+			if ((value & JR_REG_JRCR_VAL_RESET) != 0U) {
+				sec_reset();
+			}
+			return;
+		default:
+			break;
+		}
+	}
+
+	*(volatile uint32_t *)addr = value;
+}
+
+static void sec_start(unsigned int decos, bool random_latency,
+		      uint64_t hash_rate, uint64_t pk_ns)
+{
+	sec.decos = decos;
+	sec.random_latency = random_latency;
+	sec.hash_rate = hash_rate;
+	sec.pk_ns = pk_ns;
+	sec.regs = (struct jobring_regs *)&ccsr[CAAM_JR3_OFFSET];
+
+	if (sec_init((uintptr_t)ccsr) != 0) {
+		fprintf(stderr, "Failed to initialize the CAAM driver\n");
+		exit(1);
+	}
+}
+
+/*
+ * Job ring check: hash jobs, some of them failing, submitted in batches and
+ * waited for in a random order while others complete.
+ */
+#define CHECK_JOBS		2000U
+#define CHECK_DATA_SIZE		256U
+
+struct check_job {
+	struct job_descriptor jobdesc;
+	struct sg_entry sg;
+	uint8_t data[CHECK_DATA_SIZE];
+	uint8_t digest[SHA256_DIGEST_SIZE];
+	uint8_t expected[SHA256_DIGEST_SIZE];
+	unsigned int callbacks;
+	bool fails;
+};
+
+static void check_job_done(uint32_t *desc, uint32_t status, void *arg,
+			   void *jr)
+{
+	struct check_job *job = arg;
+
+	if ((desc != job->jobdesc.desc) || (status != 0U)) {
+		fail("job ring", "callback of job %p for %p, status 0x%x",
+		     (void *)job, (void *)desc, status);
+	}
+
+	job->callbacks++;
+}
+
+static void check_job_init(struct check_job *job, unsigned int len, bool fails)
+{
+	digest_t d;
+	unsigned int i;
+
+	memset(job, 0, sizeof(*job));
+
+	for (i = 0U; i < len; i++) {
+		job->data[i] = (uint8_t)rand();
+	}
+
+	job->sg.addr_lo = (uint32_t)(uintptr_t)job->data;
+	job->sg.addr_hi = (uint32_t)((uint64_t)(uintptr_t)job->data >> 32);
+	job->sg.len_flag = len | SG_ENTRY_FINAL_BIT;
+
+	cnstr_hash_jobdesc(job->jobdesc.desc, (uint8_t *)&job->sg, len,
+			   job->digest);
+	job->jobdesc.callback = check_job_done;
+	job->jobdesc.arg = job;
+
+	/* An unknown operation makes the job fail */
+	job->fails = fails;
+	if (fails) {
+		job->jobdesc.desc[1] = RM_CMD_OPERATION | RM_OP_TYPE_CLASS2_ALG;
+	}
+
+	digest_init(&d);
+	digest_update(&d, job->data, len);
+	digest_final(&d, job->expected);
+}
+
+static void check_job_result(struct check_job *job, int rc)
+{
+	if (rc != (job->fails ? -1 : 0)) {
+		fail("job ring", "job %p returned %d", (void *)job, rc);
+	}
+
+	if (job->callbacks != (job->fails ? 0U : 1U)) {
+		fail("job ring", "job %p callback called %u times",
+		     (void *)job, job->callbacks);
+	}
+
+	if (!job->fails &&
+	    (memcmp(job->digest, job->expected, SHA256_DIGEST_SIZE) != 0)) {
+		fail("job ring", "job %p has the digest of another job",
+		     (void *)job);
+	}
+
+	if ((job->jobdesc.callback != check_job_done) ||
+	    (job->jobdesc.arg != job)) {
+		fail("job ring", "job %p callback not given back", (void *)job);
+	}
+}
+
+static void check_job_ring(void)
+{
+	static struct check_job jobs[CHECK_JOBS];
+	struct job_descriptor *batch[SEC_JOB_RING_SIZE];
+	struct check_job *pending[SEC_JOB_RING_SIZE];
+	unsigned int npending = 0U, next = 0U, room, num, i, k;
+	struct check_job extra[2];
+
+	for (i = 0U; i < CHECK_JOBS; i++) {
+		check_job_init(&jobs[i], 1U + (rand() % CHECK_DATA_SIZE),
+			       (rand() % 16) == 0);
+	}
+
+	while ((next < CHECK_JOBS) || (npending != 0U)) {
+		/*
+		 * A job holds its slot until waited for, and stays on the
+		 * ring until dequeued: with up to one job less than the ring
+		 * size not waited for, every batch fits.
+		 */
+		room = SEC_JOB_RING_SIZE - 1U - npending;
+
+		/*
+		 * With one job slot left, a batch of two is rejected and the
+		 * slot taken for the first job is given back. A single job is
+		 * taken if the ring has room, the dequeued jobs having left
+		 * it.
+		 */
+		if (room == 0U) {
+			check_job_init(&extra[0], 16U, false);
+			check_job_init(&extra[1], 16U, false);
+			batch[0] = &extra[0].jobdesc;
+			batch[1] = &extra[1].jobdesc;
+			if (caam_job_submit(batch, 2U) != -1) {
+				fail("job ring", "job submitted to a full ring");
+				return;
+			}
+			for (i = 0U; i < 2U; i++) {
+				if ((extra[i].jobdesc.callback !=
+				     check_job_done) ||
+				    (extra[i].jobdesc.arg != &extra[i])) {
+					fail("job ring",
+					     "rejected job not restored");
+				}
+			}
+
+			if (caam_job_submit(batch, 1U) == 0) {
+				check_job_result(&extra[0],
+						 caam_job_wait(batch[0]));
+			} else if ((extra[0].jobdesc.callback !=
+				    check_job_done) ||
+				   (extra[0].jobdesc.arg != &extra[0])) {
+				fail("job ring", "rejected job not restored");
+			}
+		}
+
+		if ((next < CHECK_JOBS) && (room != 0U) && ((rand() % 2) == 0)) {
+			num = 1U + (rand() % room);
+			if (num > (CHECK_JOBS - next)) {
+				num = CHECK_JOBS - next;
+			}
+
+			for (i = 0U; i < num; i++) {
+				batch[i] = &jobs[next + i].jobdesc;
+				pending[npending++] = &jobs[next + i];
+			}
+			next += num;
+
+			if (caam_job_submit(batch, num) != 0) {
+				fail("job ring", "%u jobs not submitted", num);
+				return;
+			}
+		} else if (npending != 0U) {
+			k = rand() % npending;
+			check_job_result(pending[k],
+					 caam_job_wait(&pending[k]->jobdesc));
+			pending[k] = pending[--npending];
+		}
+	}
+
+	/* Jobs completed while others were waited for are not run again */
+	for (i = 0U; i < CHECK_JOBS; i++) {
+		if (jobs[i].callbacks != (jobs[i].fails ? 0U : 1U)) {
+			fail("job ring", "job %u callback called %u times", i,
+			     jobs[i].callbacks);
+		}
+	}
+
+	printf("Checked %u jobs on the job ring, up to %u in flight\n",
+	       CHECK_JOBS, sec.max_in_flight);
+}
+
+/*
+ * Hashing and RSA verification check: images hashed together, then verified
+ * with an RSA key of exponent 1, whose signature is the PKCS #1 v1.5 encoding
+ * of the digest itself.
+ */
+#define CHECK_ROUNDS		500U
+#define CHECK_IMAGE_SIZE	4096U
+#define CHECK_KEY_LEN		RSA_2K_KEY_SZ_BYTES
+
+static const uint8_t sha256_der[] = {
+	0x30, 0x31, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65,
+	0x03, 0x04, 0x02, 0x01, 0x05, 0x00, 0x04, 0x20
+};
+
+static void encode_sig(uint8_t *sig, const uint8_t *digest)
+{
+	size_t ps_end = CHECK_KEY_LEN - SHA256_DIGEST_SIZE -
+			sizeof(sha256_der) - 1U;
+
+	sig[0] = 0x00U;
+	sig[1] = 0x01U;
+	memset(&sig[2], 0xff, ps_end - 2U);
+	sig[ps_end] = 0x00U;
+	memcpy(&sig[ps_end + 1U], sha256_der, sizeof(sha256_der));
+	memcpy(&sig[CHECK_KEY_LEN - SHA256_DIGEST_SIZE], digest,
+	       SHA256_DIGEST_SIZE);
+}
+
+/* Hash an image in up to 3 parts, as calc_img_hash() does */
+static void *hash_image(const uint8_t *image, size_t len, uint8_t *hash,
+			uint8_t *expected)
+{
+	size_t parts[3], off = 0U;
+	unsigned int i, num = 1U + (rand() % 3);
+	void *ctx;
+	digest_t d;
+
+	if (hash_init(SHA256, &ctx) != 0) {
+		fail("hash", "no free context");
+		return NULL;
+	}
+
+	digest_init(&d);
+	for (i = 0U; i < num; i++) {
+		parts[i] = (i == (num - 1U)) ? len - off :
+			   (size_t)rand() % (len - off);
+		if (parts[i] == 0U) {
+			parts[i] = 1U;
+		}
+		if (hash_update(SHA256, ctx, (void *)&image[off],
+				parts[i]) != 0) {
+			fail("hash", "update failed");
+		}
+		digest_update(&d, &image[off], parts[i]);
+		off += parts[i];
+		if (off == len) {
+			break;
+		}
+	}
+	digest_final(&d, expected);
+
+	memset(hash, 0, SHA256_DIGEST_SIZE);
+	if (hash_final_async(SHA256, ctx, hash, SHA256_DIGEST_SIZE) != 0) {
+		fail("hash", "final failed");
+		return NULL;
+	}
+
+	return ctx;
+}
+
+static void check_hash_rsa(void)
+{
+	static uint8_t images[HASH_MAX_CTX][CHECK_IMAGE_SIZE];
+	uint8_t hash[HASH_MAX_CTX][SHA256_DIGEST_SIZE];
+	uint8_t expected[HASH_MAX_CTX][SHA256_DIGEST_SIZE];
+	uint8_t sig[CHECK_KEY_LEN], pk[2U * CHECK_KEY_LEN];
+	void *ctx[HASH_MAX_CTX];
+	unsigned int round, num, i, k, j;
+	int rc, exp_rc;
+
+	for (i = 0U; i < HASH_MAX_CTX; i++) {
+		for (j = 0U; j < CHECK_IMAGE_SIZE; j++) {
+			images[i][j] = (uint8_t)rand();
+		}
+	}
+
+	/* Modulus 0xff...ff and exponent 1 */
+	memset(pk, 0xff, CHECK_KEY_LEN);
+	memset(&pk[CHECK_KEY_LEN], 0, CHECK_KEY_LEN);
+
+	for (round = 0U; round < CHECK_ROUNDS; round++) {
+		num = 1U + (rand() % HASH_MAX_CTX);
+		for (i = 0U; i < num; i++) {
+			ctx[i] = hash_image(images[i], 1U + (rand() %
+					    CHECK_IMAGE_SIZE), hash[i],
+					    expected[i]);
+			if (ctx[i] == NULL) {
+				return;
+			}
+		}
+
+		/*
+		 * Verify the first image, which waits for all the hashes,
+		 * with a good or a corrupted signature, or with an exponent
+		 * that the SEC model rejects. Or wait for the hashes one by
+		 * one.
+		 */
+		k = rand() % 4;
+		if (k < 3U) {
+			encode_sig(sig, expected[0]);
+			pk[(2U * CHECK_KEY_LEN) - 1U] = (k == 2U) ? 3U : 1U;
+			if (k == 1U) {
+				sig[rand() % CHECK_KEY_LEN] ^= 0x01U;
+			}
+
+			exp_rc = (k == 0U) ? CRYPTO_SUCCESS :
+					     CRYPTO_ERR_SIGNATURE;
+			rc = rsa_verify_signature(hash[0], SHA256_DIGEST_SIZE,
+						  sig, CHECK_KEY_LEN, pk,
+						  2U * CHECK_KEY_LEN);
+			if (rc != exp_rc) {
+				fail("RSA", "verification returned %d, "
+				     "expected %d", rc, exp_rc);
+			}
+		} else {
+			for (i = num; i > 0U; i--) {
+				if (hash_wait(ctx[i - 1U]) != 0) {
+					fail("hash", "wait failed");
+				}
+			}
+		}
+
+		for (i = 0U; i < num; i++) {
+			if (memcmp(hash[i], expected[i],
+				   SHA256_DIGEST_SIZE) != 0) {
+				fail("hash", "wrong digest of image %u of %u",
+				     i, num);
+			}
+		}
+	}
+
+	printf("Checked %u rounds of hashing and RSA verification\n",
+	       CHECK_ROUNDS);
+}
+
+/*
+ * Benchmark: images hashed and verified one job at a time, as before the
+ * jobs could be kept in flight, then with the hashes in flight together and
+ * each RSA verification along with them.
+ */
+#define BENCH_ROUNDS		20U
+
+static uint64_t bench_verify(uint8_t **images, const size_t *lens,
+			     unsigned int num, bool in_flight)
+{
+	uint8_t hash[HASH_MAX_CTX][SHA256_DIGEST_SIZE];
+	uint8_t expected[HASH_MAX_CTX][SHA256_DIGEST_SIZE];
+	uint8_t sig[CHECK_KEY_LEN], pk[2U * CHECK_KEY_LEN];
+	void *ctx;
+	uint64_t start;
+	unsigned int i;
+	int rc = 0;
+
+	memset(pk, 0xff, CHECK_KEY_LEN);
+	memset(&pk[CHECK_KEY_LEN], 0, CHECK_KEY_LEN);
+	pk[(2U * CHECK_KEY_LEN) - 1U] = 1U;
+
+	start = now_ns();
+
+	for (i = 0U; i < num; i++) {
+		ctx = hash_image(images[i], lens[i], hash[i], expected[i]);
+		if (!in_flight) {
+			rc |= hash_wait(ctx);
+			encode_sig(sig, expected[i]);
+			rc |= rsa_verify_signature(hash[i], SHA256_DIGEST_SIZE,
+						   sig, CHECK_KEY_LEN, pk,
+						   2U * CHECK_KEY_LEN);
+		}
+	}
+
+	for (i = 0U; in_flight && (i < num); i++) {
+		encode_sig(sig, expected[i]);
+		rc |= rsa_verify_signature(hash[i], SHA256_DIGEST_SIZE, sig,
+					   CHECK_KEY_LEN, pk,
+					   2U * CHECK_KEY_LEN);
+	}
+
+	if (rc != 0) {
+		fail("bench", "verification failed");
+	}
+
+	return now_ns() - start;
+}
+
+static int bench(unsigned int decos, uint64_t hash_rate, uint64_t pk_us,
+		 char **sizes, unsigned int num)
+{
+	uint8_t *images[HASH_MAX_CTX];
+	size_t lens[HASH_MAX_CTX];
+	uint64_t one, all;
+	unsigned int i, r;
+
+	if ((num == 0U) || (num > HASH_MAX_CTX) || (decos == 0U) ||
+	    (decos > SEC_DECOS_MAX) || (hash_rate == 0U)) {
+		fprintf(stderr, "1 to %u images, 1 to %u DECOs\n",
+			HASH_MAX_CTX, SEC_DECOS_MAX);
+		return 1;
+	}
+
+	for (i = 0U; i < num; i++) {
+		lens[i] = strtoul(sizes[i], NULL, 0);
+		images[i] = calloc(1U, lens[i]);
+		if ((lens[i] == 0U) || (images[i] == NULL)) {
+			fprintf(stderr, "Bad image size %s\n", sizes[i]);
+			return 1;
+		}
+	}
+
+	sec_start(decos, false, hash_rate, pk_us * 1000U);
+
+	one = 0U;
+	all = 0U;
+	for (r = 0U; r < BENCH_ROUNDS; r++) {
+		one += bench_verify(images, lens, num, false);
+		all += bench_verify(images, lens, num, true);
+	}
+
+	printf("%u images, %u DECOs, hashing at %llu MB/s, RSA in %llu us\n",
+	       num, decos, (unsigned long long)hash_rate,
+	       (unsigned long long)pk_us);
+	printf("  one job at a time: %8.1f us\n",
+	       (double)one / BENCH_ROUNDS / 1000.0);
+	printf("  jobs in flight:    %8.1f us\n",
+	       (double)all / BENCH_ROUNDS / 1000.0);
+
+	return (failed != 0) ? 1 : 0;
+}
+
+int main(int argc, char *argv[])
+{
+	if ((argc >= 6) && (strcmp(argv[1], "-b") == 0)) {
+		return bench(strtoul(argv[2], NULL, 0),
+			     strtoull(argv[3], NULL, 0),
+			     strtoull(argv[4], NULL, 0), &argv[5],
+			     argc - 5);
+	}
+
+	if ((argc != 2) || (strcmp(argv[1], "-c") != 0)) {
+		printf("Usage: %s -c\n", argv[0]);
+		printf("       %s -b <DECOs> <hash MB/s> <RSA us> <image size>"
+		       "...\n\n", argv[0]);
+		printf("With -c, builds the CAAM job descriptors for a range\n"
+		       "of parameters and checks them against the command\n"
+		       "layout of the SEC reference manual, then runs jobs\n"
+		       "on a model of the SEC job ring and checks their\n"
+		       "completion.\n"
+		       "With -b, hashes and verifies the images on the model,\n"
+		       "one job at a time and with the jobs in flight.\n");
+		return 1;
+	}
+
+	check_descriptors();
+
+	if (failed != 0) {
+		fprintf(stderr, "%d descriptor checks failed\n", failed);
+		return 1;
+	}
+
+	printf("Checked the job descriptors successfully\n");
+
+	srand(1U);
+	sec_start(4U, true, 0U, 0U);
+	check_job_ring();
+	check_hash_rsa();
+
+	if (failed != 0) {
+		fprintf(stderr, "%d job ring checks failed\n", failed);
+		return 1;
+	}
+
+	printf("Checked the job ring successfully\n");
+
+	return 0;
+}
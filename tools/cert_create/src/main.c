@@ -7,6 +7,7 @@
 #include <assert.h>
 #include <ctype.h>
 #include <getopt.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -57,6 +58,7 @@
 #define ID_TO_BIT_MASK(id)		(1 << id)
 #define NUM_ELEM(x)			((sizeof(x)) / (sizeof(x[0])))
 #define HELP_OPT_MAX_LEN		128
+#define MANIFEST_LINE_MAX_LEN		4096
 
 /* Global options */
 static int key_alg;
@@ -65,6 +67,8 @@ static int key_size;
 static int new_keys;
 static int save_keys;
 static int print_cert;
+static int num_jobs = 1;
+static const char *batch_fn;
 
 /* Info messages created in the Makefile */
 extern const char build_msg[];
@@ -291,63 +295,261 @@ static const cmd_opt_t common_cmd_opt[] = {
 	{
 		{ "print-cert", no_argument, NULL, 'p' },
 		"Print the certificates in the standard output"
+	},
+	{
+		{ "jobs", required_argument, NULL, 'j' },
+		"Number of threads used to hash images and sign certificates " \
+		"(default: 1)"
+	},
+	{
+		{ "batch", required_argument, NULL, 'B' },
+		"Manifest of builds to generate certificates for, one line of " \
+		"options per build, added to the command line options"
 	}
 };
 
-int main(int argc, char *argv[])
+/*
+ * Run fn(arg, i) for every i in [0, n), spread over up to num_jobs threads.
+ */
+typedef struct work_s {
+	void (*fn)(void *arg, int idx);
+	void *arg;
+	int n;
+	int next;
+	pthread_mutex_t lock;
+} work_t;
+
+static void *work_thread(void *data)
 {
-	STACK_OF(X509_EXTENSION) * sk;
-	X509_EXTENSION *cert_ext = NULL;
-	ext_t *ext;
-	key_t *key;
-	cert_t *cert;
-	FILE *file;
-	int i, j, ext_nid, nvctr;
-	int c, opt_idx = 0;
-	const struct option *cmd_opt;
-	const char *cur_opt;
-	unsigned int err_code;
-	unsigned char md[SHA512_DIGEST_LENGTH];
-	unsigned int  md_len;
-	const EVP_MD *md_info;
+	work_t *work = data;
+	int idx;
 
-	NOTICE("CoT Generation Tool: %s\n", build_msg);
-	NOTICE("Target platform: %s\n", platform_msg);
+	while (1) {
+		pthread_mutex_lock(&work->lock);
+		idx = work->next++;
+		pthread_mutex_unlock(&work->lock);
+		if (idx >= work->n) {
+			break;
+		}
+		work->fn(work->arg, idx);
+	}
 
-	/* Set default options */
-	key_alg = KEY_ALG_RSA;
-	hash_alg = HASH_ALG_SHA256;
-	key_size = -1;
+	return NULL;
+}
 
-	/* Add common command line options */
-	for (i = 0; i < NUM_ELEM(common_cmd_opt); i++) {
-		cmd_opt_add(&common_cmd_opt[i]);
+static void run_parallel(void (*fn)(void *arg, int idx), void *arg, int n)
+{
+	pthread_t *threads;
+	work_t work = { .fn = fn, .arg = arg, .n = n, .next = 0 };
+	int i, num_threads = (num_jobs < n) ? num_jobs : n;
+
+	if (num_threads <= 1) {
+		for (i = 0; i < n; i++) {
+			fn(arg, i);
+		}
+		return;
 	}
 
-	/* Initialize the certificates */
-	if (cert_init() != 0) {
-		ERROR("Cannot initialize certificates\n");
+	threads = malloc(num_threads * sizeof(*threads));
+	if (threads == NULL) {
+		ERROR("%s:%d Failed to allocate memory.\n", __func__, __LINE__);
 		exit(1);
 	}
 
-	/* Initialize the keys */
-	if (key_init() != 0) {
-		ERROR("Cannot initialize keys\n");
+	pthread_mutex_init(&work.lock, NULL);
+	for (i = 0; i < num_threads; i++) {
+		if (pthread_create(&threads[i], NULL, work_thread, &work) != 0) {
+			ERROR("Cannot create worker thread\n");
+			exit(1);
+		}
+	}
+	for (i = 0; i < num_threads; i++) {
+		pthread_join(threads[i], NULL);
+	}
+	pthread_mutex_destroy(&work.lock);
+	free(threads);
+}
+
+/*
+ * Image hashes, kept across the builds of a batch so that an image shared by
+ * several builds is only hashed once.
+ */
+typedef struct hash_s {
+	char *fn;
+	int alg;
+	int ok;
+	unsigned char md[SHA512_DIGEST_LENGTH];
+	struct hash_s *next;
+} hash_t;
+
+static hash_t *hash_head;
+
+static hash_t *hash_lookup(const char *fn, int alg)
+{
+	hash_t *h;
+
+	for (h = hash_head; h != NULL; h = h->next) {
+		if (h->alg == alg && strcmp(h->fn, fn) == 0) {
+			return h;
+		}
+	}
+
+	return NULL;
+}
+
+static void hash_job(void *arg, int idx)
+{
+	hash_t *h = ((hash_t **)arg)[idx];
+
+	h->ok = sha_file(h->alg, h->fn, h->md);
+}
+
+/* Hash the images of the current build that are not hashed yet */
+static void hash_images(void)
+{
+	hash_t **jobs, *h;
+	ext_t *ext;
+	int i, n = 0;
+
+	jobs = malloc(num_extensions * sizeof(*jobs));
+	if (jobs == NULL) {
+		ERROR("%s:%d Failed to allocate memory.\n", __func__, __LINE__);
 		exit(1);
 	}
 
-	/* Initialize the new types and register OIDs for the extensions */
-	if (ext_init() != 0) {
-		ERROR("Cannot initialize extensions\n");
+	for (i = 0; i < num_extensions; i++) {
+		ext = &extensions[i];
+		if (ext->type != EXT_TYPE_HASH || ext->arg == NULL ||
+		    hash_lookup(ext->arg, hash_alg) != NULL) {
+			continue;
+		}
+		h = calloc(1, sizeof(*h));
+		if (h == NULL || (h->fn = strdup(ext->arg)) == NULL) {
+			ERROR("%s:%d Failed to allocate memory.\n",
+			      __func__, __LINE__);
+			exit(1);
+		}
+		h->alg = hash_alg;
+		h->next = hash_head;
+		hash_head = h;
+		jobs[n++] = h;
+	}
+
+	run_parallel(hash_job, jobs, n);
+	free(jobs);
+}
+
+static void hash_cleanup(void)
+{
+	hash_t *h = hash_head, *tmp;
+
+	while (h != NULL) {
+		tmp = h->next;
+		free(h->fn);
+		free(h);
+		h = tmp;
+	}
+	hash_head = NULL;
+}
+
+/*
+ * Private keys loaded from disk, kept across the builds of a batch so that a
+ * key shared by several builds is only loaded once.
+ */
+typedef struct key_cache_s {
+	char *fn;
+	EVP_PKEY *key;
+	struct key_cache_s *next;
+} key_cache_t;
+
+static key_cache_t *key_cache_head;
+
+static int key_cache_get(key_t *key)
+{
+	key_cache_t *kc;
+
+	if (key->fn == NULL) {
+		return 0;
+	}
+
+	for (kc = key_cache_head; kc != NULL; kc = kc->next) {
+		if (strcmp(kc->fn, key->fn) == 0) {
+			EVP_PKEY_free(key->key);
+			EVP_PKEY_up_ref(kc->key);
+			key->key = kc->key;
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+static void key_cache_add(const key_t *key)
+{
+	key_cache_t *kc;
+
+	kc = calloc(1, sizeof(*kc));
+	if (kc == NULL || (kc->fn = strdup(key->fn)) == NULL) {
+		ERROR("%s:%d Failed to allocate memory.\n", __func__, __LINE__);
 		exit(1);
 	}
+	EVP_PKEY_up_ref(key->key);
+	kc->key = key->key;
+	kc->next = key_cache_head;
+	key_cache_head = kc;
+}
+
+static void key_cache_cleanup(void)
+{
+	key_cache_t *kc = key_cache_head, *tmp;
+
+	while (kc != NULL) {
+		tmp = kc->next;
+		EVP_PKEY_free(kc->key);
+		free(kc->fn);
+		free(kc);
+		kc = tmp;
+	}
+	key_cache_head = NULL;
+}
+
+/* Replace a string option, freeing the previous value */
+static void set_opt_str(const char **str, const char *val)
+{
+	free((void *)*str);
+	*str = strdup(val);
+}
+
+/*
+ * Parse the options of one build. In batch mode this is the command line
+ * followed by the options of the build in the manifest.
+ */
+static void parse_cmd_opts(int argc, char *argv[])
+{
+	const struct option *cmd_opt;
+	const char *cur_opt;
+	ext_t *ext;
+	key_t *key;
+	cert_t *cert;
+	int c, opt_idx = 0;
+
+	/* Set default options */
+	key_alg = KEY_ALG_RSA;
+	hash_alg = HASH_ALG_SHA256;
+	key_size = -1;
+	new_keys = 0;
+	save_keys = 0;
+	print_cert = 0;
 
 	/* Get the command line options populated during the initialization */
 	cmd_opt = cmd_opt_get_array();
 
+	/* Restart the scan from the first option */
+	optind = 0;
+
 	while (1) {
 		/* getopt_long stores the option index here. */
-		c = getopt_long(argc, argv, "a:b:hknps:", cmd_opt, &opt_idx);
+		c = getopt_long(argc, argv, "a:b:B:hj:knps:", cmd_opt, &opt_idx);
 
 		/* Detect the end of the options. */
 		if (c == -1) {
@@ -369,9 +571,21 @@ int main(int argc, char *argv[])
 				exit(1);
 			}
 			break;
+		case 'B':
+			if (batch_fn == NULL) {
+				batch_fn = strdup(optarg);
+			}
+			break;
 		case 'h':
 			print_help(argv[0], cmd_opt);
 			exit(0);
+		case 'j':
+			num_jobs = atoi(optarg);
+			if (num_jobs <= 0) {
+				ERROR("Invalid number of jobs '%s'\n", optarg);
+				exit(1);
+			}
+			break;
 		case 'k':
 			save_keys = 1;
 			break;
@@ -391,17 +605,17 @@ int main(int argc, char *argv[])
 		case CMD_OPT_EXT:
 			cur_opt = cmd_opt_get_name(opt_idx);
 			ext = ext_get_by_opt(cur_opt);
-			ext->arg = strdup(optarg);
+			set_opt_str(&ext->arg, optarg);
 			break;
 		case CMD_OPT_KEY:
 			cur_opt = cmd_opt_get_name(opt_idx);
 			key = key_get_by_opt(cur_opt);
-			key->fn = strdup(optarg);
+			set_opt_str((const char **)&key->fn, optarg);
 			break;
 		case CMD_OPT_CERT:
 			cur_opt = cmd_opt_get_name(opt_idx);
 			cert = cert_get_by_opt(cur_opt);
-			cert->fn = strdup(optarg);
+			set_opt_str(&cert->fn, optarg);
 			break;
 		case '?':
 		default:
@@ -414,24 +628,14 @@ int main(int argc, char *argv[])
 	if (key_size == -1) {
 		key_size = KEY_SIZES[key_alg][0];
 	}
+}
 
-	/* Check command line arguments */
-	check_cmd_params();
-
-	/* Indicate SHA as image hash algorithm in the certificate
-	 * extension */
-	if (hash_alg == HASH_ALG_SHA384) {
-		md_info = EVP_sha384();
-		md_len  = SHA384_DIGEST_LENGTH;
-	} else if (hash_alg == HASH_ALG_SHA512) {
-		md_info = EVP_sha512();
-		md_len  = SHA512_DIGEST_LENGTH;
-	} else {
-		md_info = EVP_sha256();
-		md_len  = SHA256_DIGEST_LENGTH;
-	}
+/* Load private keys from files (or generate new ones) */
+static void load_keys(void)
+{
+	unsigned int err_code;
+	int i;
 
-	/* Load private keys from files (or generate new ones) */
 	for (i = 0 ; i < num_keys ; i++) {
 #if !USING_OPENSSL3
 		if (!key_new(&keys[i])) {
@@ -440,10 +644,16 @@ int main(int argc, char *argv[])
 		}
 #endif
 
+		/* Reuse the key if another build already loaded it */
+		if (key_cache_get(&keys[i])) {
+			continue;
+		}
+
 		/* First try to load the key from disk */
 		err_code = key_load(&keys[i]);
 		if (err_code == KEY_ERR_NONE) {
 			/* Key loaded successfully */
+			key_cache_add(&keys[i]);
 			continue;
 		}
 
@@ -473,96 +683,205 @@ int main(int argc, char *argv[])
 			exit(1);
 		}
 	}
+}
 
-	/* Create the certificates */
-	for (i = 0 ; i < num_certs ; i++) {
-
-		cert = &certs[i];
+/* Create the stack of extensions of a certificate */
+static STACK_OF(X509_EXTENSION) *cert_new_exts(cert_t *cert)
+{
+	STACK_OF(X509_EXTENSION) * sk;
+	X509_EXTENSION *cert_ext = NULL;
+	ext_t *ext;
+	hash_t *h;
+	int j, ext_nid, nvctr;
+	unsigned char md[SHA512_DIGEST_LENGTH];
+	unsigned int  md_len;
+	const EVP_MD *md_info;
 
-		if (cert->fn == NULL) {
-			/* Certificate not requested. Skip to the next one */
-			continue;
-		}
+	/* Indicate SHA as image hash algorithm in the certificate
+	 * extension */
+	if (hash_alg == HASH_ALG_SHA384) {
+		md_info = EVP_sha384();
+		md_len  = SHA384_DIGEST_LENGTH;
+	} else if (hash_alg == HASH_ALG_SHA512) {
+		md_info = EVP_sha512();
+		md_len  = SHA512_DIGEST_LENGTH;
+	} else {
+		md_info = EVP_sha256();
+		md_len  = SHA256_DIGEST_LENGTH;
+	}
 
-		/* Create a new stack of extensions. This stack will be used
-		 * to create the certificate */
-		CHECK_NULL(sk, sk_X509_EXTENSION_new_null());
+	/* Create a new stack of extensions. This stack will be used
+	 * to create the certificate */
+	CHECK_NULL(sk, sk_X509_EXTENSION_new_null());
 
-		for (j = 0 ; j < cert->num_ext ; j++) {
+	for (j = 0 ; j < cert->num_ext ; j++) {
 
-			ext = &extensions[cert->ext[j]];
+		ext = &extensions[cert->ext[j]];
 
-			/* Get OpenSSL internal ID for this extension */
-			CHECK_OID(ext_nid, ext->oid);
+		/* Get OpenSSL internal ID for this extension */
+		CHECK_OID(ext_nid, ext->oid);
 
-			/*
-			 * Three types of extensions are currently supported:
-			 *     - EXT_TYPE_NVCOUNTER
-			 *     - EXT_TYPE_HASH
-			 *     - EXT_TYPE_PKEY
-			 */
-			switch (ext->type) {
-			case EXT_TYPE_NVCOUNTER:
-				if (ext->optional && ext->arg == NULL) {
-					/* Skip this NVCounter */
-					continue;
+		/*
+		 * Three types of extensions are currently supported:
+		 *     - EXT_TYPE_NVCOUNTER
+		 *     - EXT_TYPE_HASH
+		 *     - EXT_TYPE_PKEY
+		 */
+		switch (ext->type) {
+		case EXT_TYPE_NVCOUNTER:
+			if (ext->optional && ext->arg == NULL) {
+				/* Skip this NVCounter */
+				continue;
+			} else {
+				/* Checked by `check_cmd_params` */
+				assert(ext->arg != NULL);
+				nvctr = atoi(ext->arg);
+				CHECK_NULL(cert_ext, ext_new_nvcounter(ext_nid,
+					EXT_CRIT, nvctr));
+			}
+			break;
+		case EXT_TYPE_HASH:
+			if (ext->arg == NULL) {
+				if (ext->optional) {
+					/* Include a hash filled with zeros */
+					memset(md, 0x0, SHA512_DIGEST_LENGTH);
 				} else {
-					/* Checked by `check_cmd_params` */
-					assert(ext->arg != NULL);
-					nvctr = atoi(ext->arg);
-					CHECK_NULL(cert_ext, ext_new_nvcounter(ext_nid,
-						EXT_CRIT, nvctr));
+					/* Do not include this hash in the certificate */
+					continue;
 				}
-				break;
-			case EXT_TYPE_HASH:
-				if (ext->arg == NULL) {
-					if (ext->optional) {
-						/* Include a hash filled with zeros */
-						memset(md, 0x0, SHA512_DIGEST_LENGTH);
-					} else {
-						/* Do not include this hash in the certificate */
-						continue;
-					}
-				} else {
-					/* Calculate the hash of the file */
-					if (!sha_file(hash_alg, ext->arg, md)) {
-						ERROR("Cannot calculate hash of %s\n",
-							ext->arg);
-						exit(1);
-					}
+			} else {
+				/* The hash of the file was calculated by hash_images() */
+				h = hash_lookup(ext->arg, hash_alg);
+				if (h == NULL || !h->ok) {
+					ERROR("Cannot calculate hash of %s\n",
+						ext->arg);
+					exit(1);
 				}
-				CHECK_NULL(cert_ext, ext_new_hash(ext_nid,
-						EXT_CRIT, md_info, md,
-						md_len));
-				break;
-			case EXT_TYPE_PKEY:
-				CHECK_NULL(cert_ext, ext_new_key(ext_nid,
-					EXT_CRIT, keys[ext->attr.key].key));
-				break;
-			default:
-				ERROR("Unknown extension type '%d' in %s\n",
-						ext->type, cert->cn);
-				exit(1);
+				memcpy(md, h->md, md_len);
 			}
-
-			/* Push the extension into the stack */
-			sk_X509_EXTENSION_push(sk, cert_ext);
+			CHECK_NULL(cert_ext, ext_new_hash(ext_nid,
+					EXT_CRIT, md_info, md,
+					md_len));
+			break;
+		case EXT_TYPE_PKEY:
+			CHECK_NULL(cert_ext, ext_new_key(ext_nid,
+				EXT_CRIT, keys[ext->attr.key].key));
+			break;
+		default:
+			ERROR("Unknown extension type '%d' in %s\n",
+					ext->type, cert->cn);
+			exit(1);
 		}
 
-		/* Create certificate. Signed with corresponding key */
-		if (!cert_new(hash_alg, cert, VAL_DAYS, 0, sk)) {
-			ERROR("Cannot create %s\n", cert->cn);
+		/* Push the extension into the stack */
+		sk_X509_EXTENSION_push(sk, cert_ext);
+	}
+
+	return sk;
+}
+
+/*
+ * Depth of a requested certificate in the chain: certificates of the same
+ * depth do not depend on each other and can be signed concurrently.
+ */
+static int cert_depth(const cert_t *cert)
+{
+	int depth = 0;
+
+	while (certs[cert->issuer].fn != NULL &&
+	       &certs[cert->issuer] != cert) {
+		cert = &certs[cert->issuer];
+		depth++;
+		if (depth > num_certs) {
+			ERROR("Certificate chain loop at %s\n", cert->cn);
 			exit(1);
 		}
+	}
+
+	return depth;
+}
+
+typedef struct sign_job_s {
+	cert_t *cert;
+	STACK_OF(X509_EXTENSION) * sk;
+	int ok;
+} sign_job_t;
+
+static void sign_job(void *arg, int idx)
+{
+	sign_job_t *job = &((sign_job_t *)arg)[idx];
+
+	/* Create certificate. Signed with corresponding key */
+	job->ok = cert_new(hash_alg, job->cert, VAL_DAYS, 0, job->sk);
+}
+
+/* Create the certificates, one level of the chain at a time */
+static void create_certs(void)
+{
+	X509_EXTENSION *cert_ext;
+	sign_job_t *jobs;
+	int i, n, d, depth, max_depth = 0;
 
-		for (cert_ext = sk_X509_EXTENSION_pop(sk); cert_ext != NULL;
-				cert_ext = sk_X509_EXTENSION_pop(sk)) {
-			X509_EXTENSION_free(cert_ext);
+	jobs = malloc(num_certs * sizeof(*jobs));
+	if (jobs == NULL) {
+		ERROR("%s:%d Failed to allocate memory.\n", __func__, __LINE__);
+		exit(1);
+	}
+
+	for (depth = 0; depth <= max_depth; depth++) {
+		n = 0;
+		for (i = 0 ; i < num_certs ; i++) {
+			if (certs[i].fn == NULL) {
+				/* Certificate not requested. Skip to the next one */
+				continue;
+			}
+			d = cert_depth(&certs[i]);
+			if (d > max_depth) {
+				max_depth = d;
+			}
+			if (d != depth) {
+				continue;
+			}
+			jobs[n].cert = &certs[i];
+			jobs[n].sk = cert_new_exts(&certs[i]);
+			n++;
 		}
 
-		sk_X509_EXTENSION_free(sk);
+		run_parallel(sign_job, jobs, n);
+
+		for (i = 0; i < n; i++) {
+			if (!jobs[i].ok) {
+				ERROR("Cannot create %s\n", jobs[i].cert->cn);
+				exit(1);
+			}
+
+			for (cert_ext = sk_X509_EXTENSION_pop(jobs[i].sk);
+			     cert_ext != NULL;
+			     cert_ext = sk_X509_EXTENSION_pop(jobs[i].sk)) {
+				X509_EXTENSION_free(cert_ext);
+			}
+
+			sk_X509_EXTENSION_free(jobs[i].sk);
+		}
 	}
 
+	free(jobs);
+}
+
+/* Generate, print and save the certificates of one build */
+static void run_build(void)
+{
+	FILE *file;
+	int i;
+
+	/* Check command line arguments */
+	check_cmd_params();
+
+	load_keys();
+
+	hash_images();
+
+	create_certs();
 
 	/* Print the certificates */
 	if (print_cert) {
@@ -596,6 +915,129 @@ int main(int argc, char *argv[])
 			}
 		}
 	}
+}
+
+/* Clear the keys, images and certificates of the previous build */
+static void reset_build(void)
+{
+	int i;
+
+	for (i = 0; i < num_extensions; i++) {
+		free((void *)extensions[i].arg);
+		extensions[i].arg = NULL;
+	}
+
+	for (i = 0; i < num_keys; i++) {
+		EVP_PKEY_free(keys[i].key);
+		keys[i].key = NULL;
+		free(keys[i].fn);
+		keys[i].fn = NULL;
+	}
+
+	for (i = 0; i < num_certs; i++) {
+		X509_free(certs[i].x);
+		certs[i].x = NULL;
+		free((void *)certs[i].fn);
+		certs[i].fn = NULL;
+	}
+}
+
+/*
+ * Generate the certificates of every build listed in the manifest. Each line
+ * holds the options of one build, separated by white space, which are added
+ * to the command line options. Empty lines and lines starting with '#' are
+ * skipped.
+ */
+static void run_batch(int argc, char *argv[])
+{
+	char line[MANIFEST_LINE_MAX_LEN];
+	char **build_argv;
+	char *tok;
+	FILE *file;
+	int build_argc, nr_builds = 0;
+
+	file = fopen(batch_fn, "r");
+	if (file == NULL) {
+		ERROR("Cannot open manifest %s\n", batch_fn);
+		exit(1);
+	}
+
+	/* A line of n characters holds at most (n + 1) / 2 options */
+	build_argv = malloc((argc + MANIFEST_LINE_MAX_LEN / 2 + 2) *
+			    sizeof(*build_argv));
+	if (build_argv == NULL) {
+		ERROR("%s:%d Failed to allocate memory.\n", __func__, __LINE__);
+		exit(1);
+	}
+
+	while (fgets(line, sizeof(line), file) != NULL) {
+		if (strchr(line, '\n') == NULL && !feof(file)) {
+			ERROR("Line too long in manifest %s\n", batch_fn);
+			exit(1);
+		}
+
+		memcpy(build_argv, argv, argc * sizeof(*build_argv));
+		build_argc = argc;
+		for (tok = strtok(line, " \t\r\n"); tok != NULL;
+		     tok = strtok(NULL, " \t\r\n")) {
+			build_argv[build_argc++] = tok;
+		}
+		build_argv[build_argc] = NULL;
+
+		if (build_argc == argc || build_argv[argc][0] == '#') {
+			continue;
+		}
+
+		NOTICE("Build %d\n", ++nr_builds);
+		reset_build();
+		parse_cmd_opts(build_argc, build_argv);
+		run_build();
+	}
+
+	free(build_argv);
+	fclose(file);
+}
+
+int main(int argc, char *argv[])
+{
+	int i;
+
+	NOTICE("CoT Generation Tool: %s\n", build_msg);
+	NOTICE("Target platform: %s\n", platform_msg);
+
+	/* Add common command line options */
+	for (i = 0; i < NUM_ELEM(common_cmd_opt); i++) {
+		cmd_opt_add(&common_cmd_opt[i]);
+	}
+
+	/* Initialize the certificates */
+	if (cert_init() != 0) {
+		ERROR("Cannot initialize certificates\n");
+		exit(1);
+	}
+
+	/* Initialize the keys */
+	if (key_init() != 0) {
+		ERROR("Cannot initialize keys\n");
+		exit(1);
+	}
+
+	/* Initialize the new types and register OIDs for the extensions */
+	if (ext_init() != 0) {
+		ERROR("Cannot initialize extensions\n");
+		exit(1);
+	}
+
+	parse_cmd_opts(argc, argv);
+
+	if (batch_fn == NULL) {
+		run_build();
+	} else {
+		run_batch(argc, argv);
+	}
+
+	hash_cleanup();
+	key_cache_cleanup();
 
 	/* If we got here, then we must have filled the key array completely.
 	 * We can then safely call free on all of the keys in the array
@@ -614,5 +1056,7 @@ int main(int argc, char *argv[])
 
 	cert_cleanup();
 
+	free((void *)batch_fn);
+
 	return 0;
 }
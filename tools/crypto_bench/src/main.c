@@ -0,0 +1,419 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host benchmark of the SHA-256 and AES kernels that replace the mbed TLS C
+ * code with TF_MBEDTLS_USE_ARMV8_CRYPTO=1. It runs the firmware sources of
+ * the portable kernels and, on AArch64 hosts implementing the Cryptographic
+ * Extension, of the kernels using it. The kernels are called one block at a
+ * time, as mbed TLS does.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <arch_features.h>
+#include <drivers/auth/mbedtls/armv8_crypto.h>
+
+/* Each file is processed for at least MIN_TIME seconds, and MIN_RUNS times */
+#define MIN_RUNS		3U
+#define MIN_TIME		1.0
+
+#define SHA256_BLOCK_SIZE	64U
+#define SHA256_DIGEST_SIZE	32U
+#define AES_BLOCK_SIZE		16U
+
+/* Largest AES key schedule: 15 round keys of AES-256 */
+#define AES_RK_WORDS		60U
+
+typedef struct impl_s {
+	const char *name;
+	void (*sha256_blocks)(uint32_t state[8], const uint8_t *data,
+			      size_t blocks);
+	void (*aes_encrypt)(const uint32_t *rk, unsigned int nr,
+			    const uint8_t in[16], uint8_t out[16]);
+	bool (*present)(void);
+} impl_t;
+
+static bool always_present(void)
+{
+	return true;
+}
+
+#ifdef __aarch64__
+static bool ce_present(void)
+{
+	return is_feat_sha256_present() && is_feat_aes_present();
+}
+#endif
+
+static const impl_t impls[] = {
+	{ "c", sha256_blocks_c, aes_encrypt_block_c, always_present },
+#ifdef __aarch64__
+	{ "ce", sha256_blocks_ce, aes_encrypt_block_ce, ce_present },
+#endif
+};
+
+#define NUM_IMPLS	(sizeof(impls) / sizeof(impls[0]))
+
+static uint8_t aes_sbox[256];
+
+static const uint32_t sha256_init[8] = {
+	0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+	0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+static void sha256(const impl_t *impl, const uint8_t *data, size_t len,
+		   uint8_t digest[SHA256_DIGEST_SIZE])
+{
+	uint32_t state[8];
+	uint8_t last[2U * SHA256_BLOCK_SIZE];
+	uint64_t bits = (uint64_t)len * 8U;
+	size_t i, rest, last_len;
+
+	memcpy(state, sha256_init, sizeof(state));
+
+	for (i = 0U; (len - i) >= SHA256_BLOCK_SIZE; i += SHA256_BLOCK_SIZE) {
+		impl->sha256_blocks(state, data + i, 1U);
+	}
+
+	/* Padding, and the length in bits */
+	rest = len - i;
+	last_len = (rest < (SHA256_BLOCK_SIZE - 8U)) ? SHA256_BLOCK_SIZE :
+						       sizeof(last);
+	memset(last, 0, sizeof(last));
+	memcpy(last, data + i, rest);
+	last[rest] = 0x80U;
+	for (i = 0U; i < 8U; i++) {
+		last[last_len - 1U - i] = (uint8_t)(bits >> (8U * i));
+	}
+	impl->sha256_blocks(state, last, last_len / SHA256_BLOCK_SIZE);
+
+	for (i = 0U; i < SHA256_DIGEST_SIZE; i++) {
+		digest[i] = (uint8_t)(state[i / 4U] >> (24U - (8U * (i % 4U))));
+	}
+}
+
+/* The AES S-box, from the inverses in GF(2^8) and the affine transform */
+static void aes_gen_sbox(void)
+{
+	uint8_t p = 1U, q = 1U, x;
+
+	do {
+		/* p * 3, and q / 3 */
+		p = p ^ (uint8_t)(p << 1) ^ ((p & 0x80U) != 0U ? 0x1BU : 0U);
+		q ^= q << 1;
+		q ^= q << 2;
+		q ^= q << 4;
+		if ((q & 0x80U) != 0U) {
+			q ^= 0x09U;
+		}
+
+		x = q ^ (uint8_t)((q << 1) | (q >> 7)) ^
+		    (uint8_t)((q << 2) | (q >> 6)) ^
+		    (uint8_t)((q << 3) | (q >> 5)) ^
+		    (uint8_t)((q << 4) | (q >> 4));
+		aes_sbox[p] = x ^ 0x63U;
+	} while (p != 1U);
+
+	aes_sbox[0] = 0x63U;
+}
+
+/* Key schedule in the layout of mbed TLS, returning the number of rounds */
+static unsigned int aes_setkey(const uint8_t *key, unsigned int key_len,
+			       uint32_t rk[AES_RK_WORDS])
+{
+	uint8_t *w = (uint8_t *)rk;
+	unsigned int nk = key_len / 4U;
+	unsigned int nr = nk + 6U;
+	unsigned int i, j;
+	uint8_t t[4], tmp, rcon = 1U;
+
+	memcpy(w, key, key_len);
+
+	for (i = nk; i < (4U * (nr + 1U)); i++) {
+		memcpy(t, &w[4U * (i - 1U)], sizeof(t));
+		if ((i % nk) == 0U) {
+			tmp = t[0];
+			t[0] = aes_sbox[t[1]] ^ rcon;
+			t[1] = aes_sbox[t[2]];
+			t[2] = aes_sbox[t[3]];
+			t[3] = aes_sbox[tmp];
+			rcon = (uint8_t)(rcon << 1) ^
+			       ((rcon & 0x80U) != 0U ? 0x1BU : 0U);
+		} else if ((nk > 6U) && ((i % nk) == 4U)) {
+			for (j = 0U; j < 4U; j++) {
+				t[j] = aes_sbox[t[j]];
+			}
+		}
+
+		for (j = 0U; j < 4U; j++) {
+			w[(4U * i) + j] = w[(4U * (i - nk)) + j] ^ t[j];
+		}
+	}
+
+	return nr;
+}
+
+static void aes_ecb(const impl_t *impl, const uint32_t *rk, unsigned int nr,
+		    const uint8_t *in, uint8_t *out, size_t len)
+{
+	size_t i;
+
+	for (i = 0U; (len - i) >= AES_BLOCK_SIZE; i += AES_BLOCK_SIZE) {
+		impl->aes_encrypt(rk, nr, in + i, out + i);
+	}
+}
+
+static void parse_hex(const char *hex, uint8_t *out)
+{
+	unsigned int byte;
+
+	while ((hex[0] != '\0') && (sscanf(hex, "%2x", &byte) == 1)) {
+		*out++ = (uint8_t)byte;
+		hex += 2;
+	}
+}
+
+/* Known answers of FIPS 180-2 and FIPS-197 */
+static const struct {
+	const char *msg;
+	const char *digest;
+} sha256_kat[] = {
+	{ "",
+	  "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" },
+	{ "abc",
+	  "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad" },
+	{ "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+	  "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1" },
+};
+
+static const struct {
+	const char *key;
+	const char *ct;
+} aes_kat[] = {
+	{ "000102030405060708090a0b0c0d0e0f",
+	  "69c4e0d86a7b0430d8cdb78070b4c55a" },
+	{ "000102030405060708090a0b0c0d0e0f1011121314151617",
+	  "dda97ca4864cdfe06eaf70a0ec0d7191" },
+	{ "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f",
+	  "8ea2b7ca516745bfeafc49904b496089" },
+};
+
+static int check_kat(const impl_t *impl)
+{
+	uint8_t digest[SHA256_DIGEST_SIZE], expected[SHA256_DIGEST_SIZE];
+	uint8_t key[32], pt[AES_BLOCK_SIZE], ct[AES_BLOCK_SIZE];
+	uint32_t rk[AES_RK_WORDS];
+	unsigned int i, nr;
+	int ret = 0;
+
+	for (i = 0U; i < sizeof(sha256_kat) / sizeof(sha256_kat[0]); i++) {
+		sha256(impl, (const uint8_t *)sha256_kat[i].msg,
+		       strlen(sha256_kat[i].msg), digest);
+		parse_hex(sha256_kat[i].digest, expected);
+		if (memcmp(digest, expected, sizeof(digest)) != 0) {
+			fprintf(stderr, "%s: SHA-256 test %u failed\n",
+				impl->name, i);
+			ret = -1;
+		}
+	}
+
+	parse_hex("00112233445566778899aabbccddeeff", pt);
+	for (i = 0U; i < sizeof(aes_kat) / sizeof(aes_kat[0]); i++) {
+		parse_hex(aes_kat[i].key, key);
+		parse_hex(aes_kat[i].ct, expected);
+		nr = aes_setkey(key, strlen(aes_kat[i].key) / 2U, rk);
+		impl->aes_encrypt(rk, nr, pt, ct);
+		if (memcmp(ct, expected, sizeof(ct)) != 0) {
+			fprintf(stderr, "%s: AES test %u failed\n",
+				impl->name, i);
+			ret = -1;
+		}
+	}
+
+	return ret;
+}
+
+static uint8_t *read_file(const char *fn, size_t *len)
+{
+	FILE *fp;
+	uint8_t *buf;
+	long size;
+
+	fp = fopen(fn, "rb");
+	if (fp == NULL) {
+		fprintf(stderr, "Cannot open %s\n", fn);
+		exit(1);
+	}
+
+	if ((fseek(fp, 0L, SEEK_END) != 0) || ((size = ftell(fp)) < 0) ||
+	    (fseek(fp, 0L, SEEK_SET) != 0)) {
+		fprintf(stderr, "Cannot get the size of %s\n", fn);
+		exit(1);
+	}
+
+	/* One more byte, so that empty files get a valid buffer too */
+	buf = malloc(size + 1);
+	if (buf == NULL) {
+		fprintf(stderr, "Cannot allocate memory\n");
+		exit(1);
+	}
+
+	if (fread(buf, 1, size, fp) != (size_t)size) {
+		fprintf(stderr, "Cannot read %s\n", fn);
+		exit(1);
+	}
+	fclose(fp);
+
+	*len = size;
+
+	return buf;
+}
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Best speed of fn in MB/s of input */
+#define BENCH(speed, len, fn)						\
+	do {								\
+		double start, t, best = 0.0, total = 0.0;		\
+		unsigned int runs = 0U;					\
+									\
+		while ((runs < MIN_RUNS) || (total < MIN_TIME)) {	\
+			start = now();					\
+			fn;						\
+			t = now() - start;				\
+			if ((runs == 0U) || (t < best)) {		\
+				best = t;				\
+			}						\
+			total += t;					\
+			runs++;						\
+		}							\
+		(speed) = (len) / 1e6 / best;				\
+	} while (false)
+
+static int bench_file(const char *fn, bool check_only)
+{
+	uint8_t digest[NUM_IMPLS][SHA256_DIGEST_SIZE];
+	uint8_t key[32];
+	uint32_t rk[AES_RK_WORDS];
+	uint8_t *image, *out;
+	size_t image_len;
+	double sha_speed, aes_speed;
+	unsigned int i, nr;
+	int ret = 0;
+
+	image = read_file(fn, &image_len);
+	out = malloc(image_len + 1U);
+	if (out == NULL) {
+		fprintf(stderr, "Cannot allocate memory\n");
+		exit(1);
+	}
+
+	/* The image encryption key of TF-A is 256-bit */
+	for (i = 0U; i < sizeof(key); i++) {
+		key[i] = (uint8_t)i;
+	}
+	nr = aes_setkey(key, sizeof(key), rk);
+
+	if (!check_only) {
+		printf("%s: %zu bytes\n", fn, image_len);
+		printf("%-6s %12s %12s\n", "impl", "SHA-256 MB/s", "AES MB/s");
+	}
+
+	for (i = 0U; i < NUM_IMPLS; i++) {
+		/* Only digest[0], from the always present C kernel, is used */
+		if (!impls[i].present()) {
+			continue;
+		}
+
+		sha256(&impls[i], image, image_len, digest[i]);
+		if (memcmp(digest[i], digest[0], sizeof(digest[0])) != 0) {
+			fprintf(stderr, "%s: %s digest does not match\n", fn,
+				impls[i].name);
+			ret = -1;
+		}
+
+		if (check_only) {
+			continue;
+		}
+
+		BENCH(sha_speed, image_len,
+		      sha256(&impls[i], image, image_len, digest[i]));
+		BENCH(aes_speed, image_len,
+		      aes_ecb(&impls[i], rk, nr, image, out, image_len));
+		printf("%-6s %12.1f %12.1f\n", impls[i].name, sha_speed,
+		       aes_speed);
+	}
+
+	/* In the format of sha256sum, for "make check" */
+	if (check_only) {
+		for (i = 0U; i < SHA256_DIGEST_SIZE; i++) {
+			printf("%02x", digest[0][i]);
+		}
+		printf("  %s\n", fn);
+	}
+
+	free(out);
+	free(image);
+
+	return ret;
+}
+
+int main(int argc, char *argv[])
+{
+	bool check_only = false;
+	unsigned int i;
+	int ret = 0;
+
+	if ((argc > 1) && (strcmp(argv[1], "-c") == 0)) {
+		check_only = true;
+		argc--;
+		argv++;
+	}
+
+	if (argc < 2) {
+		printf("Usage: %s [-c] <image>...\n\n", argv[0]);
+		printf("Hashes each image with SHA-256 and encrypts it with\n"
+		       "AES-256 using the portable firmware kernels (c) and,\n"
+		       "when the CPU has them, the ARMv8 Cryptographic\n"
+		       "Extension ones (ce), and prints the best speed of\n"
+		       "each in MB/s.\n\n"
+		       "  -c  Only run the known answer tests, check that the\n"
+		       "      kernels agree and print the SHA-256 digests\n");
+		return 1;
+	}
+
+	aes_gen_sbox();
+
+	for (i = 0U; i < NUM_IMPLS; i++) {
+		if (!impls[i].present()) {
+			fprintf(stderr, "%s: not supported by this CPU\n",
+				impls[i].name);
+		} else if (check_kat(&impls[i]) != 0) {
+			ret = 1;
+		}
+	}
+
+	for (i = 1U; i < (unsigned int)argc; i++) {
+		if (bench_file(argv[i], check_only) != 0) {
+			ret = 1;
+		}
+	}
+
+	return ret;
+}
@@ -0,0 +1,306 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host benchmark of the decoders available to image_decompress(). It runs
+ * the firmware sources of each decoder on compressed versions of an image,
+ * checks the output against the image and reports the compression ratio, the
+ * decoding speed and the workspace used.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <common/image_decompress.h>
+#include <tf_gunzip.h>
+#include <unlz4.h>
+#include <unzstd.h>
+
+/* Workspace given to the decoders, large enough for any of them */
+#define WORK_SIZE		(1024U * 1024U)
+#define WORK_PATTERN		0xA5U
+
+/* Each file is decoded for at least MIN_TIME seconds, and MIN_RUNS times */
+#define MIN_RUNS		3U
+#define MIN_TIME		1.0
+
+/* Size of the pieces given to gunzip_stream(), as done by io_inflate.c */
+#define STREAM_CHUNK		4096U
+
+typedef struct codec_s {
+	const char *name;
+	const uint8_t *magic;
+	size_t magic_len;
+	decompressor_t *decompressor;
+} codec_t;
+
+static const uint8_t gzip_magic[] = { 0x1F, 0x8B };
+static const uint8_t lz4_magic[] = { 0x04, 0x22, 0x4D, 0x18 };
+static const uint8_t lz4_legacy_magic[] = { 0x02, 0x21, 0x4C, 0x18 };
+static const uint8_t zstd_magic[] = { 0x28, 0xB5, 0x2F, 0xFD };
+
+/*
+ * Decode a gzip image in pieces with the streaming API, so that matches
+ * are also copied from the sliding window.
+ */
+static int gunzip_pieces(uintptr_t *in_buf, size_t in_len,
+			 uintptr_t *out_buf, size_t out_len,
+			 uintptr_t work_buf, size_t work_len)
+{
+	uintptr_t in_end = *in_buf + in_len;
+	uintptr_t out_end = *out_buf + out_len;
+	uintptr_t in_prev, out_prev;
+	size_t in_chunk, out_chunk;
+	bool stream_end = false;
+	int ret;
+
+	ret = gunzip_stream_init(work_buf, work_len);
+	if (ret != 0) {
+		return ret;
+	}
+
+	while (!stream_end) {
+		in_chunk = in_end - *in_buf;
+		if (in_chunk > STREAM_CHUNK) {
+			in_chunk = STREAM_CHUNK;
+		}
+		out_chunk = out_end - *out_buf;
+		if (out_chunk > STREAM_CHUNK) {
+			out_chunk = STREAM_CHUNK;
+		}
+
+		in_prev = *in_buf;
+		out_prev = *out_buf;
+		ret = gunzip_stream(in_buf, in_chunk, out_buf, out_chunk,
+				    &stream_end);
+		if (ret != 0) {
+			break;
+		}
+
+		if (!stream_end && (*in_buf == in_prev) &&
+		    (*out_buf == out_prev)) {
+			ret = -1;
+			break;
+		}
+	}
+
+	gunzip_stream_end();
+
+	return ret;
+}
+
+static const codec_t codecs[] = {
+	{ "gzip", gzip_magic, sizeof(gzip_magic), gunzip },
+	{ "gzip/4K", gzip_magic, sizeof(gzip_magic), gunzip_pieces },
+	{ "lz4", lz4_magic, sizeof(lz4_magic), unlz4 },
+	{ "lz4", lz4_legacy_magic, sizeof(lz4_legacy_magic), unlz4 },
+	{ "zstd", zstd_magic, sizeof(zstd_magic), unzstd },
+};
+
+static uint8_t *read_file(const char *fn, size_t *len)
+{
+	FILE *fp;
+	uint8_t *buf;
+	long size;
+
+	fp = fopen(fn, "rb");
+	if (fp == NULL) {
+		fprintf(stderr, "Cannot open %s\n", fn);
+		exit(1);
+	}
+
+	if ((fseek(fp, 0L, SEEK_END) != 0) || ((size = ftell(fp)) < 0) ||
+	    (fseek(fp, 0L, SEEK_SET) != 0)) {
+		fprintf(stderr, "Cannot get the size of %s\n", fn);
+		exit(1);
+	}
+
+	/* One more byte, so that empty files get a valid buffer too */
+	buf = malloc(size + 1);
+	if (buf == NULL) {
+		fprintf(stderr, "Cannot allocate memory\n");
+		exit(1);
+	}
+
+	if (fread(buf, 1, size, fp) != (size_t)size) {
+		fprintf(stderr, "Cannot read %s\n", fn);
+		exit(1);
+	}
+	fclose(fp);
+
+	*len = size;
+
+	return buf;
+}
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Decode once, returning the output size or -1 on error */
+static long decode(const codec_t *codec, const uint8_t *in, size_t in_len,
+		   uint8_t *out, size_t out_len, uint8_t *work)
+{
+	uintptr_t in_buf = (uintptr_t)in;
+	uintptr_t out_buf = (uintptr_t)out;
+
+	if (codec->decompressor(&in_buf, in_len, &out_buf, out_len,
+				(uintptr_t)work, WORK_SIZE) != 0) {
+		return -1;
+	}
+
+	return (long)(out_buf - (uintptr_t)out);
+}
+
+/* Highest byte of the workspace written by the decoder */
+static size_t work_used(const uint8_t *work)
+{
+	size_t i = WORK_SIZE;
+
+	while ((i > 0U) && (work[i - 1U] == WORK_PATTERN)) {
+		i--;
+	}
+
+	return i;
+}
+
+static void bench_codec(const codec_t *codec, const char *fn,
+			const uint8_t *in, size_t in_len,
+			const uint8_t *image, size_t image_len, bool check_only,
+			int *ret)
+{
+	uint8_t *out, *work;
+	size_t used;
+	double start, t, best = 0.0, total = 0.0;
+	unsigned int runs = 0U;
+	long len;
+
+	out = malloc(image_len + 1U);
+	work = malloc(WORK_SIZE);
+	if ((out == NULL) || (work == NULL)) {
+		fprintf(stderr, "Cannot allocate memory\n");
+		exit(1);
+	}
+
+	/* First run: check the output and measure the workspace use */
+	memset(work, WORK_PATTERN, WORK_SIZE);
+	len = decode(codec, in, in_len, out, image_len, work);
+	if ((len < 0) || ((size_t)len != image_len) ||
+	    (memcmp(out, image, image_len) != 0)) {
+		fprintf(stderr, "%s: %s output does not match the image\n", fn,
+			codec->name);
+		*ret = -1;
+		goto out;
+	}
+	used = work_used(work);
+
+	if (check_only) {
+		printf("%-8s %-32s OK\n", codec->name, fn);
+		goto out;
+	}
+
+	while ((runs < MIN_RUNS) || (total < MIN_TIME)) {
+		start = now();
+		decode(codec, in, in_len, out, image_len, work);
+		t = now() - start;
+		if ((runs == 0U) || (t < best)) {
+			best = t;
+		}
+		total += t;
+		runs++;
+	}
+
+	printf("%-8s %-32s %10zu %7.2f %9.1f %10zu\n", codec->name, fn, in_len,
+	       (double)image_len / in_len, image_len / 1e6 / best, used);
+
+out:
+	free(out);
+	free(work);
+}
+
+/* Run every decoder that accepts the format of the file */
+static int bench_file(const char *fn, const uint8_t *image, size_t image_len,
+		      bool check_only)
+{
+	uint8_t *in;
+	size_t in_len;
+	unsigned int i;
+	bool found = false;
+	int ret = 0;
+
+	in = read_file(fn, &in_len);
+
+	for (i = 0U; i < sizeof(codecs) / sizeof(codecs[0]); i++) {
+		if ((in_len >= codecs[i].magic_len) &&
+		    (memcmp(in, codecs[i].magic, codecs[i].magic_len) == 0)) {
+			bench_codec(&codecs[i], fn, in, in_len, image,
+				    image_len, check_only, &ret);
+			found = true;
+		}
+	}
+
+	if (!found) {
+		fprintf(stderr, "%s: unknown format\n", fn);
+		ret = -1;
+	}
+
+	free(in);
+
+	return ret;
+}
+
+int main(int argc, char *argv[])
+{
+	uint8_t *image;
+	size_t image_len;
+	bool check_only = false;
+	int i, ret = 0;
+
+	if ((argc > 1) && (strcmp(argv[1], "-c") == 0)) {
+		check_only = true;
+		argc--;
+		argv++;
+	}
+
+	if (argc < 3) {
+		printf("Usage: %s [-c] <image> <compressed image>...\n\n",
+		       argv[0]);
+		printf("Decodes each compressed image (gzip, lz4 or zstd) with the\n"
+		       "firmware decoders, checks the result against <image>\n"
+		       "and prints the compressed size, the compression ratio,\n"
+		       "the best decoding speed in MB/s of output and the\n"
+		       "workspace used in bytes (the stack is not counted).\n"
+		       "gzip is decoded both at once and in 4KB pieces.\n\n"
+		       "  -c  Only check the output of the decoders\n");
+		return 1;
+	}
+
+	image = read_file(argv[1], &image_len);
+	if (!check_only) {
+		printf("%s: %zu bytes\n", argv[1], image_len);
+		printf("%-8s %-32s %10s %7s %9s %10s\n", "codec", "file",
+		       "size", "ratio", "MB/s", "workspace");
+	}
+
+	for (i = 2; i < argc; i++) {
+		if (bench_file(argv[i], image, image_len, check_only) != 0) {
+			ret = 1;
+		}
+	}
+
+	free(image);
+
+	return ret;
+}
@@ -0,0 +1,32 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host version of the generic timer accessors used by io_encrypted.c to time
+ * the decryption: the counter is the monotonic clock, in nanoseconds.
+ */
+
+#ifndef ARCH_HELPERS_H
+#define ARCH_HELPERS_H
+
+#include <stdint.h>
+#include <time.h>
+
+static inline uint64_t read_cntpct_el0(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+static inline uint64_t read_cntfrq_el0(void)
+{
+	return 1000000000U;
+}
+
+#endif /* ARCH_HELPERS_H */
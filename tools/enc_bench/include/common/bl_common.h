@@ -0,0 +1,18 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host stub: io_encrypted.c only needs the compile time assertions and the
+ * helpers of the real header, not the image and entry point descriptors.
+ */
+
+#ifndef BL_COMMON_H
+#define BL_COMMON_H
+
+#include <lib/cassert.h>
+#include <lib/utils_def.h>
+
+#endif /* BL_COMMON_H */
@@ -0,0 +1,35 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host stub: the platform functions called by io_encrypted.c and the crypto
+ * module, implemented by the benchmark.
+ */
+
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <tools_share/firmware_encrypted.h>
+
+struct crypto_dec_ops_s;
+
+/* plat_get_enc_key_info() flags */
+#define ENC_KEY_IS_IDENTIFIER		(1 << 0)
+
+int plat_get_image_source(unsigned int image_id,
+			uintptr_t *dev_handle,
+			uintptr_t *image_spec);
+int plat_get_mbedtls_heap(void **heap_addr, size_t *heap_size);
+int get_mbedtls_heap_helper(void **heap_addr, size_t *heap_size);
+int plat_get_enc_key_info(enum fw_enc_status_t fw_enc_status, uint8_t *key,
+			  size_t *key_len, unsigned int *flags,
+			  const uint8_t *img_id, size_t img_id_len);
+const struct crypto_dec_ops_s *plat_get_dec_ops(void);
+
+#endif /* PLATFORM_H */
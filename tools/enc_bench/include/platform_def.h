@@ -0,0 +1,15 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host platform: PLAT_ENC_DEC_CHUNK_SIZE is set by the Makefile for each
+ * build of io_encrypted.c.
+ */
+
+#ifndef PLATFORM_DEF_H
+#define PLATFORM_DEF_H
+
+#endif /* PLATFORM_DEF_H */
@@ -0,0 +1,389 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host test and benchmark of the encrypted image loading of io_encrypted.c,
+ * decrypted by the mbed TLS AES-GCM backend of the crypto module. Images are
+ * encrypted here and read through the driver from a memory backend, which
+ * copies them as the storage driver below io_encrypted.c would.
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <mbedtls/gcm.h>
+#include <mbedtls/memory_buffer_alloc.h>
+
+#include <drivers/auth/crypto_mod.h>
+#include <drivers/io/io_driver.h>
+#include <drivers/io/io_encrypted.h>
+#include <drivers/io/io_storage.h>
+#include <plat/common/platform.h>
+#include <tools_share/firmware_encrypted.h>
+
+#define KEY_LEN			32U
+#define IV_LEN			12U
+#define TAG_LEN			16U
+
+/* Minimum time spent loading the image in the benchmark, in ns */
+#define BENCH_MIN_NS		500000000ULL
+
+/* Encrypted image, as stored after its header */
+static struct {
+	struct fw_enc_hdr header;
+	uint8_t *data;
+	size_t len;
+	size_t pos;
+} store;
+
+static uint8_t key[KEY_LEN];
+static const io_uuid_spec_t image_spec;
+static const io_dev_connector_t *enc_dev_con;
+
+/* Memory backend of the driver */
+int io_register_device(const io_dev_info_t *dev_info)
+{
+	return 0;
+}
+
+int io_open(uintptr_t dev_handle, const uintptr_t spec, uintptr_t *handle)
+{
+	store.pos = 0U;
+	*handle = (uintptr_t)&store;
+
+	return 0;
+}
+
+int io_size(uintptr_t handle, size_t *length)
+{
+	*length = sizeof(store.header) + store.len;
+
+	return 0;
+}
+
+int io_read(uintptr_t handle, uintptr_t buffer, size_t length,
+	    size_t *length_read)
+{
+	size_t n;
+
+	/* The header is always read on its own, first */
+	if (store.pos == 0U) {
+		if (length != sizeof(store.header)) {
+			return -EINVAL;
+		}
+		memcpy((void *)buffer, &store.header, length);
+		store.pos = sizeof(store.header);
+		*length_read = length;
+		return 0;
+	}
+
+	n = store.len - (store.pos - sizeof(store.header));
+	if (n > length) {
+		n = length;
+	}
+
+	memcpy((void *)buffer, store.data + store.pos - sizeof(store.header),
+	       n);
+	store.pos += n;
+	*length_read = n;
+
+	return 0;
+}
+
+int io_close(uintptr_t handle)
+{
+	return 0;
+}
+
+/* Platform functions */
+int plat_get_image_source(unsigned int image_id, uintptr_t *dev_handle,
+			  uintptr_t *image_spec)
+{
+	*dev_handle = 0U;
+	*image_spec = (uintptr_t)&image_spec;
+
+	return 0;
+}
+
+int plat_get_enc_key_info(enum fw_enc_status_t fw_enc_status, uint8_t *key_buf,
+			  size_t *key_len, unsigned int *flags,
+			  const uint8_t *img_id, size_t img_id_len)
+{
+	memcpy(key_buf, key, sizeof(key));
+	*key_len = sizeof(key);
+	*flags = 0U;
+
+	return 0;
+}
+
+/* No crypto engine: the chunks are decrypted by mbed TLS */
+const struct crypto_dec_ops_s *plat_get_dec_ops(void)
+{
+	return NULL;
+}
+
+int plat_get_mbedtls_heap(void **heap_addr, size_t *heap_size)
+{
+	return get_mbedtls_heap_helper(heap_addr, heap_size);
+}
+
+static void fill_random(uint8_t *buf, size_t len)
+{
+	size_t i;
+
+	for (i = 0U; i < len; i++) {
+		buf[i] = (uint8_t)rand();
+	}
+}
+
+/* Encrypt plaintext, of len bytes, to the store with a new key and IV */
+static void encrypt_image(const uint8_t *plaintext, size_t len)
+{
+	mbedtls_gcm_context ctx;
+	int rc;
+
+	fill_random(key, sizeof(key));
+
+	memset(&store.header, 0, sizeof(store.header));
+	store.header.magic = ENC_HEADER_MAGIC;
+	store.header.dec_algo = CRYPTO_GCM_DECRYPT;
+	store.header.flags = FW_ENC_WITH_SSK;
+	store.header.iv_len = IV_LEN;
+	store.header.tag_len = TAG_LEN;
+	fill_random(store.header.iv, IV_LEN);
+
+	free(store.data);
+	store.data = malloc((len != 0U) ? len : 1U);
+	if (store.data == NULL) {
+		perror("malloc");
+		exit(1);
+	}
+	store.len = len;
+
+	mbedtls_gcm_init(&ctx);
+	rc = mbedtls_gcm_setkey(&ctx, MBEDTLS_CIPHER_ID_AES, key,
+				sizeof(key) * 8U);
+	if (rc == 0) {
+		rc = mbedtls_gcm_crypt_and_tag(&ctx, MBEDTLS_GCM_ENCRYPT, len,
+					       store.header.iv, IV_LEN, NULL,
+					       0U, plaintext, store.data,
+					       TAG_LEN, store.header.tag);
+	}
+	mbedtls_gcm_free(&ctx);
+
+	if (rc != 0) {
+		fprintf(stderr, "Failed to encrypt the image (%d)\n", rc);
+		exit(1);
+	}
+}
+
+/* Load the image of the store through the driver, as BL2 does */
+static int load_image(uint8_t *buf, size_t len, size_t *length_read)
+{
+	io_dev_info_t *dev_info;
+	io_entity_t entity = { 0 };
+	int rc;
+
+	*length_read = 0U;
+
+	rc = enc_dev_con->dev_open(0U, &dev_info);
+	if (rc == 0) {
+		rc = dev_info->funcs->dev_init(dev_info, 0U);
+	}
+	if (rc == 0) {
+		entity.dev_handle = dev_info;
+		rc = dev_info->funcs->open(dev_info, (uintptr_t)&image_spec,
+					   &entity);
+	}
+	if (rc != 0) {
+		return rc;
+	}
+
+	rc = dev_info->funcs->read(&entity, (uintptr_t)buf, len, length_read);
+
+	dev_info->funcs->close(&entity);
+	dev_info->funcs->dev_close(dev_info);
+
+	return rc;
+}
+
+static int check_image(size_t len)
+{
+	uint8_t *plaintext, *buf;
+	size_t length_read;
+	int failed = 0;
+	int rc;
+
+	plaintext = malloc(len + 1U);
+	buf = malloc(len + 1U);
+	if ((plaintext == NULL) || (buf == NULL)) {
+		perror("malloc");
+		exit(1);
+	}
+
+	fill_random(plaintext, len);
+	encrypt_image(plaintext, len);
+
+	rc = load_image(buf, len, &length_read);
+	if ((rc != 0) || (length_read != len) ||
+	    (memcmp(buf, plaintext, len) != 0)) {
+		fprintf(stderr, "%zu bytes: loading failed (%d)\n", len, rc);
+		failed++;
+	}
+
+	/* Corrupted ciphertext, then corrupted tag */
+	if (len != 0U) {
+		store.data[len / 2U] ^= 0x10U;
+		rc = load_image(buf, len, &length_read);
+		if (rc == 0) {
+			fprintf(stderr,
+				"%zu bytes: corrupted data accepted\n", len);
+			failed++;
+		}
+		store.data[len / 2U] ^= 0x10U;
+	}
+
+	store.header.tag[TAG_LEN - 1U] ^= 0x01U;
+	rc = load_image(buf, len, &length_read);
+	if (rc == 0) {
+		fprintf(stderr, "%zu bytes: corrupted tag accepted\n", len);
+		failed++;
+	}
+
+	free(plaintext);
+	free(buf);
+
+	return failed;
+}
+
+static int check(size_t chunk)
+{
+	const size_t lens[] = {
+		1U, 15U, 16U, 17U, 4096U, chunk - 1U, chunk, chunk + 1U,
+		(3U * chunk) + 5U, 1048576U + 3U
+	};
+	unsigned int i;
+	int failed = 0;
+
+	for (i = 0U; i < sizeof(lens) / sizeof(lens[0]); i++) {
+		failed += check_image(lens[i]);
+	}
+
+	if (failed != 0) {
+		fprintf(stderr, "%d checks failed\n", failed);
+		return 1;
+	}
+
+	printf("Loaded %u encrypted images successfully\n", i);
+
+	return 0;
+}
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+static int bench(const char *path)
+{
+	uint8_t *plaintext, *buf;
+	size_t len, length_read;
+	uint64_t start, elapsed;
+	unsigned int loads;
+	FILE *f;
+
+	f = fopen(path, "rb");
+	if (f == NULL) {
+		perror(path);
+		return 1;
+	}
+	fseek(f, 0L, SEEK_END);
+	len = (size_t)ftell(f);
+	rewind(f);
+
+	plaintext = malloc(len + 1U);
+	buf = malloc(len + 1U);
+	if ((plaintext == NULL) || (buf == NULL) ||
+	    (fread(plaintext, 1U, len, f) != len)) {
+		fprintf(stderr, "Failed to read %s\n", path);
+		fclose(f);
+		return 1;
+	}
+	fclose(f);
+
+	encrypt_image(plaintext, len);
+
+	loads = 0U;
+	start = now_ns();
+	do {
+		if ((load_image(buf, len, &length_read) != 0) ||
+		    (length_read != len)) {
+			fprintf(stderr, "Failed to load %s\n", path);
+			return 1;
+		}
+		loads++;
+		elapsed = now_ns() - start;
+	} while (elapsed < BENCH_MIN_NS);
+
+	if (memcmp(buf, plaintext, len) != 0) {
+		fprintf(stderr, "%s: wrong plaintext\n", path);
+		return 1;
+	}
+
+	printf("%s: %zu bytes loaded in %.1f us, %.1f MB/s\n", path, len,
+	       (double)elapsed / loads / 1000.0,
+	       (double)len * loads * 1000.0 / (double)elapsed);
+
+	free(plaintext);
+	free(buf);
+
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	void *heap_addr;
+	size_t heap_size;
+
+	if ((argc != 2) && ((argc != 3) || (strcmp(argv[1], "-c") != 0))) {
+		printf("Usage: %s <image>\n", argv[0]);
+		printf("       %s -c <chunk size>\n\n", argv[0]);
+		printf("Loads the image, encrypted with AES-GCM, through the\n"
+		       "encrypted image driver and prints the throughput.\n"
+		       "With -c, loads images of lengths around the chunk\n"
+		       "size and checks the result.\n");
+		return 1;
+	}
+
+	srand(1U);
+
+	/*
+	 * As mbedtls_init(), without registering the exit handler that
+	 * panics outside of BL2.
+	 */
+	plat_get_mbedtls_heap(&heap_addr, &heap_size);
+	mbedtls_memory_buffer_alloc_init(heap_addr, heap_size);
+
+	if (register_io_dev_enc(&enc_dev_con) != 0) {
+		fprintf(stderr, "Failed to register the driver\n");
+		return 1;
+	}
+
+	if (argc == 3) {
+		return check(strtoul(argv[2], NULL, 0));
+	}
+
+	return bench(argv[1]);
+}
@@ -8,11 +8,16 @@
 #include <firmware_encrypted.h>
 #include <openssl/evp.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "debug.h"
 #include "encrypt.h"
 
-#define BUFFER_SIZE		256
+/*
+ * The image is encrypted in place, one chunk at a time, so memory use does not
+ * depend on the image size.
+ */
+#define CHUNK_SIZE		(64 * 1024)
 #define IV_SIZE			12
 #define IV_STRING_SIZE		24
 #define TAG_SIZE		16
@@ -26,9 +31,10 @@ static int gcm_encrypt(unsigned short fw_enc_status, char *key_string,
 	FILE *ip_file;
 	FILE *op_file;
 	EVP_CIPHER_CTX *ctx;
-	unsigned char data[BUFFER_SIZE], enc_data[BUFFER_SIZE];
+	unsigned char *data;
 	unsigned char key[KEY_SIZE], iv[IV_SIZE], tag[TAG_SIZE];
-	int bytes, enc_len = 0, i, j, ret = 0;
+	size_t bytes;
+	int enc_len = 0, i, j, ret = 0;
 	struct fw_enc_hdr header;
 
 	memset(&header, 0, sizeof(struct fw_enc_hdr));
@@ -57,9 +63,16 @@ static int gcm_encrypt(unsigned short fw_enc_status, char *key_string,
 		}
 	}
 
+	data = malloc(CHUNK_SIZE);
+	if (data == NULL) {
+		ERROR("Cannot allocate memory\n");
+		return -1;
+	}
+
 	ip_file = fopen(ip_name, "rb");
 	if (ip_file == NULL) {
 		ERROR("Cannot read %s\n", ip_name);
+		free(data);
 		return -1;
 	}
 
@@ -67,12 +80,19 @@ static int gcm_encrypt(unsigned short fw_enc_status, char *key_string,
 	if (op_file == NULL) {
 		ERROR("Cannot write %s\n", op_name);
 		fclose(ip_file);
+		free(data);
 		return -1;
 	}
 
-	ret = fseek(op_file, sizeof(struct fw_enc_hdr), SEEK_SET);
-	if (ret) {
-		ERROR("fseek failed\n");
+	/*
+	 * Reserve room for the header, which is only complete once the tag is
+	 * known, and stream the ciphertext after it.
+	 */
+	memset(data, 0, sizeof(struct fw_enc_hdr));
+	if (fwrite(data, 1, sizeof(struct fw_enc_hdr), op_file) !=
+	    sizeof(struct fw_enc_hdr)) {
+		ERROR("Cannot write %s\n", op_name);
+		ret = -1;
 		goto out_file;
 	}
 
@@ -93,21 +113,33 @@ static int gcm_encrypt(unsigned short fw_enc_status, char *key_string,
 	ret = EVP_EncryptInit_ex(ctx, NULL, NULL, key, iv);
 	if (ret != 1) {
 		ERROR("EVP_EncryptInit_ex failed\n");
+		ret = -1;
 		goto out;
 	}
 
-	while ((bytes = fread(data, 1, BUFFER_SIZE, ip_file)) != 0) {
-		ret = EVP_EncryptUpdate(ctx, enc_data, &enc_len, data, bytes);
+	while ((bytes = fread(data, 1, CHUNK_SIZE, ip_file)) != 0) {
+		ret = EVP_EncryptUpdate(ctx, data, &enc_len, data, (int)bytes);
 		if (ret != 1) {
 			ERROR("EVP_EncryptUpdate failed\n");
 			ret = -1;
 			goto out;
 		}
 
-		fwrite(enc_data, 1, enc_len, op_file);
+		if (fwrite(data, 1, enc_len, op_file) != (size_t)enc_len) {
+			ERROR("Cannot write %s\n", op_name);
+			ret = -1;
+			goto out;
+		}
 	}
 
-	ret = EVP_EncryptFinal_ex(ctx, enc_data, &enc_len);
+	if (ferror(ip_file)) {
+		ERROR("Cannot read %s\n", ip_name);
+		ret = -1;
+		goto out;
+	}
+
+	/* GCM is a stream mode: the final call does not output any data */
+	ret = EVP_EncryptFinal_ex(ctx, data, &enc_len);
 	if (ret != 1) {
 		ERROR("EVP_EncryptFinal_ex failed\n");
 		ret = -1;
@@ -135,14 +167,23 @@ static int gcm_encrypt(unsigned short fw_enc_status, char *key_string,
 		goto out;
 	}
 
-	fwrite(&header, 1, sizeof(struct fw_enc_hdr), op_file);
+	if (fwrite(&header, 1, sizeof(struct fw_enc_hdr), op_file) !=
+	    sizeof(struct fw_enc_hdr)) {
+		ERROR("Cannot write %s\n", op_name);
+		ret = -1;
+		goto out;
+	}
 
 out:
 	EVP_CIPHER_CTX_free(ctx);
 
 out_file:
 	fclose(ip_file);
-	fclose(op_file);
+	if (fclose(op_file) != 0 && ret >= 0) {
+		ERROR("Cannot write %s\n", op_name);
+		ret = -1;
+	}
+	free(data);
 
 	/*
 	 * EVP_* APIs returns 1 as success but enctool considers
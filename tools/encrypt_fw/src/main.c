@@ -5,13 +5,21 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+/* clock_gettime(), getrusage() and stat() with -std=c99 */
+#define _POSIX_C_SOURCE 200809L
+
 #include <assert.h>
 #include <ctype.h>
 #include <getopt.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <stdbool.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <time.h>
 
 #include <openssl/conf.h>
 
@@ -22,8 +30,28 @@
 
 #define NUM_ELEM(x)			((sizeof(x)) / (sizeof(x[0])))
 #define HELP_OPT_MAX_LEN		128
+#define MANIFEST_LINE_MAX_LEN		4096
+
+/* Options without a short form */
+#define OPT_BENCH			1
 
 /* Global options */
+static int key_alg;
+static char *key;
+static char *nonce;
+static unsigned short fw_enc_status;
+static int num_jobs = 1;
+static bool bench;
+
+/* One image to encrypt */
+typedef struct enc_job_s {
+	char *in_fn;
+	char *out_fn;
+	char *nonce;
+	int ret;
+	unsigned long long size;
+	double secs;
+} enc_job_t;
 
 /* Info messages created in the Makefile */
 extern const char build_msg[];
@@ -47,6 +75,12 @@ static void print_help(const char *cmd, const struct option *long_opt)
 	       "outputs encrypted binary image using an encryption key\n"
 	       "provided as an input hex string.\n");
 	printf("\n");
+	printf("In batch mode, each line of the manifest names one image to\n"
+	       "encrypt with the command line key, as\n"
+	       "'<in> <out> [<nonce>]'. The nonce defaults to --nonce, and\n"
+	       "must be unique in the batch. Empty lines and lines starting\n"
+	       "with '#' are ignored.\n");
+	printf("\n");
 	printf("Usage:\n");
 	printf("\t%s [OPTIONS]\n\n", cmd);
 
@@ -128,18 +162,218 @@ static const cmd_opt_t common_cmd_opt[] = {
 		{ "out", required_argument, NULL, 'o' },
 		"Encrypted output filename."
 	},
+	{
+		{ "batch", required_argument, NULL, 'b' },
+		"Encrypt the images listed in a manifest file."
+	},
+	{
+		{ "jobs", required_argument, NULL, 'j' },
+		"Number of images encrypted in parallel (default: 1)."
+	},
+	{
+		{ "bench", no_argument, NULL, OPT_BENCH },
+		"Print throughput and peak memory use."
+	},
 };
 
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void encrypt_job(enc_job_t *job)
+{
+	struct stat st;
+	double start = now();
+
+	job->ret = encrypt_file(fw_enc_status, key_alg, key, job->nonce,
+				job->in_fn, job->out_fn);
+	job->secs = now() - start;
+	if (stat(job->in_fn, &st) == 0) {
+		job->size = st.st_size;
+	}
+}
+
+typedef struct work_s {
+	enc_job_t *jobs;
+	int n;
+	int next;
+	pthread_mutex_t lock;
+} work_t;
+
+static void *work_thread(void *data)
+{
+	work_t *work = data;
+	int idx;
+
+	while (1) {
+		pthread_mutex_lock(&work->lock);
+		idx = work->next++;
+		pthread_mutex_unlock(&work->lock);
+		if (idx >= work->n) {
+			break;
+		}
+		encrypt_job(&work->jobs[idx]);
+	}
+
+	return NULL;
+}
+
+/*
+ * Encrypt the images with num_jobs worker threads. Each image is encrypted by
+ * a single thread, with its own cipher context.
+ */
+static void run_jobs(enc_job_t *jobs, int n)
+{
+	pthread_t *threads;
+	work_t work = { .jobs = jobs, .n = n, .next = 0 };
+	int i, num_threads = (num_jobs < n) ? num_jobs : n;
+
+	if (num_threads <= 1) {
+		for (i = 0; i < n; i++) {
+			encrypt_job(&jobs[i]);
+		}
+		return;
+	}
+
+	threads = malloc(num_threads * sizeof(*threads));
+	if (threads == NULL) {
+		ERROR("Cannot allocate memory\n");
+		exit(1);
+	}
+
+	pthread_mutex_init(&work.lock, NULL);
+	for (i = 0; i < num_threads; i++) {
+		if (pthread_create(&threads[i], NULL, work_thread, &work) != 0) {
+			ERROR("Cannot create worker thread\n");
+			exit(1);
+		}
+	}
+	for (i = 0; i < num_threads; i++) {
+		pthread_join(threads[i], NULL);
+	}
+	pthread_mutex_destroy(&work.lock);
+	free(threads);
+}
+
+static char *xstrdup(const char *s)
+{
+	char *p = strdup(s);
+
+	if (p == NULL) {
+		ERROR("Cannot allocate memory\n");
+		exit(1);
+	}
+
+	return p;
+}
+
+/* Read the images to encrypt from a manifest file */
+static enc_job_t *read_manifest(const char *fn, int *num)
+{
+	char line[MANIFEST_LINE_MAX_LEN];
+	char *tok[4], *p;
+	enc_job_t *jobs = NULL, *tmp;
+	FILE *file;
+	int i, n = 0, lineno = 0;
+
+	file = fopen(fn, "r");
+	if (file == NULL) {
+		ERROR("Cannot open manifest %s\n", fn);
+		exit(1);
+	}
+
+	while (fgets(line, sizeof(line), file) != NULL) {
+		lineno++;
+		if (strchr(line, '\n') == NULL && !feof(file)) {
+			ERROR("%s:%d: line too long\n", fn, lineno);
+			exit(1);
+		}
+
+		for (i = 0, p = strtok(line, " \t\r\n"); p != NULL && i < 4;
+		     p = strtok(NULL, " \t\r\n")) {
+			tok[i++] = p;
+		}
+		if (i == 0 || tok[0][0] == '#') {
+			continue;
+		}
+		if (i < 2 || i > 3) {
+			ERROR("%s:%d: expected '<in> <out> [<nonce>]'\n",
+			      fn, lineno);
+			exit(1);
+		}
+		if (i == 2 && nonce == NULL) {
+			ERROR("%s:%d: no nonce given\n", fn, lineno);
+			exit(1);
+		}
+
+		tmp = realloc(jobs, (n + 1) * sizeof(*jobs));
+		if (tmp == NULL) {
+			ERROR("Cannot allocate memory\n");
+			exit(1);
+		}
+		jobs = tmp;
+		memset(&jobs[n], 0, sizeof(*jobs));
+		jobs[n].in_fn = xstrdup(tok[0]);
+		jobs[n].out_fn = xstrdup(tok[1]);
+		jobs[n].nonce = xstrdup((i == 3) ? tok[2] : nonce);
+		n++;
+	}
+	fclose(file);
+
+	/* All the images share the key, so reusing a nonce breaks AES-GCM */
+	for (i = 0; i < n; i++) {
+		int j;
+
+		for (j = i + 1; j < n; j++) {
+			if (strcasecmp(jobs[i].nonce, jobs[j].nonce) == 0) {
+				ERROR("%s and %s use the same nonce\n",
+				      jobs[i].in_fn, jobs[j].in_fn);
+				exit(1);
+			}
+		}
+	}
+
+	*num = n;
+
+	return jobs;
+}
+
+static void print_bench(const enc_job_t *jobs, int n, double secs)
+{
+	struct rusage usage;
+	unsigned long long total = 0;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		printf("%s: %llu bytes in %.3f s, %.1f MB/s\n", jobs[i].in_fn,
+		       jobs[i].size, jobs[i].secs,
+		       jobs[i].size / 1e6 / jobs[i].secs);
+		total += jobs[i].size;
+	}
+	printf("Total: %d image(s), %llu bytes in %.3f s, %.1f MB/s, "
+	       "%d job(s)\n", n, total, secs, total / 1e6 / secs, num_jobs);
+
+	/* ru_maxrss is in kilobytes on Linux */
+	if (getrusage(RUSAGE_SELF, &usage) == 0) {
+		printf("Peak memory: %ld KiB\n", usage.ru_maxrss);
+	}
+}
+
 int main(int argc, char *argv[])
 {
-	int i, key_alg, ret;
+	int i, ret, n;
 	int c, opt_idx = 0;
 	const struct option *cmd_opt;
-	char *key = NULL;
-	char *nonce = NULL;
 	char *in_fn = NULL;
 	char *out_fn = NULL;
-	unsigned short fw_enc_status = 0;
+	char *batch_fn = NULL;
+	enc_job_t *jobs, single;
+	double start;
 
 	NOTICE("Firmware Encryption Tool: %s\n", build_msg);
 
@@ -156,7 +390,8 @@ int main(int argc, char *argv[])
 
 	while (1) {
 		/* getopt_long stores the option index here. */
-		c = getopt_long(argc, argv, "a:f:hi:k:n:o:", cmd_opt, &opt_idx);
+		c = getopt_long(argc, argv, "a:b:f:hi:j:k:n:o:", cmd_opt,
+				&opt_idx);
 
 		/* Detect the end of the options. */
 		if (c == -1) {
@@ -171,9 +406,19 @@ int main(int argc, char *argv[])
 				exit(1);
 			}
 			break;
+		case 'b':
+			batch_fn = optarg;
+			break;
 		case 'f':
 			parse_fw_enc_status_flag(optarg, &fw_enc_status);
 			break;
+		case 'j':
+			num_jobs = atoi(optarg);
+			if (num_jobs < 1) {
+				ERROR("Invalid number of jobs '%s'\n", optarg);
+				exit(1);
+			}
+			break;
 		case 'k':
 			key = optarg;
 			break;
@@ -186,6 +431,9 @@ int main(int argc, char *argv[])
 		case 'n':
 			nonce = optarg;
 			break;
+		case OPT_BENCH:
+			bench = true;
+			break;
 		case 'h':
 			print_help(argv[0], cmd_opt);
 			exit(0);
@@ -201,22 +449,59 @@ int main(int argc, char *argv[])
 		exit(1);
 	}
 
-	if (!nonce) {
-		ERROR("Nonce must not be NULL\n");
-		exit(1);
+	if (batch_fn) {
+		if (in_fn || out_fn) {
+			ERROR("--in/--out cannot be used with --batch\n");
+			exit(1);
+		}
+		jobs = read_manifest(batch_fn, &n);
+	} else {
+		if (!nonce) {
+			ERROR("Nonce must not be NULL\n");
+			exit(1);
+		}
+
+		if (!in_fn) {
+			ERROR("Input filename must not be NULL\n");
+			exit(1);
+		}
+
+		if (!out_fn) {
+			ERROR("Output filename must not be NULL\n");
+			exit(1);
+		}
+
+		memset(&single, 0, sizeof(single));
+		single.in_fn = in_fn;
+		single.out_fn = out_fn;
+		single.nonce = nonce;
+		jobs = &single;
+		n = 1;
 	}
 
-	if (!in_fn) {
-		ERROR("Input filename must not be NULL\n");
-		exit(1);
+	start = now();
+	run_jobs(jobs, n);
+
+	ret = 0;
+	for (i = 0; i < n; i++) {
+		if (jobs[i].ret != 0) {
+			ERROR("Cannot encrypt %s\n", jobs[i].in_fn);
+			ret = jobs[i].ret;
+		}
 	}
 
-	if (!out_fn) {
-		ERROR("Output filename must not be NULL\n");
-		exit(1);
+	if (bench) {
+		print_bench(jobs, n, now() - start);
 	}
 
-	ret = encrypt_file(fw_enc_status, key_alg, key, nonce, in_fn, out_fn);
+	if (batch_fn) {
+		for (i = 0; i < n; i++) {
+			free(jobs[i].in_fn);
+			free(jobs[i].out_fn);
+			free(jobs[i].nonce);
+		}
+		free(jobs);
+	}
 
 	CRYPTO_cleanup_all_ex_data();
 
@@ -5,7 +5,10 @@
  */
 
 #ifndef _MSC_VER
+#include <sys/mman.h>
 #include <sys/mount.h>
+#include <sys/uio.h>
+#include <fcntl.h>
 #endif
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -25,6 +28,8 @@
 #define OPT_TOC_ENTRY 0
 #define OPT_PLAT_TOC_FLAGS 1
 #define OPT_ALIGN 2
+#define OPT_IN_PLACE 3
+#define OPT_DIGEST_CACHE 4
 
 static int info_cmd(int argc, char *argv[]);
 static void info_usage(int);
@@ -167,15 +172,50 @@ static void set_image_desc_action(image_desc_t *desc, int action,
 		    "failed to allocate memory for argument");
 }
 
+/*
+ * Load a whole file into memory. Where possible the file is mapped rather
+ * than read, as its contents are only ever read. Return 1 if the buffer is
+ * a mapping.
+ */
+static int load_file(FILE *fp, size_t size, void **buf, const char *filename)
+{
+#ifndef _MSC_VER
+	if (size != 0) {
+		*buf = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+		if (*buf != MAP_FAILED)
+			return 1;
+	}
+#endif
+	*buf = xmalloc(size, "failed to load file into memory");
+	if (fread(*buf, 1, size, fp) != size)
+		log_errx("Failed to read %s", filename);
+	return 0;
+}
+
+static void unload_file(void *buf, size_t size, int mapped)
+{
+#ifndef _MSC_VER
+	if (mapped) {
+		munmap(buf, size);
+		return;
+	}
+#endif
+	free(buf);
+}
+
+static void free_image(image_t *image)
+{
+	unload_file(image->buffer, image->toc_e.size, image->mapped);
+	free(image);
+}
+
 static void free_image_desc(image_desc_t *desc)
 {
 	free(desc->name);
 	free(desc->cmdline_name);
 	free(desc->action_arg);
-	if (desc->image) {
-		free(desc->image->buffer);
-		free(desc->image);
-	}
+	if (desc->image)
+		free_image(desc->image);
 	free(desc);
 }
 
@@ -301,6 +341,7 @@ static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
 	fip_toc_header_t *toc_header;
 	fip_toc_entry_t *toc_entry;
 	int terminated = 0;
+	int mapped;
 	size_t st_size;
 
 	fp = fopen(filename, "rb");
@@ -318,9 +359,7 @@ static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
 			log_err("ioctl %s", filename);
 #endif
 
-	buf = xmalloc(st_size, "failed to load file into memory");
-	if (fread(buf, 1, st_size, fp) != st_size)
-		log_errx("Failed to read %s", filename);
+	mapped = load_file(fp, st_size, (void **)&buf, filename);
 	bufend = buf + st_size;
 	fclose(fp);
 
@@ -392,7 +431,7 @@ static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
 	if (terminated == 0)
 		log_errx("FIP %s does not have a ToC terminator entry",
 		    filename);
-	free(buf);
+	unload_file(buf, st_size, mapped);
 	return 0;
 }
 
@@ -414,9 +453,7 @@ static image_t *read_image_from_file(const uuid_t *uuid, const char *filename)
 
 	image = xzalloc(sizeof(*image), "failed to allocate memory for image");
 	image->toc_e.uuid = *uuid;
-	image->buffer = xmalloc(st.st_size, "failed to allocate image buffer");
-	if (fread(image->buffer, 1, st.st_size, fp) != st.st_size)
-		log_errx("Failed to read %s", filename);
+	image->mapped = load_file(fp, st.st_size, &image->buffer, filename);
 	image->toc_e.size = st.st_size;
 
 	fclose(fp);
@@ -470,14 +507,145 @@ static void md_print(const unsigned char *md, size_t len)
 }
 #endif
 
+#if !defined(_MSC_VER) && !STATIC
+/*
+ * On-disk cache of the SHA-256 digests of FIP images, so that repeated
+ * "info --verbose" runs over the same FIPs do not hash every image again.
+ * Each line holds a digest and its key: the FIP path, modification time and
+ * size, and the offset and size of the image in it.
+ */
+typedef struct digest_cache_entry {
+	unsigned char md[SHA256_DIGEST_LENGTH];
+	long long mtime;
+	unsigned long long fip_size;
+	unsigned long long offset;
+	unsigned long long size;
+	char *path;
+	struct digest_cache_entry *next;
+} digest_cache_entry_t;
+
+static digest_cache_entry_t *digest_cache_head;
+
+static void digest_cache_load(const char *filename)
+{
+	char line[PATH_MAX + 256], hex[2 * SHA256_DIGEST_LENGTH + 1];
+	digest_cache_entry_t *e;
+	FILE *fp;
+	size_t i;
+	int n;
+
+	fp = fopen(filename, "r");
+	if (fp == NULL)
+		return;
+
+	while (fgets(line, sizeof(line), fp) != NULL) {
+		e = xzalloc(sizeof(*e), "failed to allocate digest cache entry");
+		line[strcspn(line, "\n")] = '\0';
+		if (sscanf(line, "%64s %lld %llu %llu %llu %n", hex, &e->mtime,
+		    &e->fip_size, &e->offset, &e->size, &n) != 5 ||
+		    strlen(hex) != 2 * SHA256_DIGEST_LENGTH) {
+			free(e);
+			continue;
+		}
+		for (i = 0; i < SHA256_DIGEST_LENGTH; i++)
+			sscanf(&hex[2 * i], "%2hhx", &e->md[i]);
+		e->path = xstrdup(line + n,
+		    "failed to allocate digest cache entry");
+		e->next = digest_cache_head;
+		digest_cache_head = e;
+	}
+	fclose(fp);
+}
+
+static void digest_cache_free(void)
+{
+	digest_cache_entry_t *e = digest_cache_head, *tmp;
+
+	while (e != NULL) {
+		tmp = e->next;
+		free(e->path);
+		free(e);
+		e = tmp;
+	}
+	digest_cache_head = NULL;
+}
+
+/*
+ * Compute the SHA-256 digest of an image of the FIP at path, or take it from
+ * the cache. New digests are appended to the cache file if there is one.
+ */
+static void image_digest(const image_t *image, const char *path,
+    const struct BLD_PLAT_STAT *st, FILE *cache, unsigned char *md)
+{
+	digest_cache_entry_t *e;
+	size_t i;
+
+	for (e = digest_cache_head; e != NULL; e = e->next) {
+		if (e->mtime == (long long)st->st_mtime &&
+		    e->fip_size == (unsigned long long)st->st_size &&
+		    e->offset == image->toc_e.offset_address &&
+		    e->size == image->toc_e.size &&
+		    strcmp(e->path, path) == 0) {
+			memcpy(md, e->md, SHA256_DIGEST_LENGTH);
+			return;
+		}
+	}
+
+	SHA256(image->buffer, image->toc_e.size, md);
+
+	if (cache != NULL) {
+		for (i = 0; i < SHA256_DIGEST_LENGTH; i++)
+			fprintf(cache, "%02x", md[i]);
+		fprintf(cache, " %lld %llu %llu %llu %s\n",
+		    (long long)st->st_mtime,
+		    (unsigned long long)st->st_size,
+		    (unsigned long long)image->toc_e.offset_address,
+		    (unsigned long long)image->toc_e.size, path);
+	}
+}
+#endif
+
 static int info_cmd(int argc, char *argv[])
 {
+	struct option *opts = NULL;
+	size_t nr_opts = 0;
+	char cache_file[PATH_MAX] = { 0 };
 	image_desc_t *desc;
 	fip_toc_header_t toc_header;
+#if !defined(_MSC_VER) && !STATIC
+	struct BLD_PLAT_STAT st;
+	char path[PATH_MAX];
+	FILE *cache = NULL;
+#endif
 
-	if (argc != 2)
+	if (argc < 2)
+		info_usage(EXIT_FAILURE);
+
+	opts = add_opt(opts, &nr_opts, "digest-cache", required_argument,
+	    OPT_DIGEST_CACHE);
+	opts = add_opt(opts, &nr_opts, NULL, 0, 0);
+
+	while (1) {
+		int c, opt_index = 0;
+
+		c = getopt_long(argc, argv, "", opts, &opt_index);
+		if (c == -1)
+			break;
+
+		switch (c) {
+		case OPT_DIGEST_CACHE:
+			snprintf(cache_file, sizeof(cache_file), "%s", optarg);
+			break;
+		default:
+			info_usage(EXIT_FAILURE);
+		}
+	}
+	argc -= optind;
+	argv += optind;
+	free(opts);
+
+	if (argc != 1)
 		info_usage(EXIT_FAILURE);
-	argc--, argv++;
 
 	parse_fip(argv[0], &toc_header);
 
@@ -490,6 +658,19 @@ static int info_cmd(int argc, char *argv[])
 		    (unsigned long long)toc_header.flags);
 	}
 
+#if !defined(_MSC_VER) && !STATIC
+	if (verbose && cache_file[0] != '\0') {
+		if (stat(argv[0], &st) == -1)
+			log_err("stat %s", argv[0]);
+		if (realpath(argv[0], path) == NULL)
+			log_err("realpath %s", argv[0]);
+		digest_cache_load(cache_file);
+		cache = fopen(cache_file, "a");
+		if (cache == NULL)
+			log_err("fopen %s", cache_file);
+	}
+#endif
+
 	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
 		image_t *image = desc->image;
 
@@ -510,7 +691,10 @@ static int info_cmd(int argc, char *argv[])
 		if (verbose) {
 			unsigned char md[SHA256_DIGEST_LENGTH];
 
-			SHA256(image->buffer, image->toc_e.size, md);
+			if (cache != NULL)
+				image_digest(image, path, &st, cache, md);
+			else
+				SHA256(image->buffer, image->toc_e.size, md);
 			printf(", sha256=");
 			md_print(md, sizeof(md));
 		}
@@ -518,15 +702,118 @@ static int info_cmd(int argc, char *argv[])
 		putchar('\n');
 	}
 
+#if !defined(_MSC_VER) && !STATIC
+	if (cache != NULL) {
+		fclose(cache);
+		digest_cache_free();
+	}
+#endif
+
 	return 0;
 }
 
 static void info_usage(int exit_status)
 {
-	printf("fiptool info FIP_FILENAME\n");
+	printf("fiptool info [opts] FIP_FILENAME\n");
+	printf("\n");
+	printf("Options:\n");
+	printf("  --digest-cache FILE\tReuse the image digests printed by --verbose from FILE, and add new ones to it.\n");
 	exit(exit_status);
 }
 
+#ifndef _MSC_VER
+static void xwritev(int fd, struct iovec *iov, int iovcnt,
+    const char *filename)
+{
+	ssize_t n;
+
+	while (iovcnt > 0) {
+		n = writev(fd, iov, iovcnt < IOV_MAX ? iovcnt : IOV_MAX);
+		if (n == -1) {
+			if (errno == EINTR)
+				continue;
+			log_err("writev %s", filename);
+		}
+		/* Skip what was written, writev() may stop short. */
+		while (iovcnt > 0 && (size_t)n >= iov->iov_len) {
+			n -= iov->iov_len;
+			iov++;
+			iovcnt--;
+		}
+		if (iovcnt > 0) {
+			iov->iov_base = (char *)iov->iov_base + n;
+			iov->iov_len -= n;
+		}
+	}
+}
+
+static void xpwrite(int fd, const void *buf, size_t size, off_t offset,
+    const char *filename)
+{
+	ssize_t n;
+
+	while (size > 0) {
+		n = pwrite(fd, buf, size, offset);
+		if (n == -1) {
+			if (errno == EINTR)
+				continue;
+			log_err("pwrite %s", filename);
+		}
+		buf = (const char *)buf + n;
+		size -= n;
+		offset += n;
+	}
+}
+
+/*
+ * Write the ToC, the images and the padding between them with a single
+ * vectored write rather than one stdio write per image. The images must
+ * have their ToC offsets assigned.
+ */
+static void write_fip_vectored(int fd, const char *filename,
+    const void *toc, uint64_t toc_size, uint64_t fip_size,
+    unsigned long align)
+{
+	image_desc_t *desc;
+	struct iovec *iov;
+	uint64_t pos = toc_size;
+	char *zeros;
+	int iovcnt = 0;
+
+	iov = xmalloc(sizeof(*iov) * (2 * nr_image_descs + 2),
+	    "failed to allocate I/O vector");
+	zeros = xzalloc(align, "failed to allocate padding");
+
+	iov[iovcnt].iov_base = (void *)toc;
+	iov[iovcnt++].iov_len = toc_size;
+
+	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
+		image_t *image = desc->image;
+
+		if (image == NULL || image->toc_e.size == 0ULL)
+			continue;
+		assert(image->toc_e.offset_address - pos < align);
+		if (image->toc_e.offset_address != pos) {
+			iov[iovcnt].iov_base = zeros;
+			iov[iovcnt++].iov_len = image->toc_e.offset_address - pos;
+		}
+		iov[iovcnt].iov_base = image->buffer;
+		iov[iovcnt++].iov_len = image->toc_e.size;
+		pos = image->toc_e.offset_address + image->toc_e.size;
+	}
+
+	if (fip_size != pos) {
+		iov[iovcnt].iov_base = zeros;
+		iov[iovcnt++].iov_len = fip_size - pos;
+	}
+
+	xwritev(fd, iov, iovcnt, filename);
+
+	free(zeros);
+	free(iov);
+}
+#endif
+
 static int pack_images(const char *filename, uint64_t toc_flags, unsigned long align)
 {
 	FILE *fp;
@@ -534,7 +821,10 @@ static int pack_images(const char *filename, uint64_t toc_flags, unsigned long a
 	fip_toc_header_t *toc_header;
 	fip_toc_entry_t *toc_entry;
 	char *buf;
-	uint64_t entry_offset, buf_size, payload_size = 0, pad_size;
+	uint64_t entry_offset, buf_size, payload_size = 0;
+#ifdef _MSC_VER
+	uint64_t pad_size;
+#endif
 	size_t nr_images = 0;
 
 	for (desc = image_desc_head; desc != NULL; desc = desc->next)
@@ -584,6 +874,13 @@ static int pack_images(const char *filename, uint64_t toc_flags, unsigned long a
 	if (verbose)
 		log_dbgx("Metadata size: %zu bytes", buf_size);
 
+#ifndef _MSC_VER
+	if (verbose)
+		log_dbgx("Payload size: %zu bytes", payload_size);
+
+	write_fip_vectored(fileno(fp), filename, buf, buf_size,
+	    toc_entry->offset_address, align);
+#else
 	xfwrite(buf, buf_size, fp, filename);
 
 	if (verbose)
@@ -606,6 +903,7 @@ static int pack_images(const char *filename, uint64_t toc_flags, unsigned long a
 	pad_size = toc_entry->offset_address - entry_offset;
 	while (pad_size--)
 		fputc(0x0, fp);
+#endif
 
 	free(buf);
 	fclose(fp);
@@ -638,7 +936,7 @@ static void update_fip(void)
 				    desc->cmdline_name,
 				    desc->action_arg);
 			}
-			free(desc->image);
+			free_image(desc->image);
 			desc->image = image;
 		} else {
 			if (verbose)
@@ -649,6 +947,135 @@ static void update_fip(void)
 	}
 }
 
+#ifndef _MSC_VER
+/*
+ * Patch the images to be replaced straight into an existing FIP, leaving
+ * the rest of the file untouched. This is only done when every such image
+ * is already in the FIP and fits in the space taken by its old version.
+ * Images whose contents did not change are not written at all.
+ * Return -1, without writing anything, if the FIP must be repacked.
+ */
+static int update_fip_in_place(const char *filename, uint64_t toc_flags,
+    unsigned long align)
+{
+	struct BLD_PLAT_STAT st;
+	image_desc_t *desc, *other;
+	fip_toc_header_t *toc_header;
+	fip_toc_entry_t *toc_entry;
+	size_t nr_images = 0, toc_size, i;
+	int fd, toc_dirty = 0;
+
+	fd = open(filename, O_RDWR);
+	if (fd == -1)
+		log_err("open %s", filename);
+	if (fstat(fd, &st) == -1)
+		log_err("fstat %s", filename);
+
+	/* Check that every new image fits in the slot of the old one. */
+	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
+		struct BLD_PLAT_STAT img_st;
+		uint64_t slot_end = st.st_size;
+
+		if (desc->image != NULL)
+			nr_images++;
+		if (desc->action != DO_PACK)
+			continue;
+		if (desc->image == NULL ||
+		    desc->image->toc_e.offset_address % align != 0)
+			goto repack;
+		if (stat(desc->action_arg, &img_st) == -1)
+			log_err("stat %s", desc->action_arg);
+		/* Empty images are dropped from the ToC. */
+		if (img_st.st_size == 0)
+			goto repack;
+
+		for (other = image_desc_head; other != NULL;
+		     other = other->next) {
+			uint64_t offset;
+
+			if (other->image == NULL || other->image->toc_e.size == 0)
+				continue;
+			offset = other->image->toc_e.offset_address;
+			if (offset > desc->image->toc_e.offset_address &&
+			    offset < slot_end)
+				slot_end = offset;
+		}
+		if (slot_end < desc->image->toc_e.offset_address ||
+		    (uint64_t)img_st.st_size >
+		    slot_end - desc->image->toc_e.offset_address)
+			goto repack;
+	}
+
+	toc_size = sizeof(*toc_header) + sizeof(*toc_entry) * (nr_images + 1);
+	if (toc_size > (size_t)st.st_size)
+		goto repack;
+	toc_header = xmalloc(toc_size, "failed to allocate ToC");
+	if (pread(fd, toc_header, toc_size, 0) != (ssize_t)toc_size)
+		log_errx("Failed to read %s", filename);
+	if (toc_header->name != TOC_HEADER_NAME)
+		log_errx("%s is not a FIP file", filename);
+	toc_entry = (fip_toc_entry_t *)(toc_header + 1);
+
+	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
+		image_t *image, *old = desc->image;
+
+		if (desc->action != DO_PACK)
+			continue;
+
+		image = read_image_from_file(&desc->uuid, desc->action_arg);
+		if (image->toc_e.size == old->toc_e.size &&
+		    memcmp(image->buffer, old->buffer, old->toc_e.size) == 0) {
+			if (verbose)
+				log_dbgx("Keeping %s, %s is unchanged",
+				    desc->cmdline_name, desc->action_arg);
+			free_image(image);
+			continue;
+		}
+
+		if (verbose)
+			log_dbgx("Patching %s with %s", desc->cmdline_name,
+			    desc->action_arg);
+		xpwrite(fd, image->buffer, image->toc_e.size,
+		    old->toc_e.offset_address, filename);
+		/* Clear what is left of the old image. */
+		if (image->toc_e.size < old->toc_e.size) {
+			size_t pad_size = old->toc_e.size - image->toc_e.size;
+			char *zeros = xzalloc(pad_size,
+			    "failed to allocate padding");
+
+			xpwrite(fd, zeros, pad_size, old->toc_e.offset_address +
+			    image->toc_e.size, filename);
+			free(zeros);
+		}
+
+		image->toc_e.offset_address = old->toc_e.offset_address;
+		image->toc_e.flags = old->toc_e.flags;
+		for (i = 0; i < nr_images; i++)
+			if (memcmp(&toc_entry[i].uuid, &desc->uuid,
+			    sizeof(uuid_t)) == 0)
+				toc_entry[i].size = image->toc_e.size;
+		free_image(old);
+		desc->image = image;
+		toc_dirty = 1;
+	}
+
+	if (toc_header->flags != toc_flags) {
+		toc_header->flags = toc_flags;
+		toc_dirty = 1;
+	}
+	if (toc_dirty)
+		xpwrite(fd, toc_header, toc_size, 0, filename);
+
+	free(toc_header);
+	close(fd);
+	return 0;
+
+repack:
+	close(fd);
+	return -1;
+}
+#endif
+
 static void parse_plat_toc_flags(const char *arg, unsigned long long *toc_flags)
 {
 	unsigned long long flags;
@@ -805,6 +1232,7 @@ static int update_cmd(int argc, char *argv[])
 	unsigned long long toc_flags = 0;
 	unsigned long align = 1;
 	int pflag = 0;
+	int in_place = 0;
 
 	if (argc < 2)
 		update_usage(EXIT_FAILURE);
@@ -812,6 +1240,7 @@ static int update_cmd(int argc, char *argv[])
 	opts = fill_common_opts(opts, &nr_opts, required_argument);
 	opts = add_opt(opts, &nr_opts, "align", required_argument, OPT_ALIGN);
 	opts = add_opt(opts, &nr_opts, "blob", required_argument, 'b');
+	opts = add_opt(opts, &nr_opts, "in-place", no_argument, OPT_IN_PLACE);
 	opts = add_opt(opts, &nr_opts, "out", required_argument, 'o');
 	opts = add_opt(opts, &nr_opts, "plat-toc-flags", required_argument,
 	    OPT_PLAT_TOC_FLAGS);
@@ -861,6 +1290,9 @@ static int update_cmd(int argc, char *argv[])
 		case OPT_ALIGN:
 			align = get_image_align(optarg);
 			break;
+		case OPT_IN_PLACE:
+			in_place = 1;
+			break;
 		case 'o':
 			snprintf(outfile, sizeof(outfile), "%s", optarg);
 			break;
@@ -885,6 +1317,17 @@ static int update_cmd(int argc, char *argv[])
 		toc_header.flags &= ~(0xffffULL << 32);
 	toc_flags = (toc_header.flags |= toc_flags);
 
+#ifndef _MSC_VER
+	if (in_place && toc_header.name == TOC_HEADER_NAME &&
+	    strcmp(outfile, argv[0]) == 0) {
+		if (update_fip_in_place(outfile, toc_flags, align) == 0)
+			return 0;
+		if (verbose)
+			log_dbgx("Images do not fit in place, repacking %s",
+			    outfile);
+	}
+#endif
+
 	update_fip();
 
 	pack_images(outfile, toc_flags, align);
@@ -900,6 +1343,7 @@ static void update_usage(int exit_status)
 	printf("Options:\n");
 	printf("  --align <value>\t\tEach image is aligned to <value> (default: 1).\n");
 	printf("  --blob uuid=...,file=...\tAdd or update an image with the given UUID pointed to by file.\n");
+	printf("  --in-place\t\t\tPatch changed images into the FIP file without repacking it, when they fit.\n");
 	printf("  --out FIP_FILENAME\t\tSet an alternative output FIP file.\n");
 	printf("  --plat-toc-flags <value>\t16-bit platform specific flag field occupying bits 32-47 in 64-bit ToC header.\n");
 	printf("\n");
@@ -1150,7 +1594,7 @@ static int remove_cmd(int argc, char *argv[])
 			if (verbose)
 				log_dbgx("Removing %s",
 				    desc->cmdline_name);
-			free(desc->image);
+			free_image(desc->image);
 			desc->image = NULL;
 		} else {
 			log_warnx("%s does not exist in %s",
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host version of the system register accessors and barriers used by
+ * gpt_rme.c. The registers are variables of the test, and the cache and TLB
+ * maintenance operations are counted so that the test can check when they
+ * are issued.
+ */
+
+#ifndef ARCH_HELPERS_H
+#define ARCH_HELPERS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint64_t u_register_t;
+
+extern u_register_t host_gpccr_el3;
+extern u_register_t host_gpccr_l0gptsz;
+extern u_register_t host_gptbr_el3;
+extern u_register_t host_sctlr_el3;
+extern unsigned long host_tlbi_count;
+extern unsigned long host_popa_flush_count;
+
+/* L0GPTSZ is read only, set by the implementation */
+static inline u_register_t read_gpccr_el3(void)
+{
+	return host_gpccr_el3 | host_gpccr_l0gptsz;
+}
+
+static inline void write_gpccr_el3(u_register_t v)
+{
+	host_gpccr_el3 = v;
+}
+
+static inline u_register_t read_gptbr_el3(void)
+{
+	return host_gptbr_el3;
+}
+
+static inline void write_gptbr_el3(u_register_t v)
+{
+	host_gptbr_el3 = v;
+}
+
+static inline u_register_t read_sctlr_el3(void)
+{
+	return host_sctlr_el3;
+}
+
+static inline void tlbipaallos(void)
+{
+	__atomic_fetch_add(&host_tlbi_count, 1UL, __ATOMIC_RELAXED);
+}
+
+static inline void gpt_tlbi_by_pa_ll(uint64_t pa, size_t size)
+{
+	__atomic_fetch_add(&host_tlbi_count, 1UL, __ATOMIC_RELAXED);
+}
+
+static inline void flush_dcache_range(uintptr_t addr, size_t size)
+{
+}
+
+static inline void flush_dcache_to_popa_range(uint64_t addr, size_t size)
+{
+	__atomic_fetch_add(&host_popa_flush_count, 1UL, __ATOMIC_RELAXED);
+}
+
+/*
+ * A sequentially consistent read-modify-write rather than a fence, which
+ * ThreadSanitizer does not model.
+ */
+static inline void dsb(void)
+{
+	static unsigned long barrier;
+
+	__atomic_fetch_add(&barrier, 0UL, __ATOMIC_SEQ_CST);
+}
+
+#define dsbsy()		dsb()
+#define dsbishst()	dsb()
+#define dsbosh()	dsb()
+#define dsboshst()	dsb()
+#define isb()		dsb()
+
+#endif /* ARCH_HELPERS_H */
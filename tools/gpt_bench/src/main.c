@@ -0,0 +1,522 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host test and benchmark of the granule transition service of the GPT
+ * library. The tables are built by the library in host memory for a 64GB
+ * protected space with 4KB granules and 1GB L0 regions. The check mode runs
+ * random delegate and undelegate requests, compares each result with a model
+ * of the GPI of every granule and reads the GPIs back from the tables. The
+ * benchmark mode times transitioning a range in one request against one
+ * request per granule, then transitions granules from several threads at
+ * once, in one L0 region and in an L0 region per thread, to measure the
+ * contention on the L1 table locks.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <arch_helpers.h>
+#include <lib/gpt_rme/gpt_rme.h>
+#include <lib/smccc.h>
+#include <lib/spinlock.h>
+#include <lib/xlat_tables/xlat_tables_v2.h>
+
+#define GRANULE_SHIFT		12U
+#define GRANULE_SIZE		(1UL << GRANULE_SHIFT)
+#define L0_SHIFT		30U
+#define L0_SIZE			(1UL << L0_SHIFT)
+#define PPS_SIZE		(64UL * L0_SIZE)
+
+/* The first 8GB are mapped by L1 tables, the rest by blocks */
+#define L0_REGIONS		8UL
+#define GRAN_END		(L0_REGIONS * L0_SIZE)
+#define GRANULES		(GRAN_END >> GRANULE_SHIFT)
+
+/* Each L1 table holds 16 GPIs per 64-bit descriptor */
+#define L1_TABLE_SIZE		(L0_SIZE >> (GRANULE_SHIFT + 4U) << 3U)
+
+/* GPIs read back around each transition */
+#define CHECK_MARGIN		(16UL * GRANULE_SIZE)
+
+/* Range of the benchmark, and each step is timed for at least MIN_TIME */
+#define BENCH_SIZE		(2UL * 1024UL * 1024UL)
+#define MIN_RUNS		3U
+#define MIN_TIME		0.5
+
+/* Threads of the contention benchmark and delegate/undelegate pairs of each */
+#define MAX_THREADS		L0_REGIONS
+#define CONTENTION_OPS		20000U
+
+u_register_t host_gpccr_el3;
+u_register_t host_gpccr_l0gptsz;
+u_register_t host_gptbr_el3;
+u_register_t host_sctlr_el3;
+unsigned long host_tlbi_count;
+unsigned long host_popa_flush_count;
+
+static uint64_t *l0_table;
+static uint8_t model[GRANULES];
+static unsigned long long step;
+
+static void fail(const char *msg)
+{
+	fprintf(stderr, "Step %llu: %s\n", step, msg);
+	exit(1);
+}
+
+void spin_lock(spinlock_t *lock)
+{
+	/* Let the holder run when there are fewer cores than threads */
+	while (__atomic_exchange_n(&lock->lock, 1U, __ATOMIC_ACQUIRE) != 0U) {
+		sched_yield();
+	}
+}
+
+void spin_unlock(spinlock_t *lock)
+{
+	__atomic_store_n(&lock->lock, 0U, __ATOMIC_RELEASE);
+}
+
+static void *alloc_aligned(size_t align, size_t size)
+{
+	void *p;
+
+	if (posix_memalign(&p, align, size) != 0) {
+		fprintf(stderr, "Cannot allocate memory\n");
+		exit(1);
+	}
+	memset(p, 0, size);
+
+	return p;
+}
+
+/* Build the tables as BL2 does, then pick them up as BL31 does */
+static void gpt_setup(void)
+{
+	pas_region_t pas[] = {
+		GPT_MAP_REGION_GRANULE(0UL, GRAN_END, GPT_GPI_NS),
+		GPT_MAP_REGION_BLOCK(GRAN_END, PPS_SIZE - GRAN_END, GPT_GPI_NS),
+	};
+	size_t l1_size = L0_REGIONS * L1_TABLE_SIZE;
+	uintptr_t l1;
+
+	host_sctlr_el3 = SCTLR_C_BIT;
+	host_gpccr_l0gptsz = (u_register_t)GPCCR_L0GPTSZ_30BITS <<
+			     GPCCR_L0GPTSZ_SHIFT;
+
+	l0_table = alloc_aligned(PAGE_SIZE_4KB, PAGE_SIZE_4KB);
+	l1 = (uintptr_t)alloc_aligned(L1_TABLE_SIZE, l1_size);
+
+	if ((gpt_init_l0_tables(GPCCR_PPS_64GB, (uintptr_t)l0_table,
+				PAGE_SIZE_4KB) != 0) ||
+	    (gpt_init_pas_l1_tables(GPCCR_PGS_4K, l1, l1_size, pas,
+				    ARRAY_SIZE(pas)) != 0) ||
+	    (gpt_enable() != 0) ||
+	    (gpt_runtime_init() != 0)) {
+		fail("cannot set up the GPT");
+	}
+
+	memset(model, GPT_GPI_NS, sizeof(model));
+}
+
+/* Read the GPI of a granule from the tables, without the library */
+static unsigned int read_gpi(uint64_t pa)
+{
+	uint64_t l0 = l0_table[pa >> L0_SHIFT];
+	const uint64_t *l1;
+
+	if ((l0 & 0xFUL) != 0x3UL) {
+		fail("granule not mapped by an L1 table");
+	}
+
+	l1 = (const uint64_t *)(uintptr_t)(l0 & 0x000FFFFFFFFFF000UL);
+
+	return (l1[(pa & (L0_SIZE - 1UL)) >> (GRANULE_SHIFT + 4U)] >>
+		(((pa >> GRANULE_SHIFT) & 0xFUL) << 2)) & 0xFUL;
+}
+
+static void check_tables(uint64_t start, uint64_t end)
+{
+	uint64_t pa;
+
+	for (pa = start; pa < end; pa += GRANULE_SIZE) {
+		if (read_gpi(pa) != model[pa >> GRANULE_SHIFT]) {
+			fprintf(stderr, "Granule 0x%lx: GPI 0x%x, expected 0x%x\n",
+				pa, read_gpi(pa), model[pa >> GRANULE_SHIFT]);
+			fail("GPT does not match the model");
+		}
+	}
+}
+
+/*
+ * Work out the result of a request from the model, as the GPT library
+ * specifies it: the first L1 table of a valid range is transitioned as a
+ * whole if all its granules have the source GPI.
+ */
+static int expect(uint64_t base, size_t size, unsigned int src_gpi,
+		  size_t *transitioned)
+{
+	uint64_t pa;
+
+	*transitioned = 0UL;
+	if ((size == 0UL) || ((ULONG_MAX - base) < size) ||
+	    ((base & (GRANULE_SIZE - 1UL)) != 0UL) ||
+	    ((size & (GRANULE_SIZE - 1UL)) != 0UL) ||
+	    ((base + size) >= PPS_SIZE)) {
+		return -EINVAL;
+	}
+
+	if ((L0_SIZE - (base & (L0_SIZE - 1UL))) < size) {
+		size = L0_SIZE - (base & (L0_SIZE - 1UL));
+	}
+	if (base >= GRAN_END) {
+		return -EINVAL;
+	}
+
+	for (pa = base; pa < (base + size); pa += GRANULE_SIZE) {
+		if (model[pa >> GRANULE_SHIFT] != src_gpi) {
+			return -EPERM;
+		}
+	}
+
+	*transitioned = size;
+	return 0;
+}
+
+/*
+ * Run one request, check its result and the tables around it, and return the
+ * size transitioned.
+ */
+static size_t transition(uint64_t base, size_t size, unsigned int sec_state,
+		       bool delegate)
+{
+	unsigned int owner = (sec_state == SMC_FROM_REALM) ? GPT_GPI_REALM :
+							     GPT_GPI_SECURE;
+	unsigned long tlbi = host_tlbi_count;
+	unsigned long popa = host_popa_flush_count;
+	size_t done = 1UL, expected_done;
+	uint64_t pa, start, end;
+	int ret, expected;
+
+	expected = expect(base, size, delegate ? GPT_GPI_NS : owner,
+			  &expected_done);
+	if (delegate) {
+		ret = gpt_delegate_pas(base, size, sec_state, &done);
+	} else {
+		ret = gpt_undelegate_pas(base, size, sec_state, &done);
+	}
+
+	if ((ret != expected) || (done != expected_done)) {
+		fprintf(stderr, "%s 0x%lx+0x%zx: %d, 0x%zx transitioned, "
+			"expected %d, 0x%zx\n",
+			delegate ? "Delegate" : "Undelegate", base, size, ret,
+			done, expected, expected_done);
+		fail("unexpected transition result");
+	}
+
+	if (ret != 0) {
+		if ((host_tlbi_count != tlbi) ||
+		    (host_popa_flush_count != popa)) {
+			fail("maintenance issued for a failed request");
+		}
+		return 0UL;
+	}
+
+	if ((host_tlbi_count == tlbi) || (host_popa_flush_count == popa)) {
+		fail("no maintenance for a transition");
+	}
+
+	for (pa = base; pa < (base + done); pa += GRANULE_SIZE) {
+		model[pa >> GRANULE_SHIFT] = delegate ? owner : GPT_GPI_NS;
+	}
+
+	start = (base > CHECK_MARGIN) ? (base - CHECK_MARGIN) : 0UL;
+	end = base + done + CHECK_MARGIN;
+	check_tables(start, (end < GRAN_END) ? end : GRAN_END);
+
+	return done;
+}
+
+/* Mostly small ranges, some large ones, some ending past an L1 table */
+static void random_range(uint64_t *base, size_t *size)
+{
+	uint64_t granules = 1UL + (uint64_t)rand() %
+			    (((rand() % 8) == 0) ? 65536UL : 64UL);
+
+	if ((rand() % 4) == 0) {
+		*base = (1UL + (uint64_t)rand() % L0_REGIONS) * L0_SIZE -
+			(1UL + (uint64_t)rand() % 64UL) * GRANULE_SIZE;
+	} else {
+		*base = ((uint64_t)rand() % GRANULES) << GRANULE_SHIFT;
+	}
+	*size = granules << GRANULE_SHIFT;
+}
+
+/* Shrink a range to the granules with the GPI of its first one */
+static void same_gpi(uint64_t base, size_t *size)
+{
+	uint64_t pa;
+
+	for (pa = base; (pa < (base + *size)) && (pa < GRAN_END);
+	     pa += GRANULE_SIZE) {
+		if (model[pa >> GRANULE_SHIFT] != model[base >> GRANULE_SHIFT]) {
+			break;
+		}
+	}
+	*size = pa - base;
+}
+
+static void op_random(void)
+{
+	unsigned int sec_state = ((rand() % 2) == 0) ? SMC_FROM_REALM :
+						       SMC_FROM_SECURE;
+	bool delegate = ((rand() % 8) != 0);
+	uint64_t base;
+	size_t size, done;
+
+	random_range(&base, &size);
+
+	switch (rand() % 16) {
+	case 0:
+		size = 0UL;
+		break;
+	case 1:
+		base += GRANULE_SIZE / 2UL;
+		break;
+	case 2:
+		size -= GRANULE_SIZE / 2UL;
+		break;
+	case 3:
+		base = GRAN_END + ((uint64_t)rand() % GRANULES) *
+		       GRANULE_SIZE / 4UL;
+		break;
+	case 4:
+		base = PPS_SIZE - size;
+		break;
+	case 5:
+		base = ULONG_MAX & ~(GRANULE_SIZE - 1UL);
+		break;
+	default:
+		/*
+		 * A range the request applies to, continued as the RMM does
+		 * until all of it is transitioned.
+		 */
+		same_gpi(base, &size);
+		if (model[base >> GRANULE_SHIFT] == GPT_GPI_REALM) {
+			sec_state = SMC_FROM_REALM;
+		} else if (model[base >> GRANULE_SHIFT] == GPT_GPI_SECURE) {
+			sec_state = SMC_FROM_SECURE;
+		}
+		delegate = (model[base >> GRANULE_SHIFT] == GPT_GPI_NS);
+
+		do {
+			done = transition(base, size, sec_state, delegate);
+			if (done == 0UL) {
+				fail("valid range not transitioned");
+			}
+			base += done;
+			size -= done;
+		} while (size != 0UL);
+		return;
+	}
+
+	(void)transition(base, size, sec_state, delegate);
+}
+
+static int check(unsigned long long ops)
+{
+	srand(1U);
+	gpt_setup();
+	check_tables(0UL, GRAN_END);
+
+	for (step = 0U; step < ops; step++) {
+		op_random();
+
+		if ((step % 1000U) == 999U) {
+			check_tables(0UL, GRAN_END);
+		}
+	}
+	check_tables(0UL, GRAN_END);
+
+	printf("Checked %llu transitions successfully\n", ops);
+
+	return 0;
+}
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Time an expression, returning the best time of a run in seconds */
+#define BENCH(best, expr)						\
+	do {								\
+		double _start, _t, _total = 0.0;			\
+		unsigned int _runs = 0U;				\
+									\
+		while ((_runs < MIN_RUNS) || (_total < MIN_TIME)) {	\
+			_start = now();					\
+			expr;						\
+			_t = now() - _start;				\
+			if ((_runs == 0U) || (_t < (best))) {		\
+				(best) = _t;				\
+			}						\
+			_total += _t;					\
+			_runs++;					\
+		}							\
+	} while (false)
+
+/* Delegate and undelegate BENCH_SIZE bytes, @chunk bytes per request */
+static void round_trip(size_t chunk)
+{
+	size_t done;
+	uint64_t pa;
+
+	for (pa = 0UL; pa < BENCH_SIZE; pa += done) {
+		if (gpt_delegate_pas(pa, chunk, SMC_FROM_REALM, &done) != 0) {
+			fail("benchmark delegate failed");
+		}
+	}
+	for (pa = 0UL; pa < BENCH_SIZE; pa += done) {
+		if (gpt_undelegate_pas(pa, chunk, SMC_FROM_REALM, &done) != 0) {
+			fail("benchmark undelegate failed");
+		}
+	}
+}
+
+struct contender {
+	pthread_t thread;
+	pthread_barrier_t *start;
+	uint64_t base;
+};
+
+/* Delegate and undelegate one granule CONTENTION_OPS times */
+static void *contender_thread(void *arg)
+{
+	struct contender *c = arg;
+	size_t done;
+	unsigned int i;
+
+	pthread_barrier_wait(c->start);
+
+	for (i = 0U; i < CONTENTION_OPS; i++) {
+		if ((gpt_delegate_pas(c->base, GRANULE_SIZE, SMC_FROM_REALM,
+				      &done) != 0) ||
+		    (gpt_undelegate_pas(c->base, GRANULE_SIZE, SMC_FROM_REALM,
+					&done) != 0)) {
+			fail("contended transition failed");
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * Run @threads contenders, on granules in the same L0 region or in one L0
+ * region each, and return the delegate/undelegate pairs done per second.
+ */
+static double contention(unsigned int threads, bool same_region)
+{
+	struct contender c[MAX_THREADS];
+	pthread_barrier_t start;
+	double t;
+	unsigned int i;
+
+	pthread_barrier_init(&start, NULL, threads + 1U);
+
+	for (i = 0U; i < threads; i++) {
+		c[i].start = &start;
+		/* Adjacent granules share an L1 descriptor */
+		c[i].base = same_region ? (i * GRANULE_SIZE) :
+					  (i * L0_SIZE);
+		if (pthread_create(&c[i].thread, NULL, contender_thread,
+				   &c[i]) != 0) {
+			fail("cannot create a thread");
+		}
+	}
+
+	pthread_barrier_wait(&start);
+	t = now();
+	for (i = 0U; i < threads; i++) {
+		pthread_join(c[i].thread, NULL);
+	}
+	t = now() - t;
+
+	pthread_barrier_destroy(&start);
+
+	/* Every granule is back to non-secure, and no other GPI changed */
+	check_tables(0UL, GRAN_END);
+
+	return (threads * CONTENTION_OPS) / t;
+}
+
+static int bench(void)
+{
+	double t_granule = 0.0, t_range = 0.0;
+	unsigned long tlbi;
+	unsigned int threads;
+
+	gpt_setup();
+
+	BENCH(t_granule, round_trip(GRANULE_SIZE));
+	BENCH(t_range, round_trip(BENCH_SIZE));
+
+	tlbi = host_tlbi_count;
+	round_trip(GRANULE_SIZE);
+	tlbi = host_tlbi_count - tlbi;
+
+	printf("Delegate and undelegate %lu KB, without the cost of the "
+	       "cache and TLB\nmaintenance of the host\n", BENCH_SIZE / 1024UL);
+	printf("%-32s %12.1f %8lu TLBIs\n", "one granule per call, us",
+	       t_granule * 1e6, tlbi);
+	tlbi = host_tlbi_count;
+	round_trip(BENCH_SIZE);
+	printf("%-32s %12.1f %8lu TLBIs\n", "one range per call, us",
+	       t_range * 1e6, host_tlbi_count - tlbi);
+
+	printf("\nDelegate/undelegate pairs of one granule per second, in total, "
+	       "from several\nthreads with granules in the same L0 region and "
+	       "in an L0 region per thread\n");
+	printf("%-8s %16s %16s\n", "threads", "same region", "own region");
+	for (threads = 1U; threads <= MAX_THREADS; threads *= 2U) {
+		printf("%-8u %16.0f %16.0f\n", threads,
+		       contention(threads, true), contention(threads, false));
+	}
+
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	if ((argc > 3) || ((argc >= 2) && (strcmp(argv[1], "-c") != 0))) {
+		printf("Usage: %s [-c [ops]]\n\n"
+		       "Time granule transitions of the GPT library, and "
+		       "their contention\nfrom several threads.\n\n"
+		       "  -c  Check random transitions against a model "
+		       "instead\n",
+		       argv[0]);
+		return 1;
+	}
+
+	if (argc >= 2) {
+		return check((argc == 3) ? strtoull(argv[2], NULL, 0) : 20000U);
+	}
+
+	return bench();
+}
@@ -0,0 +1,68 @@
+#
+# Copyright 2026 NXP
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+
+# Common part of the host tools that build firmware sources to test and
+# benchmark them (tools/*_bench). The including Makefile includes the build
+# helpers, sets ROOT, PROJECTS and its own targets; firmware sources under ROOT
+# are built to obj/.
+#
+# Headers are looked up in the tool's include directory, then in the host
+# stubs shared by all the tools, then in the firmware tree, so that the
+# firmware headers the sources need are replaced by host versions.
+
+HOST_STUBS_DIR := ${ROOT}/tools/host_stubs
+HOST_TOOL_MAKEFILES := Makefile ${HOST_STUBS_DIR}/host_tool.mk
+
+V ?= 0
+
+HOSTCC ?= gcc
+
+override CPPFLAGS += -D_POSIX_C_SOURCE=200809L -DENABLE_ASSERTIONS=1
+HOSTCCFLAGS := -Wall -std=gnu99 -O2
+
+# SANITIZE=<sanitizer> builds the tool with it, e.g. SANITIZE=thread.
+SANITIZE ?=
+ifneq (${SANITIZE},)
+  HOSTCCFLAGS += -g -fsanitize=${SANITIZE}
+  LDFLAGS += -fsanitize=${SANITIZE}
+endif
+
+INCLUDE_PATHS := -I./include -I${HOST_STUBS_DIR}/include -I${ROOT}/include
+
+ifeq (${V},0)
+  Q := @
+else
+  Q :=
+endif
+
+.PHONY: all bench check clean distclean
+
+all: ${PROJECTS}
+
+# Link the objects among the prerequisites
+define HOST_LINK
+	@echo "  HOSTLD  $@"
+	${Q}${HOSTCC} ${LDFLAGS} $(filter %.o,$^) -o $@ ${LDLIBS}
+	@${ECHO_BLANK_LINE}
+	@echo "Built $@ successfully"
+	@${ECHO_BLANK_LINE}
+endef
+
+src/%.o: src/%.c ${HOST_TOOL_MAKEFILES}
+	@echo "  HOSTCC  $<"
+	${Q}${HOSTCC} -c ${CPPFLAGS} ${HOSTCCFLAGS} ${INCLUDE_PATHS} $< -o $@
+
+obj/%.o: ${ROOT}/%.c ${HOST_TOOL_MAKEFILES}
+	@echo "  HOSTCC  $<"
+	${Q}mkdir -p $(dir $@)
+	${Q}${HOSTCC} -c ${CPPFLAGS} ${HOSTCCFLAGS} ${INCLUDE_PATHS} $< -o $@
+
+clean:
+	$(call SHELL_DELETE_ALL, src/*.o)
+	$(call SHELL_REMOVE_DIR,obj)
+
+distclean: clean
+	$(call SHELL_DELETE_ALL, ${PROJECTS})
@@ -0,0 +1,43 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host replacement of the feature checks used by armv8_crypto.c. User space
+ * gets them from the hardware capabilities given by Linux rather than from
+ * the ID registers.
+ */
+
+#ifndef ARCH_FEATURES_H
+#define ARCH_FEATURES_H
+
+#include <stdbool.h>
+
+#if defined(__aarch64__) && defined(__linux__)
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+
+static inline bool is_feat_aes_present(void)
+{
+	return (getauxval(AT_HWCAP) & HWCAP_AES) != 0UL;
+}
+
+static inline bool is_feat_sha256_present(void)
+{
+	return (getauxval(AT_HWCAP) & HWCAP_SHA2) != 0UL;
+}
+#else
+static inline bool is_feat_aes_present(void)
+{
+	return false;
+}
+
+static inline bool is_feat_sha256_present(void)
+{
+	return false;
+}
+#endif
+
+#endif /* ARCH_FEATURES_H */
@@ -0,0 +1,64 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host replacement of the firmware logging macros. LOG_LEVEL selects the
+ * messages printed as in the firmware, and defaults to warnings.
+ */
+
+#ifndef DEBUG_H
+#define DEBUG_H
+
+#include <cdefs.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <lib/utils_def.h>
+
+#define LOG_LEVEL_NONE			0
+#define LOG_LEVEL_ERROR			10
+#define LOG_LEVEL_NOTICE		20
+#define LOG_LEVEL_WARNING		30
+#define LOG_LEVEL_INFO			40
+#define LOG_LEVEL_VERBOSE		50
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL			LOG_LEVEL_WARNING
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define ERROR(...)	fprintf(stderr, "ERROR:   " __VA_ARGS__)
+#else
+#define ERROR(...)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_NOTICE
+#define NOTICE(...)	printf(__VA_ARGS__)
+#else
+#define NOTICE(...)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARNING
+#define WARN(...)	fprintf(stderr, "WARNING: " __VA_ARGS__)
+#else
+#define WARN(...)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define INFO(...)	printf("INFO:    " __VA_ARGS__)
+#else
+#define INFO(...)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_VERBOSE
+#define VERBOSE(...)	printf("VERBOSE: " __VA_ARGS__)
+#else
+#define VERBOSE(...)
+#endif
+
+#define panic()		abort()
+
+#endif /* DEBUG_H */
@@ -0,0 +1,18 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* Host replacement of the firmware memory helpers */
+
+#ifndef UTILS_H
+#define UTILS_H
+
+#include <string.h>
+
+#include <lib/utils_def.h>
+
+#define zeromem(mem, len)	memset((mem), 0, (len))
+
+#endif /* UTILS_H */
@@ -0,0 +1,30 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host stub: the firmware libraries built by the host tools map nothing
+ * themselves. They only need the page sizes, the granule check and the libc
+ * headers pulled in by the real header.
+ */
+
+#ifndef XLAT_TABLES_V2_H
+#define XLAT_TABLES_V2_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <lib/utils_def.h>
+
+#define PAGE_SIZE_4KB		(U(1) << 12)
+#define PAGE_SIZE		PAGE_SIZE_4KB
+
+static inline bool xlat_arch_is_granule_size_supported(size_t size)
+{
+	return true;
+}
+
+#endif /* XLAT_TABLES_V2_H */
@@ -0,0 +1,39 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host version of the barriers and generic timer accessors used by the SCMI
+ * driver. The System Manager stub is a thread sharing the mailbox memory, so
+ * the barriers are full fences. The counter is the monotonic clock, in
+ * nanoseconds.
+ */
+
+#ifndef ARCH_HELPERS_H
+#define ARCH_HELPERS_H
+
+#include <stdint.h>
+#include <time.h>
+
+#define dmbsy()		__atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define dmbst()		__atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define dmbld()		__atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define dsb()		__atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+static inline uint64_t read_cntpct_el0(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+static inline uint64_t read_cntfrq_el0(void)
+{
+	return 1000000000U;
+}
+
+#endif /* ARCH_HELPERS_H */
@@ -0,0 +1,14 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* Host stub: the i.MX95 core count, for the bakery lock header */
+
+#ifndef PLATFORM_DEF_H
+#define PLATFORM_DEF_H
+
+#define PLATFORM_CORE_COUNT		6
+
+#endif /* PLATFORM_DEF_H */
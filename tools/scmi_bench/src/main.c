@@ -0,0 +1,731 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host test and benchmark of the SCMI driver, with the i.MX95 vendor
+ * commands, against a stub of the System Manager. The stub is a thread that
+ * takes the doorbell rung by the driver, holds the channel for a given
+ * latency, applies the command to its per-core state and hands the channel
+ * back with the response, as the SM does over the MU and the shared memory.
+ *
+ * The check mode posts commands and checks that they are still in flight
+ * when the call returns, that the next owner of the channel or
+ * scmi_channel_wait() waits for them, and that the status of a failed posted
+ * command is reported once. The stub checks that the mailbox is never
+ * written while it owns the channel. Several threads, one per core, then run
+ * the CPU_ON and CPU_OFF sequences of imx95_psci.c at once.
+ *
+ * The benchmark mode times the CPU_OFF sequence with the sleep mode request
+ * waited for at once, and posted then waited for after the given amount of
+ * PSCI work.
+ */
+
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <arch_helpers.h>
+#include <drivers/arm/css/scmi.h>
+#include <lib/spinlock.h>
+#include <platform_def.h>
+
+#include "scmi_imx9.h"
+#include "scmi_private.h"
+
+#define SM_CORES		PLATFORM_CORE_COUNT
+#define SM_PERF_DOMAINS		8U
+
+/* Wake masks of IMX9_SCMI_CORE_SETIRQWAKESET_MSG */
+#define SM_IRQ_MASKS		((IMX9_SCMI_CORE_SETIRQWAKESET_MSG_LEN - 16U) / 4U)
+
+/* Versions reported by the stub */
+#define SM_CORE_PROTO_VER	MAKE_SCMI_VERSION(1, 0)
+
+/* Mailbox of the channel, as the SCMI payload area of the SM */
+#define SM_MBX_SIZE		128U
+
+/* Commands remembered by the stub, latest first */
+#define SM_LOG_SIZE		4U
+
+/* Check mode parameters */
+#define CHECK_LATENCY_NS	2000000U
+#define CHECK_THREADS		SM_CORES
+#define CHECK_OPS		2000U
+
+/* CPU_OFF sequences per benchmark run */
+#define BENCH_ROUNDS		2000U
+
+#define SM_CMD(proto, msg)	(((uint32_t)(proto) << 8) | (uint32_t)(msg))
+
+/* Per-core state, as applied by the SM */
+struct sm_core {
+	bool running;
+	uint32_t wakeup;
+	uint32_t sleep_mode;
+	uint32_t lpm_pd;
+	uint32_t lpm_setting;
+	uint32_t irq_mask[SM_IRQ_MASKS];
+};
+
+static struct {
+	pthread_t thread;
+	pthread_mutex_t lock;
+	pthread_cond_t doorbell;
+	bool rung;
+	bool stop;
+	uint64_t rung_at;
+
+	/* Time the SM holds the channel: latency_ns plus up to jitter_ns */
+	uint64_t latency_ns;
+	uint64_t jitter_ns;
+
+	struct sm_core core[SM_CORES];
+	uint32_t perf[SM_PERF_DOMAINS];
+	uint32_t log[SM_LOG_SIZE];
+	unsigned long cmds;
+} sm;
+
+static uint32_t mbx[SM_MBX_SIZE / 4U] __aligned(8);
+static uint32_t mu_gcr;
+static spinlock_t scmi_lock;
+static scmi_channel_t channel;
+static void *handle;
+
+static int failed;
+
+static void fail(const char *what, const char *fmt, ...)
+	__attribute__((format(printf, 2, 3)));
+
+static void fail(const char *what, const char *fmt, ...)
+{
+	va_list ap;
+
+	fprintf(stderr, "%s: ", what);
+	va_start(ap, fmt);
+	vfprintf(stderr, fmt, ap);
+	va_end(ap);
+	fprintf(stderr, "\n");
+	__atomic_add_fetch(&failed, 1, __ATOMIC_RELAXED);
+}
+
+void spin_lock(spinlock_t *lock)
+{
+	while (__atomic_exchange_n(&lock->lock, 1U, __ATOMIC_ACQUIRE) != 0U) {
+		sched_yield();
+	}
+}
+
+void spin_unlock(spinlock_t *lock)
+{
+	__atomic_store_n(&lock->lock, 0U, __ATOMIC_RELEASE);
+}
+
+static uint64_t now_ns(void)
+{
+	return read_cntpct_el0();
+}
+
+/*
+ * System Manager stub
+ */
+static mailbox_mem_t *sm_mbx(void)
+{
+	return (mailbox_mem_t *)mbx;
+}
+
+/* The MU doorbell of scmi_client.c, waking the stub up */
+static void sm_ring_doorbell(struct scmi_channel_plat_info *plat_info)
+{
+	uint32_t db = mmio_read_32(plat_info->db_reg_addr) &
+		      plat_info->db_preserve_mask;
+
+	mmio_write_32(plat_info->db_reg_addr, db | plat_info->db_modify_mask);
+
+	pthread_mutex_lock(&sm.lock);
+	if (sm.rung) {
+		fail("SM", "doorbell rung while the SM owns the channel");
+	}
+	sm.rung = true;
+	sm.rung_at = now_ns();
+	pthread_cond_signal(&sm.doorbell);
+	pthread_mutex_unlock(&sm.lock);
+}
+
+static scmi_channel_plat_info_t sm_plat_info = {
+	.scmi_mbx_mem = (uintptr_t)mbx,
+	.db_reg_addr = (uintptr_t)&mu_gcr,
+	.db_preserve_mask = 0xfffffffe,
+	.db_modify_mask = 0x1,
+	.ring_doorbell = &sm_ring_doorbell,
+};
+
+static int32_t sm_core_cmd(uint32_t msg, uint32_t len, const uint32_t *arg)
+{
+	struct sm_core *core;
+	uint32_t i;
+
+	if ((len < 8U) || (arg[0] >= SM_CORES)) {
+		return SCMI_E_INVALID_PARAM;
+	}
+	core = &sm.core[arg[0]];
+
+	switch (msg) {
+	case IMX9_SCMI_CORE_START_MSG:
+	case IMX9_SCMI_CORE_STOP_MSG:
+		if (len != IMX9_SCMI_CORE_START_MSG_LEN) {
+			return SCMI_E_INVALID_PARAM;
+		}
+		core->running = (msg == IMX9_SCMI_CORE_START_MSG);
+		return SCMI_E_SUCCESS;
+	case IMX9_SCMI_CORE_SETSLEEPMODE_MSG:
+		if (len != IMX9_SCMI_CORE_SETSLEEPMODE_MSG_LEN) {
+			return SCMI_E_INVALID_PARAM;
+		}
+		core->wakeup = arg[1];
+		core->sleep_mode = arg[2];
+		return SCMI_E_SUCCESS;
+	case IMX9_SCMI_CORE_SETIRQWAKESET_MSG:
+		if ((len != IMX9_SCMI_CORE_SETIRQWAKESET_MSG_LEN) ||
+		    ((arg[1] + arg[2]) > SM_IRQ_MASKS)) {
+			return SCMI_E_INVALID_PARAM;
+		}
+		for (i = 0U; i < arg[2]; i++) {
+			core->irq_mask[arg[1] + i] = arg[3U + i];
+		}
+		return SCMI_E_SUCCESS;
+	case IMX9_SCMI_CORE_LPMMODESET_MSG:
+		if ((arg[1] == 0U) ||
+		    (len != (IMX9_SCMI_CORE_LPMMODESET_MSG_LEN +
+			     (arg[1] * sizeof(struct scmi_lpm_config))))) {
+			return SCMI_E_INVALID_PARAM;
+		}
+		/* The setting of the last configuration is kept */
+		core->lpm_pd = arg[2U + ((arg[1] - 1U) * 3U)];
+		core->lpm_setting = arg[3U + ((arg[1] - 1U) * 3U)];
+		return SCMI_E_SUCCESS;
+	default:
+		return SCMI_E_NOT_SUPPORTED;
+	}
+}
+
+/* Run the command of the mailbox and write the response over it */
+static void sm_serve(mailbox_mem_t *mbx_mem)
+{
+	uint32_t proto = (mbx_mem->msg_header >> SCMI_MSG_PROTO_ID_SHIFT) &
+			 SCMI_MSG_PROTO_ID_MASK;
+	uint32_t msg = (mbx_mem->msg_header >> SCMI_MSG_ID_SHIFT) &
+		       SCMI_MSG_ID_MASK;
+	uint32_t *payload = mbx_mem->payload;
+	uint32_t len = mbx_mem->len;
+	uint32_t resp_len = 8U;
+	int32_t status;
+
+	memmove(&sm.log[1], &sm.log[0], sizeof(sm.log) - sizeof(sm.log[0]));
+	sm.log[0] = SM_CMD(proto, msg);
+	sm.cmds++;
+
+	if (msg == SCMI_PROTO_VERSION_MSG) {
+		status = SCMI_E_SUCCESS;
+		resp_len = SCMI_PROTO_VERSION_RESP_LEN;
+		switch (proto) {
+		case SCMI_PWR_DMN_PROTO_ID:
+			payload[1] = SCMI_PWR_DMN_PROTO_VER;
+			break;
+		case SCMI_SYS_PWR_PROTO_ID:
+			payload[1] = SCMI_SYS_PWR_PROTO_VER;
+			break;
+		case IMX9_SCMI_CORE_PROTO_ID:
+			payload[1] = SM_CORE_PROTO_VER;
+			break;
+		default:
+			status = SCMI_E_NOT_SUPPORTED;
+			resp_len = 8U;
+			break;
+		}
+	} else if (proto == IMX9_SCMI_CORE_PROTO_ID) {
+		status = sm_core_cmd(msg, len, payload);
+	} else if ((proto == IMX9_SCMI_PERF_PROTO_ID) &&
+		   (msg == IMX9_SCMI_CORE_PERFLEVELSET_MSG)) {
+		if ((len == IMX9_SCMI_CORE_PERFLEVELSET_MSG_LEN) &&
+		    (payload[0] < SM_PERF_DOMAINS)) {
+			sm.perf[payload[0]] = payload[1];
+			status = SCMI_E_SUCCESS;
+		} else {
+			status = SCMI_E_INVALID_PARAM;
+		}
+	} else {
+		status = SCMI_E_NOT_SUPPORTED;
+	}
+
+	payload[0] = (uint32_t)status;
+	mbx_mem->len = resp_len;
+}
+
+static void *sm_thread(void *arg)
+{
+	mailbox_mem_t *mbx_mem = sm_mbx();
+	uint32_t req[SM_MBX_SIZE / 4U];
+	struct timespec ts;
+	uint64_t done_at;
+
+	for (;;) {
+		pthread_mutex_lock(&sm.lock);
+		while (!sm.rung && !sm.stop) {
+			pthread_cond_wait(&sm.doorbell, &sm.lock);
+		}
+		if (!sm.rung) {
+			pthread_mutex_unlock(&sm.lock);
+			return NULL;
+		}
+		done_at = sm.rung_at + sm.latency_ns;
+		if (sm.jitter_ns != 0U) {
+			done_at += (uint64_t)rand() % sm.jitter_ns;
+		}
+		pthread_mutex_unlock(&sm.lock);
+
+		if (SCMI_IS_CHANNEL_FREE(mbx_mem->status)) {
+			fail("SM", "doorbell rung with the channel free");
+		}
+
+		/* Hold the channel, as the SM takes time to run the command */
+		memcpy(req, mbx, sizeof(req));
+		ts.tv_sec = (time_t)(done_at / 1000000000U);
+		ts.tv_nsec = (long)(done_at % 1000000000U);
+		clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+
+		if (memcmp(req, mbx, sizeof(req)) != 0) {
+			fail("SM", "mailbox written while the SM owns the "
+			     "channel");
+		}
+
+		sm_serve(mbx_mem);
+
+		pthread_mutex_lock(&sm.lock);
+		sm.rung = false;
+		mu_gcr &= ~sm_plat_info.db_modify_mask;
+		pthread_mutex_unlock(&sm.lock);
+
+		/* Hand the channel back with the response */
+		__atomic_store_n(&mbx_mem->status, 1U, __ATOMIC_RELEASE);
+	}
+}
+
+static void sm_start(uint64_t latency_ns, uint64_t jitter_ns)
+{
+	pthread_mutex_init(&sm.lock, NULL);
+	pthread_cond_init(&sm.doorbell, NULL);
+	sm.latency_ns = latency_ns;
+	sm.jitter_ns = jitter_ns;
+	sm_mbx()->status = 1U;
+
+	if (pthread_create(&sm.thread, NULL, sm_thread, NULL) != 0) {
+		fprintf(stderr, "Cannot create the SM thread\n");
+		exit(1);
+	}
+
+	/* As plat_imx95_setup() */
+	channel.info = &sm_plat_info;
+	channel.lock = &scmi_lock;
+	handle = scmi_init(&channel);
+	if (handle == NULL) {
+		fprintf(stderr, "SCMI initialization failed\n");
+		exit(1);
+	}
+}
+
+static void sm_stop(void)
+{
+	pthread_mutex_lock(&sm.lock);
+	sm.stop = true;
+	pthread_cond_signal(&sm.doorbell);
+	pthread_mutex_unlock(&sm.lock);
+	pthread_join(sm.thread, NULL);
+}
+
+static void sm_set_latency(uint64_t latency_ns, uint64_t jitter_ns)
+{
+	pthread_mutex_lock(&sm.lock);
+	sm.latency_ns = latency_ns;
+	sm.jitter_ns = jitter_ns;
+	pthread_mutex_unlock(&sm.lock);
+}
+
+/* State of the stub, once the commands in flight are done */
+static struct sm_core sm_core_state(uint32_t cpu)
+{
+	struct sm_core core;
+
+	pthread_mutex_lock(&sm.lock);
+	core = sm.core[cpu];
+	pthread_mutex_unlock(&sm.lock);
+
+	return core;
+}
+
+/*
+ * PSCI sequences of imx95_psci.c, with the posted commands
+ */
+static void psci_cpu_on(uint32_t cpu, uint32_t lpm)
+{
+	struct scmi_lpm_config cfg = { cpu, lpm, 0U };
+	int ret;
+
+	ret = scmi_core_start(handle, cpu);
+	if (ret != SCMI_E_SUCCESS) {
+		fail("CPU_ON", "core %u start returned %d", cpu, ret);
+	}
+
+	if (scmi_core_lpm_mode_set_posted(handle, cpu, 1U, &cfg) !=
+	    SCMI_E_SUCCESS) {
+		fail("CPU_ON", "core %u LPM setting not posted", cpu);
+	}
+}
+
+static void psci_cpu_off(uint32_t cpu, uint32_t *mask, bool posted)
+{
+	int ret;
+
+	ret = scmi_core_Irq_wake_set(handle, cpu, 0U, SM_IRQ_MASKS, mask);
+	if (ret != SCMI_E_SUCCESS) {
+		fail("CPU_OFF", "core %u wake masks returned %d", cpu, ret);
+	}
+
+	if (posted) {
+		ret = scmi_core_set_sleep_mode_posted(handle, cpu,
+						      SCMI_GPC_WAKEUP,
+						      SCMI_CPU_SLEEP_SUSPEND);
+	} else {
+		ret = scmi_core_set_sleep_mode(handle, cpu, SCMI_GPC_WAKEUP,
+					       SCMI_CPU_SLEEP_SUSPEND);
+	}
+
+	if (ret != SCMI_E_SUCCESS) {
+		fail("CPU_OFF", "core %u sleep mode returned %d", cpu, ret);
+	}
+}
+
+/* As imx_pwr_domain_pwr_down_wfi() */
+static void psci_pwr_down_wfi(uint32_t cpu)
+{
+	int ret = scmi_channel_wait(handle);
+
+	if (ret != SCMI_E_SUCCESS) {
+		fail("CPU_OFF", "core %u posted command returned %d", cpu, ret);
+	}
+}
+
+/*
+ * Check mode
+ */
+
+/* A posted command is in flight until the next owner or a wait */
+static void check_posted(void)
+{
+	struct scmi_lpm_config cfg = { 1U, SCMI_CPU_PD_LPM_ON_RUN_WAIT, 0U };
+	uint64_t start, elapsed;
+	struct sm_core core;
+	int ret;
+
+	start = now_ns();
+	ret = scmi_core_lpm_mode_set_posted(handle, 1U, 1U, &cfg);
+	elapsed = now_ns() - start;
+
+	if ((ret != SCMI_E_SUCCESS) || (elapsed >= CHECK_LATENCY_NS)) {
+		fail("posted", "returned %d after %llu ns", ret,
+		     (unsigned long long)elapsed);
+	}
+
+	if (scmi_channel_poll(handle) != 0) {
+		fail("posted", "channel idle with a command in flight");
+	}
+
+	core = sm_core_state(1U);
+	if (core.lpm_setting == SCMI_CPU_PD_LPM_ON_RUN_WAIT) {
+		fail("posted", "command done before the SM latency");
+	}
+
+	ret = scmi_channel_wait(handle);
+	core = sm_core_state(1U);
+	if ((ret != SCMI_E_SUCCESS) ||
+	    (core.lpm_setting != SCMI_CPU_PD_LPM_ON_RUN_WAIT) ||
+	    (scmi_channel_poll(handle) != 1)) {
+		fail("posted", "wait returned %d before the command was done",
+		     ret);
+	}
+
+	/* The next owner of the channel waits for the posted command */
+	ret = scmi_core_set_sleep_mode_posted(handle, 2U, SCMI_GPC_WAKEUP,
+					      SCMI_CPU_SLEEP_STOP);
+	ret |= scmi_perf_mode_set(handle, 3U, 42U);
+	if ((ret != SCMI_E_SUCCESS) ||
+	    (sm.log[0] != SM_CMD(IMX9_SCMI_PERF_PROTO_ID,
+				 IMX9_SCMI_CORE_PERFLEVELSET_MSG)) ||
+	    (sm.log[1] != SM_CMD(IMX9_SCMI_CORE_PROTO_ID,
+				 IMX9_SCMI_CORE_SETSLEEPMODE_MSG)) ||
+	    (sm_core_state(2U).sleep_mode != SCMI_CPU_SLEEP_STOP) ||
+	    (sm.perf[3] != 42U)) {
+		fail("posted", "command after a posted one not run in order");
+	}
+
+	if (scmi_channel_wait(handle) != SCMI_E_SUCCESS) {
+		fail("posted", "wait after the posted command completed failed");
+	}
+}
+
+/* The status of a failed posted command is reported once */
+static void check_posted_failure(void)
+{
+	int ret;
+
+	/* To scmi_channel_wait() */
+	scmi_core_set_sleep_mode_posted(handle, SM_CORES, SCMI_GPC_WAKEUP,
+					SCMI_CPU_SLEEP_SUSPEND);
+	ret = scmi_channel_wait(handle);
+	if (ret != SCMI_E_INVALID_PARAM) {
+		fail("posted failure", "wait returned %d", ret);
+	}
+
+	ret = scmi_channel_wait(handle);
+	if (ret != SCMI_E_SUCCESS) {
+		fail("posted failure", "reported twice (%d)", ret);
+	}
+
+	/* By the next owner of the channel, with its own command succeeding */
+	scmi_core_set_sleep_mode_posted(handle, SM_CORES, SCMI_GPC_WAKEUP,
+					SCMI_CPU_SLEEP_SUSPEND);
+	ret = scmi_perf_mode_set(handle, 0U, 1U);
+	if (ret != SCMI_E_SUCCESS) {
+		fail("posted failure", "next command returned %d", ret);
+	}
+
+	ret = scmi_channel_wait(handle);
+	if (ret != SCMI_E_SUCCESS) {
+		fail("posted failure", "reported to a later wait (%d)", ret);
+	}
+}
+
+struct check_core {
+	pthread_t thread;
+	uint32_t cpu;
+	unsigned int ops;
+	unsigned long cmds;
+	unsigned int seed;
+};
+
+/* One core turned on and off, and changing its performance level */
+static void *check_core_thread(void *arg)
+{
+	struct check_core *c = arg;
+	uint32_t mask[SM_IRQ_MASKS];
+	struct sm_core core;
+	unsigned int i, j;
+	uint32_t lpm;
+
+	for (i = 0U; i < c->ops; i++) {
+		switch (rand_r(&c->seed) % 3U) {
+		case 0U:
+			lpm = 1U + (rand_r(&c->seed) % 4U);
+			psci_cpu_on(c->cpu, lpm);
+			c->cmds += 2U;
+
+			/* Ordered before any later command of the channel */
+			if (scmi_perf_mode_set(handle, c->cpu, i) !=
+			    SCMI_E_SUCCESS) {
+				fail("CPU_ON", "perf level not set");
+			}
+			c->cmds++;
+
+			core = sm_core_state(c->cpu);
+			if (!core.running || (core.lpm_pd != c->cpu) ||
+			    (core.lpm_setting != lpm)) {
+				fail("CPU_ON", "core %u not on with LPM %u",
+				     c->cpu, lpm);
+			}
+			break;
+		case 1U:
+			for (j = 0U; j < SM_IRQ_MASKS; j++) {
+				mask[j] = (uint32_t)rand_r(&c->seed);
+			}
+			psci_cpu_off(c->cpu, mask, true);
+			psci_pwr_down_wfi(c->cpu);
+			c->cmds += 2U;
+
+			core = sm_core_state(c->cpu);
+			if ((core.sleep_mode != SCMI_CPU_SLEEP_SUSPEND) ||
+			    (memcmp(core.irq_mask, mask, sizeof(mask)) != 0)) {
+				fail("CPU_OFF", "core %u sleep mode not set",
+				     c->cpu);
+			}
+
+			/* Back to run for the next CPU_OFF */
+			if (scmi_core_set_sleep_mode(handle, c->cpu,
+						     SCMI_GPC_WAKEUP,
+						     SCMI_CPU_SLEEP_RUN) !=
+			    SCMI_E_SUCCESS) {
+				fail("CPU_OFF", "sleep mode not reset");
+			}
+			c->cmds++;
+			break;
+		default:
+			scmi_channel_poll(handle);
+			break;
+		}
+	}
+
+	return NULL;
+}
+
+static void check_cores(void)
+{
+	static struct check_core cores[CHECK_THREADS];
+	unsigned long cmds = sm.cmds;
+	unsigned int i;
+
+	for (i = 0U; i < CHECK_THREADS; i++) {
+		cores[i].cpu = i;
+		cores[i].ops = CHECK_OPS;
+		cores[i].seed = i + 1U;
+		if (pthread_create(&cores[i].thread, NULL, check_core_thread,
+				   &cores[i]) != 0) {
+			fprintf(stderr, "Cannot create the core threads\n");
+			exit(1);
+		}
+	}
+
+	for (i = 0U; i < CHECK_THREADS; i++) {
+		pthread_join(cores[i].thread, NULL);
+		cmds += cores[i].cmds;
+	}
+
+	if (scmi_channel_wait(handle) != SCMI_E_SUCCESS) {
+		fail("cores", "posted command failed");
+	}
+
+	if (sm.cmds != cmds) {
+		fail("cores", "%lu commands run by the SM, %lu sent", sm.cmds,
+		     cmds);
+	}
+}
+
+static int check(void)
+{
+	sm_start(CHECK_LATENCY_NS, 0U);
+
+	check_posted();
+	check_posted_failure();
+
+	/* Short random latencies, so that commands overlap with the PSCI work */
+	sm_set_latency(0U, 20000U);
+	check_cores();
+
+	sm_stop();
+
+	if (failed != 0) {
+		fprintf(stderr, "%d checks failed\n", failed);
+		return 1;
+	}
+
+	printf("Checked posted SCMI commands on %u cores successfully\n",
+	       CHECK_THREADS);
+
+	return 0;
+}
+
+/*
+ * Benchmark mode
+ */
+static void psci_work(uint64_t work_ns)
+{
+	uint64_t end = now_ns() + work_ns;
+
+	while (now_ns() < end) {
+	}
+}
+
+static uint64_t bench_cpu_off(uint64_t work_ns, bool posted)
+{
+	uint32_t mask[SM_IRQ_MASKS] = { 0U };
+	uint64_t start = now_ns();
+	unsigned int i;
+
+	for (i = 0U; i < BENCH_ROUNDS; i++) {
+		psci_cpu_off(0U, mask, posted);
+		psci_work(work_ns);
+		psci_pwr_down_wfi(0U);
+	}
+
+	return (now_ns() - start) / BENCH_ROUNDS;
+}
+
+static void bench_stats(void)
+{
+	struct scmi_proto_stats *st;
+	unsigned int i;
+
+	for (i = 0U; i < SCMI_STATS_MAX_PROTO; i++) {
+		st = &channel.stats[i];
+		if (st->count == 0U) {
+			break;
+		}
+
+		printf("  SCMI protocol 0x%x: %u commands, avg %.1f us, "
+		       "max %.1f us\n", st->proto_id, st->count,
+		       (double)st->total / st->count / 1000.0,
+		       (double)st->max / 1000.0);
+	}
+}
+
+static int bench(uint64_t latency_us, uint64_t work_us)
+{
+	uint64_t sync, posted;
+
+	sm_start(latency_us * 1000U, 0U);
+
+	sync = bench_cpu_off(work_us * 1000U, false);
+	posted = bench_cpu_off(work_us * 1000U, true);
+
+	sm_stop();
+
+	printf("SM latency %llu us, PSCI work %llu us\n",
+	       (unsigned long long)latency_us, (unsigned long long)work_us);
+	printf("  CPU_OFF, sleep mode waited for: %8.1f us\n",
+	       (double)sync / 1000.0);
+	printf("  CPU_OFF, sleep mode posted:     %8.1f us\n",
+	       (double)posted / 1000.0);
+	bench_stats();
+
+	return (failed != 0) ? 1 : 0;
+}
+
+int main(int argc, char *argv[])
+{
+	if ((argc == 4) && (strcmp(argv[1], "-b") == 0)) {
+		return bench(strtoull(argv[2], NULL, 0),
+			     strtoull(argv[3], NULL, 0));
+	}
+
+	if ((argc != 2) || (strcmp(argv[1], "-c") != 0)) {
+		printf("Usage: %s -c\n", argv[0]);
+		printf("       %s -b <SM latency us> <PSCI work us>\n\n",
+		       argv[0]);
+		printf("With -c, checks the posted SCMI commands against a\n"
+		       "stub of the System Manager, from one core then from\n"
+		       "%u cores at once.\n"
+		       "With -b, times the CPU_OFF sequence with the sleep\n"
+		       "mode request waited for at once and posted.\n",
+		       SM_CORES);
+		return 1;
+	}
+
+	return check();
+}
@@ -0,0 +1,16 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* Host stub: only the types and platform definitions used by spmc.h */
+
+#ifndef BL_COMMON_H
+#define BL_COMMON_H
+
+#include <platform_def.h>
+
+typedef struct entry_point_info entry_point_info_t;
+
+#endif /* BL_COMMON_H */
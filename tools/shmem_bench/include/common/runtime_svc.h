@@ -0,0 +1,30 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host version of the SMC return macros. The handle points to the registers
+ * returned to the caller.
+ */
+
+#ifndef RUNTIME_SVC_H
+#define RUNTIME_SVC_H
+
+#include <stdint.h>
+
+typedef struct smc_regs {
+	uint64_t x[8];
+} smc_regs_t;
+
+#define SMC_RET8(_h, _x0, _x1, _x2, _x3, _x4, _x5, _x6, _x7) {	\
+	smc_regs_t *_r = (smc_regs_t *)(_h);			\
+	_r->x[0] = (_x0); _r->x[1] = (_x1); _r->x[2] = (_x2);	\
+	_r->x[3] = (_x3); _r->x[4] = (_x4); _r->x[5] = (_x5);	\
+	_r->x[6] = (_x6); _r->x[7] = (_x7);			\
+	return (uint64_t)(uintptr_t)(_h);			\
+}
+#define SMC_RET1(_h, _x0)	SMC_RET8(_h, _x0, 0, 0, 0, 0, 0, 0, 0)
+
+#endif /* RUNTIME_SVC_H */
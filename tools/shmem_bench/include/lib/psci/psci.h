@@ -0,0 +1,14 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* Host stub: only the types named by spmc.h */
+
+#ifndef PSCI_H
+#define PSCI_H
+
+typedef struct spd_pm_ops spd_pm_ops_t;
+
+#endif /* PSCI_H */
@@ -0,0 +1,14 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* Host platform: one secure partition execution context per thread */
+
+#ifndef PLATFORM_DEF_H
+#define PLATFORM_DEF_H
+
+#define PLATFORM_CORE_COUNT	8U
+
+#endif /* PLATFORM_DEF_H */
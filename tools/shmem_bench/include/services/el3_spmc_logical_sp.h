@@ -0,0 +1,14 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* Host stub: only the types named by spmc.h */
+
+#ifndef EL3_SP_H
+#define EL3_SP_H
+
+struct el3_lp_desc;
+
+#endif /* EL3_SP_H */
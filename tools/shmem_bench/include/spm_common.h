@@ -0,0 +1,18 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* Host stub: only the types named by spmc.h */
+
+#ifndef SPM_COMMON_H
+#define SPM_COMMON_H
+
+#include <stdint.h>
+
+typedef struct cpu_context {
+	uint64_t regs[1];
+} cpu_context_t;
+
+#endif /* SPM_COMMON_H */
@@ -0,0 +1,723 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host test and benchmark of the EL3 SPMC shared memory object store. The
+ * FF-A calls of spmc_shared_mem.c are made directly, with a normal world
+ * sender and one secure partition as the receiver. The check mode runs
+ * random sequences of shares of mixed sizes, retrieves, relinquishes and
+ * reclaims, then checks that the datastore is empty again and that it can
+ * still hold the largest object after being filled with small ones. The
+ * stress mode has several threads, each with its own partition, retrieve and
+ * relinquish the same objects while sharing and reclaiming their own. The
+ * benchmark mode times share/retrieve/relinquish/reclaim cycles with
+ * different numbers of other live objects, and the stress mode with
+ * different numbers of threads.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <common/runtime_svc.h>
+#include <lib/spinlock.h>
+#include <lib/xlat_tables/xlat_tables_v2.h>
+#include <services/ffa_svc.h>
+
+#include "spmc.h"
+#include "spmc_shared_mem.h"
+
+#define DATASTORE_SIZE		(256U * 1024U)
+
+/* Pages of each RX/TX buffer */
+#define MBOX_PAGES		16U
+
+#define NWD_ID			U(0x0001)
+#define SP_ID			U(0x8001)
+
+/*
+ * Offsets of the parts of the descriptors built here, with @nr endpoint
+ * memory access descriptors
+ */
+#define EMAD_OFFSET		sizeof(struct ffa_mtd)
+#define COMP_OFFSET(nr)		(EMAD_OFFSET + (nr) * sizeof(struct ffa_emad_v1_0))
+#define CONS_OFFSET(nr)		(COMP_OFFSET(nr) + sizeof(struct ffa_comp_mrd))
+
+/* Largest share, filling most of a TX buffer */
+#define MAX_RANGES		3000U
+
+#define MAX_LIVE		256U
+
+/* Cycles per benchmark run, and other live objects during the runs */
+#define BENCH_CYCLES		5000U
+static const unsigned int bench_live[] = { 0U, 64U, 512U };
+
+/* Each step is timed for at least MIN_TIME seconds, and MIN_RUNS times */
+#define MIN_RUNS		3U
+#define MIN_TIME		0.5
+
+/*
+ * Each thread of the stress test is a client with its own normal world
+ * mailbox and its own secure partition, as if each core ran a different
+ * sender and receiver.
+ */
+#define MAX_THREADS		8U
+
+/* Objects shared with every partition, retrieved by all the threads */
+#define POOL_SIZE		64U
+
+/* Operations per thread of the stress test */
+#define STRESS_OPS		20000U
+
+struct client {
+	struct mailbox nwd_mbox;
+	struct secure_partition_desc sp;
+	smc_regs_t regs;
+	/* Pages shared so far, so that shares never overlap */
+	uint64_t next_page;
+};
+
+typedef struct live_s {
+	uint64_t handle;
+	bool retrieved;
+} live_t;
+
+static struct client clients[MAX_THREADS];
+static unsigned int client_count;
+static __thread struct client *cur;
+static uint64_t pool[POOL_SIZE];
+static unsigned long long stress_ops;
+static live_t live[MAX_LIVE];
+static unsigned int live_count;
+static unsigned long long step;
+
+static void fail(const char *msg)
+{
+	fprintf(stderr, "Step %llu: %s\n", step, msg);
+	exit(1);
+}
+
+/*
+ * Functions of the SPMC core used by spmc_shared_mem.c
+ */
+uint64_t spmc_ffa_error_return(void *handle, int error_code)
+{
+	SMC_RET8(handle, FFA_ERROR, FFA_TARGET_INFO_MBZ, (uint32_t)error_code,
+		 0, 0, 0, 0, 0);
+}
+
+struct mailbox *spmc_get_mbox_desc(bool secure_origin)
+{
+	return secure_origin ? &cur->sp.mailbox : &cur->nwd_mbox;
+}
+
+uint32_t get_partition_ffa_version(bool secure_origin)
+{
+	return secure_origin ? cur->sp.ffa_version : FFA_VERSION_COMPILED;
+}
+
+struct secure_partition_desc *spmc_get_current_sp_ctx(void)
+{
+	return &cur->sp;
+}
+
+struct secure_partition_desc *spmc_get_sp_ctx(uint16_t id)
+{
+	unsigned int i;
+
+	for (i = 0U; i < client_count; i++) {
+		if (clients[i].sp.sp_id == id) {
+			return &clients[i].sp;
+		}
+	}
+	return NULL;
+}
+
+int plat_spmc_shmem_begin(struct ffa_mtd *desc)
+{
+	return 0;
+}
+
+int plat_spmc_shmem_reclaim(struct ffa_mtd *desc)
+{
+	return 0;
+}
+
+/* The host may have fewer cores than threads, so waiters yield */
+void spin_lock(spinlock_t *lock)
+{
+	while (__atomic_exchange_n(&lock->lock, 1U, __ATOMIC_ACQUIRE) != 0U) {
+		sched_yield();
+	}
+}
+
+void spin_unlock(spinlock_t *lock)
+{
+	__atomic_store_n(&lock->lock, 0U, __ATOMIC_RELEASE);
+}
+
+/*
+ * FF-A calls
+ */
+static void *alloc_buffer(void)
+{
+	void *buf;
+
+	if (posix_memalign(&buf, PAGE_SIZE_4KB, MBOX_PAGES * PAGE_SIZE_4KB) != 0) {
+		fprintf(stderr, "Cannot allocate memory\n");
+		exit(1);
+	}
+	memset(buf, 0, MBOX_PAGES * PAGE_SIZE_4KB);
+
+	return buf;
+}
+
+static void client_init(struct client *c, uint16_t sp_id)
+{
+	memset(c, 0, sizeof(*c));
+	/* Each client shares its own pages, so that shares never overlap */
+	c->next_page = (uint64_t)(sp_id - SP_ID) << 32;
+	c->nwd_mbox.tx_buffer = alloc_buffer();
+	c->nwd_mbox.rx_buffer = alloc_buffer();
+	c->nwd_mbox.rxtx_page_count = MBOX_PAGES;
+	c->sp.sp_id = sp_id;
+	c->sp.ffa_version = MAKE_FFA_VERSION(1, 1);
+	c->sp.mailbox.tx_buffer = alloc_buffer();
+	c->sp.mailbox.rx_buffer = alloc_buffer();
+	c->sp.mailbox.rxtx_page_count = MBOX_PAGES;
+}
+
+static int result(struct client *c, uint64_t expected)
+{
+	if (c->regs.x[0] == FFA_ERROR) {
+		return (int)(uint32_t)c->regs.x[2];
+	}
+	if (c->regs.x[0] != expected) {
+		fail("unexpected FF-A response");
+	}
+	return 0;
+}
+
+/*
+ * Fill the header and the endpoint descriptors of a transaction with the
+ * partition of @c, or with the partitions of all the clients if @all is set.
+ * Return: the number of endpoints.
+ */
+static uint32_t fill_mtd(struct client *c, uint8_t *tx, bool all)
+{
+	struct ffa_mtd *mtd = (struct ffa_mtd *)tx;
+	struct ffa_emad_v1_0 *emad = (struct ffa_emad_v1_0 *)(tx + EMAD_OFFSET);
+	uint32_t nr = all ? client_count : 1U;
+	uint32_t i;
+
+	memset(tx, 0, CONS_OFFSET(nr));
+	mtd->sender_id = NWD_ID;
+	mtd->emad_size = sizeof(*emad);
+	mtd->emad_count = nr;
+	mtd->emad_offset = EMAD_OFFSET;
+	for (i = 0U; i < nr; i++) {
+		emad[i].mapd.endpoint_id = all ? clients[i].sp.sp_id :
+						 c->sp.sp_id;
+	}
+
+	return nr;
+}
+
+/* Share @ranges pages in separate address ranges */
+static int share(struct client *c, uint32_t ranges, bool all,
+		 uint64_t *handle)
+{
+	uint8_t *tx = (uint8_t *)c->nwd_mbox.tx_buffer;
+	struct ffa_mtd *mtd = (struct ffa_mtd *)tx;
+	struct ffa_emad_v1_0 *emad = (struct ffa_emad_v1_0 *)(tx + EMAD_OFFSET);
+	uint32_t nr = fill_mtd(c, tx, all);
+	struct ffa_comp_mrd *comp = (struct ffa_comp_mrd *)(tx + COMP_OFFSET(nr));
+	uint32_t len = CONS_OFFSET(nr) + ranges * sizeof(struct ffa_cons_mrd);
+	uint32_t i;
+	int ret;
+
+	mtd->memory_region_attributes = FFA_MEM_ATTR_NORMAL_MEMORY_CACHED_WB |
+					FFA_MEM_ATTR_INNER_SHAREABLE;
+	mtd->flags = FFA_MTD_FLAG_TYPE_SHARE_MEMORY;
+	for (i = 0U; i < nr; i++) {
+		emad[i].mapd.memory_access_permissions = FFA_MEM_PERM_RW;
+		emad[i].comp_mrd_offset = COMP_OFFSET(nr);
+	}
+	comp->total_page_count = ranges;
+	comp->address_range_count = ranges;
+	for (i = 0U; i < ranges; i++) {
+		comp->address_range_array[i].address =
+			c->next_page++ * PAGE_SIZE_4KB;
+		comp->address_range_array[i].page_count = 1U;
+		comp->address_range_array[i].reserved_12_15 = 0U;
+	}
+
+	spmc_ffa_mem_send(FFA_MEM_SHARE_SMC32, false, len, len, 0U, 0U, NULL,
+			  &c->regs, 0U);
+	ret = result(c, FFA_SUCCESS_SMC32);
+	if (ret == 0) {
+		*handle = c->regs.x[2] | (c->regs.x[3] << 32);
+	}
+
+	return ret;
+}
+
+static int retrieve(struct client *c, uint64_t handle, bool all)
+{
+	uint8_t *tx = (uint8_t *)c->sp.mailbox.tx_buffer;
+	struct ffa_mtd *req = (struct ffa_mtd *)tx;
+	const struct ffa_mtd *resp = c->sp.mailbox.rx_buffer;
+	uint32_t len = COMP_OFFSET(fill_mtd(c, tx, all));
+	int ret;
+
+	req->handle = handle;
+
+	spmc_ffa_mem_retrieve_req(FFA_MEM_RETRIEVE_REQ_SMC64, true, len, len,
+				  0U, 0U, NULL, &c->regs, 0U);
+	ret = result(c, FFA_MEM_RETRIEVE_RESP);
+	if (ret != 0) {
+		return ret;
+	}
+
+	if (resp->handle != handle) {
+		fail("retrieved the wrong object");
+	}
+
+	/* The partition is done with the response, as with FFA_RX_RELEASE */
+	c->sp.mailbox.state = MAILBOX_STATE_EMPTY;
+
+	return 0;
+}
+
+static int relinquish(struct client *c, uint64_t handle)
+{
+	struct ffa_mem_relinquish_descriptor *req =
+		(struct ffa_mem_relinquish_descriptor *)c->sp.mailbox.tx_buffer;
+
+	req->handle = handle;
+	req->flags = 0U;
+	req->endpoint_count = 1U;
+	req->endpoint_array[0] = c->sp.sp_id;
+
+	spmc_ffa_mem_relinquish(FFA_MEM_RELINQUISH, true, 0U, 0U, 0U, 0U, NULL,
+				&c->regs, 0U);
+
+	return result(c, FFA_SUCCESS_SMC32);
+}
+
+static int reclaim(struct client *c, uint64_t handle)
+{
+	spmc_ffa_mem_reclaim(FFA_MEM_RECLAIM, false, (uint32_t)handle,
+			     (uint32_t)(handle >> 32), 0U, 0U, NULL, &c->regs,
+			     0U);
+
+	return result(c, FFA_SUCCESS_SMC32);
+}
+
+/*
+ * Check mode
+ */
+static void check_empty(void)
+{
+	unsigned int i;
+
+	if (spmc_shmem_obj_state.allocated != 0U) {
+		fail("datastore not empty once all objects are reclaimed");
+	}
+	for (i = 0U; i < SPMC_SHMEM_OBJ_CLASSES; i++) {
+		if (spmc_shmem_obj_state.free_list[i] != NULL) {
+			fail("free block left above the allocated area");
+		}
+	}
+	if (spmc_shmem_obj_state.objs != NULL) {
+		fail("object list not empty");
+	}
+}
+
+/* Mostly small shares, with some large ones */
+static uint32_t random_ranges(void)
+{
+	if ((rand() % 8) == 0) {
+		return 1U + (uint32_t)rand() % MAX_RANGES;
+	}
+	return 1U + (uint32_t)rand() % 16U;
+}
+
+static void op_share(void)
+{
+	uint64_t handle;
+	int ret;
+
+	ret = share(cur, random_ranges(), false, &handle);
+	if (ret == FFA_ERROR_NO_MEMORY) {
+		return;
+	}
+	if (ret != 0) {
+		fail("share failed");
+	}
+
+	live[live_count].handle = handle;
+	live[live_count].retrieved = false;
+	live_count++;
+}
+
+static void op_retrieve(unsigned int i)
+{
+	if (live[i].retrieved) {
+		if (relinquish(cur, live[i].handle) != 0) {
+			fail("relinquish failed");
+		}
+		live[i].retrieved = false;
+		return;
+	}
+
+	if (retrieve(cur, live[i].handle, false) != 0) {
+		fail("retrieve failed");
+	}
+	live[i].retrieved = true;
+}
+
+static void op_reclaim(unsigned int i)
+{
+	if (live[i].retrieved) {
+		if (reclaim(cur, live[i].handle) != FFA_ERROR_DENIED) {
+			fail("reclaimed an object still in use");
+		}
+		if (relinquish(cur, live[i].handle) != 0) {
+			fail("relinquish failed");
+		}
+	}
+
+	if (reclaim(cur, live[i].handle) != 0) {
+		fail("reclaim failed");
+	}
+	if (retrieve(cur, live[i].handle, false) != FFA_ERROR_INVALID_PARAMETER) {
+		fail("retrieved a reclaimed object");
+	}
+
+	live[i] = live[--live_count];
+}
+
+static void reclaim_all(void)
+{
+	while (live_count != 0U) {
+		op_reclaim(live_count - 1U);
+	}
+}
+
+/*
+ * Fill the datastore with the smallest objects, free every other one and then
+ * the rest. The datastore must then be empty and able to hold the largest
+ * object again.
+ */
+static void check_refill(void)
+{
+	uint64_t handles[DATASTORE_SIZE / 128U];
+	unsigned int count = 0U;
+	unsigned int i;
+	uint64_t handle;
+
+	while (share(cur, 1U, false, &handle) == 0) {
+		if (count == (DATASTORE_SIZE / 128U)) {
+			fail("more objects than the datastore can hold");
+		}
+		handles[count++] = handle;
+	}
+
+	for (i = 0U; i < count; i += 2U) {
+		if (reclaim(cur, handles[i]) != 0) {
+			fail("reclaim failed");
+		}
+	}
+	for (i = 1U; i < count; i += 2U) {
+		if (reclaim(cur, handles[i]) != 0) {
+			fail("reclaim failed");
+		}
+	}
+	check_empty();
+
+	if (share(cur, MAX_RANGES, false, &handle) != 0) {
+		fail("largest share failed on an empty datastore");
+	}
+	if (reclaim(cur, handle) != 0) {
+		fail("reclaim failed");
+	}
+	check_empty();
+}
+
+static int check(unsigned long long ops)
+{
+	unsigned int i;
+
+	srand(1U);
+
+	for (step = 0U; step < ops; step++) {
+		i = (live_count != 0U) ? (unsigned int)rand() % live_count : 0U;
+
+		switch (rand() % 4) {
+		case 0:
+		case 1:
+			if (live_count < MAX_LIVE) {
+				op_share();
+			}
+			break;
+		case 2:
+			if (live_count != 0U) {
+				op_retrieve(i);
+			}
+			break;
+		default:
+			if (live_count != 0U) {
+				op_reclaim(i);
+			}
+			break;
+		}
+
+		if ((step % 1000U) == 999U) {
+			reclaim_all();
+			check_empty();
+		}
+	}
+
+	reclaim_all();
+	check_empty();
+	check_refill();
+
+	printf("Checked %llu operations successfully\n", ops);
+
+	return 0;
+}
+
+/*
+ * Benchmark mode
+ */
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Time an expression, returning the best time of a run in seconds */
+#define BENCH(best, expr)						\
+	do {								\
+		double _start, _t, _total = 0.0;			\
+		unsigned int _runs = 0U;				\
+									\
+		while ((_runs < MIN_RUNS) || (_total < MIN_TIME)) {	\
+			_start = now();					\
+			expr;						\
+			_t = now() - _start;				\
+			if ((_runs == 0U) || (_t < (best))) {		\
+				(best) = _t;				\
+			}						\
+			_total += _t;					\
+			_runs++;					\
+		}							\
+	} while (false)
+
+/*
+ * Stress mode
+ */
+
+/*
+ * Retrieve and relinquish random pool objects, which the other threads
+ * retrieve at the same time, with a transaction of its own every 8 pairs.
+ */
+static void *stress_thread(void *arg)
+{
+	struct client *c = arg;
+	unsigned int seed = c->sp.sp_id;
+	unsigned long long i;
+	uint64_t handle;
+
+	cur = c;
+	for (i = 0U; i < stress_ops; i++) {
+		handle = pool[(unsigned int)rand_r(&seed) % POOL_SIZE];
+		if (retrieve(c, handle, true) != 0) {
+			fail("concurrent retrieve failed");
+		}
+		/* This partition at least is using the object */
+		if (((i % 16U) == 0U) &&
+		    (reclaim(c, handle) != FFA_ERROR_DENIED)) {
+			fail("concurrently reclaimed an object in use");
+		}
+		if (relinquish(c, handle) != 0) {
+			fail("concurrent relinquish failed");
+		}
+
+		if (((i % 8U) == 0U) &&
+		    ((share(c, 1U + (i % 16U), false, &handle) != 0) ||
+		     (retrieve(c, handle, false) != 0) ||
+		     (relinquish(c, handle) != 0) ||
+		     (reclaim(c, handle) != 0))) {
+			fail("concurrent share cycle failed");
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * Run @threads clients for @ops operations each. Every pool object must then
+ * be released, and the datastore empty once they are reclaimed.
+ * Return: the time taken by the threads, in seconds.
+ */
+static double stress(unsigned int threads, unsigned long long ops)
+{
+	pthread_t tids[MAX_THREADS];
+	double start, t;
+	unsigned int i;
+
+	client_count = threads;
+	stress_ops = ops;
+	for (i = 0U; i < POOL_SIZE; i++) {
+		if (share(cur, 1U, true, &pool[i]) != 0) {
+			fail("pool share failed");
+		}
+	}
+
+	start = now();
+	for (i = 0U; i < threads; i++) {
+		if (pthread_create(&tids[i], NULL, stress_thread,
+				   &clients[i]) != 0) {
+			fail("cannot create thread");
+		}
+	}
+	for (i = 0U; i < threads; i++) {
+		pthread_join(tids[i], NULL);
+	}
+	t = now() - start;
+
+	for (i = 0U; i < POOL_SIZE; i++) {
+		if (reclaim(cur, pool[i]) != 0) {
+			fail("pool object still in use");
+		}
+	}
+	check_empty();
+	client_count = 1U;
+
+	return t;
+}
+
+static void cycles(struct client *c, unsigned int count)
+{
+	uint64_t handle;
+	unsigned int i;
+
+	for (i = 0U; i < count; i++) {
+		if ((share(c, 1U + (i % 16U), false, &handle) != 0) ||
+		    (retrieve(c, handle, false) != 0) ||
+		    (relinquish(c, handle) != 0) ||
+		    (reclaim(c, handle) != 0)) {
+			fail("benchmark cycle failed");
+		}
+	}
+}
+
+static int bench(void)
+{
+	uint64_t handles[512];
+	unsigned int i, j;
+	double t;
+
+	printf("%u share/retrieve/relinquish/reclaim cycles of 1 to 16 "
+	       "ranges\n", BENCH_CYCLES);
+	for (i = 0U; i < ARRAY_SIZE(bench_live); i++) {
+		for (j = 0U; j < bench_live[i]; j++) {
+			if (share(cur, 1U, false, &handles[j]) != 0) {
+				fail("benchmark share failed");
+			}
+		}
+
+		t = 0.0;
+		BENCH(t, cycles(cur, BENCH_CYCLES));
+		printf("%4u other live objects, ns per cycle %12.1f\n",
+		       bench_live[i], t * 1e9 / BENCH_CYCLES);
+
+		for (j = 0U; j < bench_live[i]; j++) {
+			if (reclaim(cur, handles[j]) != 0) {
+				fail("benchmark reclaim failed");
+			}
+		}
+	}
+
+	printf("\n%u retrieve/relinquish pairs per thread on %u shared objects\n",
+	       STRESS_OPS, POOL_SIZE);
+	for (i = 1U; i <= MAX_THREADS; i <<= 1) {
+		t = stress(i, STRESS_OPS);
+		printf("%4u threads, thousand pairs per second %12.1f\n", i,
+		       i * STRESS_OPS / t / 1e3);
+	}
+
+	return 0;
+}
+
+static int usage(const char *name)
+{
+	printf("Usage: %s [-c [ops] | -t threads [ops]]\n\n"
+	       "Time FF-A memory share, retrieve, relinquish and reclaim\n"
+	       "calls in the SPMC shared memory object store.\n\n"
+	       "  -c  Check random operations and the datastore use instead\n"
+	       "  -t  Check concurrent operations from up to %u threads "
+	       "instead\n",
+	       name, MAX_THREADS);
+	return 1;
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned long long ops;
+	unsigned int threads = 0U;
+	unsigned int i;
+
+	if ((argc >= 2) && (strcmp(argv[1], "-t") == 0)) {
+		if ((argc < 3) || (argc > 4)) {
+			return usage(argv[0]);
+		}
+		threads = (unsigned int)strtoul(argv[2], NULL, 0);
+		if ((threads == 0U) || (threads > MAX_THREADS)) {
+			return usage(argv[0]);
+		}
+	} else if ((argc > 3) ||
+		   ((argc >= 2) && (strcmp(argv[1], "-c") != 0))) {
+		return usage(argv[0]);
+	}
+
+	spmc_shmem_obj_state.data = malloc(DATASTORE_SIZE);
+	spmc_shmem_obj_state.data_size = DATASTORE_SIZE;
+	if (spmc_shmem_obj_state.data == NULL) {
+		fprintf(stderr, "Cannot allocate memory\n");
+		return 1;
+	}
+
+	for (i = 0U; i < MAX_THREADS; i++) {
+		client_init(&clients[i], SP_ID + i);
+	}
+	client_count = 1U;
+	cur = &clients[0];
+
+	if ((argc >= 2) && (strcmp(argv[1], "-t") == 0)) {
+		ops = (argc == 4) ? strtoull(argv[3], NULL, 0) : STRESS_OPS;
+		stress(threads, ops);
+		printf("Checked %llu operations on %u threads successfully\n",
+		       ops, threads);
+		return 0;
+	}
+
+	if (argc >= 2) {
+		return check((argc == 3) ? strtoull(argv[2], NULL, 0) : 20000U);
+	}
+
+	return bench();
+}
@@ -0,0 +1,580 @@
+/*
+ * Copyright 2026 NXP
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host test and benchmark of the transfer list library. The check mode runs
+ * random sequences of additions, removals, resizes, compactions and
+ * relocations and, after each of them, checks every entry, its data, the
+ * lookups and the checksum against a model of the list. The benchmark mode
+ * times building a list, looking up its tags and compacting it.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <lib/transfer_list.h>
+
+/* Two list buffers, for relocations */
+#define TL_BUF_SIZE		(256U * 1024U)
+#define TL_BUF_ALIGN		4096U
+
+/* More tags than TRANSFER_LIST_INDEX_SIZE, so the index overflows */
+#define NUM_TAGS		24U
+
+/* Tag number n, every other one from the 24-bit non-standard range */
+#define TAG_ID(n)		((((n) % 2U) == 0U) ? (0xfff000U | (n)) : (n))
+#define TAG_NUM(id)		((id) & 0xfffU)
+
+#define MAX_ENTRIES		1024U
+#define MIN_DATA		4U
+#define MAX_DATA		600U
+#define MAX_ALIGN		6U
+
+/* Entries and tags of the benchmark list */
+#define BENCH_ENTRIES		4096U
+#define BENCH_TAGS		16U
+#define BENCH_DATA		32U
+
+/* Each step is timed for at least MIN_TIME seconds, and MIN_RUNS times */
+#define MIN_RUNS		3U
+#define MIN_TIME		0.5
+
+/* Runs of the compaction benchmark */
+#define COMPACT_RUNS		10U
+
+typedef struct model_s {
+	bool live;
+	uint32_t tag;
+	uint32_t size;
+	uint8_t align;
+} model_t;
+
+static model_t model[MAX_ENTRIES];
+static unsigned int live_count;
+static uint8_t *bufs[2];
+static unsigned int cur_buf;
+static unsigned long long step;
+
+static void fail(const char *msg)
+{
+	fprintf(stderr, "Step %llu: %s\n", step, msg);
+	exit(1);
+}
+
+static uint8_t pattern(uint32_t id, uint32_t i)
+{
+	return (uint8_t)(id * 31U + i);
+}
+
+/* The data of an entry starts with its model id, followed by a pattern */
+static void fill(struct transfer_list_entry *te, uint32_t id)
+{
+	uint8_t *data = transfer_list_entry_data(te);
+	uint32_t i;
+
+	memcpy(data, &id, sizeof(id));
+	for (i = sizeof(id); i < te->data_size; i++) {
+		data[i] = pattern(id, i);
+	}
+}
+
+static uint32_t entry_id(struct transfer_list_entry *te)
+{
+	uint32_t id;
+
+	memcpy(&id, transfer_list_entry_data(te), sizeof(id));
+
+	return id;
+}
+
+static struct transfer_list_entry *find_id(struct transfer_list_header *tl,
+					   uint32_t id)
+{
+	struct transfer_list_entry *te = NULL;
+
+	while ((te = transfer_list_next(tl, te)) != NULL) {
+		if ((te->tag_id != TL_TAG_EMPTY) && (entry_id(te) == id)) {
+			return te;
+		}
+	}
+
+	fail("entry missing from the list");
+	return NULL;
+}
+
+static void check_list(struct transfer_list_header *tl)
+{
+	struct transfer_list_entry *first[NUM_TAGS + 2U] = { NULL };
+	struct transfer_list_entry *te = NULL;
+	bool seen[MAX_ENTRIES] = { false };
+	unsigned int count = 0U;
+	const uint8_t *data;
+	uint32_t id, i, tag;
+
+	if (!transfer_list_verify_checksum(tl)) {
+		fail("bad checksum");
+	}
+	if (tl->size > tl->max_size) {
+		fail("list larger than its maximum size");
+	}
+
+	while ((te = transfer_list_next(tl, te)) != NULL) {
+		if (te->tag_id == TL_TAG_EMPTY) {
+			continue;
+		}
+
+		id = entry_id(te);
+		if ((id >= MAX_ENTRIES) || !model[id].live || seen[id]) {
+			fail("unexpected entry");
+		}
+		if ((te->tag_id != model[id].tag) ||
+		    (te->data_size != model[id].size)) {
+			fail("entry tag or size changed");
+		}
+		data = transfer_list_entry_data(te);
+		if (((uintptr_t)data & ((1U << model[id].align) - 1U)) != 0U) {
+			fail("entry data misaligned");
+		}
+		for (i = sizeof(id); i < te->data_size; i++) {
+			if (data[i] != pattern(id, i)) {
+				fail("entry data corrupted");
+			}
+		}
+
+		seen[id] = true;
+		count++;
+		if (first[TAG_NUM(te->tag_id)] == NULL) {
+			first[TAG_NUM(te->tag_id)] = te;
+		}
+	}
+
+	if (count != live_count) {
+		fail("entries lost from the list");
+	}
+
+	/* One more tag than used, which is never found */
+	for (tag = 1U; tag <= NUM_TAGS + 1U; tag++) {
+		if (transfer_list_find(tl, TAG_ID(tag)) != first[tag]) {
+			fail("lookup does not return the first entry of a tag");
+		}
+	}
+}
+
+static int new_id(void)
+{
+	uint32_t id;
+
+	for (id = 0U; id < MAX_ENTRIES; id++) {
+		if (!model[id].live) {
+			return (int)id;
+		}
+	}
+
+	return -1;
+}
+
+static int random_live_id(void)
+{
+	uint32_t id = (uint32_t)rand() % MAX_ENTRIES;
+	uint32_t i;
+
+	for (i = 0U; i < MAX_ENTRIES; i++) {
+		if (model[(id + i) % MAX_ENTRIES].live) {
+			return (int)((id + i) % MAX_ENTRIES);
+		}
+	}
+
+	return -1;
+}
+
+static uint32_t random_size(void)
+{
+	return MIN_DATA + ((uint32_t)rand() % (MAX_DATA - MIN_DATA + 1U));
+}
+
+static void add_model(uint32_t id, uint32_t tag, uint32_t size, uint8_t align)
+{
+	model[id].live = true;
+	model[id].tag = tag;
+	model[id].size = size;
+	model[id].align = align;
+	live_count++;
+}
+
+static void op_add(struct transfer_list_header *tl, bool with_align)
+{
+	uint8_t data[MAX_DATA];
+	struct transfer_list_entry *te, *te2;
+	uint32_t tag = 1U + ((uint32_t)rand() % NUM_TAGS);
+	uint32_t size = random_size();
+	uint8_t align = with_align ? (3U + (uint32_t)rand() % (MAX_ALIGN - 2U)) : 0U;
+	int id = new_id();
+	int id2;
+	uint32_t i;
+
+	if (id < 0) {
+		return;
+	}
+
+	tag = TAG_ID(tag);
+
+	if ((rand() % 2) == 0) {
+		memcpy(data, &id, sizeof(id));
+		for (i = sizeof(id); i < size; i++) {
+			data[i] = pattern(id, i);
+		}
+		te = with_align ?
+			transfer_list_add_with_align(tl, tag, size, data, align) :
+			transfer_list_add(tl, tag, size, data);
+		if (te != NULL) {
+			add_model(id, tag, size, align);
+		}
+		return;
+	}
+
+	/*
+	 * Add without data and fill it in afterwards, sometimes adding another
+	 * entry before the checksum is brought up to date.
+	 */
+	te = with_align ?
+		transfer_list_add_with_align(tl, tag, size, NULL, align) :
+		transfer_list_add(tl, tag, size, NULL);
+	if (te == NULL) {
+		return;
+	}
+	fill(te, id);
+	add_model(id, tag, size, align);
+
+	id2 = new_id();
+	if ((id2 >= 0) && ((rand() % 2) == 0)) {
+		size = random_size();
+		te2 = transfer_list_add(tl, tag, size, NULL);
+		if (te2 != NULL) {
+			fill(te2, id2);
+			add_model(id2, tag, size, 0U);
+		}
+	}
+	transfer_list_update_checksum(tl);
+}
+
+static void op_rem(struct transfer_list_header *tl)
+{
+	int id = random_live_id();
+
+	if (id < 0) {
+		return;
+	}
+
+	if (!transfer_list_rem(tl, find_id(tl, id))) {
+		fail("remove failed");
+	}
+	model[id].live = false;
+	live_count--;
+}
+
+static void op_resize(struct transfer_list_header *tl)
+{
+	struct transfer_list_entry *te;
+	uint32_t size = random_size();
+	int id = random_live_id();
+
+	if (id < 0) {
+		return;
+	}
+
+	te = find_id(tl, id);
+	if (!transfer_list_set_data_size(tl, te, size)) {
+		return;
+	}
+	model[id].size = size;
+	fill(te, id);
+	transfer_list_update_checksum(tl);
+}
+
+static struct transfer_list_header *op_relocate(struct transfer_list_header *tl)
+{
+	struct transfer_list_header *new_tl;
+	size_t off = 8U * ((uint32_t)rand() % 64U);
+
+	cur_buf ^= 1U;
+	new_tl = transfer_list_relocate(tl, bufs[cur_buf] + off,
+					TL_BUF_SIZE - off);
+	if (new_tl == NULL) {
+		fail("relocation failed");
+	}
+
+	return new_tl;
+}
+
+/* A malformed entry must make compaction fail without touching the list */
+static void check_compact_malformed(void)
+{
+	struct transfer_list_header *tl;
+	struct transfer_list_entry *te, *last = NULL;
+	static uint8_t copy[TL_BUF_SIZE];
+	uint32_t i;
+
+	tl = transfer_list_init(bufs[0], TL_BUF_SIZE);
+	for (i = 0U; i < 16U; i++) {
+		last = transfer_list_add(tl, 1U + i, 64U, NULL);
+	}
+
+	/* Void entries before the malformed one, which compaction would move */
+	te = NULL;
+	for (i = 0U; i < 8U; i++) {
+		te = transfer_list_next(tl, te);
+		transfer_list_rem(tl, te);
+		te = transfer_list_next(tl, te);
+	}
+	last->data_size = 0xFFFFFF00U;
+	transfer_list_update_checksum(tl);
+
+	memcpy(copy, tl, tl->size);
+	if (transfer_list_compact(tl) ||
+	    (memcmp(copy, tl, tl->size) != 0)) {
+		fail("compaction changed a malformed list");
+	}
+}
+
+/*
+ * Every change of a list that verified must leave it verified without a
+ * transfer_list_update_checksum(), and a change of a list whose checksum was
+ * already stale must leave it stale rather than assert.
+ */
+static void check_checksum_updates(void)
+{
+	struct transfer_list_header *tl;
+	struct transfer_list_entry *te[4];
+	uint8_t data[64] = { 0 };
+	unsigned int stale;
+
+	for (stale = 0U; stale < 2U; stale++) {
+		tl = transfer_list_init(bufs[0], TL_BUF_SIZE);
+		te[0] = transfer_list_add(tl, 1U, sizeof(data), data);
+		te[1] = transfer_list_add(tl, TAG_ID(2U), sizeof(data), data);
+		if ((te[0] == NULL) || (te[1] == NULL)) {
+			fail("cannot add the checksum test entries");
+		}
+		if (stale != 0U) {
+			((uint8_t *)transfer_list_entry_data(te[1]))[0]++;
+		}
+
+		/* Grow, shrink, remove, add in the hole, at the tail, aligned */
+		if (!transfer_list_set_data_size(tl, te[0], 200U) ||
+		    !transfer_list_set_data_size(tl, te[0], 8U) ||
+		    !transfer_list_rem(tl, te[0])) {
+			fail("cannot change the checksum test entries");
+		}
+		te[2] = transfer_list_add(tl, 3U, 16U, data);
+		te[3] = transfer_list_add_with_align(tl, 4U, 16U, data, 6U);
+		if ((te[2] == NULL) || (te[3] == NULL) ||
+		    (transfer_list_verify_checksum(tl) != (stale == 0U))) {
+			fail("checksum not kept up to date by changes");
+		}
+
+		transfer_list_update_checksum(tl);
+		if (!transfer_list_verify_checksum(tl)) {
+			fail("checksum not repaired by an update");
+		}
+	}
+}
+
+static int check(unsigned long long ops)
+{
+	struct transfer_list_header *tl;
+	unsigned int r;
+
+	srand(1);
+	memset(model, 0, sizeof(model));
+	live_count = 0U;
+	cur_buf = 0U;
+
+	tl = transfer_list_init(bufs[0], TL_BUF_SIZE);
+	if (tl == NULL) {
+		fail("cannot create the list");
+	}
+
+	for (step = 0U; step < ops; step++) {
+		r = (uint32_t)rand() % 100U;
+		if ((live_count > (MAX_ENTRIES / 2U)) && (r < 50U)) {
+			r += 50U;
+		}
+
+		if (r < 35U) {
+			op_add(tl, false);
+		} else if (r < 50U) {
+			op_add(tl, true);
+		} else if (r < 75U) {
+			op_rem(tl);
+		} else if (r < 90U) {
+			op_resize(tl);
+		} else if (r < 96U) {
+			if (!transfer_list_compact(tl)) {
+				fail("compaction failed");
+			}
+		} else if (r < 98U) {
+			tl = op_relocate(tl);
+		} else {
+			if (transfer_list_check_header(tl) != TL_OPS_ALL) {
+				fail("header check failed");
+			}
+		}
+
+		check_list(tl);
+	}
+
+	check_compact_malformed();
+	check_checksum_updates();
+
+	printf("%llu operations checked\n", ops);
+
+	return 0;
+}
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Time an expression, returning the best time of a run in seconds */
+#define BENCH(best, expr)						\
+	do {								\
+		double _start, _t, _total = 0.0;			\
+		unsigned int _runs = 0U;				\
+									\
+		while ((_runs < MIN_RUNS) || (_total < MIN_TIME)) {	\
+			_start = now();					\
+			expr;						\
+			_t = now() - _start;				\
+			if ((_runs == 0U) || (_t < (best))) {		\
+				(best) = _t;				\
+			}						\
+			_total += _t;					\
+			_runs++;					\
+		}							\
+	} while (false)
+
+static struct transfer_list_header *build(void)
+{
+	struct transfer_list_header *tl;
+	uint8_t data[BENCH_DATA] = { 0 };
+	uint32_t i;
+
+	tl = transfer_list_init(bufs[0], TL_BUF_SIZE);
+	for (i = 0U; i < BENCH_ENTRIES; i++) {
+		transfer_list_add(tl, 1U + (i * BENCH_TAGS) / BENCH_ENTRIES,
+				  sizeof(data), data);
+	}
+
+	return tl;
+}
+
+static void find_all(struct transfer_list_header *tl)
+{
+	uint16_t tag;
+
+	for (tag = 1U; tag <= BENCH_TAGS; tag++) {
+		if (transfer_list_find(tl, tag) == NULL) {
+			fail("benchmark entry not found");
+		}
+	}
+}
+
+/*
+ * Remove every other entry and compact, returning the best time of a run.
+ * Building the list takes much longer than this, so only a fixed number of
+ * runs is done.
+ */
+static double rem_compact(void)
+{
+	struct transfer_list_header *tl;
+	struct transfer_list_entry *te;
+	double start, t, best = 0.0;
+	unsigned int runs;
+	bool rem;
+
+	for (runs = 0U; runs < COMPACT_RUNS; runs++) {
+		tl = build();
+		te = NULL;
+		rem = false;
+
+		start = now();
+		while ((te = transfer_list_next(tl, te)) != NULL) {
+			if (rem && !transfer_list_rem(tl, te)) {
+				fail("benchmark entry not removed");
+			}
+			rem = !rem;
+		}
+		if (!transfer_list_compact(tl)) {
+			fail("benchmark compaction failed");
+		}
+		t = now() - start;
+
+		if ((runs == 0U) || (t < best)) {
+			best = t;
+		}
+	}
+
+	return best;
+}
+
+static int bench(void)
+{
+	struct transfer_list_header *tl;
+	double t_build = 0.0, t_find = 0.0, t_compact;
+
+	BENCH(t_build, build());
+	tl = build();
+	BENCH(t_find, find_all(tl));
+	t_compact = rem_compact();
+
+	printf("%u entries of %u bytes, %u tags\n", BENCH_ENTRIES, BENCH_DATA,
+	       BENCH_TAGS);
+	printf("%-32s %12.1f\n", "add, ns per entry",
+	       t_build * 1e9 / BENCH_ENTRIES);
+	printf("%-32s %12.1f\n", "find, ns per lookup",
+	       t_find * 1e9 / BENCH_TAGS);
+	printf("%-32s %12.1f\n", "rem half + compact, us",
+	       t_compact * 1e6);
+
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned int i;
+
+	if ((argc > 3) || ((argc >= 2) && (strcmp(argv[1], "-c") != 0))) {
+		printf("Usage: %s [-c [ops]]\n\n"
+		       "Time adding, looking up and compacting transfer list\n"
+		       "entries.\n\n"
+		       "  -c  Check random operations against a model instead\n",
+		       argv[0]);
+		return 1;
+	}
+
+	for (i = 0U; i < 2U; i++) {
+		if (posix_memalign((void **)&bufs[i], TL_BUF_ALIGN,
+				   TL_BUF_SIZE) != 0) {
+			fprintf(stderr, "Cannot allocate memory\n");
+			return 1;
+		}
+	}
+
+	if (argc >= 2) {
+		return check((argc == 3) ? strtoull(argv[2], NULL, 0) : 20000U);
+	}
+
+	return bench();
+}